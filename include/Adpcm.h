@@ -0,0 +1,58 @@
+/*
+ * Adpcm.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __ADPCM_H__
+#define __ADPCM_H__
+
+#include <stdint.h>
+
+// State of an IMA-ADPCM decoder
+typedef struct adpcm_state_s
+{
+	const uint8_t* data; // Next byte of the compressed stream
+	uint8_t highNibble; // Flag to check if the high nibble of the byte is next
+	uint8_t index; // Index into the step size table
+	int16_t predictor; // Last decoded sample
+} adpcm_state_t;
+
+
+/*
+ * Start decoding a stream
+ *
+ * The stream starts with a predictor of 0 and a step index of 0, every byte
+ * holds two samples, low nibble first.
+ *
+ * @input state		Pointer to the decoder state
+ * 		  data		Pointer to the compressed stream
+ * @return None
+ *
+ */
+void Adpcm_Start(adpcm_state_t* state, const uint8_t* data);
+
+
+/*
+ * Decode the next sample
+ *
+ * @input state		Pointer to the decoder state
+ * @return Decoded 16-bit sample
+ *
+ */
+int16_t Adpcm_DecodeSample(adpcm_state_t* state);
+
+
+/*
+ * Decode a block of samples
+ *
+ * @input state		Pointer to the decoder state
+ * 		  out		Pointer to the buffer to be populated
+ * 		  count		Number of samples to decode
+ * @return None
+ *
+ */
+void Adpcm_Decode(adpcm_state_t* state, int16_t* out, int count);
+
+#endif /* __ADPCM_H__ */
@@ -0,0 +1,105 @@
+/*
+ * Arp.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __ARP_H__
+#define __ARP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "EventQueue.h"
+
+// Notes of the held chord and the octaves it can span
+#define ARP_MAX_NOTES (8)
+#define ARP_MAX_OCTAVES (4)
+
+// Order in which the notes of the chord are played
+typedef enum {
+	ARP_UP,
+	ARP_DOWN,
+	ARP_UPDOWN, // Up, then down without repeating the ends
+	ARP_RANDOM,
+	ARP_ORDERS
+} arp_order_t;
+
+
+/*
+ * Start arpeggiating a chord
+ *
+ * The notes are sorted from low to high and repeated an octave higher for
+ * every octave. Every note sounds for half of its step. Replaces the chord
+ * if the arpeggiator is running already.
+ *
+ * @input notes			Pointer to the MIDI notes of the chord
+ * 		  velocities	Pointer to the velocity of every note
+ * 		  count			Number of notes (1 to ARP_MAX_NOTES)
+ * 		  order			Order of the notes
+ * 		  octaves		Number of octaves (1 to ARP_MAX_OCTAVES)
+ * 		  division		Notes per whole note, e.g. 16 for sixteenth notes
+ * 		  tempo			Beats per minute
+ * 		  start			Time of the first note in samples
+ * @return True if the arpeggiator was started, else False.
+ *
+ */
+bool Arp_Start(const uint8_t* notes, const uint8_t* velocities, int count, arp_order_t order,
+		int octaves, uint8_t division, uint16_t tempo, uint32_t start);
+
+
+/*
+ * Stop the arpeggiator
+ *
+ * The sounding note is ended with the next block.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Arp_Stop();
+
+
+/*
+ * Returns whether the arpeggiator is running
+ *
+ * @input None
+ * @return True until the stop has been played, else False.
+ *
+ */
+bool Arp_IsRunning();
+
+
+/*
+ * Returns the name of an order
+ *
+ * @input order		Order
+ * @return Name of the order
+ *
+ */
+const char* Arp_OrderName(arp_order_t order);
+
+
+/*
+ * Returns the time of the next note on or note off
+ *
+ * Called by the render of every block, which splits the block at the note.
+ *
+ * @input timestamp		Pointer to store the time in samples
+ * @return True if a note is pending, False if the arpeggiator is stopped.
+ *
+ */
+bool Arp_NextStep(uint32_t* timestamp);
+
+
+/*
+ * Play the next note on or note off
+ *
+ * @input events	Array of at least one event to fill
+ * @return Number of events
+ *
+ */
+int Arp_Step(note_event_t* events);
+
+#endif /* __ARP_H__ */
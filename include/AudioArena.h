@@ -0,0 +1,85 @@
+/*
+ * AudioArena.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __AUDIO_ARENA_H__
+#define __AUDIO_ARENA_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Size of the RAM shared by the audio subsystems
+#define AUDIO_ARENA_SIZE (8 * 1024)
+
+// Subsystems borrowing memory from the arena
+typedef enum {
+	ARENA_DMA, // Ring of blocks played by the DMA
+	ARENA_MIX, // Block of samples before conversion for the DAC
+	ARENA_VOICES, // State of the synthesizer voices
+	ARENA_ECHO, // Echo delay line
+	ARENA_STREAM, // Jitter buffer of the UART stream
+	ARENA_OWNERS
+} arena_owner_t;
+
+
+/*
+ * Release all the allocations
+ *
+ * Called before the audio subsystems are configured. Nothing borrowed from
+ * the arena may be used afterwards.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Arena_Reset();
+
+
+/*
+ * Borrow memory from the arena
+ *
+ * Memory is only borrowed at configuration time and is never freed on
+ * its own. The returned memory is cleared.
+ *
+ * @input owner		Subsystem borrowing the memory
+ * 		  size		Number of bytes
+ * 		  alignment	Required alignment in bytes, a power of two
+ * @return Pointer to the memory, NULL if the arena is exhausted.
+ *
+ */
+void* Arena_Alloc(arena_owner_t owner, size_t size, size_t alignment);
+
+
+/*
+ * Returns the number of bytes borrowed by a subsystem
+ *
+ * @input owner		Subsystem
+ * @return Number of bytes
+ *
+ */
+size_t Arena_Used(arena_owner_t owner);
+
+
+/*
+ * Returns the number of bytes left in the arena
+ *
+ * @input None
+ * @return Number of bytes
+ *
+ */
+size_t Arena_Free();
+
+
+/*
+ * Returns the name of a subsystem for reports
+ *
+ * @input owner		Subsystem
+ * @return Name of the subsystem
+ *
+ */
+const char* Arena_OwnerName(arena_owner_t owner);
+
+#endif /* __AUDIO_ARENA_H__ */
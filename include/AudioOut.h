@@ -10,18 +10,50 @@
 
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "Synth.h"
+
+// Sampling rate of DAC at startup, and the highest rate supported
+#define DAC_SAMPLING_RATE (48000)
+
+// Lowest sampling rate supported
+#define DAC_MIN_SAMPLING_RATE (8000)
+
+// Number of samples rendered at once, every block is one DMA transfer
+#define AUDIO_BLOCK_SHIFT (7)
+#define AUDIO_BLOCK_SIZE (1 << AUDIO_BLOCK_SHIFT)
+
+// Statistics of the audio engine
+typedef struct audio_stats_s
+{
+	uint32_t dmaInterrupts; // Number of DMA interrupts taken
+	uint32_t renderCycles; // Core clock cycles spent rendering
+	uint32_t blocksRendered; // Number of blocks rendered
+	bool idle; // Flag to check if TPM0 and the DMA are stopped
+} audio_stats_t;
+
+// Parameters which can be changed by parameter events
+enum AudioParameter{
+	AUDIO_PARAM_ECHO,
+	AUDIO_PARAM_VIBRATO,
+	AUDIO_PARAM_TREMOLO,
+	AUDIO_PARAM_PITCH_BEND, // 14 bit MIDI bend, 8192 for none
+	AUDIO_PARAM_SEQUENCER // Starts the sequencer at the current tempo when not 0, else stops it
+};
 
 /*
  * Initialize Audio Out module
  *
  * Contains the implementation to initialize the Audio Out module
- * by setting the clock and configuration settings.
+ * by setting the clock and configuration settings. The output must not
+ * be started if the audio blocks didn't get their memory.
  *
  * @input None
- * @return None
+ * @return True if the audio subsystems got their memory, else False.
  *
  */
-void AudioOut_Init();
+bool AudioOut_Init();
 
 
 /*
@@ -35,16 +67,154 @@ void AudioOut_Start();
 
 
 /*
- * Compute samples based on tone frequencies and echo mode.
+ * Compute samples based on the queued events and echo mode.
  *
- * Contains the implementation to compute the samples based on the tone
- * frequency as well as the echo mode flag.
+ * Contains the implementation to render the next block once the DMA has
+ * finished playing one. Playback is stopped after a few silent blocks
+ * with nothing queued and resumed by the next queued event.
  *
  * @input None
+ * @return True if a block was just rendered or the output is idle, so the
+ * 		   next DMA interrupt is most of a block away, else False.
+ *
+ */
+bool ComputeSamples();
+
+
+/*
+ * Get the statistics of the audio engine
+ *
+ * @input stats		Pointer to store the statistics
+ * 		  reset		Restart the counts from zero after reading them
  * @return None
  *
  */
-void ComputeSamples();
+void AudioOut_GetStats(audio_stats_t* stats, bool reset);
+
+
+/*
+ * Change the sampling rate of the DAC
+ *
+ * Stops the playback, retimes TPM0 and configures the audio subsystems
+ * again for the new rate. Playing notes and queued events are dropped.
+ *
+ * @input rate	Sampling rate in Hz (DAC_MIN_SAMPLING_RATE to DAC_SAMPLING_RATE)
+ * @return True if the rate was changed, else False.
+ *
+ */
+bool AudioOut_SetSampleRate(uint32_t rate);
+
+
+/*
+ * Configure the audio subsystems again
+ *
+ * Partitions the audio arena again after a setting which changes the
+ * memory of a subsystem, such as the waveform of the voices. Stops the
+ * playback, playing notes and queued events are dropped.
+ *
+ * @input None
+ * @return True if the subsystems got their memory, else False.
+ *
+ */
+bool AudioOut_Reconfigure();
+
+
+/*
+ * Select the sound of the voices
+ *
+ * Gaining or losing the delay lines of the plucked strings configures the
+ * audio subsystems again like AudioOut_Reconfigure() does, the other
+ * sounds switch in place and the playing notes keep sounding. The old
+ * sound is put back if the new one can't get its memory.
+ *
+ * @input wave	One of synth_wave_t
+ * @return True if the sound was changed, False while streaming or if the
+ * 		   voices didn't get their memory.
+ *
+ */
+bool AudioOut_SetWaveform(synth_wave_t wave);
+
+
+/*
+ * Returns the current sampling rate of the DAC
+ *
+ * @input None
+ * @return Sampling rate in Hz
+ *
+ */
+uint32_t AudioOut_GetSampleRate();
+
+
+/*
+ * Returns the timestamp of the next block to render
+ *
+ * Events with this timestamp are played as soon as possible.
+ *
+ * @input None
+ * @return Time in samples
+ *
+ */
+uint32_t AudioOut_GetSampleTime();
+
+
+/*
+ * Returns the timestamp at which the next queued tones start
+ *
+ * Tones continue after the ones already queued, or start right away. The
+ * cursor goes back to the current time when the queued events are dropped.
+ *
+ * @input None
+ * @return Time in samples
+ *
+ */
+uint32_t AudioOut_GetPlayCursor();
+
+
+/*
+ * Move the play cursor after the tones just queued
+ *
+ * @input time	Timestamp after the last queued event in samples
+ * @return None
+ *
+ */
+void AudioOut_SetPlayCursor(uint32_t time);
+
+
+/*
+ * Returns the tempo set by the last tempo event
+ *
+ * @input None
+ * @return Tempo in beats per minute
+ *
+ */
+uint16_t AudioOut_GetTempo();
+
+
+/*
+ * Set the tempo of the engine
+ *
+ * The arpeggiator follows it when started without a tempo, and a running
+ * sequencer changes to it.
+ *
+ * @input bpm	Beats per minute, 0 is ignored
+ * @return None
+ *
+ */
+void AudioOut_SetTempo(uint16_t bpm);
+
+
+/*
+ * Set a parameter of the audio engine
+ *
+ * Used for parameter change events. The LFO parameters hold the rate
+ * in the upper byte and the depth in the lower byte.
+ *
+ * @input parameter		Parameter id
+ * 		  value			New value
+ * @return None
+ *
+ */
+void AudioOut_SetParameter(uint8_t parameter, uint16_t value);
 
 
 /*
@@ -52,11 +222,20 @@ void ComputeSamples();
  *
  * Contains the implementation to set the echo mode flag.
  *
- * @input flag			Value to set for the flag
- * 		  scalingFactor Factor of amplitude reduction for echo
+ * @input flag	Value to set for the flag
  * @return None
  *
  */
-void SetEchoMode(bool flag, int scalingFactor);
+void SetEchoMode(bool flag);
+
+
+/*
+ * Interface to get the echo mode flag
+ *
+ * @input None
+ * @return True if the echo is enabled, else False.
+ *
+ */
+bool GetEchoMode();
 
 #endif /* __AUDIO_OUT_H__ */
@@ -0,0 +1,36 @@
+/*
+ * Benchmark.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <stdbool.h>
+
+
+/*
+ * Print the names of the benchmarks
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Benchmark_List();
+
+
+/*
+ * Run a benchmark and print its results
+ *
+ * The cycles are counted with get_cycles(), so they include the time
+ * taken by interrupts. Run the benchmarks while the audio is idle.
+ *
+ * @input name	Name of the benchmark
+ * @return True if the benchmark exists, else False.
+ *
+ */
+bool Benchmark_Run(const char* name);
+
+#endif /* __BENCHMARK_H__ */
@@ -0,0 +1,39 @@
+/*
+ * Crc16.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __CRC16_H__
+#define __CRC16_H__
+
+#include <stdint.h>
+
+// CRC-16/CCITT (polynomial 0x1021) starts from this value
+#define CRC16_INIT (0xFFFF)
+
+
+/*
+ * Add a byte to a CRC-16/CCITT
+ *
+ * @input crc		CRC so far
+ * 		  byte		Next byte
+ * @return Updated CRC
+ *
+ */
+uint16_t Crc16_Byte(uint16_t crc, uint8_t byte);
+
+
+/*
+ * Add bytes to a CRC-16/CCITT
+ *
+ * @input crc		CRC so far, CRC16_INIT to start
+ * 		  data		Pointer to the bytes
+ * 		  length	Number of bytes
+ * @return Updated CRC
+ *
+ */
+uint16_t Crc16_Update(uint16_t crc, const void* data, uint32_t length);
+
+#endif /* __CRC16_H__ */
@@ -0,0 +1,93 @@
+/*
+ * Drums.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __DRUMS_H__
+#define __DRUMS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Percussion voices, one of each can sound at a time
+typedef enum {
+	DRUM_KICK, // Sine swept down in pitch
+	DRUM_SNARE, // Short tone with high-passed pink noise
+	DRUM_HAT, // High-passed white noise
+	DRUMS
+} drum_t;
+
+
+/*
+ * Initialize the drums
+ *
+ * Borrows the state of the voices from the audio arena, and sets the
+ * envelopes and filters for the sampling rate.
+ *
+ * @input None
+ * @return True if the voices could be allocated, else False.
+ *
+ */
+bool Drums_Init();
+
+
+/*
+ * Strike a drum
+ *
+ * Restarts the voice of the drum if it is still sounding.
+ *
+ * @input drum		Drum to strike
+ * 		  velocity	Loudness of the stroke (0 to 127), 0 silences the drum
+ * @return None
+ *
+ */
+void Drums_Trigger(drum_t drum, uint8_t velocity);
+
+
+/*
+ * Returns the number of drums sounding
+ *
+ * @input None
+ * @return Number of active voices
+ *
+ */
+int Drums_ActiveVoices();
+
+
+/*
+ * Returns the drum of a pattern letter
+ *
+ * @input letter	K for the kick, S for the snare or H for the hat, in either case
+ * @return Drum of the letter, DRUMS if it is not a drum.
+ *
+ */
+drum_t Drums_FromLetter(char letter);
+
+
+/*
+ * Returns the name of a drum
+ *
+ * @input drum		Drum
+ * @return Name of the drum
+ *
+ */
+const char* Drums_Name(drum_t drum);
+
+
+/*
+ * Render a segment of the current block
+ *
+ * The sounding drums are added to [offset, offset + count) of the block,
+ * saturating the result.
+ *
+ * @input block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+void Drums_Render(int16_t* block, int offset, int count);
+
+#endif /* __DRUMS_H__ */
@@ -0,0 +1,55 @@
+/*
+ * Echo.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __ECHO_H__
+#define __ECHO_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Delay of the echo in milliseconds
+#define ECHO_DELAY_MS (125)
+
+
+/*
+ * Initialize the echo effect
+ *
+ * Borrows the delay line from the audio arena. The delay line is stored as
+ * 8-bit mu-law, which keeps the quiet tails of the echo smooth at half the
+ * memory of 16-bit samples.
+ *
+ * @input delaySamples	Length of the delay line in samples
+ * @return True if the delay line could be allocated, else False.
+ *
+ */
+bool Echo_Init(int delaySamples);
+
+
+/*
+ * Clear the delay line
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Echo_Clear();
+
+
+/*
+ * Apply the echo effect on a block
+ *
+ * Contains the implementation of a feedback delay line, where every sample
+ * is repeated after the delay with diminishing volume.
+ *
+ * @input block		Pointer to the samples to be processed in place
+ * 		  count		Number of samples
+ * @return None
+ *
+ */
+void Echo_Process(int16_t* block, int count);
+
+#endif /* __ECHO_H__ */
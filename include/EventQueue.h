@@ -0,0 +1,117 @@
+/*
+ * EventQueue.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __EVENT_QUEUE_H__
+#define __EVENT_QUEUE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Number of events the queue can hold
+#define EVENT_QUEUE_SIZE (64)
+
+// Types of the events consumed by the audio engine
+typedef enum {
+	EVENT_NOTE_ON,
+	EVENT_NOTE_OFF,
+	EVENT_REST, // Silences all the playing notes
+	EVENT_TEMPO,
+	EVENT_PARAMETER,
+	EVENT_SAMPLE, // Plays a sample from the sample bank
+	EVENT_DRUM // Strikes a drum
+} event_type_t;
+
+// A single timestamped event
+typedef struct note_event_s
+{
+	uint32_t timestamp; // Absolute time in samples
+	uint8_t type; // One of event_type_t
+	uint8_t key; // MIDI note number, parameter id, sample id or drum
+	uint16_t value; // Velocity, tempo in BPM or parameter value
+} note_event_t;
+
+
+/*
+ * Enqueue an event
+ *
+ * The whole event is copied into the queue atomically. Events have to be
+ * enqueued in the order of their timestamps.
+ *
+ * @input event		Pointer to the event
+ * @return True if the event was enqueued, false if the queue is full.
+ *
+ */
+bool EventQueue_Enqueue(const note_event_t* event);
+
+
+/*
+ * Insert an event in the order of the timestamps
+ *
+ * The event goes after the queued events which are not later than it, so
+ * an event for the current time is played before the events queued for
+ * the future. Takes the time of moving the later events with interrupts
+ * disabled.
+ *
+ * @input event		Pointer to the event
+ * @return True if the event was inserted, false if the queue is full.
+ *
+ */
+bool EventQueue_Insert(const note_event_t* event);
+
+
+/*
+ * Read the oldest event without removing it
+ *
+ * @input event		Pointer to store the event
+ * @return True if an event was available, else False.
+ *
+ */
+bool EventQueue_Peek(note_event_t* event);
+
+
+/*
+ * Dequeue the oldest event
+ *
+ * The whole event is copied out of the queue atomically.
+ *
+ * @input event		Pointer to store the event
+ * @return True if an event was dequeued, else False.
+ *
+ */
+bool EventQueue_Dequeue(note_event_t* event);
+
+
+/*
+ * Returns the number of events in the queue
+ *
+ * @input None
+ * @return Number of events waiting to be consumed
+ *
+ */
+int EventQueue_Length();
+
+
+/*
+ * Returns the number of free slots in the queue
+ *
+ * @input None
+ * @return Number of events which can still be enqueued
+ *
+ */
+int EventQueue_Space();
+
+
+/*
+ * Remove all the events from the queue
+ *
+ * @input None
+ * @return None
+ *
+ */
+void EventQueue_Clear();
+
+#endif /* __EVENT_QUEUE_H__ */
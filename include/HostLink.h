@@ -0,0 +1,144 @@
+/*
+ * HostLink.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __HOST_LINK_H__
+#define __HOST_LINK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Version of the protocol, sent in the hello frame
+#define LINK_VERSION (3)
+
+// Sequence a host sends on the console to start the link, A5 5A C3 3C
+#define LINK_MAGIC_LENGTH (4)
+
+// A frame is LINK_SYNC, the length of the payload, the opcode, the payload
+// and the CRC-16/CCITT (0x1021, starting from 0xFFFF) of the length, the
+// opcode and the payload, low byte first. Values in payloads are little endian.
+#define LINK_SYNC (0xA5)
+#define LINK_MAX_PAYLOAD (32)
+#define LINK_OVERHEAD (5)
+
+// Reply to LINK_OP_STATS: frames, CRC errors, errors, overruns, blocks
+// rendered, render cycles and DMA interrupts (u32), sounding voices and idle (u8)
+#define LINK_STATS_LENGTH (30)
+
+// Reply to LINK_OP_BAUD: actual baud rate (u32) and its error in parts per million (i32)
+#define LINK_BAUD_LENGTH (8)
+
+// Received bytes waiting for the main loop, has to be a power of 2
+#define LINK_BUFFER_SIZE (128)
+
+// Time without data after which the console is given back, in ticks
+#define LINK_TIMEOUT_TICKS (160)
+
+// Opcodes of the frames sent by the host, and their payloads
+typedef enum {
+	LINK_OP_HELLO = 0x00, // Answered to the magic sequence: version, max payload, sampling rate (u32)
+	LINK_OP_PING = 0x01, // Any payload, returned as it is
+	LINK_OP_STATS = 0x02, // No payload, answered with the counts of the link and the audio engine
+	LINK_OP_BYE = 0x03, // No payload, answered before the console is given back
+	LINK_OP_BAUD = 0x04, // Baud rate (u32), answered at the current rate before switching
+	LINK_OP_NOTE_ON = 0x10, // Note, velocity
+	LINK_OP_NOTE_OFF = 0x11, // Note
+	LINK_OP_ALL_NOTES_OFF = 0x12, // No payload
+	LINK_OP_DRUM = 0x13, // Drum, velocity
+	LINK_OP_PARAMETER = 0x20, // Parameter id, value (u16)
+	LINK_OP_TEMPO = 0x21, // Beats per minute (u16)
+	LINK_OP_SONG_ERASE = 0x30, // Sector of the song, answered once erased, sector 0 starts an upload
+	LINK_OP_SONG_DATA = 0x31, // Offset (u16), 4 to 28 bytes of the song written in order after the header
+	LINK_OP_SONG_COMMIT = 0x32, // Header of the song (SONG_HEADER_SIZE bytes), answered once checked and written
+	LINK_OP_SONG_PLAY = 0x33, // Bar to start from (u16), 0xFFFF stops the song
+	LINK_OP_REPLY = 0x80, // Or'ed with the opcode of the request answered
+	LINK_OP_ERROR = 0xFF // Error code, opcode of the request
+} link_opcode_t;
+
+// Errors reported to the host
+typedef enum {
+	LINK_ERROR_CRC = 1, // The frame was damaged, the opcode may be wrong
+	LINK_ERROR_OPCODE, // Unknown opcode
+	LINK_ERROR_LENGTH, // Payload of the wrong length
+	LINK_ERROR_VALUE, // Value out of range, no baud rate setting close enough, or the flash failed
+	LINK_ERROR_BUSY // The event queue is full, the frame was dropped
+} link_error_t;
+
+// Statistics of the link
+typedef struct link_stats_s
+{
+	bool active;
+	uint32_t frames; // Frames received intact
+	uint32_t crcErrors;
+	uint32_t errors; // Frames rejected for another reason
+	uint32_t overruns; // Received bytes dropped on a full buffer
+} link_stats_t;
+
+
+/*
+ * Initialize the link
+ *
+ * Watches the console for the magic sequence. The console keeps working
+ * until a host sends it.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void HostLink_Init();
+
+
+/*
+ * Handle the received frames
+ *
+ * Called by the main loop. Notes, drums, parameters and tempo changes are
+ * played at the next block, before the tones queued for later. A song
+ * data or commit frame stops the parsing until HostLink_ProgramFlash()
+ * has written it. The console is given back after a bye frame, or when
+ * no data arrived for LINK_TIMEOUT_TICKS.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void HostLink_Process();
+
+
+/*
+ * Program the flash for a received song frame
+ *
+ * Every program unit holds the interrupts off for about 65 us, so the
+ * main loop calls this right after a block is rendered, or while the
+ * output is idle: the data of a frame is written before the next DMA
+ * interrupt is due, and the blocks keep their timing.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void HostLink_ProgramFlash();
+
+
+/*
+ * Check if the link is active
+ *
+ * @input None
+ * @return True if a host has taken the UART, else False.
+ *
+ */
+bool HostLink_IsActive();
+
+
+/*
+ * Get the statistics of the last or current link
+ *
+ * @input stats		Pointer to store the statistics
+ * @return None
+ *
+ */
+void HostLink_GetStats(link_stats_t* stats);
+
+#endif /* __HOST_LINK_H__ */
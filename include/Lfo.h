@@ -0,0 +1,95 @@
+/*
+ * Lfo.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __LFO_H__
+#define __LFO_H__
+
+#include <stdint.h>
+
+// Parameters modulated by the low frequency oscillators
+typedef enum {
+	LFO_VIBRATO, // Pitch of the playing notes
+	LFO_TREMOLO, // Amplitude of the playing notes
+	LFO_COUNT
+} lfo_target_t;
+
+// Limits of the LFO settings
+#define LFO_MAX_RATE (20) // Hz
+#define LFO_MAX_VIBRATO_DEPTH (100) // cents
+#define LFO_MAX_TREMOLO_DEPTH (100) // percent
+
+
+/*
+ * Initialize the LFOs for the current sampling rate
+ *
+ * Recalculates the phase increments, as the control rate follows the
+ * sampling rate.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Lfo_Init();
+
+
+/*
+ * Configure an LFO
+ *
+ * Sets the rate and depth of the oscillator modulating the given target.
+ * A depth of 0 disables the modulation.
+ *
+ * @input target	Parameter to be modulated
+ * 		  rateHz	Frequency of the oscillator in Hz
+ * 		  depth		Depth in cents for vibrato, in percent for tremolo
+ * @return None
+ *
+ */
+void Lfo_Configure(lfo_target_t target, uint8_t rateHz, uint8_t depth);
+
+
+/*
+ * Get the settings of an LFO
+ *
+ * @input target	Modulated parameter
+ * 		  rateHz	Pointer to store the frequency in Hz
+ * 		  depth		Pointer to store the depth in cents or percent, 0 if disabled
+ * @return None
+ *
+ */
+void Lfo_GetSettings(lfo_target_t target, uint8_t* rateHz, uint8_t* depth);
+
+
+/*
+ * Advance the LFOs by one block
+ *
+ * Called once per rendered block (control rate). The value at the end of the
+ * previous block becomes the start of the new block.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Lfo_Update();
+
+
+/*
+ * Get the modulation over the current block
+ *
+ * Returns the modulation values at the start and the end of the current block,
+ * so the renderer can interpolate in between.
+ * For vibrato, the value is the deviation of the frequency in Q15.
+ * For tremolo, the value is the gain in Q15.
+ *
+ * @input target	Modulated parameter
+ * 		  start		Pointer to store the value at the start of the block
+ * 		  end		Pointer to store the value at the end of the block
+ * @return None
+ *
+ */
+void Lfo_GetSegment(lfo_target_t target, int32_t* start, int32_t* end);
+
+#endif /* __LFO_H__ */
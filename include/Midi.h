@@ -0,0 +1,123 @@
+/*
+ * Midi.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __MIDI_H__
+#define __MIDI_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "EventQueue.h"
+
+// Channels, 0 listens to all of them
+#define MIDI_OMNI (0)
+#define MIDI_CHANNELS (16)
+
+// General MIDI percussion channel, its notes strike the drums
+#define MIDI_DRUM_CHANNEL (10)
+
+// Events waiting for the next block, has to be a power of 2
+#define MIDI_QUEUE_SIZE (32)
+
+// Clock messages in a beat
+#define MIDI_CLOCKS_PER_BEAT (24)
+
+// Statistics of the MIDI input
+typedef struct midi_stats_s
+{
+	bool active;
+	uint8_t channel; // 1 to 16, MIDI_OMNI for all
+	uint32_t bytesReceived;
+	uint32_t messages; // Channel messages for the selected channel
+	uint32_t dropped; // Events lost on a full queue
+	uint32_t clocks; // Clock messages
+	uint16_t clockTempo; // Beats per minute of the clock, 0 if not measured
+} midi_stats_t;
+
+
+/*
+ * Start listening to MIDI on UART0
+ *
+ * Received bytes go to the MIDI parser instead of the console. Notes,
+ * pitch bend, the modulation wheel and the all notes off controllers
+ * play the synthesizer, notes on the percussion channel strike the drums.
+ * A running clock sets the tempo of the sequencer, start, continue and
+ * stop control it. A reset message, or escape outside of a message,
+ * gives the UART back to the console.
+ *
+ * @input channel	Channel to listen to (1 to 16), MIDI_OMNI for all
+ * @return True if MIDI was started, False if the UART is busy.
+ *
+ */
+bool Midi_Start(uint8_t channel);
+
+
+/*
+ * Stop listening to MIDI and give the UART back to the console
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Midi_Stop();
+
+
+/*
+ * Check if MIDI is active
+ *
+ * @input None
+ * @return True if the UART is listening to MIDI, else False.
+ *
+ */
+bool Midi_IsActive();
+
+
+/*
+ * Get the statistics of the MIDI input
+ *
+ * @input stats		Pointer to store the statistics
+ * @return None
+ *
+ */
+void Midi_GetStats(midi_stats_t* stats);
+
+
+/*
+ * Parse a received byte
+ *
+ * Called by the UART0 interrupt for every byte while MIDI is active.
+ *
+ * @input byte		Received byte
+ * @return None
+ *
+ */
+void Midi_ReceiveByte(uint8_t byte);
+
+
+/*
+ * Returns the number of events waiting for the next block
+ *
+ * @input None
+ * @return Number of events
+ *
+ */
+int Midi_Pending();
+
+
+/*
+ * Take the oldest received event
+ *
+ * Called by the render at the start of every block, the events are
+ * applied at the first sample of the block.
+ *
+ * @input event		Pointer to store the event
+ * @return True if an event was taken, False if none is waiting.
+ *
+ */
+bool Midi_Dequeue(note_event_t* event);
+
+#endif /* __MIDI_H__ */
@@ -0,0 +1,74 @@
+/*
+ * Noise.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __NOISE_H__
+#define __NOISE_H__
+
+#include <stdint.h>
+
+// Rows of the pink noise generator, one octave each below the white noise
+#define NOISE_PINK_ROWS (8)
+
+// State of a noise generator
+typedef struct noise_s
+{
+	uint32_t lfsr; // 32-bit Galois LFSR, never zero
+	uint32_t counter; // Samples generated, selects the pink row to update
+	int32_t sum; // Sum of the pink rows
+	int16_t rows[NOISE_PINK_ROWS]; // Held white noise of every pink row
+} noise_t;
+
+// The LFSR advanced by 8 steps for every value of its lowest byte
+extern const uint32_t noiseStepTable[256];
+
+
+/*
+ * Initialize a noise generator
+ *
+ * @input noise		Pointer to the generator
+ * 		  seed		Start of the sequence, zero is replaced by a fixed seed
+ * @return None
+ *
+ */
+void Noise_Init(noise_t* noise, uint32_t seed);
+
+
+/*
+ * Generate a sample of white noise
+ *
+ * Advances the LFSR by 16 steps with two table lookups, so every sample is
+ * made of 16 new bits of the sequence.
+ *
+ * @input noise		Pointer to the generator
+ * @return Noise in Q15
+ *
+ */
+static inline int16_t Noise_White(noise_t* noise)
+{
+	uint32_t lfsr = noise->lfsr;
+
+	lfsr = (lfsr >> 8) ^ noiseStepTable[lfsr & 0xFF];
+	lfsr = (lfsr >> 8) ^ noiseStepTable[lfsr & 0xFF];
+	noise->lfsr = lfsr;
+	return (int16_t)lfsr;
+}
+
+
+/*
+ * Generate a sample of pink noise
+ *
+ * Voss-McCartney generator: every row holds a white noise value which is
+ * renewed half as often as the row before, the sum falls off at about 3 dB
+ * per octave.
+ *
+ * @input noise		Pointer to the generator
+ * @return Noise in Q15, about 13 dB below the full scale (RMS)
+ *
+ */
+int16_t Noise_Pink(noise_t* noise);
+
+#endif /* __NOISE_H__ */
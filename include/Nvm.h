@@ -0,0 +1,71 @@
+/*
+ * Nvm.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __NVM_H__
+#define __NVM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Bytes erased at once
+#define NVM_SECTOR_SIZE (1024)
+
+// Bytes programmed at once, addresses and lengths are multiples of it
+#define NVM_PROGRAM_UNIT (4)
+
+// Value of the erased bytes, programming can only clear bits
+#define NVM_ERASED (0xFF)
+
+
+/*
+ * Initialize the flash driver
+ *
+ * @input None
+ * @return True if the flash can be erased and programmed, else False.
+ *
+ */
+bool Nvm_Init();
+
+
+/*
+ * Erase a sector of the flash
+ *
+ * The core can't read the flash while it is erased, so the interrupts are
+ * held off for the whole erase (up to about 100 ms).
+ *
+ * @input address	Address of the sector, a multiple of NVM_SECTOR_SIZE
+ * @return True if the sector was erased, else False.
+ *
+ */
+bool Nvm_Erase(uint32_t address);
+
+
+/*
+ * Program bytes into erased flash
+ *
+ * The bytes are programmed a unit at a time, the interrupts are held off
+ * for one unit only (about 65 us).
+ *
+ * @input address	Address to program, a multiple of NVM_PROGRAM_UNIT
+ * 		  data		Pointer to the bytes
+ * 		  length	Number of bytes, a multiple of NVM_PROGRAM_UNIT
+ * @return True if all the bytes were programmed, else False.
+ *
+ */
+bool Nvm_Program(uint32_t address, const void* data, uint32_t length);
+
+
+/*
+ * Returns a pointer to read the flash
+ *
+ * @input address	Address in the flash
+ * @return Pointer to the contents
+ *
+ */
+const void* Nvm_Read(uint32_t address);
+
+#endif /* __NVM_H__ */
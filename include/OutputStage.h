@@ -0,0 +1,70 @@
+/*
+ * OutputStage.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __OUTPUT_STAGE_H__
+#define __OUTPUT_STAGE_H__
+
+#include <stdint.h>
+
+// Range of the 12-bit DAC
+#define DAC_MAX_VALUE (4095)
+#define DAC_MIDPOINT (2048)
+
+// Ways of quantizing the Q15 mix to 12 bits
+typedef enum {
+	OUTPUT_ROUND, // Round to the nearest DAC step
+	OUTPUT_DITHER, // Add triangular (TPDF) dither of +-1 step before rounding
+	OUTPUT_SHAPED, // TPDF dither with first-order noise shaping
+	OUTPUT_MODES
+} output_mode_t;
+
+
+/*
+ * Select the quantization of the output stage
+ *
+ * @input mode	One of output_mode_t
+ * @return None
+ *
+ */
+void OutputStage_SetMode(output_mode_t mode);
+
+
+/*
+ * Returns the quantization of the output stage
+ *
+ * @input None
+ * @return One of output_mode_t
+ *
+ */
+output_mode_t OutputStage_GetMode();
+
+
+/*
+ * Returns the name of a quantization mode
+ *
+ * @input mode	One of output_mode_t
+ * @return Name of the mode
+ *
+ */
+const char* OutputStage_ModeName(output_mode_t mode);
+
+
+/*
+ * Convert a block of the Q15 mix for the DAC
+ *
+ * Centers the mix on DAC_MIDPOINT and quantizes it to 12 bits using the
+ * full 0 to DAC_MAX_VALUE range, saturating at both ends.
+ *
+ * @input in		Pointer to the signed samples in Q15
+ * 		  out		Pointer to the DAC values to be populated
+ * 		  count		Number of samples
+ * @return None
+ *
+ */
+void OutputStage_Process(const int16_t* in, uint16_t* out, int count);
+
+#endif /* __OUTPUT_STAGE_H__ */
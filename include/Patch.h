@@ -0,0 +1,54 @@
+/*
+ * Patch.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __PATCH_H__
+#define __PATCH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Settings of the sound kept in a patch, stored as they are in the flash
+typedef struct patch_s
+{
+	uint8_t wave; // One of synth_wave_t
+	uint8_t echo; // 1 if the echo is enabled
+	uint8_t output; // One of output_mode_t
+	uint8_t fmEnvelope; // Percent of the FM index following the envelope
+	uint16_t fmRatio; // Q8
+	uint16_t fmIndex; // Q8
+	uint8_t vibratoRate; // Hz
+	uint8_t vibratoDepth; // Cents, 0 if disabled
+	uint8_t tremoloRate; // Hz
+	uint8_t tremoloDepth; // Percent, 0 if disabled
+	uint16_t tempo; // Beats per minute of the engine and the running sequencer
+} patch_t;
+
+
+/*
+ * Take the current settings into a patch
+ *
+ * @input patch		Pointer to store the settings
+ * @return None
+ *
+ */
+void Patch_Capture(patch_t* patch);
+
+
+/*
+ * Apply the settings of a patch
+ *
+ * The playing notes keep sounding unless the plucked strings are gained
+ * or lost, which configures the audio subsystems again.
+ *
+ * @input patch		Settings to apply
+ * @return True if applied, False if the wave can't change, while
+ * 		   streaming or without its memory.
+ *
+ */
+bool Patch_Apply(const patch_t* patch);
+
+#endif /* __PATCH_H__ */
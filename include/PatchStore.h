@@ -0,0 +1,88 @@
+/*
+ * PatchStore.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __PATCH_STORE_H__
+#define __PATCH_STORE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Patch.h"
+
+// Number of patches which can be stored
+#define PATCH_SLOTS (8)
+
+// Flash kept for the patches, the PATCH_FLASH region of the memory
+// configuration, which the program is not linked into
+#define PATCH_STORE_ADDRESS (0x1F000)
+#define PATCH_STORE_SECTORS (4)
+
+// Statistics of the patch store
+typedef struct patch_store_stats_s
+{
+	uint8_t sector; // Sector the patches are written to
+	uint32_t generation; // Number of sectors written since the store was formatted
+	uint16_t records; // Records written to the sector
+	uint16_t capacity; // Records which fit in a sector
+	uint32_t erases; // Sectors erased since startup
+	uint8_t used; // Bit of every slot holding a patch
+} patch_store_stats_t;
+
+
+/*
+ * Initialize the patch store
+ *
+ * Finds the latest patch of every slot in the flash. A store interrupted
+ * while moving to the next sector is completed, and blank or foreign
+ * flash is formatted.
+ *
+ * @input None
+ * @return True if the store can be used, else False.
+ *
+ */
+bool PatchStore_Init();
+
+
+/*
+ * Save a patch into a slot
+ *
+ * The patch is appended to the log in the flash, the sectors are written
+ * in turn so they wear evenly. Saving the patch a slot holds already
+ * writes nothing.
+ *
+ * @input slot		Slot (0 to PATCH_SLOTS - 1)
+ * 		  patch		Patch to save
+ * @return True if the patch was saved, else False.
+ *
+ */
+bool PatchStore_Save(uint8_t slot, const patch_t* patch);
+
+
+/*
+ * Load the patch of a slot
+ *
+ * Reads the record found by PatchStore_Init or the last save, without
+ * searching the flash.
+ *
+ * @input slot		Slot (0 to PATCH_SLOTS - 1)
+ * 		  patch		Pointer to store the patch
+ * @return True if the slot holds a patch, else False.
+ *
+ */
+bool PatchStore_Load(uint8_t slot, patch_t* patch);
+
+
+/*
+ * Get the statistics of the patch store
+ *
+ * @input stats		Pointer to store the statistics
+ * @return None
+ *
+ */
+void PatchStore_GetStats(patch_store_stats_t* stats);
+
+#endif /* __PATCH_STORE_H__ */
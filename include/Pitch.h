@@ -0,0 +1,62 @@
+/*
+ * Pitch.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __PITCH_H__
+#define __PITCH_H__
+
+#include <stdint.h>
+
+// Dip of the normalized difference taken as the period, 0.1 in Q15
+#define PITCH_THRESHOLD (3277)
+
+
+/*
+ * Estimate the period of a signal
+ *
+ * YIN difference function in fixed point: the window is compared with
+ * itself shifted by every lag up to maxLag, and the first lag at which the
+ * cumulative mean normalized difference dips below PITCH_THRESHOLD is the
+ * period, or a whole fraction of it which dips below twice the threshold.
+ * The period is interpolated with a parabola at twice, four times... the
+ * period up to maxLag, so a longer maxLag gives a finer period. Takes
+ * window * maxLag multiplications.
+ *
+ * @input samples	Q15 samples, window + maxLag of them
+ * 		  window	Samples compared, at least the longest period
+ * 		  maxLag	Longest lag, at least the longest period and 2
+ * 		  scratch	Space for maxLag + 1 differences
+ * @return Period in samples in Q16, 0 if no period was found
+ *
+ */
+uint32_t Pitch_Period(const int16_t* samples, int window, int maxLag, uint16_t* scratch);
+
+
+/*
+ * Frequency of a period
+ *
+ * @input period	Period in samples in Q16
+ * 		  rate		Sampling rate in Hz
+ * @return Frequency in Hz in Q8, 0 for no period
+ *
+ */
+uint32_t Pitch_Frequency(uint32_t period, uint32_t rate);
+
+
+/*
+ * Deviation of a period from the equal tempered pitch of a note
+ *
+ * The pitch of a note is 440 Hz * 2^((note - 69) / 12).
+ *
+ * @input period	Period in samples in Q16
+ * 		  rate		Sampling rate in Hz
+ * 		  note		MIDI note number
+ * @return Cents in Q8, above 0 if the period is sharp
+ *
+ */
+int32_t Pitch_Cents(uint32_t period, uint32_t rate, uint8_t note);
+
+#endif /* __PITCH_H__ */
@@ -0,0 +1,65 @@
+/*
+ * RamCode.h - Hot code and tables run from SRAM
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __RAM_CODE_H__
+#define __RAM_CODE_H__
+
+#include <stdint.h>
+
+// At 48 MHz the flash runs at half the core clock, so fetching code and
+// tables from it adds wait states. Functions marked RAM_FUNCTION and tables
+// marked RAM_DATA are linked into the .data section of ARMonica_Debug.ld,
+// between __start_ramcode and __end_ramcode, and copied into SRAM at startup
+// with the initialized variables. Calls between them and the flash go
+// through veneers inserted by the linker. Host builds of the sources keep
+// everything in place.
+#if defined(__arm__)
+#define RAM_FUNCTION __attribute__((section(".ramfunc"), noinline))
+#define RAM_DATA __attribute__((section(".ramdata")))
+#else
+#define RAM_FUNCTION
+#define RAM_DATA
+#endif
+
+// Start and end of the code and tables in SRAM, and of their copy in
+// the flash the startup code loads them from
+extern uint8_t __start_ramcode[];
+extern uint8_t __end_ramcode[];
+extern uint8_t __load_ramcode[];
+
+
+/*
+ * Returns the number of bytes of code and tables in SRAM
+ *
+ * @input None
+ * @return Bytes between __start_ramcode and __end_ramcode
+ *
+ */
+static inline uint32_t RamCode_Size()
+{
+	return (uint32_t)(__end_ramcode - __start_ramcode);
+}
+
+
+/*
+ * Returns the copy in the flash of a function run from SRAM
+ *
+ * The copy is the startup image of the function, which runs the same from
+ * the flash: branches between the functions in SRAM are relative and lead
+ * to their copies as well, variables and tables are reached by their
+ * address in SRAM. Used to measure what running from SRAM gains.
+ *
+ * @input function		Address of a RAM_FUNCTION
+ * @return Address of the same function in the flash
+ *
+ */
+static inline void* RamCode_FlashCopy(void* function)
+{
+	return (void*)((uintptr_t)function - (uintptr_t)__start_ramcode + (uintptr_t)__load_ramcode);
+}
+
+#endif /* __RAM_CODE_H__ */
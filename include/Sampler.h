@@ -0,0 +1,81 @@
+/*
+ * Sampler.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __SAMPLER_H__
+#define __SAMPLER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Number of samples which can play at the same time
+#define SAMPLER_MAX_PLAYERS (2)
+
+// A recorded sample stored in flash as IMA-ADPCM
+typedef struct sample_info_s
+{
+	const char* name;
+	const uint8_t* data; // Compressed stream, two samples per byte
+	uint32_t numSamples; // Number of decoded samples
+	uint16_t sampleRate; // Rate of the recording in Hz
+} sample_info_t;
+
+// Samples in flash, generated by tools/wav2adpcm.py
+extern const sample_info_t sampleBank[];
+extern const int sampleBankSize;
+
+
+/*
+ * Initialize the sampler
+ *
+ * Borrows the state of the players from the audio arena.
+ *
+ * @input None
+ * @return True if the players could be allocated, else False.
+ *
+ */
+bool Sampler_Init();
+
+
+/*
+ * Start playing a sample
+ *
+ * Takes an idle player, or the one which started first if all are busy.
+ *
+ * @input id		Index of the sample in the sample bank
+ * 		  velocity	Loudness of the sample (0 to 127)
+ * @return None
+ *
+ */
+void Sampler_Trigger(int id, uint8_t velocity);
+
+
+/*
+ * Returns the number of samples playing
+ *
+ * @input None
+ * @return Number of active players
+ *
+ */
+int Sampler_ActivePlayers();
+
+
+/*
+ * Render a segment of the current block
+ *
+ * Decodes the playing samples and resamples them to the DAC sampling rate
+ * with linear interpolation. The samples are added to [offset, offset + count)
+ * of the block, saturating the result.
+ *
+ * @input block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+void Sampler_Render(int16_t* block, int offset, int count);
+
+#endif /* __SAMPLER_H__ */
@@ -0,0 +1,174 @@
+/*
+ * Sequencer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __SEQUENCER_H__
+#define __SEQUENCER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "EventQueue.h"
+
+// Patterns playing together and their length
+#define SEQ_MAX_PATTERNS (4)
+#define SEQ_MAX_STEPS (32)
+
+// One step is a sixteenth note
+#define SEQ_STEPS_PER_BEAT (4)
+
+// Range of the swing, the share of a pair of steps taken by the first step
+#define SEQ_MIN_SWING (50) // Straight
+#define SEQ_MAX_SWING (75)
+
+// Most events a step can produce, a note off and a note on per pattern
+#define SEQ_MAX_EVENTS (2 * SEQ_MAX_PATTERNS)
+
+// Keys of a step besides the MIDI notes 1 to 127
+#define SEQ_REST (0x00) // Ends the note of the previous step
+#define SEQ_TIE (0xFF) // Holds the note of the previous step
+#define SEQ_DRUM (0x80) // Or'ed with a drum_t to strike a drum
+
+// A single step, two bytes
+typedef struct seq_step_s
+{
+	uint8_t key; // MIDI note, SEQ_DRUM | drum, SEQ_REST or SEQ_TIE
+	uint8_t velocity; // 1 to 127
+} seq_step_t;
+
+
+/*
+ * Store a pattern
+ *
+ * Patterns shorter than the others loop on their own. A pattern of length 0
+ * is empty. The pattern can be changed while the sequencer is running, the
+ * new steps are played from the next step on.
+ *
+ * @input pattern	Index of the pattern (0 to SEQ_MAX_PATTERNS - 1)
+ * 		  steps		Pointer to the steps
+ * 		  length	Number of steps (0 to SEQ_MAX_STEPS)
+ * @return True if the pattern was stored, else False.
+ *
+ */
+bool Sequencer_SetPattern(int pattern, const seq_step_t* steps, int length);
+
+
+/*
+ * Set the velocity of a step
+ *
+ * @input pattern	Index of the pattern
+ * 		  step		Index of the step
+ * 		  velocity	Loudness of the step (1 to 127)
+ * @return True if the step exists, else False.
+ *
+ */
+bool Sequencer_SetVelocity(int pattern, int step, uint8_t velocity);
+
+
+/*
+ * Returns the steps of a pattern
+ *
+ * @input pattern	Index of the pattern
+ * 		  length	Pointer to store the number of steps
+ * @return Pointer to the steps, NULL if the pattern doesn't exist.
+ *
+ */
+const seq_step_t* Sequencer_GetPattern(int pattern, int* length);
+
+
+/*
+ * Start the sequencer
+ *
+ * All the patterns restart from their first step with the next block.
+ *
+ * @input tempo		Beats per minute, four steps per beat
+ * 		  swing		Percent of a pair of steps taken by the first step
+ * 					(SEQ_MIN_SWING to SEQ_MAX_SWING)
+ * @return None
+ *
+ */
+void Sequencer_Start(uint16_t tempo, uint8_t swing);
+
+
+/*
+ * Change the tempo of the running sequencer
+ *
+ * The patterns keep their position, the pair of steps being played
+ * ends at the new tempo. Ignored while the sequencer is stopped.
+ *
+ * @input tempo		Beats per minute
+ * @return None
+ *
+ */
+void Sequencer_SetTempo(uint16_t tempo);
+
+
+/*
+ * Stop the sequencer
+ *
+ * The sounding notes are ended with the next block.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Sequencer_Stop();
+
+
+/*
+ * Returns whether the sequencer is running
+ *
+ * @input None
+ * @return True until the stop has been played, else False.
+ *
+ */
+bool Sequencer_IsRunning();
+
+
+/*
+ * Returns the tempo of the sequencer
+ *
+ * @input None
+ * @return Beats per minute set by the last start or tempo change
+ *
+ */
+uint16_t Sequencer_GetTempo();
+
+
+/*
+ * Returns the swing of the sequencer
+ *
+ * @input None
+ * @return Swing set by the last start, in percent of a pair of steps
+ *
+ */
+uint8_t Sequencer_GetSwing();
+
+
+/*
+ * Returns the time of the next step
+ *
+ * Called by the render of every block, which splits the block at the step.
+ *
+ * @input timestamp		Pointer to store the time of the step in samples
+ * @return True if a step is pending, False if the sequencer is stopped.
+ *
+ */
+bool Sequencer_NextStep(uint32_t* timestamp);
+
+
+/*
+ * Play the next step
+ *
+ * Produces the events of every pattern at the step and advances the clock.
+ *
+ * @input events	Array of at least SEQ_MAX_EVENTS events to fill
+ * @return Number of events
+ *
+ */
+int Sequencer_Step(note_event_t* events);
+
+#endif /* __SEQUENCER_H__ */
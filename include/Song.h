@@ -0,0 +1,197 @@
+/*
+ * Song.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __SONG_H__
+#define __SONG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "EventQueue.h"
+
+// Flash kept for the song, the SONG_FLASH region of the memory
+// configuration, which the program is not linked into
+#define SONG_FLASH_ADDRESS (0x1B000)
+#define SONG_FLASH_SECTORS (16)
+#define SONG_FLASH_SIZE (SONG_FLASH_SECTORS * 1024)
+
+// Format of the song, songs of another format are not played
+#define SONG_MAGIC (0x474E4F53) // "SONG"
+#define SONG_VERSION (1)
+#define SONG_NAME_LENGTH (12)
+
+// The song in the flash is the header, the bar index and the events.
+// Every event is a delta time in ticks since the previous event, as a
+// variable length quantity of 7 bits per byte (most significant first, the
+// top bit set on all but the last byte), then one of:
+//   0x00 - 0x7F	Note, followed by its velocity, 0 ends the note
+//   0x80 - 0x8F	SONG_DRUM | drum_t, followed by its velocity
+//   0xF1			Tempo, followed by the beats per minute (u16)
+//   0xFE			Bar line, the deltas after it count from the bar line
+//   0xFF			End of the song
+#define SONG_DRUM (0x80)
+#define SONG_TEMPO (0xF1)
+#define SONG_BAR (0xFE)
+#define SONG_END (0xFF)
+
+// Range of the tempo in beats per minute
+#define SONG_MIN_TEMPO (20)
+#define SONG_MAX_TEMPO (400)
+
+// Header at the start of the song, programmed once the rest is written
+typedef struct song_header_s
+{
+	uint32_t magic;
+	uint8_t version;
+	uint8_t beatsPerBar;
+	uint16_t ticksPerBeat;
+	uint16_t tempo; // Beats per minute at the start
+	uint16_t bars;
+	uint32_t length; // Bytes after the header, the bar index and the events
+	uint16_t crc; // CRC-16/CCITT of the bytes after the header
+	uint16_t reserved;
+	char name[SONG_NAME_LENGTH]; // Padded with zeros
+} song_header_t;
+
+#define SONG_HEADER_SIZE (32)
+
+// Entry of the bar index, which follows the header
+typedef struct song_bar_s
+{
+	uint16_t offset; // Of the event after the bar line, from the start of the song
+	uint16_t tempo; // Beats per minute at the bar line
+} song_bar_t;
+
+// State of the song
+typedef struct song_info_s
+{
+	bool valid; // A complete song is in the flash
+	bool playing;
+	uint16_t bar; // Bar being played
+	uint32_t written; // Bytes written by the upload in progress, 0 if none
+	const song_header_t* header; // Header in the flash, when valid
+} song_info_t;
+
+
+/*
+ * Initialize the song
+ *
+ * Checks the header and the CRC of the song in the flash.
+ *
+ * @input None
+ * @return True if a complete song is in the flash, else False.
+ *
+ */
+bool Song_Init();
+
+
+/*
+ * Erase a sector of the song
+ *
+ * Stops the song, which is not valid until the next commit. The audio
+ * stops while the sector is erased.
+ *
+ * @input sector	Sector (0 to SONG_FLASH_SECTORS - 1)
+ * @return True if the sector was erased, else False.
+ *
+ */
+bool Song_Erase(uint8_t sector);
+
+
+/*
+ * Write the bytes of the song after the header
+ *
+ * The bytes have to be written in order from SONG_HEADER_SIZE into erased
+ * sectors, they are read back into the CRC of the upload.
+ *
+ * @input offset	Offset of the bytes from the start of the song
+ * 		  data		Pointer to the bytes
+ * 		  length	Number of bytes, a multiple of 4
+ * @return True if the bytes were written, else False.
+ *
+ */
+bool Song_Write(uint32_t offset, const void* data, uint32_t length);
+
+
+/*
+ * Complete the upload with the header
+ *
+ * @input header	Header of the song, its length and CRC have to match
+ * 					the bytes written
+ * @return True if the song is valid, else False.
+ *
+ */
+bool Song_Commit(const song_header_t* header);
+
+
+/*
+ * Start playing the song
+ *
+ * The events are read from the flash as they are played, starting with
+ * the next block.
+ *
+ * @input bar	Bar to start from (0 to bars - 1)
+ * @return True if the song was started, else False.
+ *
+ */
+bool Song_Start(uint16_t bar);
+
+
+/*
+ * Stop the song
+ *
+ * The sounding notes are ended with the next block.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Song_Stop();
+
+
+/*
+ * Returns whether the song is playing
+ *
+ * @input None
+ * @return True until the stop has been played, else False.
+ *
+ */
+bool Song_IsRunning();
+
+
+/*
+ * Get the state of the song
+ *
+ * @input info	Pointer to store the state
+ * @return None
+ *
+ */
+void Song_GetInfo(song_info_t* info);
+
+
+/*
+ * Returns the time of the next event
+ *
+ * Called by the render of every block, which splits the block at the event.
+ *
+ * @input timestamp		Pointer to store the time in samples
+ * @return True if an event is pending, False if the song is stopped.
+ *
+ */
+bool Song_NextStep(uint32_t* timestamp);
+
+
+/*
+ * Play the next event
+ *
+ * @input events	Array of at least one event to fill
+ * @return Number of events
+ *
+ */
+int Song_Step(note_event_t* events);
+
+#endif /* __SONG_H__ */
@@ -0,0 +1,102 @@
+/*
+ * Stream.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Size of the jitter buffer in bytes, has to be a power of 2
+#define STREAM_BUFFER_SIZE (1024)
+
+// Range of the rate of the streamed samples in Hz
+#define STREAM_MIN_RATE (1000)
+#define STREAM_MAX_RATE (16000)
+
+// Time without data after which the stream ends, in ticks
+#define STREAM_TIMEOUT_TICKS (16)
+
+// Statistics of the last or current stream
+typedef struct stream_stats_s
+{
+	bool active;
+	uint16_t sampleRate;
+	uint8_t bits;
+	uint32_t bytesReceived;
+	uint32_t fill; // Bytes in the jitter buffer now
+	uint32_t minFill; // Lowest fill while playing
+	uint32_t maxFill; // Highest fill
+	uint32_t underruns; // Output samples with no data to play
+	uint32_t overruns; // Received bytes dropped on a full buffer
+	uint32_t xoffCount; // Number of times the host was paused
+} stream_stats_t;
+
+
+/*
+ * Initialize the stream
+ *
+ * Borrows the jitter buffer from the audio arena.
+ *
+ * @input None
+ * @return True if the buffer could be allocated, else False.
+ *
+ */
+bool Stream_Init();
+
+
+/*
+ * Start streaming
+ *
+ * Received bytes go to the jitter buffer instead of the console until no
+ * data arrives for STREAM_TIMEOUT_TICKS. Playback starts once the buffer
+ * is half full. The host is paused with XOFF when the buffer is three
+ * quarters full and resumed with XON when it is half full again.
+ *
+ * @input sampleRate	Rate of the streamed samples in Hz
+ * 		  bits			8 for unsigned bytes, 12 for two samples packed in three bytes
+ * @return True if the stream was started, else False.
+ *
+ */
+bool Stream_Start(uint16_t sampleRate, uint8_t bits);
+
+
+/*
+ * Check if a stream is active
+ *
+ * @input None
+ * @return True if the stream is active, else False.
+ *
+ */
+bool Stream_IsActive();
+
+
+/*
+ * Get the statistics of the last or current stream
+ *
+ * @input stats		Pointer to store the statistics
+ * @return None
+ *
+ */
+void Stream_GetStats(stream_stats_t* stats);
+
+
+/*
+ * Render a segment of the current block
+ *
+ * Upsamples the streamed samples to the DAC sampling rate with linear
+ * interpolation and adds them to [offset, offset + count) of the block.
+ *
+ * @input block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+void Stream_Render(int16_t* block, int offset, int count);
+
+#endif /* __STREAM_H__ */
@@ -0,0 +1,212 @@
+/*
+ * Synth.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __SYNTH_H__
+#define __SYNTH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Number of notes which can sound at the same time
+#define SYNTH_MAX_VOICES (4)
+
+// Highest MIDI note velocity
+#define SYNTH_MAX_VELOCITY (127)
+
+// Range of the FM patch, ratio and index in Q8
+#define SYNTH_FM_MAX_RATIO (8 << 8)
+#define SYNTH_FM_MAX_INDEX (16 << 8) // Radians
+
+// Range of the pitch bend, 14 bit MIDI value centered on 0
+#define SYNTH_BEND_MIN (-8192)
+#define SYNTH_BEND_MAX (8191)
+#define SYNTH_BEND_SEMITONES (2) // Deviation at full bend
+
+// Sound of the voices
+typedef enum {
+	SYNTH_WAVE_SINE, // Sine oscillator
+	SYNTH_WAVE_PLUCK, // Karplus-Strong plucked string
+	SYNTH_WAVE_FM, // Two-operator FM, modulator into carrier
+	SYNTH_WAVES
+} synth_wave_t;
+
+
+/*
+ * Select the sound of the voices
+ *
+ * Takes effect when the synthesizer is initialized the next time, as the
+ * plucked strings borrow their delay lines from the audio arena.
+ *
+ * @input wave	One of synth_wave_t
+ * @return None
+ *
+ */
+void Synth_SetWaveform(synth_wave_t wave);
+
+
+/*
+ * Returns the sound of the voices
+ *
+ * @input None
+ * @return One of synth_wave_t
+ *
+ */
+synth_wave_t Synth_GetWaveform();
+
+
+/*
+ * Returns the name of a sound
+ *
+ * @input wave	One of synth_wave_t
+ * @return Name of the sound
+ *
+ */
+const char* Synth_WaveName(synth_wave_t wave);
+
+
+/*
+ * Set the patch of the FM voices
+ *
+ * The modulator runs at ratio times the frequency of the note, and shifts
+ * the phase of the carrier by up to index radians. The envelope amount
+ * sets how much of the index follows the envelope of the note, so the
+ * sound gets brighter with the attack and darker with the release.
+ *
+ * @input ratio				Frequency ratio of the modulator in Q8 (up to SYNTH_FM_MAX_RATIO)
+ * 		  index				Modulation index in Q8 (up to SYNTH_FM_MAX_INDEX)
+ * 		  envelopePercent	Share of the index controlled by the envelope (0 to 100)
+ * @return None
+ *
+ */
+void Synth_SetFmPatch(uint16_t ratio, uint16_t index, uint8_t envelopePercent);
+
+
+/*
+ * Get the patch of the FM voices
+ *
+ * @input ratio				Pointer to store the frequency ratio in Q8
+ * 		  index				Pointer to store the modulation index in Q8
+ * 		  envelopePercent	Pointer to store the share of the index following the envelope
+ * @return None
+ *
+ */
+void Synth_GetFmPatch(uint16_t* ratio, uint16_t* index, uint8_t* envelopePercent);
+
+
+/*
+ * Initialize the synthesizer
+ *
+ * Borrows the state of the voices from the audio arena, and the delay
+ * lines of the plucked strings if they are selected.
+ *
+ * @input count		Number of voices (up to SYNTH_MAX_VOICES)
+ * @return True if the voices could be allocated, else False.
+ *
+ */
+bool Synth_Init(int count);
+
+
+/*
+ * Start playing a note
+ *
+ * Allocates a voice for the note, stealing the oldest one if all the
+ * voices are busy.
+ *
+ * @input note		MIDI note number
+ * 		  velocity	Loudness of the note (0 to SYNTH_MAX_VELOCITY)
+ * @return None
+ *
+ */
+void Synth_NoteOn(uint8_t note, uint8_t velocity);
+
+
+/*
+ * Release a playing note
+ *
+ * @input note		MIDI note number
+ * @return None
+ *
+ */
+void Synth_NoteOff(uint8_t note);
+
+
+/*
+ * Release all the playing notes
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Synth_AllNotesOff();
+
+
+/*
+ * Silence all the voices at once
+ *
+ * Unlike Synth_AllNotesOff(), the voices stop without a release ramp.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Synth_Reset();
+
+
+/*
+ * Bend the pitch of all the voices
+ *
+ * Applies to the sounding voices right away and to the following notes.
+ * The plucked strings keep the pitch of their delay lines.
+ *
+ * @input bend		Bend from SYNTH_BEND_MIN to SYNTH_BEND_MAX, 0 for none,
+ * 					the ends are SYNTH_BEND_SEMITONES down or up
+ * @return None
+ *
+ */
+void Synth_SetPitchBend(int16_t bend);
+
+
+/*
+ * Returns the number of sounding voices
+ *
+ * Released voices count until their envelope has reached silence.
+ *
+ * @input None
+ * @return Number of active voices
+ *
+ */
+int Synth_ActiveVoices();
+
+
+/*
+ * Prepare the voices for a new block
+ *
+ * Called once per block (control rate), after the LFOs have been updated.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Synth_BeginBlock();
+
+
+/*
+ * Render a segment of the current block
+ *
+ * Contains the implementation to compute the mix of all the voices in Q15
+ * for the samples [offset, offset + count) of the block. Vibrato and tremolo
+ * are taken from the LFOs and linearly interpolated across the block.
+ *
+ * @input block		Pointer to the block to be populated
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+void Synth_Render(int16_t* block, int offset, int count);
+
+#endif /* __SYNTH_H__ */
@@ -15,6 +15,12 @@
  */
 typedef uint32_t ticktime_t;
 
+// Number of ticks in one second
+#define TICKS_PER_SECOND (16)
+
+// Core clock cycles in one tick
+#define CYCLES_PER_TICK (48000000L / TICKS_PER_SECOND)
+
 
 /*
  * Initialize systick
@@ -65,4 +71,18 @@ void reset_timer();
  */
 ticktime_t get_timer();
 
+
+/*
+ * Returns the core clock cycles since startup
+ *
+ * Function combines the ticks with the current value of the SysTick counter.
+ * The resolution is 16 cycles and the count wraps around after about
+ * 89 seconds, so only differences should be used.
+ *
+ * @input None
+ * @return uint32_t, cycles since startup
+ *
+ */
+uint32_t get_cycles();
+
 #endif /* __SYSTICK_H__ */
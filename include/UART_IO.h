@@ -9,6 +9,33 @@
 #define __UART_IO_H__
 
 #include <stdint.h>
+#include <stdbool.h>
+
+// Range of the oversampling ratio of UART0, both edges are sampled below 8
+#define UART_MIN_OSR (4)
+#define UART_MAX_OSR (32)
+
+// Largest baud rate error accepted, in parts per million
+#define UART_MAX_BAUD_ERROR (20000)
+
+// Time to confirm a new baud rate before the previous one is restored, in ticks
+#define UART_BAUD_CONFIRM_TICKS (80)
+
+// Function taking the received bytes in place of the console
+typedef void (*uart_receive_handler_t)(uint8_t ch);
+
+// Function called when the console receives a byte sequence
+typedef void (*uart_sequence_handler_t)(void);
+
+// Divider setting of a baud rate
+typedef struct uart_baud_s
+{
+	uint32_t baudRate; // Baud rate asked for
+	uint32_t actual; // Baud rate of the setting, rounded
+	int32_t error; // Error of the setting in parts per million
+	uint16_t sbr; // Baud rate modulo divisor
+	uint8_t osr; // Oversampling ratio
+} uart_baud_t;
 
 
 /*
@@ -47,4 +74,112 @@ int __sys_write(int handle, char* buf, int size);
 void Init_UART0(uint32_t baud_rate);
 
 
+/*
+  * Searches the oversampling ratios and divisors for the setting closest
+  * to a baud rate, with the clock of UART0.
+  *
+  * Parameters:
+  *   baud_rate    Baud rate(bits per second) to search for
+  *   setting      Pointer to store the setting found
+  *
+  * Returns:
+  *   True if the error is within UART_MAX_BAUD_ERROR, else False.
+  */
+bool UART0_FindBaud(uint32_t baud_rate, uart_baud_t* setting);
+
+
+/*
+  * Gets the baud rate setting in use.
+  *
+  * Parameters:
+  *   setting      Pointer to store the setting
+  *
+  * Returns:
+  *   None
+  */
+void UART0_GetBaud(uart_baud_t* setting);
+
+
+/*
+  * Switches UART0 to a new baud rate once the queued text is sent. The
+  * last confirmed rate is restored by UART0_ProcessBaud unless the new one
+  * is confirmed within UART_BAUD_CONFIRM_TICKS.
+  *
+  * Parameters:
+  *   setting      Setting found by UART0_FindBaud
+  *
+  * Returns:
+  *   None
+  */
+void UART0_SwitchBaud(const uart_baud_t* setting);
+
+
+/*
+  * Confirms the baud rate switched to, the other end receives it.
+  *
+  * Parameters:
+  *   None
+  *
+  * Returns:
+  *   True if a switch was waiting for the confirmation, else False.
+  */
+bool UART0_ConfirmBaud();
+
+
+/*
+  * Restores the previous baud rate when a switch was not confirmed in
+  * time. Called by the main loop.
+  *
+  * Parameters:
+  *   None
+  *
+  * Returns:
+  *   True if the previous baud rate was just restored, else False.
+  */
+bool UART0_ProcessBaud();
+
+
+/*
+  * Sends the received bytes to a handler instead of the console.
+  * The bytes are not echoed while a handler is set.
+  *
+  * Parameters:
+  *   handler      Function called by the interrupt for every byte,
+  *                NULL to give the bytes back to the console
+  *
+  * Returns:
+  *   None
+  */
+void UART0_SetReceiveHandler(uart_receive_handler_t handler);
+
+
+/*
+  * Watches the console for a byte sequence. The bytes of the sequence are
+  * neither echoed nor given to the console, a partial sequence is dropped.
+  * The handler is called by the interrupt and may set a receive handler.
+  *
+  * Parameters:
+  *   sequence     Bytes to watch for, they should not be typed in a terminal
+  *   length       Number of bytes in the sequence
+  *   handler      Function called when the sequence was received,
+  *                NULL to stop watching
+  *
+  * Returns:
+  *   None
+  */
+void UART0_SetSequenceHandler(const uint8_t* sequence, uint8_t length, uart_sequence_handler_t handler);
+
+
+/*
+  * Sends a flow control character (XON/XOFF) ahead of the queued text.
+  *
+  * Parameters:
+  *   ch      Character to send
+  *
+  * Returns:
+  *   None
+  */
+void UART0_SendFlowControl(uint8_t ch);
+
+
 #endif /* __UART_IO_H__ */
@@ -20,7 +20,7 @@
 enum QueueType{
 	TXQ,
 	RXQ,
-	TONES
+	NUM_QUEUES
 };
 
  /*
@@ -15,8 +15,6 @@
 
 #include <stdint.h>
 
-#define PERIODS_PER_BUFFER (1)
-
 /*
  * Calculate sine values
  *
@@ -33,16 +31,18 @@ int fp_sin(int x);
 
 
 /*
- * Calculate sine table
+ * Calculate sine values from a phase accumulator
+ *
+ * Contains the implementation to look up the sine of a 32-bit phase, where
+ * the full range of the phase corresponds to one period. Only the quarter wave
+ * in the lookup table is used and values in between the steps are
+ * linearly interpolated.
  *
- * Contains the implementation to populate a buffer with sine values
- * based on the tone frequency.
  *
- * @input table		Pointer to the buffer to be populated
- * 		  toneFreq	Input frequency deciding the samples
- * @return Number of elements written into the buffer.
+ * @input phase		Phase of the oscillator (0 to 2^32 - 1 for one period)
+ * @return		Sine value of the phase in Q15.
  *
  */
-int tone_to_samples(uint16_t* table, int toneFreq);
+int16_t fp_sin_phase(uint32_t phase);
 
 #endif /* FP_TRIG_H_ */
@@ -0,0 +1,18 @@
+/*
+ * test_event_queue.h - Interface to test the functions of the event queue
+ *
+ * Author: Surya Kanteti
+ *
+ */
+
+#ifndef __TEST_EVENT_QUEUE_H__
+#define __TEST_EVENT_QUEUE_H__
+
+ /*
+  * Tests the functionality of the note event queue
+  *
+  * Returns: None, asserts on failure.
+  */
+void test_event_queue();
+
+#endif // __TEST_EVENT_QUEUE_H__
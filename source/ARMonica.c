@@ -45,6 +45,12 @@
 #include "AudioOut.h"
 #include "SysTick.h"
 #include "UART_IO.h"
+#include "HostLink.h"
+#include "PatchStore.h"
+#include "Song.h"
+#include "test_cbfifo.h"
+#include "test_fp_sin.h"
+#include "test_event_queue.h"
 
 #define BAUD_RATE (38400)
 
@@ -65,15 +71,35 @@ int main(void) {
 
     test_cbfifo(); // Test the cbfifo module
     test_sin(); // Test sine values
+    test_event_queue(); // Test the note event queue
 
-    printf("Completed cbfifo and sin function tests\r\n\n");
+    printf("Completed cbfifo, sin function and event queue tests\r\n\n");
 
 #endif
 
     // Initialize all the required modules
     SysTick_Init();
-    AudioOut_Init();
-    AudioOut_Start();
+    if(!AudioOut_Init()) // The DAC and the DMA would play from memory the audio doesn't have
+    {
+    	printf("Audio not available\r\n");
+    }
+    else
+    {
+    	AudioOut_Start();
+    }
+    HostLink_Init(); // A host can take the UART with the magic sequence
+
+    patch_t patch;
+    if(!PatchStore_Init()) // Find the patches saved in the flash
+    {
+    	printf("Patch store not available\r\n");
+    }
+    else if(PatchStore_Load(0, &patch)) // Slot 1 holds the startup sound
+    {
+    	Patch_Apply(&patch);
+    	printf("Loaded slot 1\r\n");
+    }
+    Song_Init(); // Check the song kept in the flash
 
     printf("ARMonica time!\r\n");
     printf("? ");
@@ -92,7 +118,15 @@ int main(void) {
         	handleCommand = false;
         	printf("? ");
         }
-        ComputeSamples(); // Compute samples based on the tone inputted.
+        if(UART0_ProcessBaud()) // The new baud rate was not confirmed in time
+        {
+        	printf("\r\nBaud rate restored\r\n? ");
+        }
+        HostLink_Process(); // Handle the frames of a host
+        if(ComputeSamples()) // Compute samples based on the tone inputted.
+        {
+        	HostLink_ProgramFlash(); // Song data fits before the next block is due
+        }
     }
     return 0 ;
 }
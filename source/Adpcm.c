@@ -0,0 +1,121 @@
+/*
+ * Adpcm.c - IMA-ADPCM decoder
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include "Adpcm.h"
+
+#define MAX_STEP_INDEX (88)
+
+// Step sizes of the IMA-ADPCM standard
+static const int16_t stepTable[MAX_STEP_INDEX + 1] =
+	{	7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+		19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+		50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+		130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+		337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+		876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+		2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+		5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+		15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+	};
+
+// Change of the step index for every code magnitude
+static const int8_t indexTable[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+
+/*
+ * Start decoding a stream
+ *
+ * The stream starts with a predictor of 0 and a step index of 0, every byte
+ * holds two samples, low nibble first.
+ *
+ * @input state		Pointer to the decoder state
+ * 		  data		Pointer to the compressed stream
+ * @return None
+ *
+ */
+void Adpcm_Start(adpcm_state_t* state, const uint8_t* data)
+{
+	state->data = data;
+	state->highNibble = 0;
+	state->index = 0;
+	state->predictor = 0;
+}
+
+
+/*
+ * Decode the next sample
+ *
+ * @input state		Pointer to the decoder state
+ * @return Decoded 16-bit sample
+ *
+ */
+int16_t Adpcm_DecodeSample(adpcm_state_t* state)
+{
+	uint8_t code;
+	int32_t step = stepTable[state->index];
+	int32_t difference;
+	int32_t predictor = state->predictor;
+	int32_t index;
+
+	if(state->highNibble)
+	{
+		code = *state->data >> 4;
+		state->data++;
+	}
+	else
+	{
+		code = *state->data & 0x0F;
+	}
+	state->highNibble ^= 1;
+
+	// difference = (code magnitude + 0.5) * step / 4, without multiplication
+	difference = step >> 3;
+	if(code & 4)
+		difference += step;
+	if(code & 2)
+		difference += step >> 1;
+	if(code & 1)
+		difference += step >> 2;
+
+	if(code & 8)
+		predictor -= difference;
+	else
+		predictor += difference;
+
+	if(predictor > INT16_MAX)
+		predictor = INT16_MAX;
+	else if(predictor < INT16_MIN)
+		predictor = INT16_MIN;
+
+	index = state->index + indexTable[code & 7];
+	if(index < 0)
+		index = 0;
+	else if(index > MAX_STEP_INDEX)
+		index = MAX_STEP_INDEX;
+
+	state->index = index;
+	state->predictor = predictor;
+	return predictor;
+}
+
+
+/*
+ * Decode a block of samples
+ *
+ * @input state		Pointer to the decoder state
+ * 		  out		Pointer to the buffer to be populated
+ * 		  count		Number of samples to decode
+ * @return None
+ *
+ */
+void Adpcm_Decode(adpcm_state_t* state, int16_t* out, int count)
+{
+	for(int i = 0; i < count; i++)
+	{
+		out[i] = Adpcm_DecodeSample(state);
+	}
+}
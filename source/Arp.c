@@ -0,0 +1,265 @@
+/*
+ * Arp.c - Arpeggiator of a held chord on a sample-accurate clock
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+
+#include "Arp.h"
+#include "AudioOut.h"
+#include "Noise.h"
+
+// Semitones in an octave
+#define NOTES_PER_OCTAVE (12)
+
+// Highest MIDI note the octaves may reach
+#define ARP_MAX_KEY (127)
+
+// Seed of the random order
+#define ARP_NOISE_SEED (0x5EED1234)
+
+static const char* orderNames[ARP_ORDERS] = {
+		"up", "down", "updown", "random"
+};
+
+static uint8_t chord[ARP_MAX_NOTES]; // Sorted from low to high
+static uint8_t chordVelocities[ARP_MAX_NOTES];
+static int chordSize = 0;
+static int sequenceLength = 0; // Notes over all the octaves
+static arp_order_t arpOrder = ARP_UP;
+static int position = 0; // Index of the next note in the order
+static noise_t arpNoise;
+
+static bool running = false;
+static bool stopping = false; // Set until the sounding note is ended
+static uint8_t sounding = 0; // Note sounding, 0 if none
+
+// The length of a step is stepSamples and stepRemainder / stepDivisor samples
+static uint32_t stepTime; // Time of the next note on
+static uint32_t offTime; // Time of the note off of the sounding note
+static uint32_t stepSamples;
+static uint32_t stepRemainder;
+static uint32_t stepDivisor;
+static uint32_t stepError;
+
+
+/*
+ * Start arpeggiating a chord
+ *
+ * The notes are sorted from low to high and repeated an octave higher for
+ * every octave. Every note sounds for half of its step. Replaces the chord
+ * if the arpeggiator is running already.
+ *
+ * @input notes			Pointer to the MIDI notes of the chord
+ * 		  velocities	Pointer to the velocity of every note
+ * 		  count			Number of notes (1 to ARP_MAX_NOTES)
+ * 		  order			Order of the notes
+ * 		  octaves		Number of octaves (1 to ARP_MAX_OCTAVES)
+ * 		  division		Notes per whole note, e.g. 16 for sixteenth notes
+ * 		  tempo			Beats per minute
+ * 		  start			Time of the first note in samples
+ * @return True if the arpeggiator was started, else False.
+ *
+ */
+bool Arp_Start(const uint8_t* notes, const uint8_t* velocities, int count, arp_order_t order,
+		int octaves, uint8_t division, uint16_t tempo, uint32_t start)
+{
+	uint32_t samplesPerFourMinutes = AudioOut_GetSampleRate() * 240;
+	int i, j;
+	uint8_t note, velocity;
+
+	if(count < 1 || count > ARP_MAX_NOTES || order >= ARP_ORDERS || octaves < 1 ||
+			octaves > ARP_MAX_OCTAVES || division == 0 || tempo == 0)
+		return false;
+
+	// Insertion sort, the chord is a handful of notes
+	for(i = 0; i < count; i++)
+	{
+		note = notes[i];
+		velocity = velocities[i];
+		for(j = i; j > 0 && chord[j - 1] > note; j--)
+		{
+			chord[j] = chord[j - 1];
+			chordVelocities[j] = chordVelocities[j - 1];
+		}
+		chord[j] = note;
+		chordVelocities[j] = velocity;
+	}
+
+	// Octaves above the highest MIDI note are left out
+	while(octaves > 1 && chord[count - 1] + (octaves - 1) * NOTES_PER_OCTAVE > ARP_MAX_KEY)
+		octaves--;
+
+	chordSize = count;
+	sequenceLength = count * octaves;
+	arpOrder = order;
+	position = 0;
+	Noise_Init(&arpNoise, ARP_NOISE_SEED);
+
+	// A whole note is four beats, a step takes 240 / (tempo * division) seconds
+	stepDivisor = (uint32_t)tempo * division;
+	stepSamples = samplesPerFourMinutes / stepDivisor;
+	stepRemainder = samplesPerFourMinutes % stepDivisor;
+	stepError = 0;
+	stepTime = start;
+
+	stopping = false;
+	running = true;
+	return true;
+}
+
+
+/*
+ * Stop the arpeggiator
+ *
+ * The sounding note is ended with the next block.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Arp_Stop()
+{
+	if(running)
+		stopping = true;
+}
+
+
+/*
+ * Returns whether the arpeggiator is running
+ *
+ * @input None
+ * @return True until the stop has been played, else False.
+ *
+ */
+bool Arp_IsRunning()
+{
+	return running;
+}
+
+
+/*
+ * Returns the name of an order
+ *
+ * @input order		Order
+ * @return Name of the order
+ *
+ */
+const char* Arp_OrderName(arp_order_t order)
+{
+	if(order >= ARP_ORDERS)
+		return "?";
+	return orderNames[order];
+}
+
+
+/*
+ * Returns the time of the next note on or note off
+ *
+ * Called by the render of every block, which splits the block at the note.
+ *
+ * @input timestamp		Pointer to store the time in samples
+ * @return True if a note is pending, False if the arpeggiator is stopped.
+ *
+ */
+bool Arp_NextStep(uint32_t* timestamp)
+{
+	if(!running)
+		return false;
+
+	if(stopping)
+		*timestamp = AudioOut_GetSampleTime();
+	else
+		*timestamp = (sounding != 0) ? offTime : stepTime;
+	return true;
+}
+
+
+/*
+ * Returns the index of the next note over the octaves
+ *
+ * @input None
+ * @return Index, the octave times the size of the chord plus the note
+ *
+ */
+static int NextIndex()
+{
+	int index;
+
+	switch(arpOrder)
+	{
+	case ARP_DOWN:
+		index = sequenceLength - 1 - position;
+		break;
+	case ARP_UPDOWN:
+		// Up the whole way, then down to the second note
+		index = (position < sequenceLength) ? position : 2 * (sequenceLength - 1) - position;
+		break;
+	case ARP_RANDOM:
+		return (Noise_White(&arpNoise) & INT16_MAX) % sequenceLength;
+	default:
+		index = position;
+		break;
+	}
+
+	position++;
+	if(position >= ((arpOrder == ARP_UPDOWN && sequenceLength > 1) ? 2 * (sequenceLength - 1) : sequenceLength))
+		position = 0;
+	return index;
+}
+
+
+/*
+ * Play the next note on or note off
+ *
+ * @input events	Array of at least one event to fill
+ * @return Number of events
+ *
+ */
+int Arp_Step(note_event_t* events)
+{
+	int index;
+	uint32_t length;
+
+	if(!running)
+		return 0;
+
+	if(sounding != 0)
+	{
+		events[0].timestamp = stopping ? AudioOut_GetSampleTime() : offTime;
+		events[0].type = EVENT_NOTE_OFF;
+		events[0].key = sounding;
+		events[0].value = 0;
+		sounding = 0;
+		return 1;
+	}
+
+	if(stopping)
+	{
+		stopping = false;
+		running = false;
+		return 0;
+	}
+
+	index = NextIndex();
+	events[0].timestamp = stepTime;
+	events[0].type = EVENT_NOTE_ON;
+	events[0].key = chord[index % chordSize] + (index / chordSize) * NOTES_PER_OCTAVE;
+	events[0].value = chordVelocities[index % chordSize];
+	sounding = events[0].key;
+
+	// The note sounds for half of the step
+	length = stepSamples;
+	stepError += stepRemainder;
+	if(stepError >= stepDivisor)
+	{
+		stepError -= stepDivisor;
+		length++;
+	}
+	offTime = stepTime + length / 2;
+	stepTime += length;
+
+	return 1;
+}
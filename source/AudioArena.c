@@ -0,0 +1,110 @@
+/*
+ * AudioArena.c - Statically partitioned RAM shared by the audio subsystems
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <string.h>
+
+#include "AudioArena.h"
+
+// The arena is placed at the start of SRAM by the .audio_arena section
+// of the linker script, so aligned allocations (the DMA ring) need no padding.
+static uint32_t arena[AUDIO_ARENA_SIZE / sizeof(uint32_t)]
+	__attribute__((section(".audio_arena"), aligned(4096)));
+
+static size_t arenaTop = 0; // Offset of the first free byte
+static size_t ownerBytes[ARENA_OWNERS]; // Bytes borrowed by each subsystem
+
+static const char* ownerNames[ARENA_OWNERS] = {
+		"dma", "mix", "voices", "echo", "stream"
+};
+
+
+/*
+ * Release all the allocations
+ *
+ * Called before the audio subsystems are configured. Nothing borrowed from
+ * the arena may be used afterwards.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Arena_Reset()
+{
+	arenaTop = 0;
+	memset(ownerBytes, 0, sizeof(ownerBytes));
+}
+
+
+/*
+ * Borrow memory from the arena
+ *
+ * Memory is only borrowed at configuration time and is never freed on
+ * its own. The returned memory is cleared.
+ *
+ * @input owner		Subsystem borrowing the memory
+ * 		  size		Number of bytes
+ * 		  alignment	Required alignment in bytes, a power of two
+ * @return Pointer to the memory, NULL if the arena is exhausted.
+ *
+ */
+void* Arena_Alloc(arena_owner_t owner, size_t size, size_t alignment)
+{
+	if(alignment < sizeof(uint32_t))
+		alignment = sizeof(uint32_t);
+
+	size_t start = (arenaTop + alignment - 1) & ~(alignment - 1);
+
+	if(owner >= ARENA_OWNERS || start + size > AUDIO_ARENA_SIZE)
+		return NULL;
+
+	uint8_t* memory = (uint8_t*)arena + start;
+	memset(memory, 0, size);
+
+	ownerBytes[owner] += (start - arenaTop) + size; // Padding counts for the owner
+	arenaTop = start + size;
+
+	return memory;
+}
+
+
+/*
+ * Returns the number of bytes borrowed by a subsystem
+ *
+ * @input owner		Subsystem
+ * @return Number of bytes
+ *
+ */
+size_t Arena_Used(arena_owner_t owner)
+{
+	return ownerBytes[owner];
+}
+
+
+/*
+ * Returns the number of bytes left in the arena
+ *
+ * @input None
+ * @return Number of bytes
+ *
+ */
+size_t Arena_Free()
+{
+	return AUDIO_ARENA_SIZE - arenaTop;
+}
+
+
+/*
+ * Returns the name of a subsystem for reports
+ *
+ * @input owner		Subsystem
+ * @return Name of the subsystem
+ *
+ */
+const char* Arena_OwnerName(arena_owner_t owner)
+{
+	return ownerNames[owner];
+}
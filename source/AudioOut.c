@@ -10,43 +10,86 @@
 #include <stdbool.h>
 
 #include "SysTick.h"
-#include "cbfifo.h"
-#include "fp_trig.h"
+#include "AudioOut.h"
+#include "EventQueue.h"
+#include "Synth.h"
+#include "Lfo.h"
+#include "Echo.h"
+#include "Sampler.h"
+#include "Drums.h"
+#include "Sequencer.h"
+#include "Arp.h"
+#include "Song.h"
+#include "Stream.h"
+#include "Midi.h"
+#include "OutputStage.h"
+#include "AudioArena.h"
+#include "RamCode.h"
 
 // Frequency of clock used
 #define CLOCK_FREQUENCY (48000000)
 
-// Sampling rate of DAC
-#define DAC_SAMPLING_RATE (48000)
-
 // Pin of DAC output
 #define DAC_POS (30)
 
-// Number of ticks in one second
-#define TICKS_PER_SECOND (16)
-
-// Frequencies of the supported tones
-uint16_t toneFrequencies[] = {440, 494, 523, 587, 659, 698, 784};
-
-// Common variables (play)
-#define ALTERNATING_BUFFERS (2)
-#define MAX_BUFFER_SIZE (150)
+// Tempo until a tempo event is received
+#define DEFAULT_TEMPO (120)
+
+// Ring of blocks played circularly by the DMA (source address modulo).
+// The ring has to be aligned to its size, it is borrowed first from the
+// audio arena, which starts on a 4 KB boundary.
+#define AUDIO_RING_BLOCKS (2)
+#define AUDIO_RING_SHIFT (AUDIO_BLOCK_SHIFT + 2) // Two blocks of 16 bit samples
+#define AUDIO_RING_BYTES (1 << AUDIO_RING_SHIFT)
+#define DMA_SMOD_SHIFT (3) // SMOD 1 is a 16 byte ring
+
+static uint16_t (*samplesRing)[AUDIO_BLOCK_SIZE]; // Blocks played by the DMA
+static int16_t* mixBuffer; // Block of signed samples before conversion for the DAC
+
+static volatile int playingBlock = 0; // Index of the block being played by the DMA
+static volatile bool blockRequested = false; // Set when the block not being played needs new samples
+static volatile uint32_t sampleTime = 0; // Timestamp of the first sample of the next block to render
+static uint32_t playCursor = 0; // Timestamp after the last tones queued by the commands
+static uint16_t tempo = DEFAULT_TEMPO; // Beats per minute
+static uint32_t sampleRate = DAC_SAMPLING_RATE; // Current sampling rate in Hz
+
+// Idle mode, entered after IDLE_AFTER_BLOCKS silent blocks with nothing queued
+#define IDLE_AFTER_BLOCKS (2)
+#define SILENCE_THRESHOLD (16) // One DAC step in Q15
+static volatile bool idle = false; // Set when TPM0 and the DMA are stopped
+static int silentBlocks = 0; // Number of consecutive silent blocks
+
+// Sources of the events applied while a block is rendered
+typedef enum {
+	SOURCE_NONE,
+	SOURCE_QUEUE, // Event queue filled by the commands
+	SOURCE_SEQUENCER,
+	SOURCE_ARP,
+	SOURCE_SONG
+} event_source_t;
+
+// Statistics of the audio engine
+static volatile uint32_t dmaInterruptCount = 0;
+static uint32_t renderCycles = 0;
+static uint32_t blocksRendered = 0;
 
-int currentBuffer = 0; // Index to keep track of samplesBuffers
-uint8_t toneDuration = 0;
-uint16_t samplesBuffers[ALTERNATING_BUFFERS][MAX_BUFFER_SIZE]; // Buffers to alternate between
-const static uint16_t emptyBuff[] = {0};
-
-// Echo parameters
-#define ECHO_BUFFER_SIZE (6000)
-#define ECHO_BUFFER_PARTITION (3500)
-#define GAIN (0.6)
 bool echoEnabled = false; // Flag to check if echo mode is enabled
-uint16_t echoBuffer[ECHO_BUFFER_SIZE]; // Buffer containing echo samples
 
-// Variables to store play-back source and count
-static uint16_t * Reload_DMA_Source = emptyBuff;
-static uint32_t Reload_DMA_Byte_Count = 2;
+
+/*
+ * Set the overflow rate of TPM0
+ *
+ * The counter overflows every MOD + 1 clocks, MOD is rounded to the
+ * nearest rate. TPM0 has to be stopped.
+ *
+ * @input rate	Overflows per second
+ * @return None
+ *
+ */
+static void TPM0_SetRate(uint32_t rate)
+{
+	TPM0->MOD = TPM_MOD_MOD(((CLOCK_FREQUENCY + rate / 2) / rate) - 1);
+}
 
 
 /*
@@ -55,11 +98,11 @@ static uint32_t Reload_DMA_Byte_Count = 2;
  * Contains the implementation to initialize the timer-PWM 0 module
  * by setting the clock and configuration settings.
  *
- * @input None
+ * @input rate	Sampling rate in Hz, one DMA request per overflow
  * @return None
  *
  */
-void TPM0_Init(uint32_t period_us)
+void TPM0_Init(uint32_t rate)
 {
 	//turn on clock to TPM
 	SIM->SCGC6 |= SIM_SCGC6_TPM0_MASK;
@@ -70,19 +113,12 @@ void TPM0_Init(uint32_t period_us)
 	// disable TPM
 	TPM0->SC = 0;
 
-	//load the counter and mod
-	TPM0->MOD = TPM_MOD_MOD(CLOCK_FREQUENCY / period_us);
+	//load the mod for the sampling rate
+	TPM0_SetRate(rate);
 
 	//set TPM to count up and divide by 1 prescaler and clock mode
+	//the overflow only triggers the DMA, no interrupt is needed per sample
 	TPM0->SC = (TPM_SC_DMA_MASK | TPM_SC_PS(0));
-
-	// Enable TPM interrupts for debugging
-	TPM0->SC |= TPM_SC_TOIE_MASK;
-
-	// Configure NVIC
-	NVIC_SetPriority(TPM0_IRQn, 128); // 0, 64, 128 or 192
-	NVIC_ClearPendingIRQ(TPM0_IRQn);
-	NVIC_EnableIRQ(TPM0_IRQn);
 }
 
 
@@ -103,19 +139,19 @@ void TPM0_Start(void)
 
 
 /*
- * ISR for TPM0
+ * Stop TPM0
  *
- * Interrupt service routine is called for TPM0 overflow.
+ * Stops the timer module TPM0, so no more DMA requests are generated.
  *
  * @input None
  * @return None
  *
  */
-void TPM0_IRQHandler()
+void TPM0_Stop(void)
 {
-	//clear pending IRQ
-	NVIC_ClearPendingIRQ(TPM0_IRQn);
-	TPM0->SC |= TPM_SC_TOIE_MASK; // reset overflow flag
+	// Disable counter and restart the count
+	TPM0->SC &= ~TPM_SC_CMOD_MASK;
+	TPM0->CNT = 0;
 }
 
 
@@ -140,9 +176,11 @@ void DMA_Init()
 
 	// Generate DMA interrupt when done
 	// Increment source, transfer words (16 bits)
+	// Wrap the source address around the ring of blocks
 	// Enable peripheral request
 	DMA0->DMA[0].DCR = DMA_DCR_EINT_MASK | DMA_DCR_SINC_MASK |
 											DMA_DCR_SSIZE(2) | DMA_DCR_DSIZE(2) |
+											DMA_DCR_SMOD(AUDIO_RING_SHIFT - DMA_SMOD_SHIFT) |
 											DMA_DCR_ERQ_MASK | DMA_DCR_CS_MASK;
 
 	// Configure NVIC for DMA ISR
@@ -158,7 +196,8 @@ void DMA_Init()
 /*
  * Start DMA placback.
  *
- * Contains the implementation to start the DMA playback.
+ * Contains the implementation to start the DMA playback from the
+ * current block of the ring.
  *
  * @input None
  * @return None
@@ -167,10 +206,10 @@ void DMA_Init()
 void DMA_StartPlayback()
 {
 	// initialize source and destination pointers
-	DMA0->DMA[0].SAR = DMA_SAR_SAR((uint32_t) Reload_DMA_Source);
+	DMA0->DMA[0].SAR = DMA_SAR_SAR((uint32_t) samplesRing[playingBlock]);
 	DMA0->DMA[0].DAR = DMA_DAR_DAR((uint32_t) (&(DAC0->DAT[0])));
 	// byte count
-	DMA0->DMA[0].DSR_BCR = DMA_DSR_BCR_BCR(Reload_DMA_Byte_Count);
+	DMA0->DMA[0].DSR_BCR = DMA_DSR_BCR_BCR(AUDIO_BLOCK_SIZE * sizeof(uint16_t));
 	// clear done flag
 	DMA0->DMA[0].DSR_BCR &= ~DMA_DSR_BCR_DONE_MASK;
 	// set enable flag
@@ -181,19 +220,25 @@ void DMA_StartPlayback()
 /*
  * ISR for DMA0
  *
- * Interrupt service routine is called after DMA completion.
+ * Interrupt service routine is called after every block. The source
+ * address wraps around the ring by itself, so only the byte count
+ * has to be reloaded. Runs from SRAM.
  *
  * @input None
  * @return None
  *
  */
-void DMA0_IRQHandler(void)
+RAM_FUNCTION void DMA0_IRQHandler(void)
 {
-	// Clear done flag
+	dmaInterruptCount++;
+
+	// Clear done flag and continue with the next block
 	DMA0->DMA[0].DSR_BCR |= DMA_DSR_BCR_DONE_MASK;
+	DMA0->DMA[0].DSR_BCR = DMA_DSR_BCR_BCR(AUDIO_BLOCK_SIZE * sizeof(uint16_t));
 
-	// Start the next DMA playback cycle
-	DMA_StartPlayback();
+	// Request new samples for the finished block
+	playingBlock = (playingBlock + 1) & (AUDIO_RING_BLOCKS - 1);
+	blockRequested = true;
 }
 
 
@@ -220,26 +265,95 @@ void DAC_Init()
 	DAC0->C1 = 0;
 	DAC0->C2 = 0;
 
+	// Rest at mid-rail so the first samples don't cause a thump
+	DAC0->DAT[0].DATL = DAC_MIDPOINT & 0xFF;
+	DAC0->DAT[0].DATH = DAC_MIDPOINT >> 8;
+
 	// Enable DAC, select VDDA as reference voltage
 	DAC0->C0 = DAC_C0_DACEN_MASK | DAC_C0_DACRFS_MASK;
 }
 
 
+/*
+ * Partition the audio arena
+ *
+ * Contains the implementation to lend the audio arena to the DMA ring,
+ * the mix block, the voices, the sample players, the drums, the stream
+ * buffer and the echo delay line. The ring is borrowed first, so it lands on the
+ * aligned start of the arena.
+ *
+ * @input None
+ * @return True if all the subsystems got their memory, else False.
+ *
+ */
+static bool ConfigureArena()
+{
+	uint32_t echoSamples;
+
+	Arena_Reset();
+
+	samplesRing = Arena_Alloc(ARENA_DMA, AUDIO_RING_BYTES, AUDIO_RING_BYTES);
+	mixBuffer = Arena_Alloc(ARENA_MIX, AUDIO_BLOCK_SIZE * sizeof(int16_t), sizeof(int16_t));
+	if(samplesRing == NULL || mixBuffer == NULL)
+	{
+		printf("Not enough memory for the audio blocks!\r\n");
+		return false;
+	}
+
+	if(!Synth_Init(SYNTH_MAX_VOICES))
+	{
+		printf("Not enough memory for the voices!\r\n");
+		return false;
+	}
+
+	if(!Sampler_Init())
+	{
+		printf("Not enough memory for the sampler!\r\n");
+		return false;
+	}
+
+	if(!Drums_Init())
+	{
+		printf("Not enough memory for the drums!\r\n");
+		return false;
+	}
+
+	Lfo_Init();
+
+	if(!Stream_Init())
+		printf("Not enough memory for the stream buffer, streaming is disabled!\r\n");
+
+	// The echo is borrowed last and shortened to the memory left
+	echoSamples = (ECHO_DELAY_MS * sampleRate) / 1000;
+	if(echoSamples > Arena_Free())
+		echoSamples = Arena_Free();
+	if(!Echo_Init(echoSamples))
+		printf("Not enough memory for the echo, it is disabled!\r\n");
+
+	return true;
+}
+
+
 /*
  * Initialize Audio Out module
  *
  * Contains the implementation to initialize the Audio Out module
- * by setting the clock and configuration settings.
+ * by partitioning the audio arena and setting the clock and
+ * configuration settings. The output must not be started if the audio
+ * blocks didn't get their memory.
  *
  * @input None
- * @return None
+ * @return True if the audio subsystems got their memory, else False.
  *
  */
-void AudioOut_Init()
+bool AudioOut_Init()
 {
-	TPM0_Init(DAC_SAMPLING_RATE); // Initialize TPM0 to trigger DAC0
+	bool configured = ConfigureArena();
+
+	TPM0_Init(sampleRate); // Initialize TPM0 to trigger DAC0
 	DAC_Init();
 	DMA_Init();
+	return configured;
 }
 
 
@@ -252,72 +366,532 @@ void AudioOut_Init()
  */
 void AudioOut_Start()
 {
+	// Start with silence in the whole ring, it is not cleared at startup
+	for(int i = 0; i < AUDIO_RING_BLOCKS; i++)
+	{
+		for(int j = 0; j < AUDIO_BLOCK_SIZE; j++)
+		{
+			samplesRing[i][j] = DAC_MIDPOINT;
+		}
+	}
+
 	TPM0_Start(); // Start the individual modules
 	DMA_StartPlayback();
 }
 
 
 /*
- * Compute samples based on tone frequencies and echo mode.
+ * Dispatch an event to the audio engine
  *
- * Contains the implementation to compute the samples based on the tone
- * frequency as well as the echo mode flag.
+ * @input event		Pointer to the event
+ * @return None
  *
- * @input None
+ */
+static void DispatchEvent(const note_event_t* event)
+{
+	switch(event->type)
+	{
+	case EVENT_NOTE_ON:
+		Synth_NoteOn(event->key, event->value);
+		break;
+	case EVENT_NOTE_OFF:
+		Synth_NoteOff(event->key);
+		break;
+	case EVENT_REST:
+		Synth_AllNotesOff();
+		break;
+	case EVENT_TEMPO:
+		AudioOut_SetTempo(event->value);
+		break;
+	case EVENT_SAMPLE:
+		Sampler_Trigger(event->key, event->value);
+		break;
+	case EVENT_DRUM:
+		Drums_Trigger(event->key, event->value);
+		break;
+	case EVENT_PARAMETER:
+		AudioOut_SetParameter(event->key, event->value);
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*
+ * Render a segment of the current block
+ *
+ * @input offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
  * @return None
  *
  */
-void ComputeSamples()
+static void RenderSegment(int offset, int count)
+{
+	Synth_Render(mixBuffer, offset, count);
+	Sampler_Render(mixBuffer, offset, count);
+	Drums_Render(mixBuffer, offset, count);
+	Stream_Render(mixBuffer, offset, count);
+}
+
+
+/*
+ * Render the next block
+ *
+ * Contains the implementation to render a block of samples based on the
+ * queued events, the steps of the sequencer and the arpeggiator, the song and echo
+ * mode, and to convert it for the DAC. Events and steps are applied at the exact sample given
+ * by their timestamp, late ones and MIDI input are applied at the start of the block.
+ *
+ * @input out	Pointer to the DAC buffer to be populated
+ * @return True if the block is silent, else False.
+ *
+ */
+static bool RenderBlock(uint16_t* out)
 {
-	uint8_t tone;
+	note_event_t event;
+	note_event_t stepEvents[SEQ_MAX_EVENTS];
+	uint32_t stepTime;
+	int32_t offset;
+	int position = 0;
 	int count;
+	event_source_t source;
+	bool silent = true;
 
-	if(echoEnabled)
+	// Control rate processing
+	Lfo_Update();
+	Synth_BeginBlock();
+
+	// Live MIDI input is applied at the start of the block
+	while(Midi_Dequeue(&event))
 	{
-		for(int i = 0; i < ECHO_BUFFER_SIZE; i++)
-		{
-			echoBuffer[i] *= 0.97;
-		}
+		DispatchEvent(&event);
 	}
 
-	if(get_timer() > TICKS_PER_SECOND * toneDuration)
+	// Render up to the next event or step in the block, whichever comes first, then apply it
+	while(true)
 	{
-		reset_timer();
+		offset = AUDIO_BLOCK_SIZE;
+		source = SOURCE_NONE;
 
-		if(cbfifo_dequeue(TONES, &tone, 1) == 1)
+		if(EventQueue_Peek(&event))
 		{
-			cbfifo_dequeue(TONES, &toneDuration, 1);
-			count = tone_to_samples(samplesBuffers[currentBuffer], toneFrequencies[tone]);
-
-			if(echoEnabled)
-			{
-				// Initialize the echo buffer
-				for(int i = 0; i < ECHO_BUFFER_PARTITION; i++)
-				{
-					echoBuffer[i] = samplesBuffers[currentBuffer][i % count];
-				}
-				for(int i = ECHO_BUFFER_PARTITION; i < ECHO_BUFFER_SIZE; i++)
-				{
-					echoBuffer[i] = samplesBuffers[currentBuffer][i % count] + samplesBuffers[currentBuffer][(i - ECHO_BUFFER_PARTITION) % count] * GAIN;
-				}
-				Reload_DMA_Source = echoBuffer;
-				Reload_DMA_Byte_Count = 2 * ECHO_BUFFER_SIZE;
-			}
-			else
-			{
-				Reload_DMA_Source = samplesBuffers[currentBuffer];
-				Reload_DMA_Byte_Count = count * 2;
-			}
-
-			currentBuffer = 1 - currentBuffer; // Switch between the buffers
+			offset = (int32_t)(event.timestamp - sampleTime);
+			source = SOURCE_QUEUE;
 		}
-		else
+		if(Sequencer_NextStep(&stepTime) && (int32_t)(stepTime - sampleTime) < offset)
+		{
+			offset = (int32_t)(stepTime - sampleTime);
+			source = SOURCE_SEQUENCER;
+		}
+		if(Arp_NextStep(&stepTime) && (int32_t)(stepTime - sampleTime) < offset)
+		{
+			offset = (int32_t)(stepTime - sampleTime);
+			source = SOURCE_ARP;
+		}
+		if(Song_NextStep(&stepTime) && (int32_t)(stepTime - sampleTime) < offset)
+		{
+			offset = (int32_t)(stepTime - sampleTime);
+			source = SOURCE_SONG;
+		}
+
+		if(offset >= AUDIO_BLOCK_SIZE)
+			break;
+		if(offset < position)
+			offset = position;
+
+		RenderSegment(position, offset - position);
+		position = offset;
+
+		switch(source)
 		{
-			Reload_DMA_Source = emptyBuff;
-			Reload_DMA_Byte_Count = 2;
-			toneDuration = 0;
+		case SOURCE_SEQUENCER:
+			count = Sequencer_Step(stepEvents);
+			break;
+		case SOURCE_ARP:
+			count = Arp_Step(stepEvents);
+			break;
+		case SOURCE_SONG:
+			count = Song_Step(stepEvents);
+			break;
+		default:
+			EventQueue_Dequeue(&stepEvents[0]);
+			count = 1;
+			break;
 		}
 
+		for(int i = 0; i < count; i++)
+		{
+			DispatchEvent(&stepEvents[i]);
+		}
+	}
+	RenderSegment(position, AUDIO_BLOCK_SIZE - position);
+	sampleTime += AUDIO_BLOCK_SIZE;
+
+	if(echoEnabled)
+		Echo_Process(mixBuffer, AUDIO_BLOCK_SIZE);
+
+	for(int i = 0; i < AUDIO_BLOCK_SIZE; i++)
+	{
+		if(mixBuffer[i] > SILENCE_THRESHOLD || mixBuffer[i] < -SILENCE_THRESHOLD)
+			silent = false;
+	}
+
+	// Convert to the unsigned range of the DAC
+	OutputStage_Process(mixBuffer, out, AUDIO_BLOCK_SIZE);
+
+	blocksRendered++;
+	return silent;
+}
+
+
+/*
+ * Enter the idle mode
+ *
+ * Stops TPM0 and the DMA, so no interrupts are taken while there is
+ * nothing to play. The DAC holds the mid-rail value of the last silent block.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void StopPlayback()
+{
+	uint32_t maskingState;
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+
+	TPM0_Stop();
+	DMAMUX0->CHCFG[0] &= ~DMAMUX_CHCFG_ENBL_MASK;
+	DMA0->DMA[0].DSR_BCR |= DMA_DSR_BCR_DONE_MASK; // Abort the remaining transfer
+	NVIC_ClearPendingIRQ(DMA0_IRQn);
+	blockRequested = false;
+	idle = true;
+
+	__set_PRIMASK(maskingState);
+}
+
+
+/*
+ * Leave the idle mode
+ *
+ * Renders the first block before restarting TPM0 and the DMA, and requests
+ * the second one right away, so the output resumes without a gap.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void ResumePlayback()
+{
+	playingBlock = 0;
+	RenderBlock(samplesRing[0]);
+	silentBlocks = 0;
+	idle = false;
+	blockRequested = true;
+
+	DMA_StartPlayback();
+	TPM0_Start();
+}
+
+
+/*
+ * Compute samples based on the queued events and echo mode.
+ *
+ * Contains the implementation to render the next block once the DMA has
+ * finished playing one. Playback is stopped after a few silent blocks
+ * with nothing queued and resumed by the next queued or MIDI event, stream
+ * or sequencer, arpeggiator or song start.
+ *
+ * @input None
+ * @return True if a block was just rendered or the output is idle, so the
+ * 		   next DMA interrupt is most of a block away, else False.
+ *
+ */
+bool ComputeSamples()
+{
+	uint32_t start;
+	bool silent;
+
+	if(idle)
+	{
+		if(EventQueue_Length() > 0 || Midi_Pending() > 0 || Stream_IsActive() ||
+				Sequencer_IsRunning() || Arp_IsRunning() || Song_IsRunning())
+		{
+			// The second block is requested already
+			ResumePlayback();
+			return false;
+		}
+		return true;
+	}
+
+	if(!blockRequested)
+		return false;
+
+	blockRequested = false;
+
+	start = get_cycles();
+	silent = RenderBlock(samplesRing[(playingBlock - 1) & (AUDIO_RING_BLOCKS - 1)]);
+	renderCycles += get_cycles() - start;
+
+	// The block being played is silent as well once enough blocks are
+	if(silent && EventQueue_Length() == 0 && Midi_Pending() == 0 && Synth_ActiveVoices() == 0 && Sampler_ActivePlayers() == 0 &&
+			Drums_ActiveVoices() == 0 && !Stream_IsActive() &&
+			!Sequencer_IsRunning() && !Arp_IsRunning() && !Song_IsRunning())
+	{
+		silentBlocks++;
+		if(silentBlocks >= IDLE_AFTER_BLOCKS)
+			StopPlayback();
+	}
+	else
+	{
+		silentBlocks = 0;
+	}
+	return true;
+}
+
+
+/*
+ * Get the statistics of the audio engine
+ *
+ * @input stats		Pointer to store the statistics
+ * 		  reset		Restart the counts from zero after reading them
+ * @return None
+ *
+ */
+void AudioOut_GetStats(audio_stats_t* stats, bool reset)
+{
+	stats->dmaInterrupts = dmaInterruptCount;
+	stats->renderCycles = renderCycles;
+	stats->blocksRendered = blocksRendered;
+	stats->idle = idle;
+
+	if(reset)
+	{
+		dmaInterruptCount = 0;
+		renderCycles = 0;
+		blocksRendered = 0;
+	}
+}
+
+
+/*
+ * Change the sampling rate of the DAC
+ *
+ * Stops the playback, retimes TPM0 and configures the audio subsystems
+ * again for the new rate. Playing notes and queued events are dropped.
+ *
+ * @input rate	Sampling rate in Hz (DAC_MIN_SAMPLING_RATE to DAC_SAMPLING_RATE)
+ * @return True if the rate was changed, else False.
+ *
+ */
+bool AudioOut_SetSampleRate(uint32_t rate)
+{
+	if(rate < DAC_MIN_SAMPLING_RATE || rate > DAC_SAMPLING_RATE || Stream_IsActive())
+		return false;
+
+	if(!idle)
+		StopPlayback();
+
+	sampleRate = rate;
+	TPM0_SetRate(rate);
+
+	// Oscillators, envelopes and delay lines are sized for the new rate
+	return AudioOut_Reconfigure();
+}
+
+
+/*
+ * Configure the audio subsystems again
+ *
+ * Partitions the audio arena again after a setting which changes the
+ * memory of a subsystem, such as the waveform of the voices. Stops the
+ * playback, the sequencer, the arpeggiator and the song, playing notes and queued events are dropped.
+ *
+ * @input None
+ * @return True if the subsystems got their memory, else False.
+ *
+ */
+bool AudioOut_Reconfigure()
+{
+	if(Stream_IsActive())
+		return false;
+
+	if(!idle)
+		StopPlayback();
+	EventQueue_Clear();
+	playCursor = sampleTime; // Nothing is queued after now any more
+	Sequencer_Stop(); // The steps are timed for the old rate
+	Arp_Stop();
+	Song_Stop();
+
+	return ConfigureArena();
+}
+
+
+/*
+ * Select the sound of the voices
+ *
+ * Gaining or losing the delay lines of the plucked strings configures the
+ * audio subsystems again like AudioOut_Reconfigure() does, the other
+ * sounds switch in place and the playing notes keep sounding. The old
+ * sound is put back if the new one can't get its memory.
+ *
+ * @input wave	One of synth_wave_t
+ * @return True if the sound was changed, False while streaming or if the
+ * 		   voices didn't get their memory.
+ *
+ */
+bool AudioOut_SetWaveform(synth_wave_t wave)
+{
+	synth_wave_t old = Synth_GetWaveform();
+
+	if(wave >= SYNTH_WAVES || Stream_IsActive())
+		return false;
+
+	// Only the plucked strings borrow delay lines, the sine and FM voices
+	// switch in place and keep sounding
+	Synth_SetWaveform(wave);
+	if(wave != SYNTH_WAVE_PLUCK && old != SYNTH_WAVE_PLUCK)
+		return true;
+	if(AudioOut_Reconfigure() && Synth_GetWaveform() == wave)
+		return true;
+
+	// Without the memory for the new sound, the voices keep the old one
+	Synth_SetWaveform(old);
+	AudioOut_Reconfigure();
+	return false;
+}
+
+
+/*
+ * Returns the current sampling rate of the DAC
+ *
+ * @input None
+ * @return Sampling rate in Hz
+ *
+ */
+uint32_t AudioOut_GetSampleRate()
+{
+	return sampleRate;
+}
+
+
+/*
+ * Returns the timestamp of the next block to render
+ *
+ * Events with this timestamp are played as soon as possible.
+ *
+ * @input None
+ * @return Time in samples
+ *
+ */
+uint32_t AudioOut_GetSampleTime()
+{
+	return sampleTime;
+}
+
+
+/*
+ * Returns the timestamp at which the next queued tones start
+ *
+ * Tones continue after the ones already queued, or start right away. The
+ * cursor goes back to the current time when the queued events are dropped.
+ *
+ * @input None
+ * @return Time in samples
+ *
+ */
+uint32_t AudioOut_GetPlayCursor()
+{
+	if((int32_t)(playCursor - sampleTime) < 0)
+		playCursor = sampleTime;
+	return playCursor;
+}
+
+
+/*
+ * Move the play cursor after the tones just queued
+ *
+ * @input time	Timestamp after the last queued event in samples
+ * @return None
+ *
+ */
+void AudioOut_SetPlayCursor(uint32_t time)
+{
+	playCursor = time;
+}
+
+
+/*
+ * Returns the tempo set by the last tempo event
+ *
+ * @input None
+ * @return Tempo in beats per minute
+ *
+ */
+uint16_t AudioOut_GetTempo()
+{
+	return tempo;
+}
+
+
+/*
+ * Set the tempo of the engine
+ *
+ * The arpeggiator follows it when started without a tempo, and a running
+ * sequencer changes to it.
+ *
+ * @input bpm	Beats per minute, 0 is ignored
+ * @return None
+ *
+ */
+void AudioOut_SetTempo(uint16_t bpm)
+{
+	if(bpm == 0)
+		return;
+
+	tempo = bpm;
+	Sequencer_SetTempo(bpm);
+}
+
+
+/*
+ * Set a parameter of the audio engine
+ *
+ * Used for parameter change events. The LFO parameters hold the rate
+ * in the upper byte and the depth in the lower byte, the pitch bend
+ * holds the 14 bit value of the MIDI message.
+ *
+ * @input parameter		Parameter id
+ * 		  value			New value
+ * @return None
+ *
+ */
+void AudioOut_SetParameter(uint8_t parameter, uint16_t value)
+{
+	switch(parameter)
+	{
+	case AUDIO_PARAM_ECHO:
+		SetEchoMode(value != 0);
+		break;
+	case AUDIO_PARAM_VIBRATO:
+		Lfo_Configure(LFO_VIBRATO, value >> 8, value & 0xFF);
+		break;
+	case AUDIO_PARAM_TREMOLO:
+		Lfo_Configure(LFO_TREMOLO, value >> 8, value & 0xFF);
+		break;
+	case AUDIO_PARAM_PITCH_BEND:
+		Synth_SetPitchBend((int16_t)value + SYNTH_BEND_MIN);
+		break;
+	case AUDIO_PARAM_SEQUENCER:
+		if(value != 0)
+			Sequencer_Start(tempo, Sequencer_GetSwing());
+		else
+			Sequencer_Stop();
+		break;
+	default:
+		break;
 	}
 }
 
@@ -333,5 +907,22 @@ void ComputeSamples()
  */
 void SetEchoMode(bool flag)
 {
+	// Start from an empty delay line
+	if(flag && !echoEnabled)
+		Echo_Clear();
+
 	echoEnabled = flag;
 }
+
+
+/*
+ * Interface to get the echo mode flag
+ *
+ * @input None
+ * @return True if the echo is enabled, else False.
+ *
+ */
+bool GetEchoMode()
+{
+	return echoEnabled;
+}
@@ -0,0 +1,614 @@
+/*
+ * Benchmark.c - Cycle counts of the audio code on the target
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Benchmark.h"
+#include "SysTick.h"
+#include "AudioOut.h"
+#include "Adpcm.h"
+#include "Sampler.h"
+#include "Synth.h"
+#include "Echo.h"
+#include "Drums.h"
+#include "Noise.h"
+#include "Patch.h"
+#include "PatchStore.h"
+#include "OutputStage.h"
+#include "Pitch.h"
+#include "RamCode.h"
+#include "cbfifo.h"
+#include "MKL25Z4.h"
+
+// Core clock cycles in one second
+#define CYCLES_PER_SECOND (CYCLES_PER_TICK * TICKS_PER_SECOND)
+
+// Share of the core clock the audio rendering may take
+#define LOAD_BUDGET_PERCENT (75)
+
+// Blocks rendered for every measurement
+#define BENCH_BLOCKS (16)
+
+// Calls of an interrupt handler for every measurement
+#define BENCH_HANDLER_CALLS (64)
+
+// Notes measured by the pitch benchmark, C6 to B6, and the longest lag
+// of the detector, twice the period of C6 at 48 kHz and more
+#define BENCH_PITCH_FIRST_NOTE (84)
+#define BENCH_PITCH_NOTES (12)
+#define BENCH_PITCH_LAG (128)
+#define BENCH_PITCH_ATTACK_BLOCKS (4)
+
+// Sampling rates selectable with the rate command
+static const uint32_t benchRates[] = {8000, 16000, 22050, 32000, 48000};
+
+// Waves before and after the patches applied by the patch benchmark
+static const synth_wave_t patchSwitches[][2] = {
+		{SYNTH_WAVE_SINE, SYNTH_WAVE_SINE}, {SYNTH_WAVE_SINE, SYNTH_WAVE_FM},
+		{SYNTH_WAVE_FM, SYNTH_WAVE_PLUCK}, {SYNTH_WAVE_PLUCK, SYNTH_WAVE_SINE}
+};
+
+typedef void (*benchmark_t)(void);
+typedef void (*render_t)(int16_t* block, int offset, int count);
+typedef void (*output_t)(const int16_t* in, uint16_t* out, int count);
+typedef void (*handler_t)(void);
+
+// Interrupt handlers, declared by the startup code
+void DMA0_IRQHandler(void);
+void UART0_IRQHandler(void);
+
+// Structure defining entries of the benchmark table
+typedef struct benchmark_table_s
+{
+	const char* name;
+	benchmark_t run;
+	const char* description;
+} benchmark_table_t;
+
+static void Bench_Adpcm();
+static void Bench_Rates();
+static void Bench_Voice();
+static void Bench_Drums();
+static void Bench_Patch();
+static void Bench_Ram();
+static void Bench_Pitch();
+
+// Benchmark table containing all the benchmarks
+static const benchmark_table_t benchmarks[] = {
+		{"adpcm", &Bench_Adpcm, "IMA-ADPCM decoding of the sample bank"},
+		{"rates", &Bench_Rates, "Rendering load and polyphony at every sampling rate"},
+		{"voice", &Bench_Voice, "Cycles per voice of the selected wave"},
+		{"drums", &Bench_Drums, "Cycles per drum and of the noise generators"},
+		{"patch", &Bench_Patch, "Cycles to load and apply a saved patch"},
+		{"ram", &Bench_Ram, "Render loop and interrupt handlers run from SRAM and from the flash"},
+		{"pitch", &Bench_Pitch, "Tuning of the selected wave, measured from its rendered notes"},
+};
+
+static const int num_benchmarks = sizeof(benchmarks) / sizeof(benchmark_table_t);
+
+
+/*
+ * Print a count of cycles per sample with two decimals
+ *
+ * @input label		Description of the count
+ * 		  cycles	Total cycles
+ * 		  samples	Number of samples the cycles were spent on
+ * @return None
+ *
+ */
+static void PrintPerSample(const char* label, uint32_t cycles, uint32_t samples)
+{
+	uint32_t hundredths;
+
+	if(samples == 0)
+		samples = 1;
+	hundredths = (uint32_t)(((uint64_t)cycles * 100) / samples);
+	printf("%s: %lu.%02lu cycles per sample\r\n", label,
+			(unsigned long)(hundredths / 100), (unsigned long)(hundredths % 100));
+}
+
+
+/*
+ * Decode every sample of the bank a block at a time
+ *
+ * Prints the cycles per decoded sample, and per output sample once the
+ * sample rate is converted to the DAC sampling rate.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void Bench_Adpcm()
+{
+	int16_t block[AUDIO_BLOCK_SIZE];
+	adpcm_state_t state;
+	uint32_t start, cycles, remaining, count;
+
+	for(int i = 0; i < sampleBankSize; i++)
+	{
+		Adpcm_Start(&state, sampleBank[i].data);
+		remaining = sampleBank[i].numSamples;
+
+		start = get_cycles();
+		while(remaining > 0)
+		{
+			count = remaining < AUDIO_BLOCK_SIZE ? remaining : AUDIO_BLOCK_SIZE;
+			Adpcm_Decode(&state, block, count);
+			remaining -= count;
+		}
+		cycles = get_cycles() - start;
+
+		printf("\r\n%s (%lu samples at %u Hz)\r\n", sampleBank[i].name,
+				(unsigned long)sampleBank[i].numSamples, sampleBank[i].sampleRate);
+		PrintPerSample("Decoded", cycles, sampleBank[i].numSamples);
+		PrintPerSample("Output at DAC rate", cycles,
+				(uint32_t)(((uint64_t)sampleBank[i].numSamples * AudioOut_GetSampleRate()) / sampleBank[i].sampleRate));
+	}
+}
+
+
+/*
+ * Measure the cycles to render a block with the given number of voices
+ *
+ * @input voices	Number of notes sounding
+ * 		  echo		Flag to run the echo over the block as well
+ * @return Cycles per block
+ *
+ */
+static uint32_t RenderCycles(int voices, bool echo)
+{
+	int16_t block[AUDIO_BLOCK_SIZE];
+	uint32_t start, cycles;
+
+	Synth_Reset();
+	for(int i = 0; i < voices; i++)
+	{
+		Synth_NoteOn(60 + 4 * i, SYNTH_MAX_VELOCITY);
+	}
+
+	start = get_cycles();
+	for(int i = 0; i < BENCH_BLOCKS; i++)
+	{
+		Synth_BeginBlock();
+		Synth_Render(block, 0, AUDIO_BLOCK_SIZE);
+		if(echo)
+			Echo_Process(block, AUDIO_BLOCK_SIZE);
+	}
+	cycles = get_cycles() - start;
+
+	Synth_Reset();
+	return cycles / BENCH_BLOCKS;
+}
+
+
+/*
+ * Print the rendering load at every sampling rate
+ *
+ * The cycles per block don't depend on the rate, the number of blocks per
+ * second does. The table shows the load with one voice and with all the
+ * voices, and how many voices fit in LOAD_BUDGET_PERCENT of the core.
+ * The synthesizer is silenced.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void Bench_Rates()
+{
+	uint32_t base = RenderCycles(0, false);
+	uint32_t one = RenderCycles(1, false);
+	uint32_t all = RenderCycles(SYNTH_MAX_VOICES, false);
+	uint32_t echo = RenderCycles(0, true) - base;
+	uint32_t perVoice = (all - base) / SYNTH_MAX_VOICES;
+	uint32_t blocksPerSecond, budget, loadOne, loadAll, fit;
+
+	if(perVoice == 0)
+		perVoice = 1;
+
+	printf("\r\nCycles per block: %lu base, %lu per voice, %lu echo\r\n",
+			(unsigned long)base, (unsigned long)perVoice, (unsigned long)echo);
+	printf("Rate    Load 1 voice  Load %d voices  Voices in %d%%\r\n", SYNTH_MAX_VOICES, LOAD_BUDGET_PERCENT);
+
+	for(int i = 0; i < sizeof(benchRates) / sizeof(benchRates[0]); i++)
+	{
+		blocksPerSecond = benchRates[i] / AUDIO_BLOCK_SIZE;
+		budget = (CYCLES_PER_SECOND / 100) * LOAD_BUDGET_PERCENT / blocksPerSecond;
+
+		// Load in tenths of a percent
+		loadOne = (uint32_t)(((uint64_t)(one + echo) * blocksPerSecond * 1000) / CYCLES_PER_SECOND);
+		loadAll = (uint32_t)(((uint64_t)(all + echo) * blocksPerSecond * 1000) / CYCLES_PER_SECOND);
+		fit = (budget > base + echo) ? (budget - base - echo) / perVoice : 0;
+
+		printf("%-7lu %5lu.%lu%%        %5lu.%lu%%          %lu\r\n", (unsigned long)benchRates[i],
+				(unsigned long)(loadOne / 10), (unsigned long)(loadOne % 10),
+				(unsigned long)(loadAll / 10), (unsigned long)(loadAll % 10), (unsigned long)fit);
+	}
+}
+
+
+/*
+ * Print the cycles taken by a voice of the selected wave
+ *
+ * Select the wave to measure with the wave command first. Prints the
+ * cycles per voice per output sample, and how many voices would fit in
+ * LOAD_BUDGET_PERCENT of the core at the current rate. The synthesizer
+ * is silenced.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void Bench_Voice()
+{
+	uint32_t base = RenderCycles(0, false);
+	uint32_t all = RenderCycles(SYNTH_MAX_VOICES, false);
+	uint32_t perVoice = (all - base) / SYNTH_MAX_VOICES;
+	uint32_t blocksPerSecond = AudioOut_GetSampleRate() / AUDIO_BLOCK_SIZE;
+	uint32_t budget = (CYCLES_PER_SECOND / 100) * LOAD_BUDGET_PERCENT / blocksPerSecond;
+
+	if(perVoice == 0)
+		perVoice = 1;
+
+	printf("\r\nWave %s at %lu Hz\r\n", Synth_WaveName(Synth_GetWaveform()),
+			(unsigned long)AudioOut_GetSampleRate());
+	PrintPerSample("Per voice", perVoice, AUDIO_BLOCK_SIZE);
+	printf("Voices in %d%% of the core: %lu\r\n", LOAD_BUDGET_PERCENT,
+			(unsigned long)(budget > base ? (budget - base) / perVoice : 0));
+}
+
+
+/*
+ * Print the cycles taken by every drum and noise generator
+ *
+ * Every drum is measured over the first block after its stroke, when all
+ * of its parts are sounding. The drums are silenced.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void Bench_Drums()
+{
+	int16_t block[AUDIO_BLOCK_SIZE];
+	uint32_t start, cycles;
+	volatile int16_t sink;
+	noise_t noise;
+
+	printf("\r\n");
+	for(int i = 0; i < DRUMS; i++)
+	{
+		memset(block, 0, sizeof(block));
+		Drums_Trigger(i, 127);
+
+		start = get_cycles();
+		Drums_Render(block, 0, AUDIO_BLOCK_SIZE);
+		cycles = get_cycles() - start;
+
+		Drums_Trigger(i, 0);
+		PrintPerSample(Drums_Name(i), cycles, AUDIO_BLOCK_SIZE);
+	}
+
+	Noise_Init(&noise, 0);
+	start = get_cycles();
+	for(int i = 0; i < BENCH_BLOCKS * AUDIO_BLOCK_SIZE; i++)
+	{
+		sink = Noise_White(&noise);
+	}
+	PrintPerSample("White noise", get_cycles() - start, BENCH_BLOCKS * AUDIO_BLOCK_SIZE);
+
+	start = get_cycles();
+	for(int i = 0; i < BENCH_BLOCKS * AUDIO_BLOCK_SIZE; i++)
+	{
+		sink = Noise_Pink(&noise);
+	}
+	PrintPerSample("Pink noise", get_cycles() - start, BENCH_BLOCKS * AUDIO_BLOCK_SIZE);
+	(void)sink;
+}
+
+
+/*
+ * Measure the cycles to apply a patch which switches the wave
+ *
+ * @input patch		Patch to apply, its wave is changed
+ * 		  from		Wave selected before
+ * 		  to		Wave of the patch applied
+ * @return Cycles of Patch_Apply()
+ *
+ */
+static uint32_t ApplyCycles(patch_t* patch, synth_wave_t from, synth_wave_t to)
+{
+	uint32_t start;
+
+	patch->wave = from;
+	Patch_Apply(patch);
+
+	patch->wave = to;
+	start = get_cycles();
+	Patch_Apply(patch);
+	return get_cycles() - start;
+}
+
+
+/*
+ * Print the cycles taken to load a patch between two notes
+ *
+ * The patch of the first saved slot is read from the flash and applied
+ * with the wave kept, switched in place between sine and FM, and switched
+ * to and from pluck, which partitions the audio arena again. All are
+ * compared with the period of an audio block, then the current sound is
+ * applied again.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void Bench_Patch()
+{
+	patch_store_stats_t stats;
+	patch_t patch, current;
+	uint32_t start, load;
+	uint32_t blockCycles = (uint32_t)(((uint64_t)CYCLES_PER_SECOND * AUDIO_BLOCK_SIZE) / AudioOut_GetSampleRate());
+	int slot = 0;
+
+	PatchStore_GetStats(&stats);
+	while(slot < PATCH_SLOTS && !(stats.used & (1 << slot)))
+		slot++;
+
+	if(slot == PATCH_SLOTS)
+	{
+		printf("\r\nNo saved patch, enter save <slot> first\r\n");
+		return;
+	}
+
+	start = get_cycles();
+	PatchStore_Load(slot, &patch);
+	load = get_cycles() - start;
+
+	printf("\r\nLoad slot %d: %lu cycles\r\n", slot + 1, (unsigned long)load);
+	Patch_Capture(&current);
+	for(int i = 0; i < sizeof(patchSwitches) / sizeof(patchSwitches[0]); i++)
+	{
+		printf("Apply, %-5s to %-5s: %lu cycles\r\n", Synth_WaveName(patchSwitches[i][0]),
+				Synth_WaveName(patchSwitches[i][1]),
+				(unsigned long)ApplyCycles(&patch, patchSwitches[i][0], patchSwitches[i][1]));
+	}
+	printf("Audio block: %lu cycles\r\n", (unsigned long)blockCycles);
+
+	// The playing sound comes back
+	Patch_Apply(&current);
+}
+
+
+/*
+ * Measure the cycles to render and convert a block with all the voices
+ *
+ * @input render	Synth_Render() or its copy in the flash
+ * 		  output	OutputStage_Process() or its copy in the flash
+ * @return Cycles per block
+ *
+ */
+static uint32_t RenderLoopCycles(render_t render, output_t output)
+{
+	int16_t block[AUDIO_BLOCK_SIZE];
+	uint32_t start, cycles;
+
+	Synth_Reset();
+	for(int i = 0; i < SYNTH_MAX_VOICES; i++)
+	{
+		Synth_NoteOn(60 + 4 * i, SYNTH_MAX_VELOCITY);
+	}
+
+	start = get_cycles();
+	for(int i = 0; i < BENCH_BLOCKS; i++)
+	{
+		Synth_BeginBlock();
+		render(block, 0, AUDIO_BLOCK_SIZE);
+		// Converted in place, every sample is read before it is written
+		output(block, (uint16_t*)block, AUDIO_BLOCK_SIZE);
+	}
+	cycles = get_cycles() - start;
+
+	Synth_Reset();
+	return cycles / BENCH_BLOCKS;
+}
+
+
+/*
+ * Measure the cycles of an interrupt handler called with the interrupts masked
+ *
+ * @input handler	Interrupt handler or its copy in the flash
+ * @return Cycles of BENCH_HANDLER_CALLS calls
+ *
+ */
+static uint32_t HandlerCycles(handler_t handler)
+{
+	uint32_t maskingState, start, cycles;
+
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+
+	start = get_cycles();
+	for(int i = 0; i < BENCH_HANDLER_CALLS; i++)
+	{
+		handler();
+	}
+	cycles = get_cycles() - start;
+
+	__set_PRIMASK(maskingState);
+	return cycles;
+}
+
+
+/*
+ * Print a count of cycles from SRAM and from the flash
+ *
+ * @input label		Description of the count
+ * 		  ram		Cycles of the code run from SRAM
+ * 		  flash		Cycles of the same code run from the flash
+ * 		  count		Number of runs the cycles were spent on
+ * @return None
+ *
+ */
+static void PrintRamFlash(const char* label, uint32_t ram, uint32_t flash, uint32_t count)
+{
+	int32_t saved = (flash > 0) ? (int32_t)(((int64_t)flash - ram) * 100 / flash) : 0;
+
+	printf("%-16s %8lu %8lu %5ld%%\r\n", label, (unsigned long)(ram / count),
+			(unsigned long)(flash / count), (long)saved);
+}
+
+
+/*
+ * Print the cycles of the hot code run from SRAM and from the flash
+ *
+ * The functions linked into SRAM (RAM_FUNCTION) are run from their copies
+ * in the flash as well. The render loop renders all the voices of the
+ * selected wave and converts the block for the DAC. The interrupt handlers
+ * are called with nothing to receive or send, which measures their entry
+ * and the checks of the flags. The DMA0 handler is only called while the
+ * audio is idle, its calls are added to the DMA interrupt count. The
+ * synthesizer is silenced.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void Bench_Ram()
+{
+	audio_stats_t stats;
+	render_t render = (render_t)RamCode_FlashCopy((void*)&Synth_Render);
+	output_t output = (output_t)RamCode_FlashCopy((void*)&OutputStage_Process);
+
+	printf("\r\nCode and tables in SRAM: %lu bytes at 0x%08lx, loaded from 0x%08lx\r\n",
+			(unsigned long)RamCode_Size(), (unsigned long)__start_ramcode, (unsigned long)__load_ramcode);
+	printf("Wave %s, %d voices\r\n", Synth_WaveName(Synth_GetWaveform()), SYNTH_MAX_VOICES);
+	printf("Cycles               SRAM    Flash  Saved\r\n");
+
+	PrintRamFlash("Render block", RenderLoopCycles(&Synth_Render, &OutputStage_Process),
+			RenderLoopCycles(render, output), 1);
+
+	// Nothing left to send, so the handler only checks the flags
+	while(cbfifo_length(TXQ) > 0)
+		;
+	PrintRamFlash("UART0 handler", HandlerCycles(&UART0_IRQHandler),
+			HandlerCycles((handler_t)RamCode_FlashCopy((void*)&UART0_IRQHandler)), BENCH_HANDLER_CALLS);
+
+	AudioOut_GetStats(&stats, false);
+	if(stats.idle)
+		PrintRamFlash("DMA0 handler", HandlerCycles(&DMA0_IRQHandler),
+				HandlerCycles((handler_t)RamCode_FlashCopy((void*)&DMA0_IRQHandler)), BENCH_HANDLER_CALLS);
+	else
+		printf("DMA0 handler: run again once the audio is idle\r\n");
+}
+
+
+/*
+ * Print the pitch of the notes of an octave rendered by the selected wave
+ *
+ * Every note is rendered on its own after its attack, its period is found
+ * by Pitch_Period() and compared with the equal tempered pitch. Prints the
+ * frequency, the deviation in cents and the cycles taken by the detector.
+ * The synthesizer is silenced.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void Bench_Pitch()
+{
+	static int16_t samples[2 * BENCH_PITCH_LAG];
+	static uint16_t scratch[BENCH_PITCH_LAG + 1];
+	int16_t block[AUDIO_BLOCK_SIZE];
+	uint32_t rate = AudioOut_GetSampleRate();
+	uint32_t start, cycles, period, frequency;
+	int32_t cents;
+	uint8_t note;
+
+	printf("\r\nWave %s at %lu Hz\r\n", Synth_WaveName(Synth_GetWaveform()), (unsigned long)rate);
+	printf("Note  Hz        Cents   Cycles\r\n");
+
+	for(int i = 0; i < BENCH_PITCH_NOTES; i++)
+	{
+		note = BENCH_PITCH_FIRST_NOTE + i;
+		Synth_Reset();
+		Synth_NoteOn(note, SYNTH_MAX_VELOCITY);
+		for(int j = 0; j < BENCH_PITCH_ATTACK_BLOCKS; j++)
+		{
+			memset(block, 0, sizeof(block));
+			Synth_BeginBlock();
+			Synth_Render(block, 0, AUDIO_BLOCK_SIZE);
+		}
+		for(int j = 0; j < 2 * BENCH_PITCH_LAG; j += AUDIO_BLOCK_SIZE)
+		{
+			memset(samples + j, 0, AUDIO_BLOCK_SIZE * sizeof(int16_t));
+			Synth_BeginBlock();
+			Synth_Render(samples + j, 0, AUDIO_BLOCK_SIZE);
+		}
+		Synth_Reset();
+
+		start = get_cycles();
+		period = Pitch_Period(samples, BENCH_PITCH_LAG, BENCH_PITCH_LAG, scratch);
+		cycles = get_cycles() - start;
+
+		if(period == 0)
+		{
+			printf("%-5d no pitch          %lu\r\n", note, (unsigned long)cycles);
+			continue;
+		}
+
+		// Frequency in Q8 and cents in Q8, printed with two decimals
+		frequency = (Pitch_Frequency(period, rate) * 100) >> 8;
+		cents = (Pitch_Cents(period, rate, note) * 100) / 256;
+		printf("%-5d %4lu.%02lu   %c%lu.%02lu   %lu\r\n", note,
+				(unsigned long)(frequency / 100), (unsigned long)(frequency % 100),
+				(cents < 0) ? '-' : '+', (unsigned long)(((cents < 0) ? -cents : cents) / 100),
+				(unsigned long)(((cents < 0) ? -cents : cents) % 100), (unsigned long)cycles);
+	}
+}
+
+
+/*
+ * Print the names of the benchmarks
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Benchmark_List()
+{
+	for(int i = 0; i < num_benchmarks; i++)
+	{
+		printf("%-8s %s\r\n", benchmarks[i].name, benchmarks[i].description);
+	}
+}
+
+
+/*
+ * Run a benchmark and print its results
+ *
+ * The cycles are counted with get_cycles(), so they include the time
+ * taken by interrupts. Run the benchmarks while the audio is idle.
+ *
+ * @input name	Name of the benchmark
+ * @return True if the benchmark exists, else False.
+ *
+ */
+bool Benchmark_Run(const char* name)
+{
+	for(int i = 0; i < num_benchmarks; i++)
+	{
+		if(strcasecmp(name, benchmarks[i].name) == 0)
+		{
+			benchmarks[i].run();
+			return true;
+		}
+	}
+	return false;
+}
@@ -11,14 +11,64 @@
 #include <stdint.h>
 #include <ctype.h>
 #include <stdlib.h>
-#include "cbfifo.h"
+#include "AudioOut.h"
+#include "EventQueue.h"
+#include "Lfo.h"
+#include "Synth.h"
+#include "SysTick.h"
+#include "AudioArena.h"
+#include "Sampler.h"
+#include "Benchmark.h"
+#include "Stream.h"
+#include "OutputStage.h"
+#include "Drums.h"
+#include "Sequencer.h"
+#include "Arp.h"
+#include "Midi.h"
+#include "HostLink.h"
+#include "UART_IO.h"
+#include "Patch.h"
+#include "PatchStore.h"
+#include "Song.h"
 
 // Macro for enter key
 #define ENTER_KEY (13)
 
 // Argument parameters
 #define MAX_NUM_OF_ARGUMENTS 15
-#define MAX_LENGTH_OF_ARGUMENTS 10
+#define MAX_LENGTH_OF_ARGUMENTS 17 // Fits a 16 step drum pattern
+
+// Range of duration of a tone in seconds
+#define MIN_TONE_DURATION 1
+#define MAX_TONE_DURATION 60
+
+// Marks for rests and ties in the play command
+#define REST_MARK 'R'
+#define TIE_MARK '~'
+#define REST (-1)
+
+// Drum and sequencer patterns, one step is a sixteenth note
+#define MIN_TEMPO 40
+#define MAX_TEMPO 300
+#define REST_STEP_MARK '.'
+#define TIE_STEP_MARK '-'
+#define ACCENT_VELOCITY 127 // Uppercase letters
+#define SOFT_VELOCITY 80 // Lowercase letters
+
+// Sampling rates selectable with the rate command
+typedef struct sample_rate_s{
+
+  const char *name; // Rate in kHz
+  uint32_t rate;
+
+} sample_rate_t;
+
+static const sample_rate_t sampleRates[] = {
+		{"8", 8000}, {"16", 16000}, {"22.05", 22050}, {"32", 32000}, {"48", 48000}
+};
+
+// MIDI notes of the supported tones A to G
+static const uint8_t toneNotes[] = {69, 71, 72, 74, 76, 77, 79};
 
 typedef void (*command_handler_t)(int, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
 
@@ -34,6 +84,25 @@ typedef struct command_table_s{
 void Handler_Author(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
 void Handler_Play(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
 void Handler_Echo(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Lfo(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Stats(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Mem(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Sample(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Drums(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Seq(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Arp(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Bench(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Stream(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Midi(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Link(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Baud(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Rate(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Dither(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Wave(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Fm(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Save(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Load(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
+void Handler_Song(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
 void Handler_Help(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS]);
 
 
@@ -43,9 +112,77 @@ static const command_table_t commands[] = {
 		{"author", &Handler_Author, "\n\r\tPrint the author's name"},
 		{"play"  , &Handler_Play  , "\n\r\tPlay the inputed tones based on the duration" \
 									"\n\r\tEnter the tone followed by the duration in seconds"
-									"\n\r\tSupported tones are from A to G" \
-									"\n\r\tRange of duration (1 to 60 seconds)"},
+									"\n\r\tSupported tones are from A to G, R is a rest" \
+									"\n\r\tRange of duration (1 to 60 seconds)" \
+									"\n\r\tEnd a tone with ~ to tie it to the next one (e.g. A2~ A1)"},
 		{"echo"  , &Handler_Echo  , "\n\r\tSet the echo mode on or off"},
+		{"lfo"   , &Handler_Lfo   , "\n\r\tModulate the tones with a low frequency oscillator" \
+									"\n\r\tlfo vibrato <rate> <depth>: rate in Hz (1 to 20), depth in cents (0 to 100)" \
+									"\n\r\tlfo tremolo <rate> <depth>: rate in Hz (1 to 20), depth in percent (0 to 100)" \
+									"\n\r\tlfo off: Disable both oscillators"},
+		{"stats" , &Handler_Stats , "\n\r\tPrint the DMA interrupt rate and the rendering load" \
+									"\n\r\tsince the last time stats was entered"},
+		{"mem"   , &Handler_Mem   , "\n\r\tPrint the audio memory borrowed by every subsystem"},
+		{"sample", &Handler_Sample, "\n\r\tPlay a recorded sample by its id or name" \
+									"\n\r\tEnter sample alone to list the samples"},
+		{"drums" , &Handler_Drums , "\n\r\tPlay a drum pattern after the queued tones" \
+									"\n\r\tdrums <tempo> <steps> [steps...]: tempo in BPM (40 to 300)," \
+									"\n\r\tup to 16 sixteenth note steps, K kick, S snare, H hat, . rest" \
+									"\n\r\tLowercase letters are played softer, the steps are layered" \
+									"\n\r\te.g. drums 120 K...K...K...K... ....S.......S... hhhhhhhhhhhhhhhh"},
+		{"seq"   , &Handler_Seq   , "\n\r\tLoop up to 4 patterns of up to 32 sixteenth note steps" \
+									"\n\r\tseq set <pattern> <steps> [steps...]: A to G tones, K S H drums," \
+									"\n\r\t. rest, - holds the tone, lowercase letters are softer" \
+									"\n\r\tseq vel <pattern> <digits> [digits...]: velocity of every step (1 to 9, . keeps it)" \
+									"\n\r\tseq clear <pattern>: Empty the pattern" \
+									"\n\r\tseq start <tempo> [swing]: tempo in BPM (40 to 300), swing in percent (50 to 75)" \
+									"\n\r\tseq stop: Stop the patterns, enter seq alone to print them"},
+		{"arp"   , &Handler_Arp   , "\n\r\tArpeggiate a chord of the tones A to G, lowercase tones are softer" \
+									"\n\r\tarp <tones> [order] [rate] [octaves] [tempo]: order up, down, updown or random," \
+									"\n\r\trate 1/1 to 1/32 (add t for triplets), 1 to 4 octaves, tempo in BPM" \
+									"\n\r\tFollows the tempo of the sequencer or the drums if no tempo is given" \
+									"\n\r\te.g. arp ACE up 1/16 2, arp stop"},
+		{"stream", &Handler_Stream, "\n\r\tPlay raw PCM samples sent over the UART (tools/stream_wav.py)" \
+									"\n\r\tstream <rate> [8|12]: rate in Hz (1000 to 16000), 8 or 12 bit samples" \
+									"\n\r\tThe host is paused with XOFF and resumed with XON" \
+									"\n\r\tThe stream ends after a second without data" \
+									"\n\r\tEnter stream alone to print the buffer statistics"},
+		{"midi"  , &Handler_Midi  , "\n\r\tPlay MIDI sent over the UART, the clock sets the tempo of the sequencer" \
+									"\n\r\tmidi <channel|omni>: channel 1 to 16, channel 10 plays the drums" \
+									"\n\r\tA reset message or ESC gives the console back" \
+									"\n\r\tEnter midi alone to print the statistics"},
+		{"link"  , &Handler_Link  , "\n\r\tPrint the statistics of the binary host link" \
+									"\n\r\tA host takes the UART with the bytes A5 5A C3 3C (tools/armonica_link.py)"},
+		{"baud"  , &Handler_Baud  , "\n\r\tSet the baud rate of the console, the closest setting of the UART is used" \
+									"\n\r\tbaud <rate>: e.g. baud 115200, then set the terminal to the new rate" \
+									"\n\r\tbaud ok: Keep the new rate, else the last one is restored after 5 seconds" \
+									"\n\r\tEnter baud alone to print the rate and its error"},
+		{"rate"  , &Handler_Rate  , "\n\r\tSet the sampling rate of the DAC in kHz (8, 16, 22.05, 32 or 48)" \
+									"\n\r\tStops the playing tones, enter rate alone to print the rate" \
+									"\n\r\tbench rates compares the load at every rate"},
+		{"wave"  , &Handler_Wave  , "\n\r\tSelect the sound of the tones" \
+									"\n\r\twave sine: Sine oscillator" \
+									"\n\r\twave pluck: Plucked string (the echo gets shorter)" \
+									"\n\r\twave fm: Two-operator FM, see the fm command" \
+									"\n\r\tStops the playing tones, enter wave alone to print the sound"},
+		{"fm"    , &Handler_Fm    , "\n\r\tSet the patch of the FM wave" \
+									"\n\r\tfm <ratio> <index> [envelope]: ratio of the modulator (up to 8)," \
+									"\n\r\tindex in radians (up to 16), percent of the index following the envelope" \
+									"\n\r\te.g. fm 3.5 2.5 50"},
+		{"save"  , &Handler_Save  , "\n\r\tSave the sound into a slot of the flash (1 to 8)" \
+									"\n\r\tKeeps the wave, echo, dither, fm patch, lfo settings and tempo" \
+									"\n\r\tSlot 1 is loaded at startup, enter save alone to print the store"},
+		{"load"  , &Handler_Load  , "\n\r\tLoad the sound saved into a slot (1 to 8)" \
+									"\n\r\tThe playing tones keep sounding unless the wave changes"},
+		{"song"  , &Handler_Song  , "\n\r\tPlay the song kept in the flash (upload it with tools/song_upload.py)" \
+									"\n\r\tsong play [bar]: Start from the first or the given bar" \
+									"\n\r\tsong stop: Stop the song, enter song alone to print it"},
+		{"dither", &Handler_Dither, "\n\r\tSet how the output is quantized to 12 bits" \
+									"\n\r\tdither off: Round to the nearest step" \
+									"\n\r\tdither tpdf: Add triangular dither" \
+									"\n\r\tdither shaped: Triangular dither with noise shaping"},
+		{"bench" , &Handler_Bench , "\n\r\tRun a benchmark and print the cycles taken" \
+									"\n\r\tEnter bench alone to list the benchmarks"},
 		{"help"  , &Handler_Help  , "\n\r\tPrint this help message"},
 };
 
@@ -75,7 +212,9 @@ void Handler_Author(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGU
   * Handles the command "play".
   *
   * Plays the tones for a certain duration based on the
-  * input entered by the user .
+  * input entered by the user. "R" is a rest and a trailing "~"
+  * ties a tone to the next one, which continues the same note
+  * without starting it again.
   *
   * Parameters:
   *   argc		Number of arguments
@@ -89,51 +228,113 @@ void Handler_Play(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUME
 	if(argc > 20)
 	{
 		printf("\r\nPlease enter a maximum of 20 tones at once!\r\n");
+		return;
+	}
+
+	// Every tone needs a note on and a note off event
+	if(EventQueue_Space() < 2 * (argc - 1))
+	{
+		printf("\r\nToo many tones queued, please wait!\r\n");
+		return;
 	}
 
-	int tone = -1;
+	// Continue after the tones already queued, or start right away
+	uint32_t playCursor = AudioOut_GetPlayCursor();
+
+	int tone;
 	int duration;
+	int length;
+	bool tied;
+	int tiedNote = -1; // Note held over from a tied tone
+	note_event_t event;
 
 	for(int i = 1; i < argc; i++)
 	{
 		duration = 0;
-		switch (toupper(argv[i][0]))
+		length = strlen(argv[i]);
+		tied = (length > 1 && argv[i][length - 1] == TIE_MARK);
+		if(tied)
+			length--;
+
+		if(toupper(argv[i][0]) == REST_MARK)
 		{
-		case 'A':
-			tone = 0;
-			break;
-		case 'B':
-			tone = 1;
-			break;
-		case 'C':
-			tone = 2;
-			break;
-		case 'D':
-			tone = 3;
-			break;
-		case 'E':
-			tone = 4;
-			break;
-		case 'F':
-			tone = 5;
-			break;
-		case 'G':
-			tone = 6;
-			break;
-		default:
-			printf("\r\nInvalid tone. Please check!\r\n");
-			break;
+			tone = REST;
+		}
+		else
+		{
+			tone = toupper(argv[i][0]) - 'A';
+			if(tone < 0 || tone >= sizeof(toneNotes))
+			{
+				printf("\r\nInvalid tone. Please check!\r\n");
+				continue;
+			}
 		}
 
-		for(int j = 1; j < strlen(argv[i]); j++)
+		for(int j = 1; j < length; j++)
 		{
 			duration = duration * 10;
 			duration += (int)(argv[i][j]) - 48;
 		}
 
-		cbfifo_enqueue(TONES, &tone, 1);
-		cbfifo_enqueue(TONES, &duration, 1);
+		if(duration < MIN_TONE_DURATION || duration > MAX_TONE_DURATION)
+		{
+			printf("\r\nInvalid duration. Please check!\r\n");
+			continue;
+		}
+
+		event.timestamp = playCursor;
+		event.value = SYNTH_MAX_VELOCITY;
+
+		// A tie into a different tone (or a rest) ends the held note here
+		if(tiedNote >= 0 && (tone == REST || toneNotes[tone] != tiedNote))
+		{
+			event.type = EVENT_NOTE_OFF;
+			event.key = tiedNote;
+			EventQueue_Enqueue(&event);
+			tiedNote = -1;
+		}
+
+		// Every tone ends its own note, a rest only leaves time, so the
+		// notes of the sequencer, arpeggiator, MIDI and song keep sounding
+		if(tone == REST)
+		{
+			playCursor += duration * AudioOut_GetSampleRate();
+			continue;
+		}
+
+		// A tie into the same tone keeps the note sounding
+		if(tiedNote < 0)
+		{
+			event.type = EVENT_NOTE_ON;
+			event.key = toneNotes[tone];
+			EventQueue_Enqueue(&event);
+		}
+
+		playCursor += duration * AudioOut_GetSampleRate();
+
+		if(tied)
+		{
+			tiedNote = toneNotes[tone];
+			continue;
+		}
+
+		event.timestamp = playCursor;
+		event.type = EVENT_NOTE_OFF;
+		event.key = toneNotes[tone];
+		EventQueue_Enqueue(&event);
+		tiedNote = -1;
+	}
+
+	// A tie at the end of the command has nothing to continue into
+	if(tiedNote >= 0)
+	{
+		event.timestamp = playCursor;
+		event.type = EVENT_NOTE_OFF;
+		event.key = tiedNote;
+		EventQueue_Enqueue(&event);
 	}
+
+	AudioOut_SetPlayCursor(playCursor);
 	printf("\n\rTones in progress...\r\n");
 }
 
@@ -175,8 +376,8 @@ void Handler_Echo(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUME
 
 
 /*
-  * Handles the command "help".
-  * Prints all the existing commands along with their description.
+  * Handles the command "lfo".
+  * Sets the rate and depth of the vibrato or tremolo oscillator.
   *
   * Parameters:
   *   argc		Number of arguments
@@ -185,62 +386,1288 @@ void Handler_Echo(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUME
   * Returns:
   *   None
   */
-void Handler_Help(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+void Handler_Lfo(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
 {
-	printf("\r\n\ARMonica Command Processor\r\n\n");
-	for(int i = 0; i < num_commands; i++)
+	if(argc == 2 && strcasecmp(argv[1], "off") == 0)
 	{
-		printf("\r%s", commands[i].name);
-		printf("%s\n\n", commands[i].help_string);
+		Lfo_Configure(LFO_VIBRATO, 0, 0);
+		Lfo_Configure(LFO_TREMOLO, 0, 0);
+		printf("\r\nDisabling vibrato and tremolo...\r\n");
+		return;
+	}
+
+	if(argc != 4)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	int rate = atoi(argv[2]);
+	int depth = atoi(argv[3]);
+
+	if(rate < 1 || rate > LFO_MAX_RATE)
+	{
+		printf("\r\nInvalid rate. Please check!\r\n");
+		return;
+	}
+
+	if(strcasecmp(argv[1], "vibrato") == 0 && depth >= 0 && depth <= LFO_MAX_VIBRATO_DEPTH)
+	{
+		Lfo_Configure(LFO_VIBRATO, rate, depth);
+		printf("\r\nVibrato at %d Hz, %d cents\r\n", rate, depth);
+	}
+	else if(strcasecmp(argv[1], "tremolo") == 0 && depth >= 0 && depth <= LFO_MAX_TREMOLO_DEPTH)
+	{
+		Lfo_Configure(LFO_TREMOLO, rate, depth);
+		printf("\r\nTremolo at %d Hz, %d percent\r\n", rate, depth);
+	}
+	else
+	{
+		printf("\r\nInvalid lfo option...\r\n");
 	}
-	printf("\r");
 }
 
 
 /*
-  * Handles the command inputted by the user.
+  * Handles the command "stats".
+  * Prints the statistics of the audio engine since the last query.
   *
   * Parameters:
-  *   input		Pointer to the input command
+  *   argc		Number of arguments
+  *   argv		Array of arguments
   *
   * Returns:
   *   None
   */
-void HandleCommand(char* input)
+void Handler_Stats(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
 {
-	if (input == NULL)
+	static ticktime_t lastQuery = 0;
+	audio_stats_t stats;
+
+	ticktime_t elapsed = now() - lastQuery;
+	lastQuery = now();
+	if(elapsed == 0)
+		elapsed = 1;
+
+	AudioOut_GetStats(&stats, true);
+
+	// Load in tenths of a percent of the elapsed cycles
+	uint32_t load = (uint32_t)(((uint64_t)stats.renderCycles * 1000) / ((uint64_t)elapsed * CYCLES_PER_TICK));
+
+	printf("\r\nAudio: %s\r\n", stats.idle ? "idle" : "playing");
+	printf("DMA interrupts: %lu per second\r\n", (unsigned long)(stats.dmaInterrupts * TICKS_PER_SECOND / elapsed));
+	printf("Render load: %lu.%lu%%\r\n", (unsigned long)(load / 10), (unsigned long)(load % 10));
+	printf("Cycles per block: %lu\r\n",
+			(unsigned long)(stats.blocksRendered ? stats.renderCycles / stats.blocksRendered : 0));
+	printf("Queued events: %d\r\n", EventQueue_Length());
+}
+
+
+/*
+  * Handles the command "mem".
+  * Prints the usage of the audio arena per subsystem.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Mem(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	printf("\r\nAudio arena (%d bytes)\r\n", AUDIO_ARENA_SIZE);
+	for(int i = 0; i < ARENA_OWNERS; i++)
+	{
+		printf("%-8s %5u\r\n", Arena_OwnerName(i), (unsigned)Arena_Used(i));
+	}
+	printf("%-8s %5u\r\n", "free", (unsigned)Arena_Free());
+}
+
+
+/*
+  * Handles the command "sample".
+  * Plays a sample from the sample bank, or lists the samples.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Sample(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	note_event_t event;
+	int id = -1;
+
+	if(argc == 1)
+	{
+		printf("\r\n");
+		for(int i = 0; i < sampleBankSize; i++)
+		{
+			printf("%d %-8s %lu ms\r\n", i, sampleBank[i].name,
+					(unsigned long)(sampleBank[i].numSamples * 1000 / sampleBank[i].sampleRate));
+		}
 		return;
+	}
 
-	int index = 0;
-	int argc = 0;
-	char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS];
-	bool validArg = false;
+	if(argc != 2)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
 
-	char* ptr = input;
-	while(*ptr == ' ') // Skip the starting spaces
+	for(int i = 0; i < sampleBankSize; i++)
 	{
-		ptr++;
+		if(strcasecmp(argv[1], sampleBank[i].name) == 0)
+			id = i;
 	}
+	if(id < 0 && isdigit((unsigned char)argv[1][0]))
+		id = atoi(argv[1]);
 
-	while(*ptr != '\0') // Iterate through the whole command and parse it
+	if(id < 0 || id >= sampleBankSize)
 	{
-		validArg = false;
-		index = 0;
-		while(*ptr != ' ' && *ptr != '\0') // Spaces are removed all the time
+		printf("\r\nInvalid sample. Please check!\r\n");
+		return;
+	}
+
+	event.timestamp = AudioOut_GetSampleTime();
+	event.type = EVENT_SAMPLE;
+	event.key = id;
+	event.value = 127;
+	if(!EventQueue_Insert(&event))
+	{
+		printf("\r\nToo many events queued. Please wait!\r\n");
+		return;
+	}
+	printf("\r\nPlaying %s...\r\n", sampleBank[id].name);
+}
+
+/*
+  * Handles the command "drums".
+  * Queues the strokes of a drum pattern after the tones already queued.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Drums(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	int tempo;
+	int steps = 0;
+	int strokes = 0;
+	int length;
+	uint32_t stepStart;
+	note_event_t event;
+
+	if(argc < 3)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	tempo = atoi(argv[1]);
+	if(tempo < MIN_TEMPO || tempo > MAX_TEMPO)
+	{
+		printf("\r\nInvalid tempo. Please check!\r\n");
+		return;
+	}
+
+	// Check the whole pattern before queuing any of it
+	for(int i = 2; i < argc; i++)
+	{
+		length = strlen(argv[i]);
+		if(length > steps)
+			steps = length;
+
+		for(int j = 0; j < length; j++)
 		{
-			argv[argc][index] = *ptr;
-			validArg = true;
-			index++;
-			ptr++;
+			if(argv[i][j] == REST_STEP_MARK)
+				continue;
+			if(Drums_FromLetter(argv[i][j]) == DRUMS)
+			{
+				printf("\r\nInvalid drum %c. Please check!\r\n", argv[i][j]);
+				return;
+			}
+			strokes++;
 		}
+	}
 
-		if(*ptr != '\0')
-			ptr++;
+	// Every stroke is an event, plus the tempo
+	if(EventQueue_Space() < strokes + 1)
+	{
+		printf("\r\nToo many events queued, please wait!\r\n");
+		return;
+	}
 
-		argv[argc][index] = '\0';
+	uint32_t playCursor = AudioOut_GetPlayCursor();
 
-		if(validArg) // Increment argc only if the argument is non-empty
-			argc++;
+	event.timestamp = playCursor;
+	event.type = EVENT_TEMPO;
+	event.key = 0;
+	event.value = tempo;
+	EventQueue_Enqueue(&event);
+
+	event.type = EVENT_DRUM;
+	for(int step = 0; step < steps; step++)
+	{
+		// A sixteenth note is a quarter of a beat, 15 / tempo seconds
+		stepStart = playCursor + (step * AudioOut_GetSampleRate() * 15) / tempo;
+
+		for(int i = 2; i < argc; i++)
+		{
+			if(step >= (int)strlen(argv[i]) || argv[i][step] == REST_STEP_MARK)
+				continue;
+
+			event.timestamp = stepStart;
+			event.key = Drums_FromLetter(argv[i][step]);
+			event.value = isupper((unsigned char)argv[i][step]) ? ACCENT_VELOCITY : SOFT_VELOCITY;
+			EventQueue_Enqueue(&event);
+		}
+	}
+
+	AudioOut_SetPlayCursor(playCursor + (steps * AudioOut_GetSampleRate() * 15) / tempo);
+	printf("\n\rDrums in progress...\r\n");
+}
+
+
+
+/*
+  * Converts a letter of a pattern to a step of the sequencer.
+  *
+  * Parameters:
+  *   letter	A to G for a tone, K, S or H for a drum, . for a rest or - to hold the tone
+  *   step		Pointer to store the step
+  *
+  * Returns:
+  *   True if the letter is a step, else False.
+  */
+static bool ParseStep(char letter, seq_step_t* step)
+{
+	int tone = toupper((unsigned char)letter) - 'A';
+	drum_t drum = Drums_FromLetter(letter);
+
+	step->velocity = isupper((unsigned char)letter) ? ACCENT_VELOCITY : SOFT_VELOCITY;
+
+	if(letter == REST_STEP_MARK)
+		step->key = SEQ_REST;
+	else if(letter == TIE_STEP_MARK)
+		step->key = SEQ_TIE;
+	else if(drum != DRUMS)
+		step->key = SEQ_DRUM | drum;
+	else if(tone >= 0 && tone < sizeof(toneNotes))
+		step->key = toneNotes[tone];
+	else
+		return false;
+
+	return true;
+}
+
+
+/*
+  * Converts a step of the sequencer back to its letter.
+  *
+  * Parameters:
+  *   step		Pointer to the step
+  *
+  * Returns:
+  *   Letter of the step, lowercase if it is played softer.
+  */
+static char StepLetter(const seq_step_t* step)
+{
+	char letter = '?';
+
+	if(step->key == SEQ_REST)
+		return REST_STEP_MARK;
+	if(step->key == SEQ_TIE)
+		return TIE_STEP_MARK;
+
+	if(step->key & SEQ_DRUM)
+	{
+		letter = toupper((unsigned char)Drums_Name(step->key & ~SEQ_DRUM)[0]);
+	}
+	else
+	{
+		for(int i = 0; i < sizeof(toneNotes); i++)
+		{
+			if(toneNotes[i] == step->key)
+				letter = 'A' + i;
+		}
+	}
+
+	return (step->velocity < ACCENT_VELOCITY) ? tolower((unsigned char)letter) : letter;
+}
+
+
+/*
+  * Handles the command "seq".
+  * Stores the patterns of the sequencer, starts and stops it, or prints
+  * the patterns.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Seq(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	seq_step_t steps[SEQ_MAX_STEPS];
+	const seq_step_t* pattern;
+	int index, length;
+
+	if(argc == 1)
+	{
+		printf("\r\nSequencer %s\r\n", Sequencer_IsRunning() ? "running" : "stopped");
+		for(int i = 0; i < SEQ_MAX_PATTERNS; i++)
+		{
+			pattern = Sequencer_GetPattern(i, &length);
+			printf("%d: ", i + 1);
+			for(int j = 0; j < length; j++)
+			{
+				putchar(StepLetter(&pattern[j]));
+			}
+			printf("%s\r\n", (length == 0) ? "empty" : "");
+		}
+		return;
+	}
+
+	if(strcasecmp(argv[1], "stop") == 0 && argc == 2)
+	{
+		Sequencer_Stop();
+		printf("\r\nStopping the sequencer...\r\n");
+		return;
+	}
+
+	if(strcasecmp(argv[1], "start") == 0 && (argc == 3 || argc == 4))
+	{
+		int tempo = atoi(argv[2]);
+		int swing = (argc == 4) ? atoi(argv[3]) : SEQ_MIN_SWING;
+
+		if(tempo < MIN_TEMPO || tempo > MAX_TEMPO || swing < SEQ_MIN_SWING || swing > SEQ_MAX_SWING)
+		{
+			printf("\r\nInvalid tempo or swing. Please check!\r\n");
+			return;
+		}
+
+		Sequencer_Start(tempo, swing);
+		printf("\r\nSequencer at %d BPM, %d%% swing\r\n", tempo, swing);
+		return;
+	}
+
+	if(argc < 3)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	index = atoi(argv[2]) - 1;
+	if(Sequencer_GetPattern(index, &length) == NULL)
+	{
+		printf("\r\nInvalid pattern. Please check!\r\n");
+		return;
+	}
+
+	if(strcasecmp(argv[1], "clear") == 0 && argc == 3)
+	{
+		Sequencer_SetPattern(index, steps, 0);
+		printf("\r\nPattern %d cleared\r\n", index + 1);
+	}
+	else if(strcasecmp(argv[1], "set") == 0 && argc > 3)
+	{
+		// The arguments are joined, so 32 steps can be entered as two halves
+		length = 0;
+		for(int i = 3; i < argc; i++)
+		{
+			for(int j = 0; argv[i][j] != '\0'; j++)
+			{
+				if(length == SEQ_MAX_STEPS || !ParseStep(argv[i][j], &steps[length]))
+				{
+					printf("\r\nInvalid step %c or more than %d steps. Please check!\r\n", argv[i][j], SEQ_MAX_STEPS);
+					return;
+				}
+				length++;
+			}
+		}
+
+		Sequencer_SetPattern(index, steps, length);
+		printf("\r\nPattern %d has %d steps\r\n", index + 1, length);
+	}
+	else if(strcasecmp(argv[1], "vel") == 0 && argc > 3)
+	{
+		// Joined like the steps, one digit per step
+		length = 0;
+		for(int i = 3; i < argc; i++)
+		{
+			for(int j = 0; argv[i][j] != '\0'; j++, length++)
+			{
+				if(argv[i][j] >= '1' && argv[i][j] <= '9')
+					Sequencer_SetVelocity(index, length, ((argv[i][j] - '0') * ACCENT_VELOCITY) / 9);
+				else if(argv[i][j] != REST_STEP_MARK)
+					printf("\r\nInvalid velocity %c. Please check!\r\n", argv[i][j]);
+			}
+		}
+		printf("\r\nVelocities of pattern %d set\r\n", index + 1);
+	}
+	else
+	{
+		printf("\r\nInvalid seq option...\r\n");
+	}
+}
+
+
+/*
+  * Handles the command "arp".
+  * Starts the arpeggiator on a chord, or stops it.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Arp(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	uint8_t notes[ARP_MAX_NOTES];
+	uint8_t velocities[ARP_MAX_NOTES];
+	int count = 0;
+	int tone;
+	arp_order_t order = ARP_UP;
+	int division = 16;
+	int octaves = 1;
+	int tempo;
+	uint32_t start;
+	char* rate;
+
+	if(argc == 2 && strcasecmp(argv[1], "stop") == 0)
+	{
+		Arp_Stop();
+		printf("\r\nStopping the arpeggiator...\r\n");
+		return;
+	}
+
+	if(argc < 2 || argc > 6)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	for(int j = 0; argv[1][j] != '\0'; j++)
+	{
+		tone = toupper((unsigned char)argv[1][j]) - 'A';
+		if(count == ARP_MAX_NOTES || tone < 0 || tone >= sizeof(toneNotes))
+		{
+			printf("\r\nInvalid tones, up to %d of A to G. Please check!\r\n", ARP_MAX_NOTES);
+			return;
+		}
+		notes[count] = toneNotes[tone];
+		velocities[count] = isupper((unsigned char)argv[1][j]) ? ACCENT_VELOCITY : SOFT_VELOCITY;
+		count++;
+	}
+
+	if(argc > 2)
+	{
+		for(order = 0; order < ARP_ORDERS; order++)
+		{
+			if(strcasecmp(argv[2], Arp_OrderName(order)) == 0)
+				break;
+		}
+		if(order == ARP_ORDERS)
+		{
+			printf("\r\nInvalid order. Please check!\r\n");
+			return;
+		}
+	}
+
+	// Note value 1/N, or 1/Nt for triplets which fit three in the time of two
+	if(argc > 3)
+	{
+		rate = argv[3];
+		division = (strncmp(rate, "1/", 2) == 0) ? atoi(rate + 2) : 0;
+		if(tolower((unsigned char)rate[strlen(rate) - 1]) == 't')
+			division = division * 3 / 2;
+		if(division < 1 || division > 48)
+		{
+			printf("\r\nInvalid rate. Please check!\r\n");
+			return;
+		}
+	}
+
+	if(argc > 4)
+		octaves = atoi(argv[4]);
+
+	// Lock to the running sequencer, or follow the tempo of the engine
+	if(argc > 5)
+		tempo = atoi(argv[5]);
+	else
+		tempo = Sequencer_IsRunning() ? Sequencer_GetTempo() : AudioOut_GetTempo();
+
+	if(tempo < MIN_TEMPO || tempo > MAX_TEMPO)
+	{
+		printf("\r\nInvalid tempo. Please check!\r\n");
+		return;
+	}
+
+	if(!Sequencer_NextStep(&start) || argc > 5)
+		start = AudioOut_GetSampleTime();
+
+	if(!Arp_Start(notes, velocities, count, order, octaves, division, tempo, start))
+	{
+		printf("\r\nInvalid number of octaves. Please check!\r\n");
+		return;
+	}
+	printf("\r\nArpeggiating %s %s at %d BPM...\r\n", argv[1], Arp_OrderName(order), tempo);
+}
+
+
+/*
+  * Handles the command "stream".
+  * Starts playing PCM samples from the UART, or prints the statistics
+  * of the last stream.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Stream(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	stream_stats_t stats;
+
+	if(argc == 1)
+	{
+		Stream_GetStats(&stats);
+		printf("\r\nStream: %s, %u Hz, %d bit\r\n", stats.active ? "active" : "ended",
+				stats.sampleRate, stats.bits);
+		printf("Bytes received: %lu\r\n", (unsigned long)stats.bytesReceived);
+		printf("Buffer fill: %lu of %d (min %lu, max %lu)\r\n", (unsigned long)stats.fill,
+				STREAM_BUFFER_SIZE, (unsigned long)stats.minFill, (unsigned long)stats.maxFill);
+		printf("Underruns: %lu\r\n", (unsigned long)stats.underruns);
+		printf("Overruns: %lu\r\n", (unsigned long)stats.overruns);
+		printf("XOFF sent: %lu\r\n", (unsigned long)stats.xoffCount);
+		return;
+	}
+
+	if(argc > 3)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	int rate = atoi(argv[1]);
+	int bits = (argc == 3) ? atoi(argv[2]) : 8;
+
+	if(rate < STREAM_MIN_RATE || rate > STREAM_MAX_RATE || (bits != 8 && bits != 12))
+	{
+		printf("\r\nInvalid stream format. Please check!\r\n");
+		return;
+	}
+
+	printf("\r\nStreaming at %d Hz, %d bit. Send the samples...\r\n", rate, bits);
+	if(!Stream_Start(rate, bits))
+		printf("Streaming is not available!\r\n");
+}
+
+
+/*
+  * Handles the command "midi".
+  * Starts listening to MIDI on the UART, or prints the statistics of the
+  * MIDI input.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Midi(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	midi_stats_t stats;
+	int channel;
+
+	if(argc == 1)
+	{
+		Midi_GetStats(&stats);
+		printf("\r\nMIDI: %s, ", stats.active ? "active" : "ended");
+		if(stats.channel == MIDI_OMNI)
+			printf("all channels\r\n");
+		else
+			printf("channel %u\r\n", stats.channel);
+		printf("Bytes received: %lu\r\n", (unsigned long)stats.bytesReceived);
+		printf("Messages: %lu\r\n", (unsigned long)stats.messages);
+		printf("Dropped: %lu\r\n", (unsigned long)stats.dropped);
+		printf("Clocks: %lu\r\n", (unsigned long)stats.clocks);
+		if(stats.clockTempo != 0)
+			printf("Clock tempo: %u BPM\r\n", stats.clockTempo);
+		return;
+	}
+
+	if(argc != 2)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	channel = (strcasecmp(argv[1], "omni") == 0) ? MIDI_OMNI : atoi(argv[1]);
+	if(channel == MIDI_OMNI && strcasecmp(argv[1], "omni") != 0)
+		channel = -1;
+	if(channel < MIDI_OMNI || channel > MIDI_CHANNELS)
+	{
+		printf("\r\nInvalid MIDI channel. Please check!\r\n");
+		return;
+	}
+
+	if(Stream_IsActive() || !Midi_Start(channel))
+	{
+		printf("\r\nMIDI is not available!\r\n");
+		return;
+	}
+	printf("\r\nListening to MIDI. Send a reset or ESC to return...\r\n");
+}
+
+
+/*
+  * Handles the command "link".
+  * Prints the statistics of the last binary host link.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Link(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	link_stats_t stats;
+
+	if(argc != 1)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	HostLink_GetStats(&stats);
+	printf("\r\nLink: %s\r\n", stats.active ? "active" : "ended");
+	printf("Frames: %lu\r\n", (unsigned long)stats.frames);
+	printf("CRC errors: %lu\r\n", (unsigned long)stats.crcErrors);
+	printf("Rejected frames: %lu\r\n", (unsigned long)stats.errors);
+	printf("Overruns: %lu\r\n", (unsigned long)stats.overruns);
+}
+
+
+/*
+  * Prints a baud rate setting.
+  *
+  * Parameters:
+  *   setting		Setting to print
+  *
+  * Returns:
+  *   None
+  */
+static void PrintBaud(const uart_baud_t* setting)
+{
+	printf("%lu baud (actual %lu, error %ld ppm, OSR %u, SBR %u)\r\n",
+			(unsigned long)setting->baudRate, (unsigned long)setting->actual, (long)setting->error,
+			setting->osr, setting->sbr);
+}
+
+
+/*
+  * Handles the command "baud".
+  * Switches the console to a new baud rate, confirms it, or prints it.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Baud(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	uart_baud_t setting;
+	bool waiting;
+
+	if(argc == 1)
+	{
+		UART0_GetBaud(&setting);
+		printf("\r\nBaud rate: ");
+		PrintBaud(&setting);
+		return;
+	}
+
+	if(argc != 2)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	// Receiving the command at the new rate shows that it works
+	waiting = UART0_ConfirmBaud();
+	if(strcasecmp(argv[1], "ok") == 0)
+	{
+		printf(waiting ? "\r\nBaud rate kept\r\n" : "\r\nNo baud rate to confirm\r\n");
+		return;
+	}
+
+	if(!UART0_FindBaud(strtoul(argv[1], NULL, 10), &setting))
+	{
+		printf("\r\nNo setting within %d ppm of %s baud. Please check!\r\n", UART_MAX_BAUD_ERROR, argv[1]);
+		return;
+	}
+
+	printf("\r\nSwitching to ");
+	PrintBaud(&setting);
+	printf("Enter \"baud ok\" at the new rate within %d seconds to keep it\r\n",
+			UART_BAUD_CONFIRM_TICKS / TICKS_PER_SECOND);
+	UART0_SwitchBaud(&setting);
+}
+
+
+/*
+  * Handles the command "rate".
+  * Changes the sampling rate of the DAC, or prints it.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Rate(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	const int numRates = sizeof(sampleRates) / sizeof(sample_rate_t);
+	int selected = -1;
+
+	if(argc == 1)
+	{
+		printf("\r\nSampling rate: %lu Hz\r\n", (unsigned long)AudioOut_GetSampleRate());
+		return;
+	}
+
+	if(argc != 2)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	// Accept the rate in kHz or in Hz
+	for(int i = 0; i < numRates; i++)
+	{
+		if(strcmp(argv[1], sampleRates[i].name) == 0 || (uint32_t)atoi(argv[1]) == sampleRates[i].rate)
+			selected = i;
+	}
+
+	if(selected < 0)
+	{
+		printf("\r\nInvalid rate. Please check!\r\n");
+		return;
+	}
+
+	if(!AudioOut_SetSampleRate(sampleRates[selected].rate))
+	{
+		printf("\r\nCould not change the rate while streaming!\r\n");
+		return;
+	}
+	printf("\r\nSampling rate set to %s kHz\r\n", sampleRates[selected].name);
+}
+
+
+/*
+  * Handles the command "wave".
+  * Selects the sound of the voices, or prints it.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Wave(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	if(argc == 1)
+	{
+		printf("\r\nWave: %s\r\n", Synth_WaveName(Synth_GetWaveform()));
+		return;
+	}
+
+	if(argc != 2)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	for(int i = 0; i < SYNTH_WAVES; i++)
+	{
+		if(strcasecmp(argv[1], Synth_WaveName(i)) == 0)
+		{
+			if(Stream_IsActive())
+			{
+				printf("\r\nCould not change the wave while streaming!\r\n");
+				return;
+			}
+			if(!AudioOut_SetWaveform(i))
+			{
+				printf("\r\nNot enough memory for the %s wave!\r\n", Synth_WaveName(i));
+				return;
+			}
+			printf("\r\nWave set to %s\r\n", Synth_WaveName(Synth_GetWaveform()));
+			return;
+		}
+	}
+	printf("\r\nInvalid wave option...\r\n");
+}
+
+
+/*
+  * Parses a positive decimal number (e.g. "3.5") into Q8.
+  *
+  * Parameters:
+  *   text		String to parse
+  *   value		Pointer to store the value
+  *
+  * Returns:
+  *   True if the string is a number below 256, else False.
+  */
+static bool ParseQ8(const char* text, uint32_t* value)
+{
+	uint32_t whole = 0, fraction = 0, scale = 1;
+
+	if(!isdigit((unsigned char)*text))
+		return false;
+
+	while(isdigit((unsigned char)*text))
+		whole = whole * 10 + (*text++ - '0');
+
+	if(*text == '.')
+	{
+		text++;
+		while(isdigit((unsigned char)*text) && scale < 10000)
+		{
+			fraction = fraction * 10 + (*text++ - '0');
+			scale *= 10;
+		}
+	}
+
+	if(*text != '\0' || whole > 255)
+		return false;
+
+	*value = (whole << 8) + ((fraction << 8) + scale / 2) / scale;
+	return true;
+}
+
+
+/*
+  * Handles the command "fm".
+  * Sets the ratio, index and envelope amount of the FM wave.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Fm(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	uint32_t ratio, index;
+	int envelope = 0;
+
+	if(argc != 3 && argc != 4)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	if(argc == 4)
+		envelope = atoi(argv[3]);
+
+	if(!ParseQ8(argv[1], &ratio) || !ParseQ8(argv[2], &index) || ratio == 0 ||
+			ratio > SYNTH_FM_MAX_RATIO || index > SYNTH_FM_MAX_INDEX || envelope < 0 || envelope > 100)
+	{
+		printf("\r\nInvalid fm patch. Please check!\r\n");
+		return;
+	}
+
+	Synth_SetFmPatch(ratio, index, envelope);
+	printf("\r\nFM ratio %s, index %s, %d%% on the envelope\r\n", argv[1], argv[2], envelope);
+	if(Synth_GetWaveform() != SYNTH_WAVE_FM)
+		printf("Enter wave fm to hear it\r\n");
+}
+
+
+/*
+  * Handles the command "dither".
+  * Selects the quantization of the output stage, or prints it.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Dither(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	if(argc == 1)
+	{
+		printf("\r\nDither: %s\r\n", OutputStage_ModeName(OutputStage_GetMode()));
+		return;
+	}
+
+	if(argc != 2)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	for(int i = 0; i < OUTPUT_MODES; i++)
+	{
+		if(strcasecmp(argv[1], OutputStage_ModeName(i)) == 0)
+		{
+			OutputStage_SetMode(i);
+			printf("\r\nDither set to %s\r\n", OutputStage_ModeName(i));
+			return;
+		}
+	}
+	printf("\r\nInvalid dither option...\r\n");
+}
+
+
+/*
+  * Prints the slots holding a patch and the wear of the patch store.
+  *
+  * Parameters:
+  *   None
+  *
+  * Returns:
+  *   None
+  */
+static void PrintPatchStore()
+{
+	patch_store_stats_t stats;
+
+	PatchStore_GetStats(&stats);
+	printf("\r\nSaved slots:");
+	for(int slot = 0; slot < PATCH_SLOTS; slot++)
+	{
+		if(stats.used & (1 << slot))
+			printf(" %d", slot + 1);
+	}
+	printf("%s\r\n", stats.used ? "" : " none");
+	printf("Sector %u (generation %lu): %u of %u records, %lu sectors erased since startup\r\n",
+			stats.sector, (unsigned long)stats.generation, stats.records, stats.capacity,
+			(unsigned long)stats.erases);
+}
+
+
+/*
+  * Parses the slot argument of the commands "save" and "load".
+  *
+  * Parameters:
+  *   text		String to parse
+  *   slot		Pointer to store the slot, from 0
+  *
+  * Returns:
+  *   True if the string is a slot from 1 to PATCH_SLOTS, else False.
+  */
+static bool ParseSlot(const char* text, uint8_t* slot)
+{
+	int value = atoi(text);
+
+	if(value < 1 || value > PATCH_SLOTS)
+		return false;
+
+	*slot = value - 1;
+	return true;
+}
+
+
+/*
+  * Handles the command "save".
+  * Saves the current sound into a slot of the flash, or prints the store.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Save(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	patch_t patch;
+	uint8_t slot;
+
+	if(argc == 1)
+	{
+		PrintPatchStore();
+		return;
+	}
+
+	if(argc != 2)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	if(!ParseSlot(argv[1], &slot))
+	{
+		printf("\r\nInvalid slot, enter 1 to %d. Please check!\r\n", PATCH_SLOTS);
+		return;
+	}
+
+	Patch_Capture(&patch);
+	if(!PatchStore_Save(slot, &patch))
+	{
+		printf("\r\nCould not write the flash!\r\n");
+		return;
+	}
+	printf("\r\nSaved into slot %d\r\n", slot + 1);
+}
+
+
+/*
+  * Handles the command "load".
+  * Applies the sound saved into a slot, or prints the store.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Load(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	patch_t patch;
+	uint8_t slot;
+
+	if(argc == 1)
+	{
+		PrintPatchStore();
+		return;
+	}
+
+	if(argc != 2)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	if(!ParseSlot(argv[1], &slot))
+	{
+		printf("\r\nInvalid slot, enter 1 to %d. Please check!\r\n", PATCH_SLOTS);
+		return;
+	}
+
+	if(!PatchStore_Load(slot, &patch))
+	{
+		printf("\r\nNothing saved into slot %d\r\n", slot + 1);
+		return;
+	}
+
+	if(!Patch_Apply(&patch))
+	{
+		printf("\r\nCould not change the wave while streaming!\r\n");
+		return;
+	}
+	printf("\r\nLoaded slot %d: wave %s\r\n", slot + 1, Synth_WaveName(Synth_GetWaveform()));
+}
+
+
+/*
+  * Handles the command "song".
+  * Starts or stops the song kept in the flash, or prints it.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Song(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	song_info_t info;
+	int bar = 1;
+
+	Song_GetInfo(&info);
+
+	if(argc == 1)
+	{
+		if(info.written != 0)
+			printf("\r\nUploading, %lu bytes written\r\n", (unsigned long)info.written);
+		else if(!info.valid)
+			printf("\r\nNo song in the flash\r\n");
+		else
+			printf("\r\nSong \"%.*s\": %u bars of %u beats at %u BPM, %lu bytes%s\r\n",
+					SONG_NAME_LENGTH, info.header->name, info.header->bars, info.header->beatsPerBar,
+					info.header->tempo, (unsigned long)info.header->length, info.playing ? ", playing" : "");
+		if(info.playing)
+			printf("Bar %u\r\n", info.bar + 1);
+		return;
+	}
+
+	if(argc > 3)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	if(strcasecmp(argv[1], "stop") == 0 && argc == 2)
+	{
+		Song_Stop();
+		printf("\r\nSong stopped\r\n");
+		return;
+	}
+
+	if(strcasecmp(argv[1], "play") != 0)
+	{
+		printf("\r\nInvalid song option...\r\n");
+		return;
+	}
+
+	if(!info.valid)
+	{
+		printf("\r\nNo song in the flash\r\n");
+		return;
+	}
+
+	if(argc == 3)
+		bar = atoi(argv[2]);
+
+	if(bar < 1 || bar > info.header->bars)
+	{
+		printf("\r\nInvalid bar, enter 1 to %u. Please check!\r\n", info.header->bars);
+		return;
+	}
+
+	if(!Song_Start(bar - 1))
+	{
+		printf("\r\nThe song is playing, enter song stop first\r\n");
+		return;
+	}
+	printf("\r\nPlaying from bar %d\r\n", bar);
+}
+
+
+/*
+  * Handles the command "bench".
+  * Runs a benchmark on the target, or lists the benchmarks.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Bench(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	if(argc == 1)
+	{
+		printf("\r\n");
+		Benchmark_List();
+		return;
+	}
+
+	if(argc != 2)
+	{
+		printf("\r\nInvalid number of arguments. Please check!\r\n");
+		return;
+	}
+
+	if(!Benchmark_Run(argv[1]))
+		printf("\r\nInvalid benchmark. Please check!\r\n");
+}
+
+
+/*
+  * Handles the command "help".
+  * Prints all the existing commands along with their description.
+  *
+  * Parameters:
+  *   argc		Number of arguments
+  *   argv		Array of arguments
+  *
+  * Returns:
+  *   None
+  */
+void Handler_Help(int argc, char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS])
+{
+	printf("\r\n\ARMonica Command Processor\r\n\n");
+	for(int i = 0; i < num_commands; i++)
+	{
+		printf("\r%s", commands[i].name);
+		printf("%s\n\n", commands[i].help_string);
+	}
+	printf("\r");
+}
+
+
+/*
+  * Handles the command inputted by the user.
+  *
+  * Parameters:
+  *   input		Pointer to the input command
+  *
+  * Returns:
+  *   None
+  */
+void HandleCommand(char* input)
+{
+	if (input == NULL)
+		return;
+
+	int index = 0;
+	int argc = 0;
+	char argv[MAX_NUM_OF_ARGUMENTS][MAX_LENGTH_OF_ARGUMENTS];
+	bool validArg = false;
+
+	char* ptr = input;
+	while(*ptr == ' ') // Skip the starting spaces
+	{
+		ptr++;
+	}
+
+	while(*ptr != '\0') // Iterate through the whole command and parse it
+	{
+		validArg = false;
+		index = 0;
+		while(*ptr != ' ' && *ptr != '\0') // Spaces are removed all the time
+		{
+			if(index < MAX_LENGTH_OF_ARGUMENTS - 1) // Longer arguments are cut short
+			{
+				argv[argc][index] = *ptr;
+				index++;
+			}
+			validArg = true;
+			ptr++;
+		}
+
+		if(*ptr != '\0')
+			ptr++;
+
+		argv[argc][index] = '\0';
+
+		if(validArg) // Increment argc only if the argument is non-empty
+			argc++;
+
+		if(argc == MAX_NUM_OF_ARGUMENTS) // Further arguments are dropped
+			break;
 	}
 
 	if(argc == 0) // No commands
@@ -0,0 +1,48 @@
+/*
+ * Crc16.c - CRC-16/CCITT of the host link frames and the flash records
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include "Crc16.h"
+
+
+/*
+ * Add a byte to a CRC-16/CCITT
+ *
+ * Byte-wise form of the polynomial 0x1021, without a table.
+ *
+ * @input crc		CRC so far
+ * 		  byte		Next byte
+ * @return Updated CRC
+ *
+ */
+uint16_t Crc16_Byte(uint16_t crc, uint8_t byte)
+{
+	uint8_t x = (crc >> 8) ^ byte;
+
+	x ^= x >> 4;
+	return (crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x;
+}
+
+
+/*
+ * Add bytes to a CRC-16/CCITT
+ *
+ * @input crc		CRC so far, CRC16_INIT to start
+ * 		  data		Pointer to the bytes
+ * 		  length	Number of bytes
+ * @return Updated CRC
+ *
+ */
+uint16_t Crc16_Update(uint16_t crc, const void* data, uint32_t length)
+{
+	const uint8_t* bytes = data;
+
+	while(length-- > 0)
+	{
+		crc = Crc16_Byte(crc, *bytes++);
+	}
+	return crc;
+}
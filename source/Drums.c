@@ -0,0 +1,313 @@
+/*
+ * Drums.c - Percussion voices from swept sines and filtered noise
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+#include <ctype.h>
+
+#include "Drums.h"
+#include "Noise.h"
+#include "AudioOut.h"
+#include "AudioArena.h"
+#include "fp_trig.h"
+
+// Scale from velocity to Q15 gain
+#define VELOCITY_GAIN (258)
+
+// Envelopes are in Q30, a voice ends below this level (8 in Q15, -72 dB)
+#define DRUM_SILENCE (8 << 15)
+
+// 2 pi in Q14, for the cutoff of the high-pass filters
+#define TWO_PI_Q14 (102944)
+
+// Seed of the noise of the drums
+#define DRUM_NOISE_SEED (0x1F2E3D4C)
+
+// Source of the noise of a drum
+typedef enum {
+	DRUM_NOISE_NONE,
+	DRUM_NOISE_WHITE,
+	DRUM_NOISE_PINK
+} drum_noise_t;
+
+// Sound of a drum, a tone and a noise part with exponential decays
+typedef struct drum_patch_s
+{
+	const char* name;
+	char letter; // Letter of the drum in patterns
+	uint16_t toneHz; // Frequency the tone settles at, 0 for no tone
+	uint16_t sweepHz; // Frequency added to the tone at the stroke
+	uint16_t sweepMs; // Time constant of the pitch sweep
+	uint16_t toneMs; // Time constant of the tone level
+	int16_t toneLevel; // Q15
+	uint8_t noise; // One of drum_noise_t
+	uint16_t cutoffHz; // Cutoff of the high-pass filter of the noise
+	uint16_t noiseMs; // Time constant of the noise level
+	int16_t noiseLevel; // Q15
+} drum_patch_t;
+
+static const drum_patch_t patches[DRUMS] = {
+		{"kick",  'K', 50,  110, 25, 120, 32767, DRUM_NOISE_NONE,  0,    0,  0},
+		{"snare", 'S', 180, 60,  10, 35,  14000, DRUM_NOISE_PINK,  400,  55, 32767},
+		{"hat",   'H', 0,   0,   0,  0,   0,     DRUM_NOISE_WHITE, 7000, 15, 9000},
+};
+
+// State of a single drum voice
+typedef struct drum_voice_s
+{
+	bool active; // Flag to check if the drum is sounding
+	uint32_t phase; // Phase accumulator of the tone
+	int32_t sweep; // Phase increment above the settled tone, decays to zero
+	int32_t toneLevel; // Envelope of the tone in Q30, includes the velocity
+	int32_t noiseLevel; // Envelope of the noise in Q30, includes the velocity
+	int32_t lowpass; // State of the high-pass filter
+	// Coefficients for the sampling rate
+	uint32_t increment; // Phase increment of the settled tone
+	int32_t startSweep; // Sweep at the stroke
+	uint16_t sweepDecay; // Decays per sample in Q15
+	uint16_t toneDecay;
+	uint16_t noiseDecay;
+	uint16_t filter; // Coefficient of the filter in Q14
+} drum_voice_t;
+
+static drum_voice_t* drumVoices = NULL; // Voices borrowed from the audio arena
+static noise_t drumNoise;
+
+
+/*
+ * Convert a time constant to a decay per sample
+ *
+ * The level is reduced by level * decay / 32768 every sample.
+ *
+ * @input ms	Time constant in milliseconds
+ * @return Decay in Q15
+ *
+ */
+static uint16_t DecayPerSample(uint16_t ms)
+{
+	uint32_t samples = (ms * AudioOut_GetSampleRate()) / 1000;
+
+	if(samples < 2)
+		return INT16_MAX;
+	return (32768 + samples / 2) / samples;
+}
+
+
+/*
+ * Initialize the drums
+ *
+ * Borrows the state of the voices from the audio arena, and sets the
+ * envelopes and filters for the sampling rate.
+ *
+ * @input None
+ * @return True if the voices could be allocated, else False.
+ *
+ */
+bool Drums_Init()
+{
+	uint32_t rate = AudioOut_GetSampleRate();
+	uint32_t omega, cutoff;
+
+	drumVoices = Arena_Alloc(ARENA_VOICES, DRUMS * sizeof(drum_voice_t), sizeof(uint32_t));
+	if(drumVoices == NULL)
+		return false;
+
+	Noise_Init(&drumNoise, DRUM_NOISE_SEED);
+
+	for(int i = 0; i < DRUMS; i++)
+	{
+		drumVoices[i].increment = (uint32_t)(((uint64_t)patches[i].toneHz << 32) / rate);
+		drumVoices[i].startSweep = (int32_t)(((uint64_t)patches[i].sweepHz << 32) / rate);
+		drumVoices[i].sweepDecay = DecayPerSample(patches[i].sweepMs);
+		drumVoices[i].toneDecay = DecayPerSample(patches[i].toneMs);
+		drumVoices[i].noiseDecay = DecayPerSample(patches[i].noiseMs);
+
+		// One-pole low-pass a = w / (1 + w), the high-pass is the input minus the
+		// low-pass. The cutoff is kept well below the Nyquist frequency at low rates.
+		cutoff = (patches[i].cutoffHz < rate / 4) ? patches[i].cutoffHz : rate / 4;
+		omega = (TWO_PI_Q14 * cutoff) / rate;
+		drumVoices[i].filter = (omega << 14) / ((1 << 14) + omega);
+	}
+	return true;
+}
+
+
+/*
+ * Strike a drum
+ *
+ * Restarts the voice of the drum if it is still sounding.
+ *
+ * @input drum		Drum to strike
+ * 		  velocity	Loudness of the stroke (0 to 127), 0 silences the drum
+ * @return None
+ *
+ */
+void Drums_Trigger(drum_t drum, uint8_t velocity)
+{
+	if(drumVoices == NULL || drum >= DRUMS)
+		return;
+
+	drum_voice_t* voice = &drumVoices[drum];
+	int32_t gain = (velocity > 127 ? 127 : velocity) * VELOCITY_GAIN;
+
+	voice->phase = 0;
+	voice->sweep = voice->startSweep;
+	voice->toneLevel = (patches[drum].toneHz != 0) ? patches[drum].toneLevel * gain : 0;
+	voice->noiseLevel = (patches[drum].noise != DRUM_NOISE_NONE) ? patches[drum].noiseLevel * gain : 0;
+	voice->lowpass = 0;
+	voice->active = (voice->toneLevel >= DRUM_SILENCE || voice->noiseLevel >= DRUM_SILENCE);
+}
+
+
+/*
+ * Returns the number of drums sounding
+ *
+ * @input None
+ * @return Number of active voices
+ *
+ */
+int Drums_ActiveVoices()
+{
+	int count = 0;
+
+	if(drumVoices == NULL)
+		return 0;
+
+	for(int i = 0; i < DRUMS; i++)
+	{
+		if(drumVoices[i].active)
+			count++;
+	}
+	return count;
+}
+
+
+/*
+ * Returns the drum of a pattern letter
+ *
+ * @input letter	K for the kick, S for the snare or H for the hat, in either case
+ * @return Drum of the letter, DRUMS if it is not a drum.
+ *
+ */
+drum_t Drums_FromLetter(char letter)
+{
+	for(int i = 0; i < DRUMS; i++)
+	{
+		if(toupper((unsigned char)letter) == patches[i].letter)
+			return (drum_t)i;
+	}
+	return DRUMS;
+}
+
+
+/*
+ * Returns the name of a drum
+ *
+ * @input drum		Drum
+ * @return Name of the drum
+ *
+ */
+const char* Drums_Name(drum_t drum)
+{
+	if(drum >= DRUMS)
+		return "?";
+	return patches[drum].name;
+}
+
+
+/*
+ * Render a single drum
+ *
+ * The tone is a sine whose phase increment decays to the settled tone. The
+ * noise is high-passed by subtracting a one-pole low-pass. Both parts decay
+ * exponentially until they are silent.
+ *
+ * @input voice		Pointer to the voice
+ * 		  patch		Pointer to the sound of the drum
+ * 		  block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+static void RenderVoice(drum_voice_t* voice, const drum_patch_t* patch, int16_t* block, int offset, int count)
+{
+	uint32_t phase = voice->phase;
+	int32_t sweep = voice->sweep;
+	int32_t toneLevel = voice->toneLevel;
+	int32_t noiseLevel = voice->noiseLevel;
+	int32_t lowpass = voice->lowpass;
+	int32_t sample, noise;
+
+	for(int i = offset; i < offset + count; i++)
+	{
+		sample = 0;
+
+		if(toneLevel != 0)
+		{
+			sample = (fp_sin_phase(phase) * (toneLevel >> 15)) >> 15;
+			phase += voice->increment + sweep;
+			sweep -= (sweep >> 15) * voice->sweepDecay;
+			toneLevel -= (toneLevel >> 15) * voice->toneDecay;
+			if(toneLevel < DRUM_SILENCE)
+				toneLevel = 0;
+		}
+
+		if(noiseLevel != 0)
+		{
+			noise = (patch->noise == DRUM_NOISE_PINK) ? Noise_Pink(&drumNoise) : Noise_White(&drumNoise);
+			lowpass += ((noise - lowpass) * voice->filter) >> 14;
+			sample += ((noise - lowpass) * (noiseLevel >> 15)) >> 15;
+			noiseLevel -= (noiseLevel >> 15) * voice->noiseDecay;
+			if(noiseLevel < DRUM_SILENCE)
+				noiseLevel = 0;
+		}
+
+		if(toneLevel == 0 && noiseLevel == 0)
+		{
+			voice->active = false;
+			break;
+		}
+
+		sample += block[i];
+		if(sample > INT16_MAX)
+			sample = INT16_MAX;
+		else if(sample < INT16_MIN)
+			sample = INT16_MIN;
+		block[i] = sample;
+	}
+
+	voice->phase = phase;
+	voice->sweep = sweep;
+	voice->toneLevel = toneLevel;
+	voice->noiseLevel = noiseLevel;
+	voice->lowpass = lowpass;
+}
+
+
+/*
+ * Render a segment of the current block
+ *
+ * The sounding drums are added to [offset, offset + count) of the block,
+ * saturating the result.
+ *
+ * @input block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+void Drums_Render(int16_t* block, int offset, int count)
+{
+	if(drumVoices == NULL)
+		return;
+
+	for(int i = 0; i < DRUMS; i++)
+	{
+		if(drumVoices[i].active)
+			RenderVoice(&drumVoices[i], &patches[i], block, offset, count);
+	}
+}
@@ -0,0 +1,168 @@
+/*
+ * Echo.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "Echo.h"
+#include "AudioArena.h"
+
+#define GAIN_Q15 (19661) // 0.6 in Q15
+
+// Mu-law (G.711) parameters
+#define MULAW_BIAS (0x84)
+#define MULAW_CLIP (8159)
+#define MULAW_SIGN_BIT (0x80)
+#define MULAW_QUANT_MASK (0x0F)
+#define MULAW_SEG_SHIFT (4)
+#define MULAW_SEG_MASK (0x70)
+#define MULAW_SILENCE (0xFF)
+
+// Upper end of the magnitude of every mu-law segment
+static const int16_t segmentEnds[8] = {0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF};
+
+static uint8_t* delayLine = NULL; // Delay line borrowed from the arena
+static int delayLength = 0;
+static int delayIndex = 0;
+
+
+/*
+ * Encode a sample in mu-law
+ *
+ * @input sample	16-bit sample
+ * @return 8-bit mu-law code
+ *
+ */
+static uint8_t MulawEncode(int32_t sample)
+{
+	uint8_t mask;
+	int segment;
+
+	sample >>= 2; // 14-bit magnitude
+	if(sample < 0)
+	{
+		sample = -sample;
+		mask = 0x7F;
+	}
+	else
+	{
+		mask = 0xFF;
+	}
+
+	if(sample > MULAW_CLIP)
+		sample = MULAW_CLIP;
+	sample += (MULAW_BIAS >> 2);
+
+	for(segment = 0; segment < 8; segment++)
+	{
+		if(sample <= segmentEnds[segment])
+			break;
+	}
+
+	// Out of range, the largest code
+	if(segment == 8)
+		return 0x7F ^ mask;
+
+	return ((segment << MULAW_SEG_SHIFT) | ((sample >> (segment + 1)) & MULAW_QUANT_MASK)) ^ mask;
+}
+
+
+/*
+ * Decode a mu-law sample
+ *
+ * @input code		8-bit mu-law code
+ * @return 16-bit sample
+ *
+ */
+static int32_t MulawDecode(uint8_t code)
+{
+	int32_t magnitude;
+
+	code = ~code;
+	magnitude = ((code & MULAW_QUANT_MASK) << 3) + MULAW_BIAS;
+	magnitude <<= (code & MULAW_SEG_MASK) >> MULAW_SEG_SHIFT;
+
+	return (code & MULAW_SIGN_BIT) ? (MULAW_BIAS - magnitude) : (magnitude - MULAW_BIAS);
+}
+
+
+/*
+ * Initialize the echo effect
+ *
+ * Borrows the delay line from the audio arena. The delay line is stored as
+ * 8-bit mu-law, which keeps the quiet tails of the echo smooth at half the
+ * memory of 16-bit samples.
+ *
+ * @input delaySamples	Length of the delay line in samples
+ * @return True if the delay line could be allocated, else False.
+ *
+ */
+bool Echo_Init(int delaySamples)
+{
+	delayLine = (delaySamples > 0) ? Arena_Alloc(ARENA_ECHO, delaySamples, 1) : NULL;
+	if(delayLine == NULL)
+	{
+		delayLength = 0;
+		return false;
+	}
+
+	delayLength = delaySamples;
+	Echo_Clear();
+	return true;
+}
+
+
+/*
+ * Clear the delay line
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Echo_Clear()
+{
+	if(delayLine != NULL)
+		memset(delayLine, MULAW_SILENCE, delayLength);
+	delayIndex = 0;
+}
+
+
+/*
+ * Apply the echo effect on a block
+ *
+ * Contains the implementation of a feedback delay line, where every sample
+ * is repeated after the delay with diminishing volume.
+ *
+ * @input block		Pointer to the samples to be processed in place
+ * 		  count		Number of samples
+ * @return None
+ *
+ */
+void Echo_Process(int16_t* block, int count)
+{
+	int32_t sample;
+
+	if(delayLine == NULL)
+		return;
+
+	for(int i = 0; i < count; i++)
+	{
+		sample = block[i] + ((MulawDecode(delayLine[delayIndex]) * GAIN_Q15) >> 15);
+
+		if(sample > INT16_MAX)
+			sample = INT16_MAX;
+		else if(sample < INT16_MIN)
+			sample = INT16_MIN;
+
+		block[i] = sample;
+		delayLine[delayIndex] = MulawEncode(sample);
+
+		delayIndex++;
+		if(delayIndex == delayLength)
+			delayIndex = 0;
+	}
+}
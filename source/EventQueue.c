@@ -0,0 +1,203 @@
+/*
+ * EventQueue.c - Fixed size queue of timestamped note events
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+
+#include "EventQueue.h"
+#include "MKL25Z4.h"
+
+#define EVENT_INDEX_MASK (EVENT_QUEUE_SIZE - 1)
+
+static note_event_t events[EVENT_QUEUE_SIZE];
+static volatile uint16_t readIndex = 0; // Oldest event
+static volatile uint16_t writeIndex = 0; // Next free slot
+static volatile uint16_t length = 0; // Number of events in the queue
+
+
+/*
+ * Enqueue an event
+ *
+ * The whole event is copied into the queue atomically. Events have to be
+ * enqueued in the order of their timestamps.
+ *
+ * @input event		Pointer to the event
+ * @return True if the event was enqueued, false if the queue is full.
+ *
+ */
+bool EventQueue_Enqueue(const note_event_t* event)
+{
+	bool enqueued = false;
+
+	if(event == NULL)
+		return false;
+
+	uint32_t maskingState;
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+
+	if(length < EVENT_QUEUE_SIZE)
+	{
+		events[writeIndex] = *event;
+		writeIndex = (writeIndex + 1) & EVENT_INDEX_MASK;
+		length++;
+		enqueued = true;
+	}
+
+	__set_PRIMASK(maskingState);
+	return enqueued;
+}
+
+
+/*
+ * Insert an event in the order of the timestamps
+ *
+ * The event goes after the queued events which are not later than it, so
+ * an event for the current time is played before the events queued for
+ * the future. Takes the time of moving the later events with interrupts
+ * disabled.
+ *
+ * @input event		Pointer to the event
+ * @return True if the event was inserted, false if the queue is full.
+ *
+ */
+bool EventQueue_Insert(const note_event_t* event)
+{
+	bool inserted = false;
+	uint16_t index, previous;
+
+	if(event == NULL)
+		return false;
+
+	uint32_t maskingState;
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+
+	if(length < EVENT_QUEUE_SIZE)
+	{
+		// Move the later events back by a slot, from the newest
+		index = writeIndex;
+		for(int i = 0; i < length; i++)
+		{
+			previous = (index - 1) & EVENT_INDEX_MASK;
+			if((int32_t)(events[previous].timestamp - event->timestamp) <= 0)
+				break;
+			events[index] = events[previous];
+			index = previous;
+		}
+
+		events[index] = *event;
+		writeIndex = (writeIndex + 1) & EVENT_INDEX_MASK;
+		length++;
+		inserted = true;
+	}
+
+	__set_PRIMASK(maskingState);
+	return inserted;
+}
+
+
+/*
+ * Read the oldest event without removing it
+ *
+ * @input event		Pointer to store the event
+ * @return True if an event was available, else False.
+ *
+ */
+bool EventQueue_Peek(note_event_t* event)
+{
+	bool available = false;
+
+	uint32_t maskingState;
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+
+	if(length > 0)
+	{
+		*event = events[readIndex];
+		available = true;
+	}
+
+	__set_PRIMASK(maskingState);
+	return available;
+}
+
+
+/*
+ * Dequeue the oldest event
+ *
+ * The whole event is copied out of the queue atomically.
+ *
+ * @input event		Pointer to store the event
+ * @return True if an event was dequeued, else False.
+ *
+ */
+bool EventQueue_Dequeue(note_event_t* event)
+{
+	bool dequeued = false;
+
+	uint32_t maskingState;
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+
+	if(length > 0)
+	{
+		*event = events[readIndex];
+		readIndex = (readIndex + 1) & EVENT_INDEX_MASK;
+		length--;
+		dequeued = true;
+	}
+
+	__set_PRIMASK(maskingState);
+	return dequeued;
+}
+
+
+/*
+ * Returns the number of events in the queue
+ *
+ * @input None
+ * @return Number of events waiting to be consumed
+ *
+ */
+int EventQueue_Length()
+{
+	return length;
+}
+
+
+/*
+ * Returns the number of free slots in the queue
+ *
+ * @input None
+ * @return Number of events which can still be enqueued
+ *
+ */
+int EventQueue_Space()
+{
+	return EVENT_QUEUE_SIZE - length;
+}
+
+
+/*
+ * Remove all the events from the queue
+ *
+ * @input None
+ * @return None
+ *
+ */
+void EventQueue_Clear()
+{
+	uint32_t maskingState;
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+
+	readIndex = 0;
+	writeIndex = 0;
+	length = 0;
+
+	__set_PRIMASK(maskingState);
+}
@@ -0,0 +1,598 @@
+/*
+ * HostLink.c - Binary framed control protocol over UART0
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "HostLink.h"
+#include "Crc16.h"
+#include "AudioOut.h"
+#include "EventQueue.h"
+#include "Synth.h"
+#include "Sampler.h"
+#include "Drums.h"
+#include "Song.h"
+#include "SysTick.h"
+#include "UART_IO.h"
+
+// Frame bytes besides the payload
+#define LINK_HEADER_LENGTH (3) // Sync, length and opcode
+
+static const uint8_t magic[LINK_MAGIC_LENGTH] = {0xA5, 0x5A, 0xC3, 0x3C};
+
+// Received bytes, the head is only written by the UART interrupt and the
+// tail only by the main loop
+static uint8_t buffer[LINK_BUFFER_SIZE];
+static volatile uint32_t head = 0;
+static volatile uint32_t tail = 0;
+
+static volatile bool active = false;
+static volatile bool helloPending = false; // Set until the hello frame is sent
+static bool flashPending = false; // A song frame waits to program the flash after a block
+static volatile ticktime_t lastReceived = 0;
+
+// States of the frame parser
+typedef enum {
+	PARSE_SYNC,
+	PARSE_LENGTH,
+	PARSE_OPCODE,
+	PARSE_PAYLOAD,
+	PARSE_CRC_LOW,
+	PARSE_CRC_HIGH
+} parse_state_t;
+
+static parse_state_t state = PARSE_SYNC;
+static uint8_t length;
+static uint8_t opcode;
+static uint8_t payload[LINK_MAX_PAYLOAD];
+static uint8_t received; // Payload bytes received
+static uint16_t crc;
+static uint8_t crcLow;
+
+static link_stats_t stats;
+
+
+/*
+ * Store a 32 bit value little endian
+ *
+ * @input bytes		Pointer to the four bytes
+ * 		  value		Value
+ * @return None
+ *
+ */
+static void PutU32(uint8_t* bytes, uint32_t value)
+{
+	bytes[0] = value;
+	bytes[1] = value >> 8;
+	bytes[2] = value >> 16;
+	bytes[3] = value >> 24;
+}
+
+
+/*
+ * Send a frame to the host
+ *
+ * @input op		Opcode
+ * 		  data		Pointer to the payload
+ * 		  count		Number of payload bytes (up to LINK_MAX_PAYLOAD)
+ * @return None
+ *
+ */
+static void SendFrame(uint8_t op, const uint8_t* data, uint8_t count)
+{
+	uint8_t frame[LINK_MAX_PAYLOAD + LINK_OVERHEAD];
+	uint16_t frameCrc;
+	int i;
+
+	frame[0] = LINK_SYNC;
+	frame[1] = count;
+	frame[2] = op;
+	for(i = 0; i < count; i++)
+	{
+		frame[LINK_HEADER_LENGTH + i] = data[i];
+	}
+	// The sync byte is not covered
+	frameCrc = Crc16_Update(CRC16_INIT, &frame[1], LINK_HEADER_LENGTH - 1 + count);
+	i = LINK_HEADER_LENGTH + count;
+	frame[i++] = frameCrc;
+	frame[i++] = frameCrc >> 8;
+
+	__sys_write(0, (char*)frame, i);
+}
+
+
+/*
+ * Report an error to the host
+ *
+ * @input error		One of link_error_t
+ * 		  op		Opcode of the frame
+ * @return None
+ *
+ */
+static void SendError(uint8_t error, uint8_t op)
+{
+	uint8_t data[2] = {error, op};
+
+	if(error == LINK_ERROR_CRC)
+		stats.crcErrors++;
+	else
+		stats.errors++;
+	SendFrame(LINK_OP_ERROR, data, sizeof(data));
+}
+
+
+/*
+ * Receive a byte of the link
+ *
+ * Called by the UART0 interrupt for every received byte.
+ *
+ * @input ch	Received byte
+ * @return None
+ *
+ */
+static void ReceiveByte(uint8_t ch)
+{
+	lastReceived = now();
+
+	if(head - tail >= LINK_BUFFER_SIZE)
+	{
+		stats.overruns++;
+		return;
+	}
+
+	buffer[head & (LINK_BUFFER_SIZE - 1)] = ch;
+	head++;
+}
+
+
+/*
+ * Start the link when the console received the magic sequence
+ *
+ * Called by the UART0 interrupt.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void StartLink()
+{
+	head = 0;
+	tail = 0;
+	state = PARSE_SYNC;
+	flashPending = false;
+
+	stats = (link_stats_t){0};
+	stats.active = true;
+
+	lastReceived = now();
+	helloPending = true;
+	active = true;
+	UART0_SetReceiveHandler(&ReceiveByte);
+}
+
+
+/*
+ * Give the UART back to the console
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void StopLink()
+{
+	UART0_SetReceiveHandler(NULL);
+	active = false;
+	flashPending = false;
+	stats.active = false;
+}
+
+
+/*
+ * Initialize the link
+ *
+ * Watches the console for the magic sequence. The console keeps working
+ * until a host sends it.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void HostLink_Init()
+{
+	UART0_SetSequenceHandler(magic, LINK_MAGIC_LENGTH, &StartLink);
+}
+
+
+/*
+ * Queue an event at the current time, before the events queued for later
+ *
+ * @input type		One of event_type_t
+ * 		  key		Key of the event
+ * 		  value		Value of the event
+ * @return None
+ *
+ */
+static void QueueEvent(uint8_t type, uint8_t key, uint16_t value)
+{
+	note_event_t event;
+
+	event.timestamp = AudioOut_GetSampleTime();
+	event.type = type;
+	event.key = key;
+	event.value = value;
+
+	if(!EventQueue_Insert(&event))
+		SendError(LINK_ERROR_BUSY, opcode);
+}
+
+
+/*
+ * Answer a stats frame
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void SendStats()
+{
+	uint8_t data[LINK_STATS_LENGTH];
+	audio_stats_t audio;
+
+	AudioOut_GetStats(&audio, false);
+	PutU32(&data[0], stats.frames);
+	PutU32(&data[4], stats.crcErrors);
+	PutU32(&data[8], stats.errors);
+	PutU32(&data[12], stats.overruns);
+	PutU32(&data[16], audio.blocksRendered);
+	PutU32(&data[20], audio.renderCycles);
+	PutU32(&data[24], audio.dmaInterrupts);
+	data[28] = Synth_ActiveVoices() + Sampler_ActivePlayers() + Drums_ActiveVoices();
+	data[29] = audio.idle;
+	SendFrame(LINK_OP_STATS | LINK_OP_REPLY, data, sizeof(data));
+}
+
+
+/*
+ * Answer a baud frame and switch to the rate asked for
+ *
+ * The host has to send a frame at the new rate within
+ * UART_BAUD_CONFIRM_TICKS, else the last rate is restored.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void SwitchBaud()
+{
+	uint8_t data[LINK_BAUD_LENGTH];
+	uart_baud_t setting;
+	uint32_t baudRate = payload[0] | (payload[1] << 8) | (payload[2] << 16) | ((uint32_t)payload[3] << 24);
+
+	if(!UART0_FindBaud(baudRate, &setting))
+	{
+		SendError(LINK_ERROR_VALUE, opcode);
+		return;
+	}
+
+	PutU32(&data[0], setting.actual);
+	PutU32(&data[4], (uint32_t)setting.error);
+	SendFrame(LINK_OP_BAUD | LINK_OP_REPLY, data, sizeof(data));
+	UART0_SwitchBaud(&setting);
+}
+
+
+/*
+ * Handle a frame of the song
+ *
+ * Erases and the commit are answered once done, so the host waits for
+ * them. The data is not answered, a ping after the data of a sector tells
+ * the host it is written.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void HandleSong()
+{
+	song_header_t header;
+	uint16_t value = payload[0] | (payload[1] << 8);
+	bool done = false;
+
+	switch(opcode)
+	{
+	case LINK_OP_SONG_ERASE:
+		done = Song_Erase(payload[0]);
+		if(done)
+			SendFrame(LINK_OP_SONG_ERASE | LINK_OP_REPLY, payload, length);
+		break;
+	case LINK_OP_SONG_DATA:
+		done = (length > 2 && Song_Write(value, &payload[2], length - 2));
+		break;
+	case LINK_OP_SONG_COMMIT:
+		memcpy(&header, payload, sizeof(header));
+		done = Song_Commit(&header);
+		if(done)
+			SendFrame(LINK_OP_SONG_COMMIT | LINK_OP_REPLY, NULL, 0);
+		break;
+	case LINK_OP_SONG_PLAY:
+		done = true;
+		if(value == 0xFFFF)
+			Song_Stop();
+		else
+			done = Song_Start(value);
+		break;
+	default:
+		break;
+	}
+
+	if(!done)
+		SendError(LINK_ERROR_VALUE, opcode);
+}
+
+
+/*
+ * Execute a received frame
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void ExecuteFrame()
+{
+	// Payload length of every opcode, -1 for any
+	int expected = 0;
+	uint16_t value;
+
+	switch(opcode)
+	{
+	case LINK_OP_PING:
+		expected = -1;
+		break;
+	case LINK_OP_BAUD:
+		expected = 4;
+		break;
+	case LINK_OP_NOTE_ON:
+	case LINK_OP_DRUM:
+	case LINK_OP_TEMPO:
+		expected = 2;
+		break;
+	case LINK_OP_NOTE_OFF:
+	case LINK_OP_SONG_ERASE:
+		expected = 1;
+		break;
+	case LINK_OP_SONG_PLAY:
+		expected = 2;
+		break;
+	case LINK_OP_SONG_DATA:
+		expected = -1;
+		break;
+	case LINK_OP_SONG_COMMIT:
+		expected = SONG_HEADER_SIZE;
+		break;
+	case LINK_OP_PARAMETER:
+		expected = 3;
+		break;
+	case LINK_OP_STATS:
+	case LINK_OP_BYE:
+	case LINK_OP_ALL_NOTES_OFF:
+		break;
+	default:
+		SendError(LINK_ERROR_OPCODE, opcode);
+		return;
+	}
+
+	if(expected >= 0 && length != expected)
+	{
+		SendError(LINK_ERROR_LENGTH, opcode);
+		return;
+	}
+	stats.frames++;
+	// An intact frame shows that the host follows a new baud rate
+	UART0_ConfirmBaud();
+
+	switch(opcode)
+	{
+	case LINK_OP_PING:
+		SendFrame(LINK_OP_PING | LINK_OP_REPLY, payload, length);
+		break;
+	case LINK_OP_STATS:
+		SendStats();
+		break;
+	case LINK_OP_BYE:
+		SendFrame(LINK_OP_BYE | LINK_OP_REPLY, NULL, 0);
+		StopLink();
+		break;
+	case LINK_OP_BAUD:
+		SwitchBaud();
+		break;
+	case LINK_OP_NOTE_ON:
+		if(payload[0] > 127 || payload[1] == 0 || payload[1] > SYNTH_MAX_VELOCITY)
+			SendError(LINK_ERROR_VALUE, opcode);
+		else
+			QueueEvent(EVENT_NOTE_ON, payload[0], payload[1]);
+		break;
+	case LINK_OP_NOTE_OFF:
+		QueueEvent(EVENT_NOTE_OFF, payload[0], 0);
+		break;
+	case LINK_OP_ALL_NOTES_OFF:
+		QueueEvent(EVENT_REST, 0, 0);
+		break;
+	case LINK_OP_DRUM:
+		if(payload[0] >= DRUMS)
+			SendError(LINK_ERROR_VALUE, opcode);
+		else
+			QueueEvent(EVENT_DRUM, payload[0], payload[1]);
+		break;
+	case LINK_OP_PARAMETER:
+		value = payload[1] | (payload[2] << 8);
+		QueueEvent(EVENT_PARAMETER, payload[0], value);
+		break;
+	case LINK_OP_TEMPO:
+		value = payload[0] | (payload[1] << 8);
+		if(value == 0)
+			SendError(LINK_ERROR_VALUE, opcode);
+		else
+			QueueEvent(EVENT_TEMPO, 0, value);
+		break;
+	case LINK_OP_SONG_DATA:
+	case LINK_OP_SONG_COMMIT:
+		// Programmed by HostLink_ProgramFlash(), the frames after it wait
+		flashPending = true;
+		break;
+	case LINK_OP_SONG_ERASE:
+	case LINK_OP_SONG_PLAY:
+		HandleSong();
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*
+ * Parse a byte of a frame
+ *
+ * Bytes outside of a frame are skipped until the next sync byte.
+ *
+ * @input ch	Received byte
+ * @return None
+ *
+ */
+static void ParseByte(uint8_t ch)
+{
+	switch(state)
+	{
+	case PARSE_SYNC:
+		if(ch == LINK_SYNC)
+			state = PARSE_LENGTH;
+		break;
+	case PARSE_LENGTH:
+		// A wrong length can't be a frame, start looking for one again
+		if(ch > LINK_MAX_PAYLOAD)
+		{
+			state = (ch == LINK_SYNC) ? PARSE_LENGTH : PARSE_SYNC;
+			break;
+		}
+		length = ch;
+		received = 0;
+		crc = Crc16_Byte(CRC16_INIT, ch);
+		state = PARSE_OPCODE;
+		break;
+	case PARSE_OPCODE:
+		opcode = ch;
+		crc = Crc16_Byte(crc, ch);
+		state = (length > 0) ? PARSE_PAYLOAD : PARSE_CRC_LOW;
+		break;
+	case PARSE_PAYLOAD:
+		payload[received++] = ch;
+		crc = Crc16_Byte(crc, ch);
+		if(received == length)
+			state = PARSE_CRC_LOW;
+		break;
+	case PARSE_CRC_LOW:
+		crcLow = ch;
+		state = PARSE_CRC_HIGH;
+		break;
+	case PARSE_CRC_HIGH:
+		state = PARSE_SYNC;
+		if(crc != (crcLow | (ch << 8)))
+			SendError(LINK_ERROR_CRC, opcode);
+		else
+			ExecuteFrame();
+		break;
+	}
+}
+
+
+/*
+ * Handle the received frames
+ *
+ * Called by the main loop. Notes, drums, parameters and tempo changes are
+ * played at the next block, before the tones queued for later. A song
+ * data or commit frame stops the parsing until HostLink_ProgramFlash()
+ * has written it. The console is given back after a bye frame, or when
+ * no data arrived for LINK_TIMEOUT_TICKS.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void HostLink_Process()
+{
+	uint8_t hello[6];
+	uint8_t ch;
+
+	if(!active)
+		return;
+
+	if(helloPending)
+	{
+		helloPending = false;
+		hello[0] = LINK_VERSION;
+		hello[1] = LINK_MAX_PAYLOAD;
+		PutU32(&hello[2], AudioOut_GetSampleRate());
+		SendFrame(LINK_OP_HELLO | LINK_OP_REPLY, hello, sizeof(hello));
+	}
+
+	while(active && !flashPending && tail != head)
+	{
+		ch = buffer[tail & (LINK_BUFFER_SIZE - 1)];
+		tail++;
+		ParseByte(ch);
+	}
+
+	if(active && now() - lastReceived > LINK_TIMEOUT_TICKS)
+		StopLink();
+}
+
+
+/*
+ * Program the flash for a received song frame
+ *
+ * Every program unit holds the interrupts off for about 65 us, so the
+ * main loop calls this right after a block is rendered, or while the
+ * output is idle: the data of a frame is written before the next DMA
+ * interrupt is due, and the blocks keep their timing.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void HostLink_ProgramFlash()
+{
+	if(!flashPending)
+		return;
+
+	flashPending = false;
+	HandleSong();
+}
+
+
+/*
+ * Check if the link is active
+ *
+ * @input None
+ * @return True if a host has taken the UART, else False.
+ *
+ */
+bool HostLink_IsActive()
+{
+	return active;
+}
+
+
+/*
+ * Get the statistics of the last or current link
+ *
+ * @input stats		Pointer to store the statistics
+ * @return None
+ *
+ */
+void HostLink_GetStats(link_stats_t* out)
+{
+	*out = stats;
+}
@@ -0,0 +1,170 @@
+/*
+ * Lfo.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stdint.h>
+
+#include "Lfo.h"
+#include "AudioOut.h"
+#include "fp_trig.h"
+
+// Rate at which the LFOs are updated (once per block)
+#define LFO_CONTROL_RATE (AudioOut_GetSampleRate() >> AUDIO_BLOCK_SHIFT)
+
+// Frequency deviation of one cent in Q15 (ln(2) / 1200)
+#define Q15_PER_CENT (19)
+
+#define Q15_ONE (32767)
+
+// State of a single low frequency oscillator
+typedef struct lfo_s
+{
+	uint32_t phase; // Phase accumulator
+	uint32_t phaseIncrement; // Phase advance per block
+	uint8_t rateHz; // Frequency of the oscillator
+	int32_t depth; // Depth in Q15
+	int32_t start; // Modulation value at the start of the block
+	int32_t end; // Modulation value at the end of the block
+	uint8_t depthSetting; // Depth as configured, in cents or percent
+} lfo_t;
+
+static lfo_t lfos[LFO_COUNT] = {
+		{0, 0, 0, 0, 0, 0},
+		{0, 0, 0, 0, Q15_ONE, Q15_ONE},
+};
+
+
+/*
+ * Calculate the modulation value
+ *
+ * Contains the implementation to map the current LFO phase to the
+ * value used by the renderer for the given target.
+ *
+ * @input target	Modulated parameter
+ * @return Modulation value in Q15
+ *
+ */
+static int32_t Lfo_Value(lfo_target_t target)
+{
+	lfo_t* lfo = &lfos[target];
+	int32_t sine = fp_sin_phase(lfo->phase);
+
+	if(target == LFO_VIBRATO)
+		return (sine * lfo->depth) >> 15;
+
+	// Tremolo swings the gain between 1 - depth and 1
+	return Q15_ONE - ((lfo->depth * (sine + 32768)) >> 16);
+}
+
+
+/*
+ * Initialize the LFOs for the current sampling rate
+ *
+ * Recalculates the phase increments, as the control rate follows the
+ * sampling rate.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Lfo_Init()
+{
+	for(int i = 0; i < LFO_COUNT; i++)
+	{
+		lfos[i].phaseIncrement = (uint32_t)(((uint64_t)lfos[i].rateHz << 32) / LFO_CONTROL_RATE);
+	}
+}
+
+
+/*
+ * Configure an LFO
+ *
+ * Sets the rate and depth of the oscillator modulating the given target.
+ * A depth of 0 disables the modulation.
+ *
+ * @input target	Parameter to be modulated
+ * 		  rateHz	Frequency of the oscillator in Hz
+ * 		  depth		Depth in cents for vibrato, in percent for tremolo
+ * @return None
+ *
+ */
+void Lfo_Configure(lfo_target_t target, uint8_t rateHz, uint8_t depth)
+{
+	lfo_t* lfo = &lfos[target];
+
+	if(rateHz > LFO_MAX_RATE)
+		rateHz = LFO_MAX_RATE;
+
+	lfo->rateHz = rateHz;
+	lfo->depthSetting = depth;
+	lfo->phaseIncrement = (uint32_t)(((uint64_t)rateHz << 32) / LFO_CONTROL_RATE);
+
+	if(target == LFO_VIBRATO)
+		lfo->depth = depth * Q15_PER_CENT;
+	else
+		lfo->depth = (depth * Q15_ONE) / 100;
+
+	if(lfo->depth == 0)
+		lfo->phase = 0;
+}
+
+
+/*
+ * Get the settings of an LFO
+ *
+ * @input target	Modulated parameter
+ * 		  rateHz	Pointer to store the frequency in Hz
+ * 		  depth		Pointer to store the depth in cents or percent, 0 if disabled
+ * @return None
+ *
+ */
+void Lfo_GetSettings(lfo_target_t target, uint8_t* rateHz, uint8_t* depth)
+{
+	*rateHz = lfos[target].rateHz;
+	*depth = lfos[target].depthSetting;
+}
+
+
+/*
+ * Advance the LFOs by one block
+ *
+ * Called once per rendered block (control rate). The value at the end of the
+ * previous block becomes the start of the new block.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Lfo_Update()
+{
+	for(int i = 0; i < LFO_COUNT; i++)
+	{
+		lfos[i].phase += lfos[i].phaseIncrement;
+		lfos[i].start = lfos[i].end;
+		lfos[i].end = Lfo_Value(i);
+	}
+}
+
+
+/*
+ * Get the modulation over the current block
+ *
+ * Returns the modulation values at the start and the end of the current block,
+ * so the renderer can interpolate in between.
+ * For vibrato, the value is the deviation of the frequency in Q15.
+ * For tremolo, the value is the gain in Q15.
+ *
+ * @input target	Modulated parameter
+ * 		  start		Pointer to store the value at the start of the block
+ * 		  end		Pointer to store the value at the end of the block
+ * @return None
+ *
+ */
+void Lfo_GetSegment(lfo_target_t target, int32_t* start, int32_t* end)
+{
+	*start = lfos[target].start;
+	*end = lfos[target].end;
+}
@@ -0,0 +1,461 @@
+/*
+ * Midi.c - MIDI input over UART0
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+
+#include "Midi.h"
+#include "AudioOut.h"
+#include "Drums.h"
+#include "Lfo.h"
+#include "SysTick.h"
+#include "UART_IO.h"
+
+// Status bytes of the channel messages, the low nibble is the channel
+#define STATUS_NOTE_OFF (0x80)
+#define STATUS_NOTE_ON (0x90)
+#define STATUS_POLY_PRESSURE (0xA0)
+#define STATUS_CONTROL (0xB0)
+#define STATUS_PROGRAM (0xC0)
+#define STATUS_PRESSURE (0xD0)
+#define STATUS_PITCH_BEND (0xE0)
+
+// System messages
+#define SYSEX_START (0xF0)
+#define TIME_CODE (0xF1)
+#define SONG_POSITION (0xF2)
+#define SONG_SELECT (0xF3)
+#define SYSEX_END (0xF7)
+#define REALTIME_FIRST (0xF8) // Real time messages may come between any bytes
+#define CLOCK (0xF8)
+#define START (0xFA)
+#define CONTINUE (0xFB)
+#define STOP (0xFC)
+#define SYSTEM_RESET (0xFF)
+
+// Controllers
+#define CC_MODULATION (1)
+#define CC_ALL_SOUND_OFF (120)
+#define CC_ALL_NOTES_OFF (123)
+
+// Rate of the vibrato of the modulation wheel, the wheel sets its depth
+#define MODULATION_RATE_HZ (5)
+
+// Leaves MIDI when received outside of a message, so the console can be
+// taken back from a terminal
+#define CONSOLE_ESCAPE (0x1B)
+
+// Range of the tempo taken from the clock, and the change needed to
+// follow it in 1/16 beats per minute, which keeps the jitter of the
+// clock from toggling the tempo
+#define CLOCK_MIN_TEMPO (20)
+#define CLOCK_MAX_TEMPO (300)
+#define CLOCK_HYSTERESIS (12)
+#define CYCLES_PER_MINUTE (60UL * CYCLES_PER_TICK * TICKS_PER_SECOND)
+
+// Events for the next block, the head is only written by the UART
+// interrupt and the tail only by the renderer
+static note_event_t queue[MIDI_QUEUE_SIZE];
+static volatile uint32_t head = 0;
+static volatile uint32_t tail = 0;
+
+static volatile bool active = false;
+static uint8_t listenChannel = MIDI_OMNI;
+
+// Parser state
+static uint8_t runningStatus = 0; // Status of the message being received, 0 if none
+static uint8_t data[2]; // Data bytes received for the message
+static uint8_t dataCount = 0;
+static bool inSysex = false;
+
+// Clock state, the beat is timed from every 24th clock
+static uint8_t clockCount = 0;
+static bool beatTimed = false; // Set once a beat has started
+static uint32_t beatStart; // Time of the clock starting the beat in cycles
+static uint32_t clockTempoQ4 = 0; // Tempo followed, in 1/16 beats per minute
+
+static midi_stats_t stats;
+
+
+/*
+ * Queue an event for the next block
+ *
+ * @input type		One of event_type_t
+ * 		  key		Key of the event
+ * 		  value		Value of the event
+ * @return None
+ *
+ */
+static void Push(uint8_t type, uint8_t key, uint16_t value)
+{
+	note_event_t* event;
+
+	if(head - tail >= MIDI_QUEUE_SIZE)
+	{
+		stats.dropped++;
+		return;
+	}
+
+	event = &queue[head & (MIDI_QUEUE_SIZE - 1)];
+	event->timestamp = AudioOut_GetSampleTime();
+	event->type = type;
+	event->key = key;
+	event->value = value;
+	head++;
+}
+
+
+/*
+ * Returns the number of data bytes of a message
+ *
+ * @input status	Status byte
+ * @return Number of data bytes
+ *
+ */
+static int DataLength(uint8_t status)
+{
+	switch(status & 0xF0)
+	{
+	case STATUS_PROGRAM:
+	case STATUS_PRESSURE:
+		return 1;
+	case 0xF0:
+		if(status == TIME_CODE || status == SONG_SELECT)
+			return 1;
+		return (status == SONG_POSITION) ? 2 : 0;
+	default:
+		return 2;
+	}
+}
+
+
+/*
+ * Returns the drum of a General MIDI percussion note
+ *
+ * @input note		Note on the percussion channel
+ * @return Drum of the note, DRUMS if there is none.
+ *
+ */
+static drum_t DrumOfNote(uint8_t note)
+{
+	switch(note)
+	{
+	case 35: // Acoustic bass drum
+	case 36: // Bass drum
+		return DRUM_KICK;
+	case 37: // Side stick
+	case 38: // Acoustic snare
+	case 39: // Hand clap
+	case 40: // Electric snare
+		return DRUM_SNARE;
+	case 42: // Closed hi-hat
+	case 44: // Pedal hi-hat
+	case 46: // Open hi-hat
+		return DRUM_HAT;
+	default:
+		return DRUMS;
+	}
+}
+
+
+/*
+ * Leave MIDI from the interrupt and give the UART back to the console
+ *
+ * The notes still sounding are released.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void StopMidi()
+{
+	UART0_SetReceiveHandler(NULL);
+	Push(EVENT_REST, 0, 0);
+	active = false;
+	stats.active = false;
+}
+
+
+/*
+ * Time the beat with a clock message
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void Clock()
+{
+	uint32_t time = get_cycles();
+	uint32_t cycles, tempoQ4;
+
+	stats.clocks++;
+	if(clockCount++ > 0)
+	{
+		if(clockCount >= MIDI_CLOCKS_PER_BEAT)
+			clockCount = 0;
+		return;
+	}
+
+	if(beatTimed)
+	{
+		cycles = time - beatStart;
+		tempoQ4 = (CYCLES_PER_MINUTE + cycles / 32) / (cycles / 16);
+
+		if(tempoQ4 >= (CLOCK_MIN_TEMPO << 4) && tempoQ4 <= (CLOCK_MAX_TEMPO << 4) &&
+				(tempoQ4 > clockTempoQ4 + CLOCK_HYSTERESIS || tempoQ4 + CLOCK_HYSTERESIS < clockTempoQ4))
+		{
+			clockTempoQ4 = tempoQ4;
+			stats.clockTempo = (tempoQ4 + 8) >> 4;
+			Push(EVENT_TEMPO, 0, stats.clockTempo);
+		}
+	}
+	beatStart = time;
+	beatTimed = true;
+}
+
+
+/*
+ * Handle a real time message
+ *
+ * @input status	Status byte, REALTIME_FIRST or above
+ * @return None
+ *
+ */
+static void RealTime(uint8_t status)
+{
+	switch(status)
+	{
+	case CLOCK:
+		Clock();
+		break;
+	case START:
+	case CONTINUE:
+		// The sequencer has no song position, it restarts either way
+		clockCount = 0;
+		beatTimed = false;
+		Push(EVENT_PARAMETER, AUDIO_PARAM_SEQUENCER, 1);
+		break;
+	case STOP:
+		Push(EVENT_PARAMETER, AUDIO_PARAM_SEQUENCER, 0);
+		break;
+	case SYSTEM_RESET:
+		StopMidi();
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*
+ * Handle a complete channel message
+ *
+ * @input status	Status byte
+ * 		  first		First data byte
+ * 		  second	Second data byte, 0 for messages with one
+ * @return None
+ *
+ */
+static void ChannelMessage(uint8_t status, uint8_t first, uint8_t second)
+{
+	uint8_t channel = (status & 0x0F) + 1;
+	drum_t drum;
+
+	if(listenChannel != MIDI_OMNI && channel != listenChannel)
+		return;
+	stats.messages++;
+
+	switch(status & 0xF0)
+	{
+	case STATUS_NOTE_ON:
+		if(second != 0)
+		{
+			if(channel != MIDI_DRUM_CHANNEL)
+			{
+				Push(EVENT_NOTE_ON, first, second);
+				break;
+			}
+			drum = DrumOfNote(first);
+			if(drum != DRUMS)
+				Push(EVENT_DRUM, drum, second);
+			break;
+		}
+		// Velocity 0 is a note off
+		// Falls through
+	case STATUS_NOTE_OFF:
+		if(channel != MIDI_DRUM_CHANNEL)
+			Push(EVENT_NOTE_OFF, first, 0);
+		break;
+	case STATUS_CONTROL:
+		if(first == CC_MODULATION)
+			Push(EVENT_PARAMETER, AUDIO_PARAM_VIBRATO,
+					(MODULATION_RATE_HZ << 8) | ((second * LFO_MAX_VIBRATO_DEPTH) / 127));
+		else if(first == CC_ALL_SOUND_OFF || first == CC_ALL_NOTES_OFF)
+			Push(EVENT_REST, 0, 0);
+		break;
+	case STATUS_PITCH_BEND:
+		Push(EVENT_PARAMETER, AUDIO_PARAM_PITCH_BEND, ((uint16_t)second << 7) | first);
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*
+ * Parse a received byte
+ *
+ * Channel messages keep their status for the following messages (running
+ * status), system messages cancel it. System exclusive data is skipped.
+ *
+ * @input byte		Received byte
+ * @return None
+ *
+ */
+void Midi_ReceiveByte(uint8_t byte)
+{
+	stats.bytesReceived++;
+
+	if(byte >= REALTIME_FIRST)
+	{
+		RealTime(byte);
+		return;
+	}
+
+	if(byte & 0x80)
+	{
+		inSysex = (byte == SYSEX_START);
+		runningStatus = (byte == SYSEX_END || DataLength(byte) == 0) ? 0 : byte;
+		dataCount = 0;
+		return;
+	}
+
+	if(inSysex)
+		return;
+
+	if(runningStatus == 0)
+	{
+		if(byte == CONSOLE_ESCAPE)
+			StopMidi();
+		return;
+	}
+
+	data[dataCount++] = byte;
+	if(dataCount < DataLength(runningStatus))
+		return;
+	dataCount = 0;
+
+	if(runningStatus >= SYSEX_START)
+	{
+		// Song position and selection and time code are not followed
+		runningStatus = 0;
+		return;
+	}
+	ChannelMessage(runningStatus, data[0], (DataLength(runningStatus) == 2) ? data[1] : 0);
+}
+
+
+/*
+ * Start listening to MIDI on UART0
+ *
+ * @input channel	Channel to listen to (1 to 16), MIDI_OMNI for all
+ * @return True if MIDI was started, False if the UART is busy.
+ *
+ */
+bool Midi_Start(uint8_t channel)
+{
+	if(active || channel > MIDI_CHANNELS)
+		return false;
+
+	head = 0;
+	tail = 0;
+	listenChannel = channel;
+	runningStatus = 0;
+	dataCount = 0;
+	inSysex = false;
+	clockCount = 0;
+	beatTimed = false;
+	clockTempoQ4 = 0;
+
+	stats = (midi_stats_t){0};
+	stats.active = true;
+	stats.channel = channel;
+
+	active = true;
+	UART0_SetReceiveHandler(&Midi_ReceiveByte);
+	return true;
+}
+
+
+/*
+ * Stop listening to MIDI and give the UART back to the console
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Midi_Stop()
+{
+	if(active)
+		StopMidi();
+}
+
+
+/*
+ * Check if MIDI is active
+ *
+ * @input None
+ * @return True if the UART is listening to MIDI, else False.
+ *
+ */
+bool Midi_IsActive()
+{
+	return active;
+}
+
+
+/*
+ * Get the statistics of the MIDI input
+ *
+ * @input stats		Pointer to store the statistics
+ * @return None
+ *
+ */
+void Midi_GetStats(midi_stats_t* out)
+{
+	*out = stats;
+}
+
+
+/*
+ * Returns the number of events waiting for the next block
+ *
+ * @input None
+ * @return Number of events
+ *
+ */
+int Midi_Pending()
+{
+	return head - tail;
+}
+
+
+/*
+ * Take the oldest received event
+ *
+ * @input event		Pointer to store the event
+ * @return True if an event was taken, False if none is waiting.
+ *
+ */
+bool Midi_Dequeue(note_event_t* event)
+{
+	if(head == tail)
+		return false;
+
+	*event = queue[tail & (MIDI_QUEUE_SIZE - 1)];
+	tail++;
+	return true;
+}
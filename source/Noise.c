@@ -0,0 +1,121 @@
+/*
+ * Noise.c - White and pink noise from a Galois LFSR
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <string.h>
+
+#include "Noise.h"
+
+// Seed used in place of zero, which would lock the LFSR
+#define NOISE_DEFAULT_SEED (0xACE1ACE1UL)
+
+// Scale of the white noise added to every pink row
+#define PINK_ROW_SHIFT (3)
+
+// Taps 32, 31, 29 and 1 of the maximal length LFSR (mask 0xD0000001),
+// every entry is its lowest byte shifted out over 8 steps
+const uint32_t noiseStepTable[256] = {
+		0x00000000, 0x9F600001, 0x9EC00001, 0x01A00000, 0x9D800001, 0x02E00000,
+		0x03400000, 0x9C200001, 0x9B000001, 0x04600000, 0x05C00000, 0x9AA00001,
+		0x06800000, 0x99E00001, 0x98400001, 0x07200000, 0x96000001, 0x09600000,
+		0x08C00000, 0x97A00001, 0x0B800000, 0x94E00001, 0x95400001, 0x0A200000,
+		0x0D000000, 0x92600001, 0x93C00001, 0x0CA00000, 0x90800001, 0x0FE00000,
+		0x0E400000, 0x91200001, 0x8C000001, 0x13600000, 0x12C00000, 0x8DA00001,
+		0x11800000, 0x8EE00001, 0x8F400001, 0x10200000, 0x17000000, 0x88600001,
+		0x89C00001, 0x16A00000, 0x8A800001, 0x15E00000, 0x14400000, 0x8B200001,
+		0x1A000000, 0x85600001, 0x84C00001, 0x1BA00000, 0x87800001, 0x18E00000,
+		0x19400000, 0x86200001, 0x81000001, 0x1E600000, 0x1FC00000, 0x80A00001,
+		0x1C800000, 0x83E00001, 0x82400001, 0x1D200000, 0xB8000001, 0x27600000,
+		0x26C00000, 0xB9A00001, 0x25800000, 0xBAE00001, 0xBB400001, 0x24200000,
+		0x23000000, 0xBC600001, 0xBDC00001, 0x22A00000, 0xBE800001, 0x21E00000,
+		0x20400000, 0xBF200001, 0x2E000000, 0xB1600001, 0xB0C00001, 0x2FA00000,
+		0xB3800001, 0x2CE00000, 0x2D400000, 0xB2200001, 0xB5000001, 0x2A600000,
+		0x2BC00000, 0xB4A00001, 0x28800000, 0xB7E00001, 0xB6400001, 0x29200000,
+		0x34000000, 0xAB600001, 0xAAC00001, 0x35A00000, 0xA9800001, 0x36E00000,
+		0x37400000, 0xA8200001, 0xAF000001, 0x30600000, 0x31C00000, 0xAEA00001,
+		0x32800000, 0xADE00001, 0xAC400001, 0x33200000, 0xA2000001, 0x3D600000,
+		0x3CC00000, 0xA3A00001, 0x3F800000, 0xA0E00001, 0xA1400001, 0x3E200000,
+		0x39000000, 0xA6600001, 0xA7C00001, 0x38A00000, 0xA4800001, 0x3BE00000,
+		0x3A400000, 0xA5200001, 0xD0000001, 0x4F600000, 0x4EC00000, 0xD1A00001,
+		0x4D800000, 0xD2E00001, 0xD3400001, 0x4C200000, 0x4B000000, 0xD4600001,
+		0xD5C00001, 0x4AA00000, 0xD6800001, 0x49E00000, 0x48400000, 0xD7200001,
+		0x46000000, 0xD9600001, 0xD8C00001, 0x47A00000, 0xDB800001, 0x44E00000,
+		0x45400000, 0xDA200001, 0xDD000001, 0x42600000, 0x43C00000, 0xDCA00001,
+		0x40800000, 0xDFE00001, 0xDE400001, 0x41200000, 0x5C000000, 0xC3600001,
+		0xC2C00001, 0x5DA00000, 0xC1800001, 0x5EE00000, 0x5F400000, 0xC0200001,
+		0xC7000001, 0x58600000, 0x59C00000, 0xC6A00001, 0x5A800000, 0xC5E00001,
+		0xC4400001, 0x5B200000, 0xCA000001, 0x55600000, 0x54C00000, 0xCBA00001,
+		0x57800000, 0xC8E00001, 0xC9400001, 0x56200000, 0x51000000, 0xCE600001,
+		0xCFC00001, 0x50A00000, 0xCC800001, 0x53E00000, 0x52400000, 0xCD200001,
+		0x68000000, 0xF7600001, 0xF6C00001, 0x69A00000, 0xF5800001, 0x6AE00000,
+		0x6B400000, 0xF4200001, 0xF3000001, 0x6C600000, 0x6DC00000, 0xF2A00001,
+		0x6E800000, 0xF1E00001, 0xF0400001, 0x6F200000, 0xFE000001, 0x61600000,
+		0x60C00000, 0xFFA00001, 0x63800000, 0xFCE00001, 0xFD400001, 0x62200000,
+		0x65000000, 0xFA600001, 0xFBC00001, 0x64A00000, 0xF8800001, 0x67E00000,
+		0x66400000, 0xF9200001, 0xE4000001, 0x7B600000, 0x7AC00000, 0xE5A00001,
+		0x79800000, 0xE6E00001, 0xE7400001, 0x78200000, 0x7F000000, 0xE0600001,
+		0xE1C00001, 0x7EA00000, 0xE2800001, 0x7DE00000, 0x7C400000, 0xE3200001,
+		0x72000000, 0xED600001, 0xECC00001, 0x73A00000, 0xEF800001, 0x70E00000,
+		0x71400000, 0xEE200001, 0xE9000001, 0x76600000, 0x77C00000, 0xE8A00001,
+		0x74800000, 0xEBE00001, 0xEA400001, 0x75200000
+};
+
+
+/*
+ * Initialize a noise generator
+ *
+ * @input noise		Pointer to the generator
+ * 		  seed		Start of the sequence, zero is replaced by a fixed seed
+ * @return None
+ *
+ */
+void Noise_Init(noise_t* noise, uint32_t seed)
+{
+	memset(noise, 0, sizeof(noise_t));
+	noise->lfsr = (seed != 0) ? seed : NOISE_DEFAULT_SEED;
+}
+
+
+/*
+ * Generate a sample of pink noise
+ *
+ * Voss-McCartney generator: every row holds a white noise value which is
+ * renewed half as often as the row before, the sum falls off at about 3 dB
+ * per octave.
+ *
+ * @input noise		Pointer to the generator
+ * @return Noise in Q15, about 13 dB below the full scale (RMS)
+ *
+ */
+int16_t Noise_Pink(noise_t* noise)
+{
+	uint32_t counter = ++noise->counter;
+	int row = 0;
+	int16_t value;
+	int32_t sum;
+
+	// Row n is renewed on every 2^(n + 1)th sample, which is the number of
+	// trailing zeros of the counter. Nothing is renewed once in 2^ROWS samples.
+	while((counter & 1) == 0 && row < NOISE_PINK_ROWS)
+	{
+		counter >>= 1;
+		row++;
+	}
+
+	if(row < NOISE_PINK_ROWS)
+	{
+		value = Noise_White(noise) >> PINK_ROW_SHIFT;
+		noise->sum += value - noise->rows[row];
+		noise->rows[row] = value;
+	}
+
+	sum = noise->sum + (Noise_White(noise) >> PINK_ROW_SHIFT);
+	if(sum > INT16_MAX)
+		sum = INT16_MAX;
+	else if(sum < INT16_MIN)
+		sum = INT16_MIN;
+	return sum;
+}
@@ -0,0 +1,113 @@
+/*
+ * Nvm.c - Erasing and programming the flash with the fsl_flash driver
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <string.h>
+
+#include "Nvm.h"
+#include "fsl_flash.h"
+#include "MKL25Z4.h"
+
+static flash_config_t config;
+static bool ready = false;
+
+
+/*
+ * Initialize the flash driver
+ *
+ * @input None
+ * @return True if the flash can be erased and programmed, else False.
+ *
+ */
+bool Nvm_Init()
+{
+	if(!ready)
+		ready = (FLASH_Init(&config) == kStatus_FLASH_Success);
+
+	return ready;
+}
+
+
+/*
+ * Erase a sector of the flash
+ *
+ * The core can't read the flash while it is erased, so the interrupts are
+ * held off for the whole erase (up to about 100 ms).
+ *
+ * @input address	Address of the sector, a multiple of NVM_SECTOR_SIZE
+ * @return True if the sector was erased, else False.
+ *
+ */
+bool Nvm_Erase(uint32_t address)
+{
+	uint32_t maskingState;
+	status_t status;
+
+	if(!ready || (address % NVM_SECTOR_SIZE) != 0)
+		return false;
+
+	// The handlers and the vector table are in the flash too
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+	status = FLASH_Erase(&config, address, NVM_SECTOR_SIZE, kFLASH_ApiEraseKey);
+	__set_PRIMASK(maskingState);
+
+	return (status == kStatus_FLASH_Success);
+}
+
+
+/*
+ * Program bytes into erased flash
+ *
+ * The bytes are programmed a unit at a time, the interrupts are held off
+ * for one unit only (about 65 us).
+ *
+ * @input address	Address to program, a multiple of NVM_PROGRAM_UNIT
+ * 		  data		Pointer to the bytes
+ * 		  length	Number of bytes, a multiple of NVM_PROGRAM_UNIT
+ * @return True if all the bytes were programmed, else False.
+ *
+ */
+bool Nvm_Program(uint32_t address, const void* data, uint32_t length)
+{
+	const uint8_t* bytes = data;
+	uint32_t maskingState;
+	uint32_t word; // The driver reads whole words, the data may be unaligned
+	status_t status;
+
+	if(!ready || (address % NVM_PROGRAM_UNIT) != 0 || (length % NVM_PROGRAM_UNIT) != 0)
+		return false;
+
+	for(; length > 0; length -= NVM_PROGRAM_UNIT)
+	{
+		memcpy(&word, bytes, NVM_PROGRAM_UNIT);
+
+		maskingState = __get_PRIMASK();
+		__disable_irq();
+		status = FLASH_Program(&config, address, &word, NVM_PROGRAM_UNIT);
+		__set_PRIMASK(maskingState);
+
+		if(status != kStatus_FLASH_Success)
+			return false;
+
+		address += NVM_PROGRAM_UNIT;
+		bytes += NVM_PROGRAM_UNIT;
+	}
+	return true;
+}
+
+
+/*
+ * Returns a pointer to read the flash
+ *
+ * @input address	Address in the flash
+ * @return Pointer to the contents
+ *
+ */
+const void* Nvm_Read(uint32_t address)
+{
+	return (const void*)address;
+}
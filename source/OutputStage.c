@@ -0,0 +1,163 @@
+/*
+ * OutputStage.c - Conversion of the Q15 mix to 12-bit DAC values
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include "OutputStage.h"
+#include "RamCode.h"
+
+// Q15 units per DAC step (16 bits to 12 bits)
+#define STEP_SHIFT (4)
+#define STEP_HALF (1 << (STEP_SHIFT - 1))
+
+// Linear congruential generator for the dither (Numerical Recipes constants)
+#define LCG_MULTIPLIER (1664525UL)
+#define LCG_INCREMENT (1013904223UL)
+
+// Dither is the sum of two uniform values of 0 to 15 (one step each)
+#define DITHER_FIELD_MASK (0x0F)
+#define DITHER_OFFSET (15)
+
+// Bound of the fed back error, so clipped samples don't build it up
+#define MAX_ERROR (2 << STEP_SHIFT)
+
+static output_mode_t outputMode = OUTPUT_ROUND;
+static uint32_t ditherSeed = 1;
+static int32_t lastError = 0; // Quantization error of the previous sample in Q15
+
+static const char* modeNames[OUTPUT_MODES] = {
+		"off", "tpdf", "shaped"
+};
+
+
+/*
+ * Select the quantization of the output stage
+ *
+ * @input mode	One of output_mode_t
+ * @return None
+ *
+ */
+void OutputStage_SetMode(output_mode_t mode)
+{
+	if(mode >= OUTPUT_MODES)
+		return;
+
+	outputMode = mode;
+	lastError = 0;
+}
+
+
+/*
+ * Returns the quantization of the output stage
+ *
+ * @input None
+ * @return One of output_mode_t
+ *
+ */
+output_mode_t OutputStage_GetMode()
+{
+	return outputMode;
+}
+
+
+/*
+ * Returns the name of a quantization mode
+ *
+ * @input mode	One of output_mode_t
+ * @return Name of the mode
+ *
+ */
+const char* OutputStage_ModeName(output_mode_t mode)
+{
+	if(mode >= OUTPUT_MODES)
+		return "?";
+	return modeNames[mode];
+}
+
+
+/*
+ * Generate triangular dither
+ *
+ * @input None
+ * @return Dither of -15 to 15 in Q15 (+-1 DAC step)
+ *
+ */
+static inline int32_t NextDither()
+{
+	ditherSeed = ditherSeed * LCG_MULTIPLIER + LCG_INCREMENT;
+
+	// The upper bits of the generator are the most random ones
+	return (int32_t)((ditherSeed >> 28) & DITHER_FIELD_MASK) +
+			(int32_t)((ditherSeed >> 24) & DITHER_FIELD_MASK) - DITHER_OFFSET;
+}
+
+
+/*
+ * Quantize a value in Q15 to a DAC value
+ *
+ * @input value		Value in Q15, may be outside of the 16-bit range
+ * @return DAC value, saturated to 0 to DAC_MAX_VALUE
+ *
+ */
+static inline int32_t Quantize(int32_t value)
+{
+	int32_t code = ((value + STEP_HALF) >> STEP_SHIFT) + DAC_MIDPOINT;
+
+	if(code > DAC_MAX_VALUE)
+		code = DAC_MAX_VALUE;
+	else if(code < 0)
+		code = 0;
+	return code;
+}
+
+
+/*
+ * Convert a block of the Q15 mix for the DAC
+ *
+ * Centers the mix on DAC_MIDPOINT and quantizes it to 12 bits using the
+ * full 0 to DAC_MAX_VALUE range, saturating at both ends.
+ *
+ * @input in		Pointer to the signed samples in Q15
+ * 		  out		Pointer to the DAC values to be populated
+ * 		  count		Number of samples
+ * @return None
+ *
+ */
+RAM_FUNCTION void OutputStage_Process(const int16_t* in, uint16_t* out, int count)
+{
+	int32_t wanted, code;
+
+	switch(outputMode)
+	{
+	case OUTPUT_DITHER:
+		for(int i = 0; i < count; i++)
+		{
+			out[i] = Quantize(in[i] + NextDither());
+		}
+		break;
+
+	case OUTPUT_SHAPED:
+		// Feed the last error back, so the noise is pushed to high frequencies
+		for(int i = 0; i < count; i++)
+		{
+			wanted = in[i] - lastError;
+			code = Quantize(wanted + NextDither());
+			lastError = ((code - DAC_MIDPOINT) << STEP_SHIFT) - wanted;
+			if(lastError > MAX_ERROR)
+				lastError = MAX_ERROR;
+			else if(lastError < -MAX_ERROR)
+				lastError = -MAX_ERROR;
+			out[i] = code;
+		}
+		break;
+
+	default:
+		for(int i = 0; i < count; i++)
+		{
+			out[i] = Quantize(in[i]);
+		}
+		break;
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * Patch.c - Settings of the sound saved and loaded together
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include "Patch.h"
+#include "AudioOut.h"
+#include "Lfo.h"
+#include "OutputStage.h"
+#include "Sequencer.h"
+#include "Synth.h"
+
+
+/*
+ * Take the current settings into a patch
+ *
+ * @input patch		Pointer to store the settings
+ * @return None
+ *
+ */
+void Patch_Capture(patch_t* patch)
+{
+	patch->wave = Synth_GetWaveform();
+	patch->echo = GetEchoMode() ? 1 : 0;
+	patch->output = OutputStage_GetMode();
+	Synth_GetFmPatch(&patch->fmRatio, &patch->fmIndex, &patch->fmEnvelope);
+	Lfo_GetSettings(LFO_VIBRATO, &patch->vibratoRate, &patch->vibratoDepth);
+	Lfo_GetSettings(LFO_TREMOLO, &patch->tremoloRate, &patch->tremoloDepth);
+	patch->tempo = Sequencer_IsRunning() ? Sequencer_GetTempo() : AudioOut_GetTempo();
+}
+
+
+/*
+ * Apply the settings of a patch
+ *
+ * The playing notes keep sounding unless the plucked strings are gained
+ * or lost, which configures the audio subsystems again.
+ *
+ * @input patch		Settings to apply
+ * @return True if applied, False if the wave can't change, while
+ * 		   streaming or without its memory.
+ *
+ */
+bool Patch_Apply(const patch_t* patch)
+{
+	if(patch->wave < SYNTH_WAVES && patch->wave != Synth_GetWaveform() &&
+			!AudioOut_SetWaveform(patch->wave))
+		return false;
+
+	SetEchoMode(patch->echo != 0);
+	if(patch->output < OUTPUT_MODES)
+		OutputStage_SetMode(patch->output);
+	Synth_SetFmPatch(patch->fmRatio, patch->fmIndex, patch->fmEnvelope);
+	Lfo_Configure(LFO_VIBRATO, patch->vibratoRate, patch->vibratoDepth);
+	Lfo_Configure(LFO_TREMOLO, patch->tremoloRate, patch->tremoloDepth);
+	AudioOut_SetTempo(patch->tempo);
+	return true;
+}
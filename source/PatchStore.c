@@ -0,0 +1,436 @@
+/*
+ * PatchStore.c - Patches kept in an append-only log in the flash
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "PatchStore.h"
+#include "Crc16.h"
+#include "Nvm.h"
+
+// Format of the records, records of another format are skipped
+#define PATCH_VERSION (1)
+
+// Marks the header of a sector of the log, "PTCH"
+#define SECTOR_MAGIC (0x48435450)
+
+// Written at the start of a sector when the log moves into it. The
+// generation is programmed first, so a header is only valid once complete.
+typedef struct sector_header_s
+{
+	uint32_t generation; // Number of sectors written before, plus one
+	uint32_t magic;
+} sector_header_t;
+
+// A patch saved into a slot, the last valid record of a slot holds its patch
+typedef struct patch_record_s
+{
+	uint8_t slot;
+	uint8_t version;
+	patch_t patch;
+	uint16_t spare; // Left erased, pads the record to whole program units
+	uint16_t crc; // Of the bytes before it
+} patch_record_t;
+
+#define RECORDS_PER_SECTOR ((NVM_SECTOR_SIZE - sizeof(sector_header_t)) / sizeof(patch_record_t))
+
+static bool ready = false;
+static uint8_t active; // Sector the records are appended to
+static uint32_t generation; // Generation of the active sector
+static uint16_t records; // Records written to the active sector, valid or not
+static uint32_t latest[PATCH_SLOTS]; // Address of the last record of every slot, 0 if none
+static uint32_t erases;
+
+
+/*
+ * Returns the address of a sector of the store
+ *
+ * @input sector	Sector (0 to PATCH_STORE_SECTORS - 1)
+ * @return Address of the sector
+ *
+ */
+static uint32_t SectorAddress(uint8_t sector)
+{
+	return PATCH_STORE_ADDRESS + (uint32_t)sector * NVM_SECTOR_SIZE;
+}
+
+
+/*
+ * Returns the address of a record in a sector
+ *
+ * @input sector	Sector of the record
+ * 		  index		Position of the record in the sector
+ * @return Address of the record
+ *
+ */
+static uint32_t RecordAddress(uint8_t sector, uint16_t index)
+{
+	return SectorAddress(sector) + sizeof(sector_header_t) + index * sizeof(patch_record_t);
+}
+
+
+/*
+ * Check if flash is erased
+ *
+ * @input address	Address of the first byte
+ * 		  length	Number of bytes
+ * @return True if all the bytes are erased, else False.
+ *
+ */
+static bool IsBlank(uint32_t address, uint32_t length)
+{
+	const uint8_t* bytes = Nvm_Read(address);
+
+	while(length-- > 0)
+	{
+		if(*bytes++ != NVM_ERASED)
+			return false;
+	}
+	return true;
+}
+
+
+/*
+ * Returns the header of a sector of the log
+ *
+ * @input sector	Sector of the store
+ * @return Pointer to the header, NULL if the sector has no valid header.
+ *
+ */
+static const sector_header_t* Header(uint8_t sector)
+{
+	const sector_header_t* header = Nvm_Read(SectorAddress(sector));
+
+	return (header->magic == SECTOR_MAGIC) ? header : NULL;
+}
+
+
+/*
+ * Check a record
+ *
+ * @input record	Pointer to the record
+ * @return True if the record is complete and of this format, else False.
+ *
+ */
+static bool IsValid(const patch_record_t* record)
+{
+	return (record->version == PATCH_VERSION && record->slot < PATCH_SLOTS &&
+			record->crc == Crc16_Update(CRC16_INIT, record, offsetof(patch_record_t, crc)));
+}
+
+
+/*
+ * Index the records of a sector
+ *
+ * A record takes the place of the earlier records of its slot. The
+ * records are programmed in order, so the first blank one ends the sector.
+ *
+ * @input sector	Sector of the log
+ * @return Number of records written to the sector, valid or not
+ *
+ */
+static uint16_t ScanSector(uint8_t sector)
+{
+	const patch_record_t* record;
+	uint32_t address;
+	uint16_t i;
+
+	for(i = 0; i < RECORDS_PER_SECTOR; i++)
+	{
+		address = RecordAddress(sector, i);
+		if(IsBlank(address, sizeof(patch_record_t)))
+			break;
+
+		record = Nvm_Read(address);
+		if(IsValid(record))
+			latest[record->slot] = address;
+	}
+	return i;
+}
+
+
+/*
+ * Start the log in a sector
+ *
+ * @input sector		Erased sector
+ * 		  sectorGeneration	Generation of the sector
+ * @return True if the header was written, else False.
+ *
+ */
+static bool StartSector(uint8_t sector, uint32_t sectorGeneration)
+{
+	sector_header_t header = {sectorGeneration, SECTOR_MAGIC};
+
+	if(!Nvm_Program(SectorAddress(sector), &header, sizeof(header)))
+		return false;
+
+	active = sector;
+	generation = sectorGeneration;
+	records = 0;
+	return true;
+}
+
+
+static bool WriteRecord(const patch_record_t* record);
+
+
+/*
+ * Erase a sector of the log once its latest records are copied
+ *
+ * The copies are appended to the active sector, so the patches survive
+ * a reset at any point. A sector which is blank already, as on the first
+ * pass over fresh flash, isn't erased again.
+ *
+ * @input sector	Sector to erase, not the active one
+ * @return True if the sector was erased, else False.
+ *
+ */
+static bool CollectSector(uint8_t sector)
+{
+	patch_record_t copy;
+	uint32_t start = SectorAddress(sector);
+
+	for(int slot = 0; slot < PATCH_SLOTS; slot++)
+	{
+		if(latest[slot] >= start && latest[slot] < start + NVM_SECTOR_SIZE)
+		{
+			memcpy(&copy, Nvm_Read(latest[slot]), sizeof(copy));
+			if(!WriteRecord(&copy))
+				return false;
+		}
+	}
+
+	if(IsBlank(start, NVM_SECTOR_SIZE))
+		return true;
+
+	erases++;
+	return Nvm_Erase(start);
+}
+
+
+/*
+ * Move the log to the next sector
+ *
+ * The next sector is kept erased. The sector after it holds the oldest
+ * records, it is emptied to become the erased one. The sectors are
+ * written in turn, so they wear evenly.
+ *
+ * @input None
+ * @return True if the log moved, else False.
+ *
+ */
+static bool NextSector()
+{
+	uint8_t next = (active + 1) % PATCH_STORE_SECTORS;
+
+	if(!StartSector(next, generation + 1))
+		return false;
+
+	return CollectSector((next + 1) % PATCH_STORE_SECTORS);
+}
+
+
+/*
+ * Append a record to the log
+ *
+ * @input record	Record to write, with its CRC
+ * @return True if the record was written, else False.
+ *
+ */
+static bool WriteRecord(const patch_record_t* record)
+{
+	uint32_t address;
+
+	if(records >= RECORDS_PER_SECTOR && !NextSector())
+		return false;
+
+	// A record which failed keeps its place
+	address = RecordAddress(active, records);
+	records++;
+
+	if(!Nvm_Program(address, record, sizeof(patch_record_t)) || !IsValid(Nvm_Read(address)))
+		return false;
+
+	latest[record->slot] = address;
+	return true;
+}
+
+
+/*
+ * Erase the store and start the log in the first sector
+ *
+ * @input None
+ * @return True if the store was formatted, else False.
+ *
+ */
+static bool Format()
+{
+	for(uint8_t sector = 0; sector < PATCH_STORE_SECTORS; sector++)
+	{
+		if(IsBlank(SectorAddress(sector), NVM_SECTOR_SIZE))
+			continue;
+
+		erases++;
+		if(!Nvm_Erase(SectorAddress(sector)))
+			return false;
+	}
+	return StartSector(0, 1);
+}
+
+
+/*
+ * Initialize the patch store
+ *
+ * Finds the latest patch of every slot in the flash. A store interrupted
+ * while moving to the next sector is completed, and blank or foreign
+ * flash is formatted.
+ *
+ * @input None
+ * @return True if the store can be used, else False.
+ *
+ */
+bool PatchStore_Init()
+{
+	const sector_header_t* header;
+	uint8_t sector;
+	uint16_t count;
+	bool found = false;
+
+	ready = false;
+	erases = 0;
+	memset(latest, 0, sizeof(latest));
+
+	if(!Nvm_Init())
+		return false;
+
+	// The active sector has the highest generation
+	for(sector = 0; sector < PATCH_STORE_SECTORS; sector++)
+	{
+		header = Header(sector);
+		if(header != NULL && (!found || header->generation > generation))
+		{
+			found = true;
+			active = sector;
+			generation = header->generation;
+		}
+	}
+
+	if(!found)
+	{
+		ready = Format();
+		return ready;
+	}
+
+	// Index from the oldest sector, so the later records of a slot win
+	for(int i = 1; i <= PATCH_STORE_SECTORS; i++)
+	{
+		sector = (active + i) % PATCH_STORE_SECTORS;
+		header = Header(sector);
+		if(header == NULL || generation - header->generation >= PATCH_STORE_SECTORS)
+			continue;
+
+		count = ScanSector(sector);
+		if(sector == active)
+			records = count;
+	}
+
+	// A reset while moving to the active sector left the next one to erase
+	ready = true;
+	sector = (active + 1) % PATCH_STORE_SECTORS;
+	if(!IsBlank(SectorAddress(sector), NVM_SECTOR_SIZE))
+		ready = CollectSector(sector);
+
+	return ready;
+}
+
+
+/*
+ * Save a patch into a slot
+ *
+ * The patch is appended to the log in the flash, the sectors are written
+ * in turn so they wear evenly. Saving the patch a slot holds already
+ * writes nothing.
+ *
+ * @input slot		Slot (0 to PATCH_SLOTS - 1)
+ * 		  patch		Patch to save
+ * @return True if the patch was saved, else False.
+ *
+ */
+bool PatchStore_Save(uint8_t slot, const patch_t* patch)
+{
+	const patch_record_t* stored;
+	patch_record_t record;
+
+	if(!ready || slot >= PATCH_SLOTS)
+		return false;
+
+	if(latest[slot] != 0)
+	{
+		stored = Nvm_Read(latest[slot]);
+		if(memcmp(&stored->patch, patch, sizeof(patch_t)) == 0)
+			return true;
+	}
+
+	memset(&record, NVM_ERASED, sizeof(record));
+	record.slot = slot;
+	record.version = PATCH_VERSION;
+	record.patch = *patch;
+	record.crc = Crc16_Update(CRC16_INIT, &record, offsetof(patch_record_t, crc));
+
+	return WriteRecord(&record);
+}
+
+
+/*
+ * Load the patch of a slot
+ *
+ * Reads the record found by PatchStore_Init or the last save, without
+ * searching the flash.
+ *
+ * @input slot		Slot (0 to PATCH_SLOTS - 1)
+ * 		  patch		Pointer to store the patch
+ * @return True if the slot holds a patch, else False.
+ *
+ */
+bool PatchStore_Load(uint8_t slot, patch_t* patch)
+{
+	const patch_record_t* record;
+
+	if(!ready || slot >= PATCH_SLOTS || latest[slot] == 0)
+		return false;
+
+	record = Nvm_Read(latest[slot]);
+	if(!IsValid(record))
+		return false;
+
+	*patch = record->patch;
+	return true;
+}
+
+
+/*
+ * Get the statistics of the patch store
+ *
+ * @input stats		Pointer to store the statistics
+ * @return None
+ *
+ */
+void PatchStore_GetStats(patch_store_stats_t* stats)
+{
+	stats->sector = active;
+	stats->generation = generation;
+	stats->records = records;
+	stats->capacity = RECORDS_PER_SECTOR;
+	stats->erases = erases;
+	stats->used = 0;
+
+	for(int slot = 0; slot < PATCH_SLOTS; slot++)
+	{
+		if(latest[slot] != 0)
+			stats->used |= 1 << slot;
+	}
+}
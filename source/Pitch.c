@@ -0,0 +1,312 @@
+/*
+ * Pitch.c - Period of the rendered output for the tuning checks
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stdint.h>
+
+#include "Pitch.h"
+
+// Normalized difference of a lag without energy, 2.0 in Q15
+#define NO_DIP (0xFFFF)
+
+// Numerator and denominator of a ratio are kept below this before scaling
+#define RATIO_LIMIT (1ULL << 47)
+
+// Steps taken by the refinement towards the bottom of a dip
+#define MAX_REFINE_STEPS (8)
+
+// Reference pitch: A4 is MIDI note 69 at 440 Hz
+#define NOTE_A4 (69)
+#define A4_HZ (440)
+#define CENTS_PER_OCTAVE (1200)
+#define CENTS_PER_NOTE (100)
+
+
+/*
+ * Squared difference of the window and the window shifted by a lag
+ *
+ * The differences are halved so their squares fit 30 bits.
+ *
+ * @input samples	Q15 samples
+ * 		  window	Samples compared
+ * 		  lag		Shift in samples
+ * @return Sum of the squared differences
+ *
+ */
+static uint64_t Difference(const int16_t* samples, int window, int lag)
+{
+	const int16_t* shifted = samples + lag;
+	uint64_t sum = 0;
+	int32_t diff;
+
+	for(int i = 0; i < window; i++)
+	{
+		diff = (samples[i] - shifted[i]) >> 1;
+		sum += (uint32_t)(diff * diff);
+	}
+	return sum;
+}
+
+
+/*
+ * Find the bottom of the dip of the difference near a lag and interpolate
+ * it with a parabola through the lag and its two neighbours
+ *
+ * @input samples	Q15 samples
+ * 		  window	Samples compared
+ * 		  lag		Lag in the dip
+ * 		  maxLag	Longest lag
+ * @return Lag of the bottom in Q16
+ *
+ */
+static uint32_t DipBottom(const int16_t* samples, int window, int lag, int maxLag)
+{
+	uint64_t before, at, after;
+	int64_t num, den;
+
+	if(lag < 2)
+		lag = 2;
+	if(lag > maxLag - 1)
+		lag = maxLag - 1;
+
+	before = Difference(samples, window, lag - 1);
+	at = Difference(samples, window, lag);
+	after = Difference(samples, window, lag + 1);
+
+	for(int step = 0; step < MAX_REFINE_STEPS; step++)
+	{
+		if(after < at && lag + 1 < maxLag)
+		{
+			lag++;
+			before = at;
+			at = after;
+			after = Difference(samples, window, lag + 1);
+		}
+		else if(before < at && lag - 1 > 1)
+		{
+			lag--;
+			after = at;
+			at = before;
+			before = Difference(samples, window, lag - 1);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	// Offset of the vertex, (before - after) / (2 * (before - 2 * at + after))
+	num = (int64_t)before - (int64_t)after;
+	den = (int64_t)before - 2 * (int64_t)at + (int64_t)after;
+	while(num >= (int64_t)RATIO_LIMIT || num <= -(int64_t)RATIO_LIMIT || den >= (int64_t)RATIO_LIMIT)
+	{
+		num /= 2;
+		den /= 2;
+	}
+	if(den <= 0)
+		return (uint32_t)lag << 16;
+
+	num = (num * 32768) / den;
+	if(num > 32768)
+		num = 32768;
+	else if(num < -32768)
+		num = -32768;
+	return (uint32_t)(((int64_t)lag << 16) + num);
+}
+
+
+/*
+ * Depth of the dip of the normalized difference near a lag, the bottom of
+ * a parabola through the lowest of the lag and its neighbours
+ *
+ * @input scratch	Normalized differences in Q15
+ * 		  lag		Lag near the dip, from 2
+ * 		  maxLag	Longest lag
+ * @return Normalized difference at the bottom in Q15
+ *
+ */
+static int32_t DipDepth(const uint16_t* scratch, int lag, int maxLag)
+{
+	int32_t before, at, after, curve;
+
+	if(lag + 1 < maxLag && scratch[lag + 1] < scratch[lag])
+		lag++;
+	else if(lag > 2 && scratch[lag - 1] < scratch[lag])
+		lag--;
+	if(lag + 1 > maxLag)
+		return scratch[lag];
+
+	before = scratch[lag - 1];
+	at = scratch[lag];
+	after = scratch[lag + 1];
+	curve = before - 2 * at + after;
+	if(at > before || at > after || curve <= 0)
+		return at;
+	return at - (int32_t)(((int64_t)(before - after) * (before - after)) / (8 * curve));
+}
+
+
+/*
+ * Estimate the period of a signal
+ *
+ * YIN difference function in fixed point: the window is compared with
+ * itself shifted by every lag up to maxLag, and the first lag at which the
+ * cumulative mean normalized difference dips below PITCH_THRESHOLD is the
+ * period, or a whole fraction of it which dips below twice the threshold.
+ * The period is interpolated with a parabola at twice, four times... the
+ * period up to maxLag, so a longer maxLag gives a finer period. Takes
+ * window * maxLag multiplications.
+ *
+ * @input samples	Q15 samples, window + maxLag of them
+ * 		  window	Samples compared, at least the longest period
+ * 		  maxLag	Longest lag, at least the longest period and 2
+ * 		  scratch	Space for maxLag + 1 differences
+ * @return Period in samples in Q16, 0 if no period was found
+ *
+ */
+uint32_t Pitch_Period(const int16_t* samples, int window, int maxLag, uint16_t* scratch)
+{
+	uint64_t running = 0;
+	uint64_t num, den, ratio;
+	uint32_t period, multiple;
+	int lag, dip = 0;
+
+	if(window <= 0 || maxLag < 3)
+		return 0;
+
+	// Cumulative mean normalized difference in Q15
+	scratch[0] = NO_DIP;
+	for(lag = 1; lag <= maxLag; lag++)
+	{
+		num = Difference(samples, window, lag);
+		running += num;
+		if(running == 0)
+		{
+			scratch[lag] = NO_DIP;
+			continue;
+		}
+
+		num *= lag;
+		den = running;
+		while(num >= RATIO_LIMIT)
+		{
+			num >>= 1;
+			den >>= 1;
+		}
+		ratio = (num << 15) / den;
+		scratch[lag] = (ratio > NO_DIP) ? NO_DIP : (uint16_t)ratio;
+	}
+
+	// First dip below the threshold, down to its bottom
+	for(lag = 2; lag < maxLag; lag++)
+	{
+		if(scratch[lag] < PITCH_THRESHOLD)
+		{
+			while(lag < maxLag && scratch[lag + 1] <= scratch[lag])
+				lag++;
+			dip = lag;
+			break;
+		}
+	}
+	if(dip == 0)
+		return 0;
+
+	// A short period between two lags can miss the threshold, which its
+	// multiples then meet
+	for(int divisor = dip / 2; divisor >= 2; divisor--)
+	{
+		lag = (dip + divisor / 2) / divisor;
+		if(lag >= 2 && DipDepth(scratch, lag, maxLag) < 2 * PITCH_THRESHOLD)
+		{
+			dip = lag;
+			break;
+		}
+	}
+
+	// Refine the period over twice as many periods at every step, the
+	// error of the interpolation is spread over all of them
+	period = DipBottom(samples, window, dip, maxLag);
+	for(multiple = 2; ((uint64_t)period * multiple >> 16) + 1 < (uint32_t)maxLag; multiple *= 2)
+	{
+		lag = (int)(((uint64_t)period * multiple + 0x8000) >> 16);
+		period = DipBottom(samples, window, lag, maxLag) / multiple;
+	}
+	return period;
+}
+
+
+/*
+ * Frequency of a period
+ *
+ * @input period	Period in samples in Q16
+ * 		  rate		Sampling rate in Hz
+ * @return Frequency in Hz in Q8, 0 for no period
+ *
+ */
+uint32_t Pitch_Frequency(uint32_t period, uint32_t rate)
+{
+	if(period == 0)
+		return 0;
+	return (uint32_t)(((uint64_t)rate << 24) / period);
+}
+
+
+/*
+ * Base 2 logarithm
+ *
+ * Takes the leading bit for the integer part and squares the rest 16
+ * times for the fraction.
+ *
+ * @input x		Value, above 0
+ * @return Logarithm in Q16
+ *
+ */
+static int32_t Log2(uint32_t x)
+{
+	int32_t result = 0;
+	int bits = 0;
+	uint64_t mantissa; // Q31, from 1 to 2
+
+	while((x >> bits) >= 2)
+		bits++;
+	result = bits << 16;
+	mantissa = ((uint64_t)x << 31) >> bits;
+
+	for(int32_t bit = 1 << 15; bit > 0; bit >>= 1)
+	{
+		mantissa = (mantissa * mantissa) >> 31;
+		if(mantissa >= (2ULL << 31))
+		{
+			mantissa >>= 1;
+			result |= bit;
+		}
+	}
+	return result;
+}
+
+
+/*
+ * Deviation of a period from the equal tempered pitch of a note
+ *
+ * The pitch of a note is 440 Hz * 2^((note - 69) / 12).
+ *
+ * @input period	Period in samples in Q16
+ * 		  rate		Sampling rate in Hz
+ * 		  note		MIDI note number
+ * @return Cents in Q8, above 0 if the period is sharp
+ *
+ */
+int32_t Pitch_Cents(uint32_t period, uint32_t rate, uint8_t note)
+{
+	int64_t octaves; // From the reference to the frequency in Q16
+
+	if(period == 0 || rate == 0)
+		return 0;
+
+	octaves = (int64_t)Log2(rate) + (16 << 16) - Log2(period) - Log2(A4_HZ);
+	return (int32_t)((octaves * CENTS_PER_OCTAVE) >> 8) -
+			(((int32_t)note - NOTE_A4) * CENTS_PER_NOTE << 8);
+}
@@ -0,0 +1,240 @@
+/*
+ * SampleBank.c - IMA-ADPCM samples played by the sampler
+ *
+ * Generated by tools/wav2adpcm.py, do not edit.
+ */
+
+#include "Sampler.h"
+
+// kick: 4000 samples at 16000 Hz, 2000 bytes
+static const uint8_t kick_adpcm[2000] =
+	{
+		0x77, 0x77, 0x77, 0x77, 0x27, 0x00, 0x01, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x08, 0x98, 0x99,
+		0xAA, 0xBC, 0xBC, 0xCC, 0xCB, 0xCB, 0xBB, 0xAD, 0xAC, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC, 0xBB, 0xBC,
+		0xBB, 0xCB, 0xBB, 0xBB, 0xAC, 0xBA, 0xAA, 0xAA, 0x9A, 0x88, 0x00, 0x32, 0x45, 0x53, 0x53, 0x33,
+		0x35, 0x34, 0x34, 0x34, 0x43, 0x24, 0x24, 0x33, 0x34, 0x33, 0x44, 0x32, 0x33, 0x24, 0x43, 0x32,
+		0x33, 0x33, 0x43, 0x32, 0x23, 0x23, 0x22, 0x11, 0x00, 0x98, 0xBB, 0xBE, 0xCD, 0xCB, 0xDB, 0xCB,
+		0xBB, 0xBD, 0xCB, 0xCB, 0xCB, 0xBB, 0xBC, 0xCB, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xBB, 0xBC, 0xBB,
+		0xBC, 0xBA, 0xAC, 0xAB, 0xBB, 0xBA, 0xAB, 0xAA, 0xAA, 0x88, 0x18, 0x32, 0x54, 0x34, 0x35, 0x35,
+		0x53, 0x33, 0x44, 0x33, 0x25, 0x24, 0x43, 0x42, 0x32, 0x43, 0x33, 0x34, 0x24, 0x33, 0x34, 0x33,
+		0x34, 0x43, 0x32, 0x24, 0x23, 0x33, 0x43, 0x32, 0x32, 0x23, 0x23, 0x23, 0x11, 0x01, 0x90, 0xBA,
+		0xDC, 0xDB, 0xBC, 0xCC, 0xCB, 0xCB, 0xCB, 0xAC, 0xBC, 0xBB, 0xCC, 0xBB, 0xDB, 0xCA, 0xBA, 0xCB,
+		0xBB, 0xCB, 0xCB, 0xBB, 0xCB, 0xBB, 0xCB, 0xCB, 0xBA, 0xBB, 0xAC, 0xBB, 0xCB, 0xBA, 0xAB, 0xBB,
+		0xBB, 0xAB, 0xAB, 0x9A, 0x99, 0x00, 0x32, 0x45, 0x44, 0x53, 0x43, 0x43, 0x34, 0x34, 0x53, 0x33,
+		0x34, 0x34, 0x43, 0x24, 0x43, 0x33, 0x34, 0x43, 0x33, 0x34, 0x43, 0x33, 0x34, 0x33, 0x34, 0x24,
+		0x33, 0x34, 0x42, 0x32, 0x32, 0x24, 0x23, 0x33, 0x43, 0x22, 0x23, 0x23, 0x32, 0x21, 0x11, 0x80,
+		0x99, 0xDB, 0xDB, 0xBC, 0xCC, 0xDB, 0xBB, 0xCC, 0xBB, 0xBD, 0xCB, 0xBB, 0xBD, 0xBB, 0xBD, 0xBB,
+		0xCC, 0xBA, 0xBC, 0xBB, 0xBC, 0xBC, 0xBB, 0xBC, 0xAC, 0xAC, 0xBB, 0xBB, 0xBC, 0xAC, 0xBB, 0xAC,
+		0xBB, 0xCB, 0xBB, 0xBB, 0xCB, 0xBB, 0xBB, 0xBB, 0xAC, 0xAB, 0xAA, 0x9A, 0x99, 0x88, 0x20, 0x42,
+		0x44, 0x34, 0x35, 0x44, 0x33, 0x35, 0x34, 0x43, 0x34, 0x43, 0x43, 0x43, 0x33, 0x34, 0x34, 0x43,
+		0x43, 0x33, 0x43, 0x24, 0x43, 0x32, 0x24, 0x33, 0x34, 0x43, 0x33, 0x43, 0x33, 0x43, 0x43, 0x32,
+		0x43, 0x32, 0x43, 0x32, 0x33, 0x24, 0x33, 0x33, 0x33, 0x24, 0x33, 0x32, 0x22, 0x22, 0x11, 0x00,
+		0x99, 0xDA, 0xDB, 0xDB, 0xCB, 0xBC, 0xCC, 0xBB, 0xBD, 0xCB, 0xAC, 0xBC, 0xBB, 0xBD, 0xBB, 0xBD,
+		0xBB, 0xCC, 0xCA, 0xBA, 0xCB, 0xBB, 0xBC, 0xCB, 0xCB, 0xCA, 0xBA, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC,
+		0xBB, 0xBC, 0xCB, 0xBB, 0xCB, 0xBB, 0xCB, 0xBB, 0xCB, 0xBB, 0xBB, 0xBC, 0xBB, 0xBB, 0xBC, 0xBA,
+		0xBB, 0xBB, 0xBA, 0xAA, 0xAA, 0x88, 0x10, 0x32, 0x46, 0x43, 0x44, 0x53, 0x33, 0x35, 0x43, 0x34,
+		0x53, 0x42, 0x33, 0x43, 0x34, 0x43, 0x33, 0x34, 0x34, 0x34, 0x33, 0x44, 0x32, 0x34, 0x33, 0x34,
+		0x34, 0x33, 0x34, 0x34, 0x33, 0x34, 0x24, 0x24, 0x33, 0x33, 0x34, 0x24, 0x43, 0x32, 0x33, 0x34,
+		0x33, 0x24, 0x24, 0x32, 0x33, 0x24, 0x33, 0x33, 0x43, 0x32, 0x23, 0x33, 0x23, 0x23, 0x22, 0x12,
+		0x80, 0xA9, 0xDB, 0xCC, 0xBC, 0xCC, 0xBC, 0xDB, 0xCB, 0xCB, 0xCB, 0xCB, 0xBB, 0xBD, 0xBB, 0xBD,
+		0xBB, 0xBD, 0xBB, 0xBD, 0xBB, 0xBC, 0xBC, 0xCB, 0xCB, 0xBB, 0xCB, 0xCB, 0xBB, 0xBC, 0xCB, 0xBB,
+		0xAC, 0xAC, 0xCB, 0xBA, 0xCB, 0xBA, 0xAC, 0xCB, 0xBA, 0xCB, 0xBA, 0xAC, 0xBB, 0xCB, 0xBB, 0xCB,
+		0xBA, 0xAC, 0xBB, 0xBB, 0xBC, 0xCA, 0xAA, 0xAB, 0xBB, 0xBB, 0xBB, 0xBB, 0xBA, 0xAA, 0x8A, 0x09,
+		0x21, 0x34, 0x36, 0x35, 0x35, 0x53, 0x43, 0x53, 0x42, 0x33, 0x34, 0x34, 0x53, 0x33, 0x53, 0x33,
+		0x34, 0x43, 0x43, 0x43, 0x33, 0x53, 0x42, 0x32, 0x43, 0x33, 0x43, 0x24, 0x43, 0x23, 0x34, 0x33,
+		0x34, 0x43, 0x33, 0x34, 0x43, 0x33, 0x34, 0x33, 0x34, 0x43, 0x33, 0x34, 0x33, 0x34, 0x33, 0x34,
+		0x43, 0x33, 0x33, 0x34, 0x43, 0x32, 0x43, 0x32, 0x33, 0x33, 0x24, 0x33, 0x33, 0x33, 0x33, 0x23,
+		0x23, 0x12, 0x00, 0xA8, 0xDB, 0xCC, 0xDB, 0xDB, 0xCB, 0xCB, 0xBC, 0xBC, 0xDB, 0xBB, 0xBC, 0xCC,
+		0xBA, 0xBC, 0xAC, 0xAC, 0xAC, 0xBB, 0xBC, 0xBC, 0xBB, 0xAD, 0xCB, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC,
+		0xCB, 0xCB, 0xBB, 0xCB, 0xCB, 0xBB, 0xCB, 0xCB, 0xCA, 0xBA, 0xBB, 0xBC, 0xCB, 0xBB, 0xAC, 0xAC,
+		0xBB, 0xCB, 0xCA, 0xBA, 0xBB, 0xAC, 0xCB, 0xBA, 0xCB, 0xBA, 0xCB, 0xBA, 0xBB, 0xCB, 0xBB, 0xBB,
+		0xBC, 0xBA, 0xCB, 0xAA, 0xAB, 0xAB, 0xBA, 0x9A, 0x9A, 0x88, 0x10, 0x32, 0x45, 0x34, 0x35, 0x35,
+		0x53, 0x33, 0x35, 0x53, 0x42, 0x33, 0x34, 0x53, 0x33, 0x34, 0x43, 0x34, 0x33, 0x44, 0x33, 0x43,
+		0x24, 0x43, 0x33, 0x34, 0x43, 0x33, 0x34, 0x43, 0x24, 0x33, 0x34, 0x43, 0x33, 0x53, 0x32, 0x24,
+		0x33, 0x34, 0x43, 0x33, 0x43, 0x43, 0x32, 0x24, 0x43, 0x32, 0x43, 0x32, 0x24, 0x33, 0x24, 0x33,
+		0x34, 0x33, 0x43, 0x43, 0x32, 0x33, 0x24, 0x33, 0x24, 0x33, 0x33, 0x43, 0x32, 0x33, 0x33, 0x24,
+		0x32, 0x22, 0x21, 0x11, 0x80, 0xA8, 0xBB, 0xBE, 0xCD, 0xCB, 0xDB, 0xBB, 0xBD, 0xDB, 0xBB, 0xBC,
+		0xCC, 0xCA, 0xCA, 0xBA, 0xBC, 0xBB, 0xBD, 0xCB, 0xBB, 0xBC, 0xBC, 0xCB, 0xCB, 0xBB, 0xBC, 0xCB,
+		0xCB, 0xCA, 0xBA, 0xCB, 0xBB, 0xBC, 0xAC, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xCB, 0xCB, 0xBA, 0xAC,
+		0xCB, 0xBA, 0xCB, 0xBB, 0xCB, 0xCB, 0xBA, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xBB, 0xAC, 0xAC, 0xBB,
+		0xBB, 0xBC, 0xBB, 0xBC, 0xBB, 0xBC, 0xBB, 0xBB, 0xBC, 0xBB, 0xCB, 0xBA, 0xAB, 0xBB, 0xAB, 0xAB,
+		0xAA, 0x99, 0x08, 0x21, 0x44, 0x44, 0x53, 0x53, 0x33, 0x35, 0x34, 0x53, 0x33, 0x35, 0x43, 0x33,
+		0x35, 0x43, 0x43, 0x33, 0x34, 0x34, 0x43, 0x43, 0x43, 0x42, 0x32, 0x24, 0x43, 0x33, 0x53, 0x32,
+		0x24, 0x43, 0x33, 0x43, 0x43, 0x42, 0x32, 0x43, 0x33, 0x24, 0x24, 0x33, 0x34, 0x33, 0x34, 0x34,
+		0x33, 0x34, 0x43, 0x33, 0x34, 0x33, 0x34, 0x43, 0x33, 0x24, 0x43, 0x23, 0x24, 0x33, 0x43, 0x32,
+		0x24, 0x33, 0x24, 0x33, 0x43, 0x32, 0x33, 0x34, 0x32, 0x24, 0x23, 0x33, 0x33, 0x33, 0x33, 0x33,
+		0x32, 0x12, 0x01, 0x99, 0xDB, 0xBC, 0xCD, 0xBC, 0xBC, 0xCC, 0xCB, 0xCB, 0xCB, 0xAC, 0xAC, 0xAC,
+		0xCB, 0xBB, 0xBC, 0xBC, 0xBC, 0xCB, 0xBB, 0xAD, 0xCB, 0xBB, 0xBC, 0xCB, 0xBB, 0xCC, 0xBA, 0xAC,
+		0xAC, 0xBB, 0xAC, 0xAC, 0xCB, 0xBA, 0xAC, 0xCB, 0xCA, 0xBA, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC, 0xCB,
+		0xBB, 0xBC, 0xBB, 0xCC, 0xBA, 0xBB, 0xBC, 0xCB, 0xBB, 0xCB, 0xCB, 0xBA, 0xAC, 0xBB, 0xCB, 0xBB,
+		0xCB, 0xBB, 0xBC, 0xCA, 0xBA, 0xBB, 0xCB, 0xBB, 0xCB, 0xBA, 0xCB, 0xBA, 0xBA, 0xCB, 0xAA, 0xAB,
+		0xAB, 0xAB, 0xAA, 0xAA, 0x89, 0x00, 0x31, 0x44, 0x34, 0x45, 0x43, 0x34, 0x34, 0x34, 0x35, 0x33,
+		0x35, 0x53, 0x33, 0x53, 0x33, 0x53, 0x33, 0x34, 0x43, 0x24, 0x24, 0x33, 0x34, 0x34, 0x33, 0x44,
+		0x42, 0x32, 0x43, 0x33, 0x53, 0x32, 0x34, 0x33, 0x34, 0x24, 0x24, 0x33, 0x34, 0x33, 0x34, 0x34,
+		0x43, 0x42, 0x32, 0x43, 0x42, 0x32, 0x33, 0x34, 0x43, 0x33, 0x43, 0x33, 0x34, 0x24, 0x33, 0x24,
+		0x43, 0x32, 0x43, 0x33, 0x33, 0x34, 0x33, 0x34, 0x24, 0x33, 0x33, 0x34, 0x33, 0x34, 0x32, 0x24,
+		0x23, 0x33, 0x43, 0x22, 0x23, 0x23, 0x22, 0x12, 0x11, 0x90, 0xA9, 0xEB, 0xDB, 0xCB, 0xBC, 0xCC,
+		0xCB, 0xCB, 0xDB, 0xBA, 0xBC, 0xBC, 0xBC, 0xCB, 0xCB, 0xCB, 0xBB, 0xBC, 0xBC, 0xCB, 0xAC, 0xCB,
+		0xBB, 0xCB, 0xAC, 0xAC, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC, 0xBC, 0xBB, 0xAD, 0xBB, 0xBC, 0xCB, 0xCB,
+		0xBA, 0xBC, 0xCA, 0xBB, 0xCB, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC, 0xBB, 0xAD, 0xBB, 0xAC, 0xCB, 0xBB,
+		0xBB, 0xBC, 0xBC, 0xBB, 0xBC, 0xBB, 0xBC, 0xCB, 0xBB, 0xCB, 0xBB, 0xCB, 0xBB, 0xAC, 0xBB, 0xBC,
+		0xBA, 0xAC, 0xBB, 0xCB, 0xBA, 0xBB, 0xBB, 0xAC, 0xAB, 0xBB, 0xBB, 0xAA, 0xBA, 0x99, 0x09, 0x11,
+		0x53, 0x53, 0x43, 0x34, 0x44, 0x43, 0x43, 0x43, 0x34, 0x43, 0x43, 0x43, 0x43, 0x33, 0x25, 0x43,
+		0x33, 0x34, 0x34, 0x43, 0x43, 0x33, 0x34, 0x43, 0x43, 0x33, 0x34, 0x43, 0x43, 0x33, 0x34, 0x43,
+		0x33, 0x34, 0x34, 0x33, 0x34, 0x34, 0x43, 0x33, 0x43, 0x43, 0x33, 0x34, 0x33, 0x34, 0x34, 0x33,
+		0x34, 0x43, 0x33, 0x34, 0x43, 0x33, 0x43, 0x33, 0x34, 0x43, 0x42, 0x32, 0x42, 0x32, 0x33, 0x34,
+		0x33, 0x34, 0x33, 0x34, 0x43, 0x32, 0x43, 0x32, 0x33, 0x24, 0x33, 0x43, 0x32, 0x32, 0x33, 0x33,
+		0x24, 0x22, 0x12, 0x12, 0x01, 0x89, 0xBB, 0xBD, 0xBC, 0xCC, 0xBC, 0xBC, 0xBD, 0xCB, 0xBC, 0xCB,
+		0xDB, 0xCA, 0xBA, 0xBC, 0xCB, 0xCB, 0xBB, 0xBC, 0xBC, 0xBC, 0xCB, 0xBB, 0xBC, 0xBC, 0xCB, 0xCB,
+		0xBB, 0xBC, 0xCB, 0xBB, 0xBC, 0xBC, 0xBB, 0xBC, 0xBC, 0xCB, 0xBB, 0xBC, 0xAC, 0xCB, 0xBB, 0xCB,
+		0xBB, 0xBC, 0xCB, 0xBB, 0xBC, 0xAC, 0xBB, 0xBC, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xCB, 0xBB, 0xCB,
+		0xCB, 0xBA, 0xAC, 0xBB, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xBB, 0xCB, 0xBB, 0xBC, 0xBB, 0xCB, 0xBB,
+		0xBB, 0xBC, 0xBB, 0xBB, 0xBC, 0xAB, 0xBB, 0xBB, 0xBB, 0xAB, 0x9A, 0x99, 0x11, 0x33, 0x53, 0x43,
+		0x53, 0x43, 0x43, 0x53, 0x33, 0x35, 0x43, 0x43, 0x43, 0x43, 0x33, 0x34, 0x34, 0x34, 0x43, 0x43,
+		0x33, 0x34, 0x34, 0x43, 0x43, 0x33, 0x34, 0x43, 0x43, 0x42, 0x32, 0x24, 0x43, 0x33, 0x43, 0x43,
+		0x42, 0x32, 0x43, 0x33, 0x34, 0x43, 0x33, 0x43, 0x24, 0x33, 0x34, 0x43, 0x33, 0x43, 0x43, 0x42,
+		0x32, 0x33, 0x34, 0x33, 0x34, 0x34, 0x33, 0x34, 0x33, 0x34, 0x43, 0x33, 0x34, 0x33, 0x43, 0x43,
+		0x32, 0x43, 0x32, 0x43, 0x32, 0x43, 0x32, 0x33, 0x33, 0x34, 0x33, 0x43, 0x23, 0x33, 0x23, 0x33,
+		0x23, 0x12, 0x12, 0x01, 0xA9, 0xBB, 0xBC, 0xBC, 0xBD, 0xCC, 0xCB, 0xCB, 0xDB, 0xBA, 0xBC, 0xBC,
+		0xBC, 0xCB, 0xCB, 0xCB, 0xBB, 0xBC, 0xBC, 0xAC, 0xAC, 0xCB, 0xBB, 0xBC, 0xCB, 0xCB, 0xCA, 0xBA,
+		0xBC, 0xBB, 0xBC, 0xBC, 0xBB, 0xAD, 0xCB, 0xCA, 0xBA, 0xBB, 0xBC, 0xAC, 0xAC, 0xBB, 0xAC, 0xAC,
+		0xBB, 0xCB, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xCB, 0xBB, 0xDB, 0xBA, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC,
+		0xBB, 0xBC, 0xBB, 0xBC, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xBB, 0xCB, 0xBB, 0xCB, 0xBB, 0xAC, 0xBB,
+		0xBB, 0xBC, 0xBA, 0xAC, 0xBA, 0xAB, 0xAB, 0xBB, 0xAA, 0x9A, 0x9A, 0x19, 0x21, 0x32, 0x34, 0x53,
+		0x53, 0x33, 0x44, 0x43, 0x43, 0x43, 0x43, 0x43, 0x43, 0x33, 0x34, 0x34, 0x34, 0x43, 0x43, 0x33,
+		0x34, 0x34, 0x43, 0x43, 0x33, 0x34, 0x43, 0x43, 0x33, 0x34, 0x43, 0x33, 0x34, 0x34, 0x43, 0x33,
+		0x43, 0x24, 0x43, 0x32, 0x24, 0x43, 0x23, 0x34, 0x42, 0x32, 0x24, 0x43, 0x32, 0x43, 0x33, 0x34,
+		0x33, 0x34, 0x43, 0x33, 0x34, 0x43, 0x33, 0x43, 0x33, 0x43, 0x43, 0x32, 0x43, 0x33, 0x43, 0x33,
+		0x43, 0x33, 0x43, 0x33, 0x33, 0x34, 0x43, 0x23, 0x43, 0x32, 0x33, 0x33, 0x43, 0x32, 0x32, 0x23,
+		0x13, 0x33, 0x21, 0x00, 0x99, 0xBB, 0xBB, 0xBD, 0xBB, 0xBD, 0xBC, 0xCC, 0xBB, 0xBD, 0xCB, 0xDB,
+		0xBA, 0xBC, 0xCB, 0xCB, 0xBB, 0xCC, 0xBA, 0xBC, 0xCB, 0xCB, 0xBB, 0xBC, 0xCB, 0xCB, 0xBB, 0xBC,
+		0xCB, 0xCB, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC, 0xCB, 0xCB, 0xBB, 0xCB, 0xCB, 0xBB, 0xBC, 0xBB, 0xAD,
+		0xBB, 0xBC, 0xBB, 0xAD, 0xBB, 0xBC, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC, 0xBB, 0xBC, 0xAC, 0xCB, 0xBA,
+		0xCB, 0xBB, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xBB, 0xBC, 0xBB, 0xBC, 0xCB, 0xBA, 0xBB, 0xBC, 0xBB,
+		0xAC, 0xBB, 0xBB, 0xAC, 0xBB, 0xAB, 0xCB, 0xAA, 0xAA, 0xA9, 0x9A, 0x99, 0x10, 0x31, 0x32, 0x43,
+		0x33, 0x44, 0x43, 0x43, 0x43, 0x34, 0x43, 0x34, 0x43, 0x43, 0x43, 0x33, 0x35, 0x33, 0x34, 0x34,
+		0x24, 0x24, 0x43, 0x33, 0x34, 0x43, 0x33, 0x25, 0x43, 0x32, 0x34, 0x33, 0x34, 0x34, 0x43, 0x33,
+		0x34, 0x43, 0x43, 0x32, 0x34, 0x33, 0x34, 0x24, 0x43, 0x33, 0x43, 0x33, 0x34, 0x24, 0x43, 0x32,
+		0x43, 0x33, 0x34, 0x33, 0x34, 0x43, 0x33, 0x43, 0x43, 0x33, 0x33, 0x34, 0x24, 0x43, 0x32, 0x33,
+		0x34, 0x33, 0x34, 0x33, 0x34, 0x33, 0x34, 0x33, 0x43, 0x33, 0x33, 0x43, 0x33, 0x33, 0x43, 0x22,
+		0x13, 0x33, 0x22, 0x11, 0x00, 0x99, 0xAA, 0xBA, 0xCB, 0xBB, 0xEB, 0xAB, 0xBC, 0xDB, 0xCA, 0xBB,
+		0xBC, 0xBC, 0xDB, 0xBB, 0xDB, 0xBB, 0xBC, 0xBC, 0xCB, 0xBB, 0xBC, 0xBC, 0xAC, 0xAC, 0xBB, 0xBC,
+		0xBC, 0xBB, 0xAD, 0xCB, 0xBA, 0xBC, 0xBB, 0xBC, 0xBC, 0xCB, 0xBB, 0xDB, 0xBA, 0xAC, 0xCB, 0xAB,
+		0xAC, 0xCB, 0xBA, 0xAC, 0xCB, 0xBA, 0xAC, 0xBB, 0xBC, 0xBB, 0xBC, 0xCB, 0xBB, 0xBC, 0xBB, 0xBC,
+		0xAC, 0xCB, 0xBA, 0xCB, 0xBA, 0xAC, 0xBB, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xBB, 0xCB, 0xBB, 0xAC,
+		0xBB, 0xBB, 0xBC, 0xBA, 0xAC, 0xAB, 0xBB, 0xBB, 0xBB, 0xBB, 0xBB, 0xA9, 0x09, 0x10, 0x11, 0x22,
+		0x33, 0x33, 0x25, 0x33, 0x53, 0x53, 0x32, 0x34, 0x24, 0x34, 0x43, 0x43, 0x33, 0x44, 0x33, 0x53,
+		0x33, 0x53, 0x33, 0x43, 0x43, 0x33, 0x25, 0x33, 0x34, 0x43, 0x43, 0x33, 0x43, 0x43, 0x33, 0x34,
+		0x34, 0x33, 0x34, 0x53, 0x32, 0x43, 0x33, 0x43, 0x43, 0x33, 0x34, 0x33, 0x34, 0x34, 0x33, 0x34,
+		0x43, 0x33, 0x34, 0x43, 0x33, 0x34, 0x33, 0x34, 0x43, 0x33, 0x43, 0x43, 0x32, 0x43, 0x33, 0x43,
+		0x33, 0x43, 0x33, 0x34, 0x33, 0x43, 0x33, 0x43, 0x23, 0x24, 0x23, 0x43, 0x32, 0x32, 0x33, 0x33,
+		0x25, 0x21, 0x21, 0x12, 0x12, 0x00, 0x90, 0xA9, 0xB9, 0xBA, 0xBB, 0xBC, 0xCA, 0xCB, 0xBB, 0xBD,
+		0xCB, 0xDB, 0xBA, 0xBC, 0xDB, 0xBB, 0xCB, 0xAC, 0xAC, 0xCB, 0xBB, 0xBC, 0xCB, 0xCB, 0xBB, 0xBC,
+		0xBC, 0xBB, 0xBD, 0xCA, 0xBB, 0xCB, 0xCB, 0xBB, 0xDB, 0xBA, 0xAC, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC,
+		0xAC, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xCB, 0xCB, 0xBA, 0xCB, 0xBB, 0xBC, 0xBB, 0xBC, 0xCB, 0xBB,
+		0xBC, 0xBB, 0xAD, 0xBB, 0xCB, 0xBB, 0xCB, 0xBB, 0xBC, 0xBB, 0xBC, 0xCB, 0xBA, 0xCB, 0xBA, 0xBB,
+		0xAC, 0xCB, 0xAA, 0xBB, 0xCB, 0xBA, 0xBB, 0xBB, 0xCB, 0xAA, 0xAA, 0xAA, 0x99, 0x99, 0x09, 0x10,
+	};
+
+// snare: 2880 samples at 16000 Hz, 1440 bytes
+static const uint8_t snare_adpcm[1440] =
+	{
+		0xFF, 0xF7, 0xF7, 0x7F, 0x4F, 0x0E, 0x53, 0x0E, 0x12, 0x99, 0xE4, 0xB4, 0x08, 0x30, 0x2C, 0xA0,
+		0xC1, 0x18, 0xA4, 0x28, 0xA9, 0x85, 0x2C, 0x28, 0xC9, 0xC6, 0x11, 0x1B, 0x4A, 0x90, 0xC2, 0x92,
+		0x90, 0x13, 0x1D, 0x4D, 0x18, 0xB8, 0x20, 0x2D, 0x89, 0x68, 0x1B, 0x30, 0x1D, 0x20, 0x08, 0x0C,
+		0x30, 0xE0, 0x80, 0x10, 0xB1, 0x39, 0x28, 0xA5, 0x09, 0xF1, 0x84, 0x80, 0x8A, 0x4A, 0x0C, 0x80,
+		0xA1, 0x18, 0x28, 0x7C, 0xA8, 0x00, 0xA8, 0x07, 0x8A, 0x89, 0x81, 0xC4, 0x58, 0xA9, 0xA2, 0x32,
+		0x98, 0x0C, 0x69, 0x19, 0x8A, 0x04, 0x88, 0x80, 0x2D, 0xA9, 0x20, 0x58, 0xC2, 0x03, 0xE0, 0x88,
+		0x80, 0x23, 0xB8, 0x12, 0x2F, 0x81, 0xA8, 0x7B, 0x2A, 0xC1, 0x38, 0xC9, 0x80, 0x85, 0x3B, 0xA1,
+		0x1A, 0x9C, 0x87, 0x18, 0x2A, 0xC8, 0x80, 0x38, 0x1B, 0x7A, 0x0A, 0x21, 0x3C, 0x0B, 0xD0, 0xA3,
+		0x79, 0x1A, 0x91, 0x19, 0x20, 0x2E, 0x09, 0x92, 0x20, 0xD1, 0x81, 0x28, 0x0A, 0x68, 0x19, 0xF0,
+		0x21, 0xC9, 0x10, 0x1A, 0x59, 0x00, 0x2D, 0xA8, 0x04, 0x3C, 0x8A, 0x93, 0x1C, 0x90, 0x19, 0xF3,
+		0x82, 0x1A, 0x92, 0x7B, 0x18, 0x0D, 0x38, 0x9A, 0x22, 0xC8, 0x58, 0x09, 0x0B, 0x94, 0x6A, 0x09,
+		0x3A, 0x4C, 0x89, 0x20, 0x8C, 0x92, 0x09, 0x18, 0x81, 0xB5, 0xA1, 0xB1, 0xB2, 0x07, 0x1A, 0xE4,
+		0xA3, 0x20, 0x0B, 0x21, 0x2D, 0x88, 0x8A, 0x0A, 0x78, 0x8A, 0x69, 0x90, 0x0A, 0x18, 0x2A, 0x69,
+		0xB0, 0x59, 0x0B, 0x2A, 0x00, 0x2A, 0x2D, 0x29, 0x0B, 0x93, 0x85, 0x82, 0x20, 0x8F, 0xC5, 0x82,
+		0x4A, 0x90, 0x00, 0x2C, 0x28, 0x08, 0x3A, 0x0A, 0x9E, 0x20, 0x7A, 0x09, 0x00, 0xC9, 0x85, 0x09,
+		0xC0, 0xA4, 0x19, 0xB2, 0x14, 0x9B, 0x11, 0x90, 0xF8, 0x00, 0xB3, 0xD2, 0x10, 0x83, 0xB8, 0x82,
+		0xD8, 0xB7, 0x04, 0x1D, 0x11, 0x9A, 0x58, 0x1B, 0x19, 0xD3, 0x82, 0x81, 0x4B, 0xAA, 0x48, 0x88,
+		0x19, 0x50, 0x3E, 0xB0, 0x83, 0xC0, 0x00, 0xA4, 0x09, 0x99, 0x70, 0x3A, 0x8C, 0x91, 0x40, 0x88,
+		0x29, 0xB8, 0xF1, 0x93, 0x81, 0xAA, 0xB7, 0x92, 0x20, 0xD1, 0x91, 0x91, 0x09, 0x60, 0x9A, 0x04,
+		0x9B, 0x80, 0x91, 0x01, 0x43, 0xB9, 0x18, 0x89, 0x2D, 0xC7, 0x02, 0xD2, 0x80, 0x01, 0x83, 0xF0,
+		0x38, 0xA0, 0xC1, 0x32, 0x09, 0xF1, 0x88, 0x12, 0xA1, 0x18, 0x1B, 0x4E, 0x3A, 0xA9, 0x09, 0x04,
+		0x8D, 0x02, 0x99, 0xD3, 0x11, 0xA4, 0xC2, 0x09, 0x95, 0x9A, 0x13, 0x9A, 0x24, 0x8F, 0x01, 0xB1,
+		0x04, 0x9A, 0xB6, 0xB3, 0x38, 0x6B, 0x9A, 0x10, 0x21, 0x1F, 0x39, 0x8B, 0x28, 0x03, 0x29, 0xF8,
+		0x48, 0xB9, 0x93, 0x88, 0x99, 0x03, 0xC7, 0xB3, 0x20, 0xB0, 0x4B, 0x48, 0x0D, 0xD3, 0x11, 0xB8,
+		0x80, 0xA6, 0x01, 0x8A, 0x94, 0x3A, 0x8B, 0x69, 0x90, 0xE2, 0x10, 0x82, 0x9A, 0x01, 0xE3, 0x83,
+		0x80, 0xA8, 0x08, 0xD5, 0x30, 0x8B, 0x48, 0x49, 0x08, 0x8D, 0x28, 0x91, 0x19, 0x01, 0x01, 0xFA,
+		0xB4, 0x92, 0xC2, 0x80, 0x68, 0x99, 0x30, 0xAB, 0x95, 0xE2, 0x11, 0x00, 0x0D, 0x08, 0xA4, 0xB2,
+		0xB3, 0x49, 0xE1, 0x82, 0x09, 0x09, 0x20, 0xC0, 0x39, 0xD3, 0x91, 0x95, 0x0B, 0x12, 0xE1, 0x30,
+		0x99, 0x60, 0x1B, 0x09, 0x13, 0x8E, 0xA2, 0x69, 0x2A, 0x2A, 0x9A, 0x49, 0x20, 0x2F, 0x09, 0x09,
+		0x21, 0x1E, 0x11, 0x8C, 0x84, 0x9A, 0xA4, 0x92, 0xC1, 0xB3, 0x30, 0xD8, 0x10, 0x90, 0x09, 0x15,
+		0x2F, 0xB0, 0xB4, 0x82, 0x90, 0x10, 0x29, 0x0A, 0x5C, 0xA8, 0x04, 0xAA, 0xA2, 0x38, 0x4B, 0xD0,
+		0xB5, 0x04, 0xAA, 0x93, 0xC5, 0x03, 0x09, 0x4C, 0x2A, 0xC8, 0x03, 0x1D, 0xB1, 0xA4, 0xC2, 0x21,
+		0x8B, 0x92, 0x0A, 0x70, 0x19, 0x3C, 0x2C, 0x90, 0x92, 0x28, 0x4E, 0x99, 0xB2, 0x94, 0x29, 0x9A,
+		0xC4, 0xA4, 0x21, 0x0A, 0xAA, 0x00, 0x95, 0x30, 0x0E, 0xC2, 0x10, 0x19, 0x38, 0xB8, 0x94, 0x7B,
+		0x8A, 0x38, 0x81, 0x9B, 0x7A, 0x98, 0x81, 0x93, 0x4D, 0x1C, 0x88, 0x59, 0x2B, 0xC1, 0x20, 0x19,
+		0xC0, 0x00, 0x7A, 0x88, 0x4B, 0x98, 0x91, 0x89, 0xA1, 0x33, 0x28, 0xDA, 0x92, 0xA4, 0x4A, 0xF3,
+		0xC2, 0x81, 0x03, 0xB8, 0xB4, 0x58, 0x09, 0x28, 0x2C, 0x08, 0x3B, 0xAA, 0x59, 0x6C, 0x8B, 0x40,
+		0x9A, 0x88, 0x85, 0x80, 0x3B, 0x4A, 0x08, 0x3E, 0x00, 0x0D, 0x88, 0x84, 0x08, 0xA8, 0x89, 0xB5,
+		0x01, 0x2B, 0x58, 0x8A, 0xA5, 0xA2, 0x2C, 0x20, 0x3B, 0xC9, 0xC6, 0xB3, 0x18, 0x13, 0x1F, 0x10,
+		0x1B, 0x38, 0x4C, 0x8B, 0x93, 0x3A, 0x5C, 0x08, 0x99, 0x80, 0xD4, 0xC3, 0x81, 0xA3, 0x38, 0x1D,
+		0x10, 0x88, 0x8A, 0x79, 0x09, 0x2B, 0xA2, 0x3B, 0xF3, 0x18, 0x02, 0x0D, 0x80, 0xA1, 0x91, 0x87,
+		0x4B, 0x1B, 0x93, 0xA8, 0x39, 0x1D, 0xA0, 0x43, 0x99, 0x91, 0x5C, 0x29, 0xC1, 0x11, 0x9B, 0x05,
+		0x88, 0x91, 0xA8, 0x5A, 0x2D, 0x82, 0xC8, 0x01, 0xA1, 0x33, 0x1F, 0xA0, 0x50, 0x1F, 0x39, 0xA0,
+		0x3A, 0x08, 0x19, 0xB1, 0x68, 0x2D, 0x19, 0x5B, 0x9A, 0x10, 0x3B, 0x38, 0x9B, 0x78, 0xB1, 0x5A,
+		0x9A, 0x58, 0x90, 0x08, 0x5A, 0x2B, 0x00, 0xAA, 0xC3, 0xA6, 0xB2, 0x80, 0xA1, 0x79, 0x0A, 0x00,
+		0x10, 0xA8, 0x86, 0x3D, 0x80, 0x3C, 0xC8, 0x40, 0x99, 0x88, 0x40, 0x9A, 0x85, 0x4B, 0x09, 0x18,
+		0x09, 0x3D, 0x19, 0x3A, 0xBA, 0x90, 0xC4, 0xB3, 0x84, 0x30, 0x3F, 0x0A, 0x11, 0x0C, 0xE4, 0x82,
+		0x3A, 0x28, 0x3C, 0x8A, 0xF3, 0x82, 0x28, 0x1B, 0x10, 0x1C, 0x18, 0xD2, 0xA3, 0xA0, 0x42, 0x1A,
+		0x8C, 0x38, 0x10, 0x3F, 0xA0, 0x2C, 0x1A, 0x96, 0x00, 0xA0, 0x80, 0x91, 0xD0, 0x93, 0xF2, 0x80,
+		0x04, 0x99, 0x83, 0xAA, 0x00, 0x18, 0x43, 0x1F, 0x0C, 0x94, 0xA2, 0x2B, 0x22, 0xE1, 0x98, 0xB3,
+		0x98, 0x70, 0x5A, 0x3C, 0x8B, 0xA3, 0xA2, 0x59, 0x18, 0xC9, 0x03, 0x39, 0x3D, 0xC9, 0x48, 0xB0,
+		0x21, 0x4C, 0x9A, 0x11, 0x29, 0x4D, 0x1A, 0x88, 0x28, 0x91, 0xAA, 0x7B, 0x10, 0x1C, 0x93, 0xAA,
+		0x51, 0x2C, 0x18, 0xC8, 0x2A, 0x11, 0x12, 0x2F, 0x00, 0xAA, 0x85, 0x18, 0xAC, 0x14, 0x3C, 0xD1,
+		0x01, 0xA8, 0x40, 0xA0, 0x6B, 0xA8, 0x12, 0xB0, 0x18, 0x8C, 0x50, 0x1A, 0x19, 0x8C, 0xA7, 0x28,
+		0xB0, 0x92, 0xD1, 0x60, 0x98, 0xA0, 0xA3, 0x83, 0x18, 0x8F, 0x80, 0x08, 0x23, 0x4B, 0xF8, 0x92,
+		0x59, 0x0A, 0x20, 0x9A, 0xA0, 0x87, 0x9A, 0x01, 0x03, 0xE8, 0x83, 0x28, 0x0E, 0x02, 0x99, 0x11,
+		0x1D, 0x88, 0xA2, 0x90, 0xC5, 0xA3, 0x69, 0x2A, 0x80, 0x1C, 0x49, 0x88, 0x89, 0xB3, 0xC1, 0x90,
+		0x86, 0x4A, 0x0B, 0x19, 0xB3, 0x29, 0x79, 0x3C, 0x3C, 0xA8, 0x91, 0x88, 0x61, 0x88, 0x0C, 0xC3,
+		0xA3, 0xD3, 0xA3, 0x89, 0x95, 0x19, 0xC2, 0xA2, 0x48, 0xA8, 0x09, 0x84, 0x8A, 0x04, 0x90, 0x8C,
+		0x95, 0xC1, 0xA4, 0x02, 0xBA, 0x97, 0xB1, 0x30, 0x9B, 0x21, 0x3D, 0x08, 0x4B, 0x81, 0x2C, 0x3A,
+		0x4E, 0xA0, 0x08, 0xC0, 0xA5, 0x88, 0x30, 0x0C, 0xB3, 0x49, 0x80, 0xD1, 0x84, 0x0B, 0x01, 0x99,
+		0xA2, 0x15, 0x2D, 0xC1, 0x13, 0x0C, 0xA2, 0x48, 0xA9, 0x19, 0x60, 0x19, 0x09, 0x2F, 0x81, 0x1B,
+		0xA1, 0xC1, 0x12, 0x0C, 0x86, 0x90, 0x00, 0xE0, 0x92, 0xA1, 0x22, 0xBA, 0x82, 0xD5, 0x10, 0x2A,
+		0xC3, 0x19, 0xB0, 0x08, 0x21, 0x8A, 0x7A, 0xA3, 0x18, 0x3E, 0x09, 0x90, 0x89, 0x48, 0x29, 0x2F,
+		0xD3, 0x82, 0x59, 0x2C, 0x9A, 0x95, 0x2A, 0x28, 0x0C, 0x94, 0x0A, 0x20, 0x18, 0xB0, 0x82, 0xC0,
+		0x94, 0xF2, 0xD3, 0x93, 0x28, 0x8A, 0x02, 0x9A, 0x80, 0xD4, 0x10, 0x89, 0x05, 0x8B, 0x1A, 0x59,
+		0xD0, 0xA5, 0x02, 0xD0, 0x21, 0x0D, 0x01, 0x81, 0x29, 0x0B, 0xA1, 0x28, 0x7A, 0x99, 0x1A, 0x20,
+		0x48, 0xD0, 0x18, 0xE3, 0x11, 0x0C, 0x84, 0xAA, 0x85, 0x00, 0xA8, 0x1A, 0x81, 0x0B, 0x85, 0x7A,
+		0xB9, 0x22, 0x2C, 0x1C, 0x93, 0xC0, 0x02, 0x3A, 0x59, 0x9B, 0x0A, 0xB6, 0x08, 0x32, 0x2A, 0x9F,
+		0xA5, 0xA2, 0x08, 0x69, 0x89, 0x08, 0x5A, 0x29, 0x1B, 0x9A, 0x87, 0x3A, 0xB8, 0x12, 0x3A, 0x0E,
+		0xB2, 0x40, 0x1A, 0x8B, 0x91, 0xA7, 0xA0, 0x93, 0xB0, 0x70, 0x8A, 0x08, 0x90, 0xA4, 0x48, 0x0C,
+		0xC3, 0x21, 0xD0, 0x11, 0x39, 0x3D, 0x9A, 0xA1, 0xA4, 0x94, 0x99, 0xB3, 0xC5, 0x82, 0x39, 0x1A,
+		0xA8, 0xB0, 0x71, 0x2A, 0x3C, 0x09, 0xA9, 0x82, 0x79, 0x1A, 0x83, 0x80, 0x0F, 0x49, 0x98, 0x10,
+		0xC0, 0xA4, 0xB1, 0x78, 0x88, 0x0B, 0x00, 0x00, 0x2B, 0xC3, 0x95, 0xC1, 0x11, 0xAA, 0x87, 0x8A,
+		0x94, 0x0A, 0x48, 0x4B, 0xB8, 0xA3, 0x12, 0x9D, 0xA6, 0x92, 0x00, 0x98, 0x5B, 0x09, 0xE3, 0xB2,
+		0x03, 0x1A, 0xB3, 0xA8, 0x3A, 0xB1, 0xB2, 0x17, 0x0C, 0x81, 0xC5, 0x48, 0x2C, 0x29, 0x19, 0x3C,
+		0x98, 0x02, 0x0E, 0x80, 0x19, 0x48, 0xB9, 0x12, 0xA9, 0x89, 0x27, 0x3E, 0xA1, 0x2B, 0x98, 0xD3,
+		0x96, 0x10, 0xA9, 0x88, 0x58, 0xB0, 0x38, 0x01, 0x3F, 0x88, 0x8A, 0xA4, 0x18, 0x49, 0x9C, 0x03,
+		0x81, 0x01, 0x8C, 0x2B, 0xF3, 0xB3, 0x42, 0x0E, 0x91, 0xB2, 0x04, 0xA8, 0x28, 0x89, 0x08, 0x22,
+		0xF1, 0x19, 0xA1, 0x99, 0x22, 0x87, 0x18, 0xB8, 0xF2, 0x82, 0x2A, 0xC3, 0xB1, 0x50, 0x0E, 0x82,
+		0x3A, 0x19, 0x09, 0x90, 0x0B, 0x87, 0x5B, 0x9A, 0x92, 0x01, 0x3A, 0x3D, 0xC0, 0xA2, 0x42, 0x1A,
+		0xF0, 0x84, 0x3B, 0x8A, 0x94, 0xB0, 0xC4, 0x10, 0x3A, 0x0A, 0xA3, 0xA5, 0xB2, 0x83, 0x3F, 0x2A,
+		0x08, 0x1D, 0x12, 0xDA, 0xB3, 0x13, 0x4E, 0x99, 0x18, 0x92, 0x9B, 0x61, 0x2B, 0x29, 0xAA, 0x97,
+		0x00, 0xE1, 0x81, 0x11, 0xC8, 0x30, 0xA8, 0xA1, 0xA5, 0x92, 0x1B, 0x68, 0xB9, 0x10, 0x10, 0x89,
+		0x5C, 0xA9, 0x43, 0x0E, 0xA2, 0x10, 0x19, 0x48, 0xF8, 0x02, 0x80, 0x88, 0x89, 0x03, 0xA0, 0x4C,
+		0x98, 0xB1, 0x92, 0x2D, 0x70, 0x9A, 0x08, 0x90, 0x79, 0x09, 0x90, 0x89, 0x01, 0x94, 0xE3, 0xA3,
+		0x0A, 0x33, 0x2E, 0x3A, 0x1E, 0xB2, 0x90, 0x00, 0xB3, 0xA1, 0x24, 0xD9, 0x14, 0xCA, 0x04, 0x8B,
+		0x38, 0xA2, 0xF3, 0x20, 0x99, 0xB2, 0x3A, 0x6B, 0x09, 0xB1, 0xD2, 0x96, 0xD2, 0x02, 0x8A, 0x80,
+		0xC3, 0x94, 0x80, 0x00, 0xA8, 0xC3, 0x03, 0xD0, 0x13, 0x9C, 0x32, 0x8F, 0x02, 0xA0, 0xC4, 0xB2,
+		0x18, 0x38, 0xA8, 0xA7, 0x09, 0x03, 0x8D, 0xA4, 0xA3, 0x90, 0xB3, 0x69, 0x2C, 0x3B, 0x39, 0x2E,
+	};
+
+const sample_info_t sampleBank[] =
+	{
+		{"kick", kick_adpcm, 4000, 16000},
+		{"snare", snare_adpcm, 2880, 16000},
+	};
+
+const int sampleBankSize = sizeof(sampleBank) / sizeof(sampleBank[0]);
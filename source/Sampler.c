@@ -0,0 +1,185 @@
+/*
+ * Sampler.c - Playback of IMA-ADPCM samples from flash
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+
+#include "Sampler.h"
+#include "Adpcm.h"
+#include "AudioOut.h"
+#include "AudioArena.h"
+
+// Resampling position in 16.16 fixed point
+#define POSITION_ONE (0x10000)
+
+// Scale from velocity to Q15 gain
+#define VELOCITY_GAIN (258)
+
+// State of a single sample player
+typedef struct sample_player_s
+{
+	bool active; // Flag to check if the player is sounding
+	uint32_t age; // Order in which the samples were started
+	adpcm_state_t decoder;
+	uint32_t remaining; // Number of samples left to decode
+	uint32_t step; // Input samples per output sample in 16.16
+	uint32_t position; // Position between the previous and current sample in 16.16
+	int32_t previous; // Decoded samples around the output position
+	int32_t current;
+	int32_t gain; // Q15
+} sample_player_t;
+
+static sample_player_t* players = NULL; // Players borrowed from the audio arena
+static uint32_t triggerCounter = 0;
+
+
+/*
+ * Initialize the sampler
+ *
+ * Borrows the state of the players from the audio arena.
+ *
+ * @input None
+ * @return True if the players could be allocated, else False.
+ *
+ */
+bool Sampler_Init()
+{
+	players = Arena_Alloc(ARENA_VOICES, SAMPLER_MAX_PLAYERS * sizeof(sample_player_t), sizeof(uint32_t));
+	triggerCounter = 0;
+	return players != NULL;
+}
+
+
+/*
+ * Start playing a sample
+ *
+ * Takes an idle player, or the one which started first if all are busy.
+ *
+ * @input id		Index of the sample in the sample bank
+ * 		  velocity	Loudness of the sample (0 to 127)
+ * @return None
+ *
+ */
+void Sampler_Trigger(int id, uint8_t velocity)
+{
+	if(players == NULL || id < 0 || id >= sampleBankSize || sampleBank[id].numSamples == 0)
+		return;
+
+	sample_player_t* player = &players[0];
+	for(int i = 0; i < SAMPLER_MAX_PLAYERS; i++)
+	{
+		if(!players[i].active)
+		{
+			player = &players[i];
+			break;
+		}
+		if(players[i].age < player->age)
+			player = &players[i];
+	}
+
+	Adpcm_Start(&player->decoder, sampleBank[id].data);
+	player->remaining = sampleBank[id].numSamples - 1;
+	player->step = ((uint32_t)sampleBank[id].sampleRate << 16) / AudioOut_GetSampleRate();
+	player->position = 0;
+	player->previous = 0;
+	player->current = Adpcm_DecodeSample(&player->decoder);
+	player->gain = (velocity > 127 ? 127 : velocity) * VELOCITY_GAIN;
+	player->age = triggerCounter++;
+	player->active = true;
+}
+
+
+/*
+ * Returns the number of samples playing
+ *
+ * @input None
+ * @return Number of active players
+ *
+ */
+int Sampler_ActivePlayers()
+{
+	int count = 0;
+
+	if(players == NULL)
+		return 0;
+
+	for(int i = 0; i < SAMPLER_MAX_PLAYERS; i++)
+	{
+		if(players[i].active)
+			count++;
+	}
+	return count;
+}
+
+
+/*
+ * Render a single player
+ *
+ * @input player	Pointer to the player
+ * 		  block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+static void RenderPlayer(sample_player_t* player, int16_t* block, int offset, int count)
+{
+	int32_t sample;
+
+	for(int i = offset; i < offset + count; i++)
+	{
+		// Linear interpolation between the two decoded samples
+		sample = player->previous + (((player->current - player->previous) * (int32_t)(player->position >> 1)) >> 15);
+		sample = block[i] + ((sample * player->gain) >> 15);
+
+		if(sample > INT16_MAX)
+			sample = INT16_MAX;
+		else if(sample < INT16_MIN)
+			sample = INT16_MIN;
+		block[i] = sample;
+
+		// Decode as many samples as the output position moved over
+		player->position += player->step;
+		while(player->position >= POSITION_ONE)
+		{
+			player->position -= POSITION_ONE;
+			if(player->remaining == 0)
+			{
+				player->active = false;
+				return;
+			}
+			player->previous = player->current;
+			player->current = Adpcm_DecodeSample(&player->decoder);
+			player->remaining--;
+		}
+	}
+}
+
+
+/*
+ * Render a segment of the current block
+ *
+ * Decodes the playing samples and resamples them to the DAC sampling rate
+ * with linear interpolation. The samples are added to [offset, offset + count)
+ * of the block, saturating the result.
+ *
+ * @input block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+void Sampler_Render(int16_t* block, int offset, int count)
+{
+	if(players == NULL)
+		return;
+
+	for(int i = 0; i < SAMPLER_MAX_PLAYERS; i++)
+	{
+		if(players[i].active)
+			RenderPlayer(&players[i], block, offset, count);
+	}
+}
@@ -0,0 +1,341 @@
+/*
+ * Sequencer.c - Looping step patterns on a sample-accurate clock
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "Sequencer.h"
+#include "AudioOut.h"
+
+// A pattern, its steps are stored in two bytes each
+typedef struct seq_pattern_s
+{
+	uint8_t length; // Number of steps, 0 if empty
+	uint8_t position; // Index of the next step to play
+	uint8_t sounding; // Note held by the pattern, SEQ_REST if none
+	seq_step_t steps[SEQ_MAX_STEPS];
+} seq_pattern_t;
+
+static seq_pattern_t patterns[SEQ_MAX_PATTERNS];
+
+static bool running = false;
+static bool stopping = false; // Set until the sounding notes are ended
+
+// The clock counts pairs of steps, the first step of a pair starts on the
+// grid and the second one is delayed by the swing. The length of a pair
+// is pairSamples and pairRemainder / tempo samples.
+static uint16_t seqTempo;
+static uint8_t seqSwing = SEQ_MIN_SWING;
+static uint32_t pairStart; // Time of the first step of the current pair
+static uint32_t pairSamples;
+static uint32_t pairRemainder;
+static uint32_t pairError; // Fraction of a sample accumulated, in 1 / tempo
+static uint32_t swingSamples; // Start of the second step within a pair
+static bool secondOfPair = false; // Set when the next step is the second of a pair
+
+
+/*
+ * Store a pattern
+ *
+ * Patterns shorter than the others loop on their own. A pattern of length 0
+ * is empty. The pattern can be changed while the sequencer is running, the
+ * new steps are played from the next step on.
+ *
+ * @input pattern	Index of the pattern (0 to SEQ_MAX_PATTERNS - 1)
+ * 		  steps		Pointer to the steps
+ * 		  length	Number of steps (0 to SEQ_MAX_STEPS)
+ * @return True if the pattern was stored, else False.
+ *
+ */
+bool Sequencer_SetPattern(int pattern, const seq_step_t* steps, int length)
+{
+	if(pattern < 0 || pattern >= SEQ_MAX_PATTERNS || length < 0 || length > SEQ_MAX_STEPS)
+		return false;
+
+	memcpy(patterns[pattern].steps, steps, length * sizeof(seq_step_t));
+	patterns[pattern].length = length;
+	if(patterns[pattern].position >= length)
+		patterns[pattern].position = 0;
+	return true;
+}
+
+
+/*
+ * Set the velocity of a step
+ *
+ * @input pattern	Index of the pattern
+ * 		  step		Index of the step
+ * 		  velocity	Loudness of the step (1 to 127)
+ * @return True if the step exists, else False.
+ *
+ */
+bool Sequencer_SetVelocity(int pattern, int step, uint8_t velocity)
+{
+	if(pattern < 0 || pattern >= SEQ_MAX_PATTERNS || step < 0 || step >= patterns[pattern].length)
+		return false;
+
+	patterns[pattern].steps[step].velocity = (velocity > 127) ? 127 : velocity;
+	return true;
+}
+
+
+/*
+ * Returns the steps of a pattern
+ *
+ * @input pattern	Index of the pattern
+ * 		  length	Pointer to store the number of steps
+ * @return Pointer to the steps, NULL if the pattern doesn't exist.
+ *
+ */
+const seq_step_t* Sequencer_GetPattern(int pattern, int* length)
+{
+	if(pattern < 0 || pattern >= SEQ_MAX_PATTERNS)
+		return NULL;
+
+	*length = patterns[pattern].length;
+	return patterns[pattern].steps;
+}
+
+
+/*
+ * Set the length of a pair of steps
+ *
+ * @input tempo		Beats per minute, four steps per beat
+ * @return None
+ *
+ */
+static void SetClock(uint16_t tempo)
+{
+	uint32_t samplesPerTwoMinutes = AudioOut_GetSampleRate() * 120;
+
+	// Two steps take 120 / (tempo * SEQ_STEPS_PER_BEAT) seconds
+	seqTempo = tempo;
+	pairSamples = (samplesPerTwoMinutes / SEQ_STEPS_PER_BEAT) / tempo;
+	pairRemainder = (samplesPerTwoMinutes / SEQ_STEPS_PER_BEAT) % tempo;
+	pairError = 0;
+	swingSamples = (pairSamples * seqSwing) / 100;
+}
+
+
+/*
+ * Start the sequencer
+ *
+ * All the patterns restart from their first step with the next block.
+ *
+ * @input tempo		Beats per minute, four steps per beat
+ * 		  swing		Percent of a pair of steps taken by the first step
+ * 					(SEQ_MIN_SWING to SEQ_MAX_SWING)
+ * @return None
+ *
+ */
+void Sequencer_Start(uint16_t tempo, uint8_t swing)
+{
+	if(tempo == 0)
+		return;
+	if(swing < SEQ_MIN_SWING)
+		swing = SEQ_MIN_SWING;
+	else if(swing > SEQ_MAX_SWING)
+		swing = SEQ_MAX_SWING;
+
+	seqSwing = swing;
+	SetClock(tempo);
+	pairStart = AudioOut_GetSampleTime();
+	secondOfPair = false;
+
+	// The notes still sounding are ended by the first step
+	for(int i = 0; i < SEQ_MAX_PATTERNS; i++)
+	{
+		patterns[i].position = 0;
+	}
+
+	stopping = false;
+	running = true;
+}
+
+
+/*
+ * Change the tempo of the running sequencer
+ *
+ * The patterns keep their position, the pair of steps being played
+ * ends at the new tempo. Ignored while the sequencer is stopped.
+ *
+ * @input tempo		Beats per minute
+ * @return None
+ *
+ */
+void Sequencer_SetTempo(uint16_t tempo)
+{
+	if(!running || tempo == 0 || tempo == seqTempo)
+		return;
+
+	SetClock(tempo);
+}
+
+
+/*
+ * Stop the sequencer
+ *
+ * The sounding notes are ended with the next block.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Sequencer_Stop()
+{
+	if(running)
+		stopping = true;
+}
+
+
+/*
+ * Returns whether the sequencer is running
+ *
+ * @input None
+ * @return True until the stop has been played, else False.
+ *
+ */
+bool Sequencer_IsRunning()
+{
+	return running;
+}
+
+
+/*
+ * Returns the tempo of the sequencer
+ *
+ * @input None
+ * @return Beats per minute set by the last start or tempo change
+ *
+ */
+uint16_t Sequencer_GetTempo()
+{
+	return seqTempo;
+}
+
+
+/*
+ * Returns the swing of the sequencer
+ *
+ * @input None
+ * @return Swing set by the last start, in percent of a pair of steps
+ *
+ */
+uint8_t Sequencer_GetSwing()
+{
+	return seqSwing;
+}
+
+
+/*
+ * Returns the time of the next step
+ *
+ * Called by the render of every block, which splits the block at the step.
+ *
+ * @input timestamp		Pointer to store the time of the step in samples
+ * @return True if a step is pending, False if the sequencer is stopped.
+ *
+ */
+bool Sequencer_NextStep(uint32_t* timestamp)
+{
+	if(!running)
+		return false;
+
+	if(stopping)
+		*timestamp = AudioOut_GetSampleTime();
+	else
+		*timestamp = pairStart + (secondOfPair ? swingSamples : 0);
+	return true;
+}
+
+
+/*
+ * Play the next step
+ *
+ * Produces the events of every pattern at the step and advances the clock.
+ *
+ * @input events	Array of at least SEQ_MAX_EVENTS events to fill
+ * @return Number of events
+ *
+ */
+int Sequencer_Step(note_event_t* events)
+{
+	seq_pattern_t* pattern;
+	const seq_step_t* step;
+	uint32_t timestamp;
+	int count = 0;
+
+	if(!Sequencer_NextStep(&timestamp))
+		return 0;
+
+	for(int i = 0; i < SEQ_MAX_PATTERNS; i++)
+	{
+		pattern = &patterns[i];
+		step = NULL;
+
+		if(!stopping && pattern->length > 0)
+		{
+			if(pattern->position >= pattern->length)
+				pattern->position = 0;
+			step = &pattern->steps[pattern->position++];
+
+			if(step->key == SEQ_TIE)
+				continue;
+		}
+
+		// Every step but a tie ends the note of the pattern
+		if(pattern->sounding != SEQ_REST)
+		{
+			events[count].timestamp = timestamp;
+			events[count].type = EVENT_NOTE_OFF;
+			events[count].key = pattern->sounding;
+			events[count].value = 0;
+			count++;
+			pattern->sounding = SEQ_REST;
+		}
+
+		if(step == NULL || step->key == SEQ_REST)
+			continue;
+
+		events[count].timestamp = timestamp;
+		events[count].value = step->velocity;
+		if(step->key & SEQ_DRUM)
+		{
+			events[count].type = EVENT_DRUM;
+			events[count].key = step->key & ~SEQ_DRUM;
+		}
+		else
+		{
+			events[count].type = EVENT_NOTE_ON;
+			events[count].key = step->key;
+			pattern->sounding = step->key;
+		}
+		count++;
+	}
+
+	if(stopping)
+	{
+		stopping = false;
+		running = false;
+		return count;
+	}
+
+	// Move on to the next step, a new pair after the second one
+	if(secondOfPair)
+	{
+		pairStart += pairSamples;
+		pairError += pairRemainder;
+		if(pairError >= seqTempo)
+		{
+			pairError -= seqTempo;
+			pairStart++;
+		}
+	}
+	secondOfPair = !secondOfPair;
+
+	return count;
+}
@@ -0,0 +1,450 @@
+/*
+ * Song.c - Song kept in the flash and played straight from it
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "Song.h"
+#include "AudioOut.h"
+#include "Crc16.h"
+#include "Drums.h"
+#include "Nvm.h"
+
+// Longest delta time, 4 bytes of 7 bits
+#define SONG_MAX_DELTA_BYTES (4)
+
+// Notes which can sound, one bit per MIDI note
+#define SONG_NOTES (128)
+
+static bool valid = false;
+static const song_header_t* header; // In the flash, when valid
+
+// Upload in progress, started by erasing the first sector
+static uint32_t uploadOffset = 0; // Offset of the next bytes, 0 if no upload
+static uint16_t uploadCrc;
+
+static bool running = false;
+static bool stopping = false; // Set until the sounding notes are ended
+static const uint8_t* position; // Event after the delta time of the next event
+static const uint8_t* end; // End of the song in the flash
+static uint16_t bar;
+static uint8_t sounding[SONG_NOTES / 8];
+
+// The length of a tick is tickSamples and tickRemainder / tickDivisor samples
+static uint32_t eventTime; // Time of the next event
+static uint32_t tickSamples;
+static uint32_t tickRemainder;
+static uint32_t tickDivisor;
+static uint32_t tickError;
+
+
+/*
+ * Check a header against the bytes after it
+ *
+ * @input songHeader	Header to check
+ * 		  crc			CRC of the bytes after the header
+ * @return True if the header describes a song which can be played, else False.
+ *
+ */
+static bool CheckHeader(const song_header_t* songHeader, uint16_t crc)
+{
+	const song_bar_t* index = Nvm_Read(SONG_FLASH_ADDRESS + SONG_HEADER_SIZE);
+	uint32_t first = SONG_HEADER_SIZE + songHeader->bars * sizeof(song_bar_t);
+	uint32_t last = SONG_HEADER_SIZE + songHeader->length;
+
+	if(songHeader->magic != SONG_MAGIC || songHeader->version != SONG_VERSION ||
+			songHeader->length > SONG_FLASH_SIZE - SONG_HEADER_SIZE || songHeader->crc != crc ||
+			songHeader->bars == 0 || first >= last || songHeader->ticksPerBeat == 0 ||
+			songHeader->tempo < SONG_MIN_TEMPO || songHeader->tempo > SONG_MAX_TEMPO)
+		return false;
+
+	// Every bar starts inside the events
+	for(int i = 0; i < songHeader->bars; i++)
+	{
+		if(index[i].offset < first || index[i].offset >= last ||
+				index[i].tempo < SONG_MIN_TEMPO || index[i].tempo > SONG_MAX_TEMPO)
+			return false;
+	}
+	return true;
+}
+
+
+/*
+ * Initialize the song
+ *
+ * Checks the header and the CRC of the song in the flash.
+ *
+ * @input None
+ * @return True if a complete song is in the flash, else False.
+ *
+ */
+bool Song_Init()
+{
+	const song_header_t* songHeader = Nvm_Read(SONG_FLASH_ADDRESS);
+	uint16_t crc;
+
+	valid = false;
+	uploadOffset = 0;
+
+	if(!Nvm_Init() || songHeader->magic != SONG_MAGIC ||
+			songHeader->length > SONG_FLASH_SIZE - SONG_HEADER_SIZE)
+		return false;
+
+	crc = Crc16_Update(CRC16_INIT, Nvm_Read(SONG_FLASH_ADDRESS + SONG_HEADER_SIZE), songHeader->length);
+	if(!CheckHeader(songHeader, crc))
+		return false;
+
+	header = songHeader;
+	valid = true;
+	return true;
+}
+
+
+/*
+ * End the song at once
+ *
+ * The events are not read anymore, only the sounding notes are ended.
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void Abort()
+{
+	if(running)
+		stopping = true;
+}
+
+
+/*
+ * Erase a sector of the song
+ *
+ * Stops the song, which is not valid until the next commit. The audio
+ * stops while the sector is erased.
+ *
+ * @input sector	Sector (0 to SONG_FLASH_SECTORS - 1)
+ * @return True if the sector was erased, else False.
+ *
+ */
+bool Song_Erase(uint8_t sector)
+{
+	if(sector >= SONG_FLASH_SECTORS)
+		return false;
+
+	Abort();
+	valid = false;
+
+	// Erasing the header starts an upload
+	if(sector == 0)
+	{
+		uploadOffset = SONG_HEADER_SIZE;
+		uploadCrc = CRC16_INIT;
+	}
+
+	return Nvm_Erase(SONG_FLASH_ADDRESS + (uint32_t)sector * NVM_SECTOR_SIZE);
+}
+
+
+/*
+ * Write the bytes of the song after the header
+ *
+ * The bytes have to be written in order from SONG_HEADER_SIZE into erased
+ * sectors, they are read back into the CRC of the upload.
+ *
+ * @input offset	Offset of the bytes from the start of the song
+ * 		  data		Pointer to the bytes
+ * 		  length	Number of bytes, a multiple of 4
+ * @return True if the bytes were written, else False.
+ *
+ */
+bool Song_Write(uint32_t offset, const void* data, uint32_t length)
+{
+	uint32_t address = SONG_FLASH_ADDRESS + offset;
+
+	if(uploadOffset == 0 || offset != uploadOffset || (length % NVM_PROGRAM_UNIT) != 0 ||
+			offset + length > SONG_FLASH_SIZE)
+		return false;
+
+	if(!Nvm_Program(address, data, length) || memcmp(Nvm_Read(address), data, length) != 0)
+		return false;
+
+	uploadCrc = Crc16_Update(uploadCrc, Nvm_Read(address), length);
+	uploadOffset += length;
+	return true;
+}
+
+
+/*
+ * Complete the upload with the header
+ *
+ * @input songHeader	Header of the song, its length and CRC have to match
+ * 						the bytes written
+ * @return True if the song is valid, else False.
+ *
+ */
+bool Song_Commit(const song_header_t* songHeader)
+{
+	if(uploadOffset == 0 || songHeader->length != uploadOffset - SONG_HEADER_SIZE ||
+			!CheckHeader(songHeader, uploadCrc))
+		return false;
+
+	uploadOffset = 0;
+	if(!Nvm_Program(SONG_FLASH_ADDRESS, songHeader, SONG_HEADER_SIZE) ||
+			memcmp(Nvm_Read(SONG_FLASH_ADDRESS), songHeader, SONG_HEADER_SIZE) != 0)
+		return false;
+
+	header = Nvm_Read(SONG_FLASH_ADDRESS);
+	valid = true;
+	return true;
+}
+
+
+/*
+ * Set the length of a tick
+ *
+ * The fraction of a sample the events are behind is kept, so tempo
+ * changes don't add up to a drift.
+ *
+ * @input tempo		Beats per minute
+ * 		  restart	Flag to start without a fraction
+ * @return None
+ *
+ */
+static void SetTempo(uint16_t tempo, bool restart)
+{
+	uint32_t samplesPerMinute = AudioOut_GetSampleRate() * 60;
+	uint32_t divisor = (uint32_t)tempo * header->ticksPerBeat;
+
+	tickError = restart ? 0 : (uint32_t)(((uint64_t)tickError * divisor) / tickDivisor);
+	tickDivisor = divisor;
+	tickSamples = samplesPerMinute / tickDivisor;
+	tickRemainder = samplesPerMinute % tickDivisor;
+}
+
+
+/*
+ * Read the delta time of the next event and advance its time
+ *
+ * @input None
+ * @return True if the delta time was read, False at the end of the song.
+ *
+ */
+static bool ReadDelta()
+{
+	uint32_t ticks = 0;
+	uint64_t error;
+	int i;
+
+	for(i = 0; i < SONG_MAX_DELTA_BYTES && position < end; i++)
+	{
+		ticks = (ticks << 7) | (*position & 0x7F);
+		if((*position++ & 0x80) == 0)
+			break;
+	}
+	if(i == SONG_MAX_DELTA_BYTES || position >= end)
+		return false;
+
+	error = (uint64_t)ticks * tickRemainder + tickError;
+	eventTime += ticks * tickSamples + (uint32_t)(error / tickDivisor);
+	tickError = (uint32_t)(error % tickDivisor);
+	return true;
+}
+
+
+/*
+ * Start playing the song
+ *
+ * The events are read from the flash as they are played, starting with
+ * the next block.
+ *
+ * @input startBar	Bar to start from (0 to bars - 1)
+ * @return True if the song was started, else False.
+ *
+ */
+bool Song_Start(uint16_t startBar)
+{
+	const song_bar_t* index = Nvm_Read(SONG_FLASH_ADDRESS + SONG_HEADER_SIZE);
+
+	if(!valid || running || startBar >= header->bars)
+		return false;
+
+	position = Nvm_Read(SONG_FLASH_ADDRESS + index[startBar].offset);
+	end = Nvm_Read(SONG_FLASH_ADDRESS + SONG_HEADER_SIZE + header->length);
+	bar = startBar;
+	memset(sounding, 0, sizeof(sounding));
+
+	SetTempo(index[startBar].tempo, true);
+	eventTime = AudioOut_GetSampleTime();
+	if(!ReadDelta())
+		return false;
+
+	stopping = false;
+	running = true;
+	return true;
+}
+
+
+/*
+ * Stop the song
+ *
+ * The sounding notes are ended with the next block.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Song_Stop()
+{
+	Abort();
+}
+
+
+/*
+ * Returns whether the song is playing
+ *
+ * @input None
+ * @return True until the stop has been played, else False.
+ *
+ */
+bool Song_IsRunning()
+{
+	return running;
+}
+
+
+/*
+ * Get the state of the song
+ *
+ * @input info	Pointer to store the state
+ * @return None
+ *
+ */
+void Song_GetInfo(song_info_t* info)
+{
+	info->valid = valid;
+	info->playing = running && !stopping;
+	info->bar = bar;
+	info->written = (uploadOffset != 0) ? uploadOffset - SONG_HEADER_SIZE : 0;
+	info->header = valid ? header : NULL;
+}
+
+
+/*
+ * Returns the time of the next event
+ *
+ * Called by the render of every block, which splits the block at the event.
+ *
+ * @input timestamp		Pointer to store the time in samples
+ * @return True if an event is pending, False if the song is stopped.
+ *
+ */
+bool Song_NextStep(uint32_t* timestamp)
+{
+	if(!running)
+		return false;
+
+	*timestamp = stopping ? AudioOut_GetSampleTime() : eventTime;
+	return true;
+}
+
+
+/*
+ * End the next sounding note, or the song once none is left
+ *
+ * @input events	Array of at least one event to fill
+ * @return Number of events
+ *
+ */
+static int StopStep(note_event_t* events)
+{
+	for(int note = 0; note < SONG_NOTES; note++)
+	{
+		if(sounding[note / 8] & (1 << (note % 8)))
+		{
+			sounding[note / 8] &= ~(1 << (note % 8));
+			events[0].timestamp = AudioOut_GetSampleTime();
+			events[0].type = EVENT_NOTE_OFF;
+			events[0].key = note;
+			events[0].value = 0;
+			return 1;
+		}
+	}
+
+	stopping = false;
+	running = false;
+	return 0;
+}
+
+
+/*
+ * Play the next event
+ *
+ * @input events	Array of at least one event to fill
+ * @return Number of events
+ *
+ */
+int Song_Step(note_event_t* events)
+{
+	uint8_t code;
+	int count = 0;
+
+	if(!running)
+		return 0;
+
+	if(stopping)
+		return StopStep(events);
+
+	code = *position++;
+	events[0].timestamp = eventTime;
+
+	if(code < SONG_DRUM && position < end)
+	{
+		events[0].type = (*position != 0) ? EVENT_NOTE_ON : EVENT_NOTE_OFF;
+		events[0].key = code;
+		events[0].value = *position++;
+		if(events[0].value != 0)
+			sounding[code / 8] |= 1 << (code % 8);
+		else
+			sounding[code / 8] &= ~(1 << (code % 8));
+		count = 1;
+	}
+	else if((code & 0xF0) == SONG_DRUM && (code & 0x0F) < DRUMS && position < end)
+	{
+		events[0].type = EVENT_DRUM;
+		events[0].key = code & 0x0F;
+		events[0].value = *position++;
+		count = 1;
+	}
+	else if(code == SONG_TEMPO && position + 1 < end)
+	{
+		events[0].type = EVENT_TEMPO;
+		events[0].key = 0;
+		events[0].value = position[0] | (position[1] << 8);
+		position += 2;
+		if(events[0].value < SONG_MIN_TEMPO || events[0].value > SONG_MAX_TEMPO)
+		{
+			stopping = true;
+			return 0;
+		}
+		SetTempo(events[0].value, false);
+		count = 1;
+	}
+	else if(code == SONG_BAR)
+	{
+		bar++;
+	}
+	else
+	{
+		// End of the song, or bytes which are not an event
+		stopping = true;
+		return 0;
+	}
+
+	if(!ReadDelta())
+		stopping = true;
+	return count;
+}
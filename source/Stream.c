@@ -0,0 +1,314 @@
+/*
+ * Stream.c - Playback of PCM audio streamed over UART0
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stddef.h>
+
+#include "Stream.h"
+#include "AudioOut.h"
+#include "AudioArena.h"
+#include "SysTick.h"
+#include "UART_IO.h"
+
+// Software flow control characters
+#define XON (0x11)
+#define XOFF (0x13)
+
+// Fill levels of the jitter buffer
+#define PREBUFFER_LEVEL (STREAM_BUFFER_SIZE / 2) // Playback starts here
+#define XOFF_LEVEL (STREAM_BUFFER_SIZE * 3 / 4) // The host is paused here
+#define XON_LEVEL (STREAM_BUFFER_SIZE / 2) // and resumed here
+
+// Resampling position in 16.16 fixed point
+#define POSITION_ONE (0x10000)
+
+static uint8_t* buffer = NULL; // Jitter buffer borrowed from the audio arena
+
+// Free running indices, the head is only written by the UART interrupt
+// and the tail only by the renderer
+static volatile uint32_t head = 0;
+static volatile uint32_t tail = 0;
+
+static volatile bool active = false; // Flag to check if a stream is active
+static volatile bool xoffSent = false; // Flag to check if the host is paused
+static volatile ticktime_t lastReceived = 0; // Time of the last received byte
+static bool playing = false; // Cleared while the buffer fills up
+
+static uint8_t sampleBits = 8;
+static uint8_t pairPhase = 0; // Position in a pair of 12-bit samples
+static uint8_t pairNibble = 0; // Upper nibble of the middle byte of a pair
+static uint32_t step = 0; // Stream samples per output sample in 16.16
+static uint32_t position = 0;
+static int32_t previous = 0; // Stream samples around the output position
+static int32_t current = 0;
+
+static stream_stats_t stats;
+
+
+/*
+ * Initialize the stream
+ *
+ * Borrows the jitter buffer from the audio arena.
+ *
+ * @input None
+ * @return True if the buffer could be allocated, else False.
+ *
+ */
+bool Stream_Init()
+{
+	buffer = Arena_Alloc(ARENA_STREAM, STREAM_BUFFER_SIZE, 1);
+	active = false;
+	return buffer != NULL;
+}
+
+
+/*
+ * Receive a byte of the stream
+ *
+ * Called by the UART0 interrupt for every received byte.
+ *
+ * @input ch	Received byte
+ * @return None
+ *
+ */
+static void ReceiveByte(uint8_t ch)
+{
+	uint32_t fill = head - tail;
+
+	lastReceived = now();
+	stats.bytesReceived++;
+
+	if(fill >= STREAM_BUFFER_SIZE)
+	{
+		stats.overruns++;
+		return;
+	}
+
+	buffer[head & (STREAM_BUFFER_SIZE - 1)] = ch;
+	head++;
+	fill++;
+
+	if(fill > stats.maxFill)
+		stats.maxFill = fill;
+
+	if(fill >= XOFF_LEVEL && !xoffSent)
+	{
+		xoffSent = true;
+		stats.xoffCount++;
+		UART0_SendFlowControl(XOFF);
+	}
+}
+
+
+/*
+ * Start streaming
+ *
+ * Received bytes go to the jitter buffer instead of the console until no
+ * data arrives for STREAM_TIMEOUT_TICKS. Playback starts once the buffer
+ * is half full. The host is paused with XOFF when the buffer is three
+ * quarters full and resumed with XON when it is half full again.
+ *
+ * @input sampleRate	Rate of the streamed samples in Hz
+ * 		  bits			8 for unsigned bytes, 12 for two samples packed in three bytes
+ * @return True if the stream was started, else False.
+ *
+ */
+bool Stream_Start(uint16_t sampleRate, uint8_t bits)
+{
+	if(buffer == NULL || active || (bits != 8 && bits != 12) ||
+			sampleRate < STREAM_MIN_RATE || sampleRate > STREAM_MAX_RATE)
+		return false;
+
+	head = 0;
+	tail = 0;
+	xoffSent = false;
+	playing = false;
+	sampleBits = bits;
+	pairPhase = 0;
+	step = ((uint32_t)sampleRate << 16) / AudioOut_GetSampleRate();
+	position = 0;
+	previous = 0;
+	current = 0;
+
+	stats = (stream_stats_t){0};
+	stats.active = true;
+	stats.sampleRate = sampleRate;
+	stats.bits = bits;
+	stats.minFill = STREAM_BUFFER_SIZE;
+
+	lastReceived = now();
+	active = true;
+	UART0_SetReceiveHandler(&ReceiveByte);
+	return true;
+}
+
+
+/*
+ * Stop streaming and give the UART back to the console
+ *
+ * @input None
+ * @return None
+ *
+ */
+static void StopStream()
+{
+	UART0_SetReceiveHandler(NULL);
+	if(xoffSent)
+	{
+		xoffSent = false;
+		UART0_SendFlowControl(XON);
+	}
+	active = false;
+	stats.active = false;
+}
+
+
+/*
+ * Check if a stream is active
+ *
+ * @input None
+ * @return True if the stream is active, else False.
+ *
+ */
+bool Stream_IsActive()
+{
+	return active;
+}
+
+
+/*
+ * Get the statistics of the last or current stream
+ *
+ * @input stats		Pointer to store the statistics
+ * @return None
+ *
+ */
+void Stream_GetStats(stream_stats_t* out)
+{
+	*out = stats;
+	out->fill = head - tail;
+	if(out->minFill > out->maxFill)
+		out->minFill = out->maxFill;
+}
+
+
+/*
+ * Read the next sample from the jitter buffer
+ *
+ * @input sample	Pointer to store the sample in Q15
+ * @return True if enough data was buffered, else False.
+ *
+ */
+static bool NextSample(int32_t* sample)
+{
+	uint32_t fill = head - tail;
+	uint32_t value;
+
+	if(sampleBits == 8)
+	{
+		if(fill < 1)
+			return false;
+		*sample = ((int32_t)buffer[tail & (STREAM_BUFFER_SIZE - 1)] - 128) << 8;
+		tail++;
+		return true;
+	}
+
+	// Two 12-bit samples in three bytes, low byte first
+	if(pairPhase == 0)
+	{
+		if(fill < 2)
+			return false;
+		value = buffer[tail & (STREAM_BUFFER_SIZE - 1)];
+		value |= (buffer[(tail + 1) & (STREAM_BUFFER_SIZE - 1)] & 0x0F) << 8;
+		pairNibble = buffer[(tail + 1) & (STREAM_BUFFER_SIZE - 1)] >> 4;
+		tail += 2;
+	}
+	else
+	{
+		if(fill < 1)
+			return false;
+		value = pairNibble | (buffer[tail & (STREAM_BUFFER_SIZE - 1)] << 4);
+		tail++;
+	}
+	pairPhase ^= 1;
+
+	*sample = ((int32_t)value - 2048) << 4;
+	return true;
+}
+
+
+/*
+ * Render a segment of the current block
+ *
+ * Upsamples the streamed samples to the DAC sampling rate with linear
+ * interpolation and adds them to [offset, offset + count) of the block.
+ *
+ * @input block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+void Stream_Render(int16_t* block, int offset, int count)
+{
+	uint32_t fill;
+	int32_t sample;
+	bool timedOut;
+
+	if(!active)
+		return;
+
+	fill = head - tail;
+	timedOut = (now() - lastReceived) > STREAM_TIMEOUT_TICKS;
+
+	if(!playing)
+	{
+		// Wait for the buffer to fill up, or play the rest of a short stream
+		if(fill >= PREBUFFER_LEVEL || (timedOut && fill > 0))
+			playing = true;
+		else if(timedOut)
+			StopStream();
+		return;
+	}
+
+	for(int i = offset; i < offset + count; i++)
+	{
+		sample = previous + (((current - previous) * (int32_t)(position >> 1)) >> 15);
+		sample += block[i];
+
+		if(sample > INT16_MAX)
+			sample = INT16_MAX;
+		else if(sample < INT16_MIN)
+			sample = INT16_MIN;
+		block[i] = sample;
+
+		position += step;
+		while(position >= POSITION_ONE)
+		{
+			position -= POSITION_ONE;
+			previous = current;
+			if(!NextSample(&current))
+			{
+				// Ran dry, hold the last sample and buffer up again
+				if(!timedOut)
+					stats.underruns++;
+				playing = false;
+				position = 0;
+				return;
+			}
+		}
+	}
+
+	fill = head - tail;
+	if(fill < stats.minFill)
+		stats.minFill = fill;
+
+	if(xoffSent && fill <= XON_LEVEL)
+	{
+		xoffSent = false;
+		UART0_SendFlowControl(XON);
+	}
+}
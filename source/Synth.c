@@ -0,0 +1,781 @@
+/*
+ * Synth.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Surya Kanteti
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Synth.h"
+#include "AudioOut.h"
+#include "Lfo.h"
+#include "fp_trig.h"
+#include "Noise.h"
+#include "AudioArena.h"
+#include "RamCode.h"
+
+#define Q15_ONE (32767)
+
+// Lengths of the envelope ramps in samples at DAC_SAMPLING_RATE,
+// scaled to the current rate so they keep their duration
+#define ATTACK_SAMPLES (256) // 5.3 ms
+#define RELEASE_SAMPLES (1024) // 21.3 ms
+
+// Phase increment just below the Nyquist frequency
+#define MAX_INCREMENT (0x7FFFFFFFUL)
+
+// Frequency ratio of no bend in Q16, and ln(2) / 12 in Q16 to turn
+// semitones into the exponent of the ratio
+#define BEND_UNITY (65536)
+#define Q16_LN2_PER_SEMITONE (3786)
+
+// Delay lines of the plucked strings, in samples (a power of 2)
+#define PLUCK_LINE_SHIFT (8)
+#define PLUCK_LINE_LENGTH (1 << PLUCK_LINE_SHIFT)
+#define PLUCK_LINE_MASK (PLUCK_LINE_LENGTH - 1)
+
+// Longest period of a string, leaving room for the three filter taps.
+// Lower notes are plucked an octave up (below 190 Hz at 48 kHz).
+#define PLUCK_MAX_PERIOD (PLUCK_LINE_LENGTH - 4)
+
+// Delay of the two-tap averaging filter, half a sample in 16.16
+#define PLUCK_FILTER_DELAY (0x8000)
+
+// Radians in Q8 to cycles in Q12 (4096 / 256 / 2pi = 10430 / 4096),
+// scaled up by 32768 / 32592 as fp_sin_phase() peaks at 32592
+#define FM_RADIANS_TO_CYCLES (10486)
+#define FM_RADIANS_SHIFT (12)
+
+// Phase offset of the carrier from a Q12 cycle depth and a Q15 sine
+#define FM_OFFSET_SHIFT (32 - 12 - 15)
+
+// Seed of the noise burst
+#define PLUCK_NOISE_SEED (0xACE1)
+
+// MIDI note number of C4 and the number of notes in an octave
+#define NOTE_C4 (60)
+#define NOTES_PER_OCTAVE (12)
+
+/*
+ * Phase increments of the notes from C4 to B4 at DAC_SAMPLING_RATE
+ * (frequency * 2^32 / DAC_SAMPLING_RATE), other octaves are shifted.
+ * Generated using a Python script.
+ */
+static const uint32_t octaveIncrements[NOTES_PER_OCTAVE] =
+	{	23409862, 24801879, 26276681, 27839173, 29494578, 31248410,
+		33106538, 35075155, 37160836, 39370534, 41711631, 44191930
+	};
+
+// State of a single voice
+typedef struct voice_s
+{
+	bool active; // Flag to check if the voice is sounding
+	uint8_t note; // MIDI note number
+	bool released; // Flag to check if the note has been released
+	uint32_t age; // Order in which the notes were started
+	uint32_t phase; // Phase accumulator of the oscillator
+	uint32_t phaseIncrement; // Phase advance per sample without modulation
+	int32_t incrementStart; // Modulated phase increment at the start of the block
+	int32_t incrementStep; // Change of the phase increment per sample
+	int32_t level; // Envelope level in Q15
+	int32_t peak; // Envelope level reached after the attack
+	int32_t levelStep; // Change of the envelope level per sample
+	int16_t* line; // Delay line of the plucked string
+	uint16_t writeIndex; // Position of the next sample in the delay line
+	uint16_t delay; // Whole samples of the string period
+	int32_t fraction; // Fractional sample of the string period in Q15
+	uint32_t modPhase; // Phase accumulator of the FM modulator
+	uint32_t modIncrement; // Modulator phase advance at the start of the block
+	int32_t modIncrementStep; // Change of the modulator phase increment per sample
+} voice_t;
+
+static voice_t* voices = NULL; // Voices borrowed from the audio arena
+static int numVoices = 0;
+static uint32_t noteCounter = 0;
+static int32_t attackSamples = ATTACK_SAMPLES; // Envelope ramps at the current rate
+static int32_t releaseSamples = RELEASE_SAMPLES;
+static synth_wave_t waveform = SYNTH_WAVE_SINE;
+static noise_t pluckNoise; // Noise generator of the plucks
+
+static const char* waveNames[SYNTH_WAVES] = {
+		"sine", "pluck", "fm"
+};
+
+// FM patch, the depth is in cycles of the carrier in Q12.
+// Starts with a ratio of 2 and an index of 2, half of it following the envelope.
+static uint32_t fmRatio = 2 << 8; // Q8
+static int32_t fmDepthBase = 652; // Part of the depth independent of the envelope
+static int32_t fmDepthScale = 651; // Part of the depth following the envelope
+static uint16_t fmIndex = 2 << 8; // Q8, as set by the last patch
+static uint8_t fmEnvelope = 50;
+
+// Modulation over the current block
+static int32_t vibratoStart, vibratoEnd;
+static int32_t gainStart, gainStep;
+
+// Frequency ratio of the pitch bend in Q16
+static uint32_t bendRatio = BEND_UNITY;
+
+
+/*
+ * Calculate the phase increment of a note
+ *
+ * The table is scaled from DAC_SAMPLING_RATE to the current rate, notes
+ * above the Nyquist frequency are held at it.
+ *
+ * @input note		MIDI note number
+ * @return Phase advance per sample
+ *
+ */
+static uint32_t NoteIncrement(uint8_t note)
+{
+	int octave = (note / NOTES_PER_OCTAVE) - (NOTE_C4 / NOTES_PER_OCTAVE);
+	uint64_t increment = octaveIncrements[note % NOTES_PER_OCTAVE];
+
+	if(octave >= 0)
+		increment <<= octave;
+	else
+		increment >>= -octave;
+
+	increment = (increment * DAC_SAMPLING_RATE) / AudioOut_GetSampleRate();
+	if(increment > MAX_INCREMENT)
+		increment = MAX_INCREMENT;
+	return increment;
+}
+
+
+/*
+ * Apply the pitch bend and the vibrato of the current block to a voice
+ *
+ * @input voice		Pointer to the voice
+ * @return None
+ *
+ */
+static void UpdateIncrement(voice_t* voice)
+{
+	uint64_t bent = ((uint64_t)voice->phaseIncrement * bendRatio) >> 16;
+	int32_t increment = (bent > MAX_INCREMENT) ? MAX_INCREMENT : (int32_t)bent;
+	int32_t incrementEnd = increment + (int32_t)(((int64_t)increment * vibratoEnd) >> 15);
+
+	voice->incrementStart = increment + (int32_t)(((int64_t)increment * vibratoStart) >> 15);
+	voice->incrementStep = (incrementEnd - voice->incrementStart) >> AUDIO_BLOCK_SHIFT;
+
+	// The modulator follows the carrier at the ratio of the patch
+	voice->modIncrement = (uint32_t)(((uint64_t)(uint32_t)voice->incrementStart * fmRatio) >> 8);
+	voice->modIncrementStep = (int32_t)(((int64_t)voice->incrementStep * fmRatio) >> 8);
+}
+
+
+/*
+ * Select the sound of the voices
+ *
+ * Takes effect when the synthesizer is initialized the next time, as the
+ * plucked strings borrow their delay lines from the audio arena.
+ *
+ * @input wave	One of synth_wave_t
+ * @return None
+ *
+ */
+void Synth_SetWaveform(synth_wave_t wave)
+{
+	if(wave < SYNTH_WAVES)
+		waveform = wave;
+}
+
+
+/*
+ * Returns the sound of the voices
+ *
+ * @input None
+ * @return One of synth_wave_t
+ *
+ */
+synth_wave_t Synth_GetWaveform()
+{
+	return waveform;
+}
+
+
+/*
+ * Returns the name of a sound
+ *
+ * @input wave	One of synth_wave_t
+ * @return Name of the sound
+ *
+ */
+const char* Synth_WaveName(synth_wave_t wave)
+{
+	if(wave >= SYNTH_WAVES)
+		return "?";
+	return waveNames[wave];
+}
+
+
+/*
+ * Pluck the string of a voice
+ *
+ * Tunes the delay line to the period of the note and fills it with a burst
+ * of noise. The averaging filter adds half a sample to the loop, the rest of
+ * the period is split into whole samples and a fraction for interpolation.
+ *
+ * @input voice		Pointer to the voice
+ * 		  peak		Amplitude of the burst in Q15
+ * @return None
+ *
+ */
+static void PluckString(voice_t* voice, int32_t peak)
+{
+	uint32_t period = (uint32_t)((1ULL << 48) / voice->phaseIncrement); // Samples in 16.16
+
+	while(period > (PLUCK_MAX_PERIOD << 16))
+		period >>= 1;
+	period -= PLUCK_FILTER_DELAY;
+
+	voice->delay = period >> 16;
+	voice->fraction = (period & 0xFFFF) >> 1;
+	voice->writeIndex = 0;
+
+	for(int i = 0; i < PLUCK_LINE_LENGTH; i++)
+	{
+		voice->line[i] = (Noise_White(&pluckNoise) * peak) >> 15;
+	}
+}
+
+
+/*
+ * Set the patch of the FM voices
+ *
+ * The modulator runs at ratio times the frequency of the note, and shifts
+ * the phase of the carrier by up to index radians. The envelope amount
+ * sets how much of the index follows the envelope of the note, so the
+ * sound gets brighter with the attack and darker with the release.
+ *
+ * @input ratio				Frequency ratio of the modulator in Q8 (up to SYNTH_FM_MAX_RATIO)
+ * 		  index				Modulation index in Q8 (up to SYNTH_FM_MAX_INDEX)
+ * 		  envelopePercent	Share of the index controlled by the envelope (0 to 100)
+ * @return None
+ *
+ */
+void Synth_SetFmPatch(uint16_t ratio, uint16_t index, uint8_t envelopePercent)
+{
+	int32_t depth;
+
+	if(ratio > SYNTH_FM_MAX_RATIO)
+		ratio = SYNTH_FM_MAX_RATIO;
+	if(index > SYNTH_FM_MAX_INDEX)
+		index = SYNTH_FM_MAX_INDEX;
+	if(envelopePercent > 100)
+		envelopePercent = 100;
+
+	depth = (index * FM_RADIANS_TO_CYCLES) >> FM_RADIANS_SHIFT;
+
+	fmRatio = ratio;
+	fmIndex = index;
+	fmEnvelope = envelopePercent;
+	fmDepthScale = (depth * envelopePercent) / 100;
+	fmDepthBase = depth - fmDepthScale;
+}
+
+
+/*
+ * Get the patch of the FM voices
+ *
+ * @input ratio				Pointer to store the frequency ratio in Q8
+ * 		  index				Pointer to store the modulation index in Q8
+ * 		  envelopePercent	Pointer to store the share of the index following the envelope
+ * @return None
+ *
+ */
+void Synth_GetFmPatch(uint16_t* ratio, uint16_t* index, uint8_t* envelopePercent)
+{
+	*ratio = fmRatio;
+	*index = fmIndex;
+	*envelopePercent = fmEnvelope;
+}
+
+
+/*
+ * Initialize the synthesizer
+ *
+ * Borrows the state of the voices from the audio arena, and the delay
+ * lines of the plucked strings if they are selected.
+ *
+ * @input count		Number of voices (up to SYNTH_MAX_VOICES)
+ * @return True if the voices could be allocated, else False.
+ *
+ */
+bool Synth_Init(int count)
+{
+	int16_t* lines;
+
+	if(count > SYNTH_MAX_VOICES)
+		count = SYNTH_MAX_VOICES;
+
+	voices = Arena_Alloc(ARENA_VOICES, count * sizeof(voice_t), sizeof(uint32_t));
+	numVoices = (voices == NULL) ? 0 : count;
+	noteCounter = 0;
+	Noise_Init(&pluckNoise, PLUCK_NOISE_SEED);
+
+	if(voices != NULL && waveform == SYNTH_WAVE_PLUCK)
+	{
+		lines = Arena_Alloc(ARENA_VOICES, count * PLUCK_LINE_LENGTH * sizeof(int16_t), sizeof(uint32_t));
+		// Without memory for the strings, the voices stay sines
+		if(lines == NULL)
+			waveform = SYNTH_WAVE_SINE;
+
+		for(int i = 0; lines != NULL && i < count; i++)
+		{
+			voices[i].line = &lines[i * PLUCK_LINE_LENGTH];
+		}
+	}
+
+	attackSamples = (ATTACK_SAMPLES * AudioOut_GetSampleRate()) / DAC_SAMPLING_RATE;
+	releaseSamples = (RELEASE_SAMPLES * AudioOut_GetSampleRate()) / DAC_SAMPLING_RATE;
+
+	return voices != NULL;
+}
+
+
+/*
+ * Start playing a note
+ *
+ * Allocates a voice for the note, stealing the oldest one if all the
+ * voices are busy.
+ *
+ * @input note		MIDI note number
+ * 		  velocity	Loudness of the note (0 to SYNTH_MAX_VELOCITY)
+ * @return None
+ *
+ */
+void Synth_NoteOn(uint8_t note, uint8_t velocity)
+{
+	voice_t* voice = &voices[0];
+
+	if(numVoices == 0)
+		return;
+
+	if(velocity == 0)
+	{
+		Synth_NoteOff(note);
+		return;
+	}
+
+	// Prefer an idle voice, otherwise take the oldest one
+	for(int i = 0; i < numVoices; i++)
+	{
+		if(!voices[i].active)
+		{
+			voice = &voices[i];
+			break;
+		}
+		if(voices[i].age < voice->age)
+			voice = &voices[i];
+	}
+
+	if(!voice->active)
+		voice->level = 0;
+
+	voice->active = true;
+	voice->released = false;
+	voice->note = note;
+	voice->age = noteCounter++;
+	voice->phaseIncrement = NoteIncrement(note);
+	voice->peak = (velocity > SYNTH_MAX_VELOCITY ? SYNTH_MAX_VELOCITY : velocity) * (Q15_ONE / SYNTH_MAX_VELOCITY);
+	voice->levelStep = (voice->peak / attackSamples) + 1;
+	UpdateIncrement(voice);
+
+	if(waveform == SYNTH_WAVE_FM)
+	{
+		// The spectrum depends on the phase of the modulator to the carrier
+		voice->phase = 0;
+		voice->modPhase = 0;
+	}
+	else if(waveform == SYNTH_WAVE_PLUCK)
+	{
+		// The velocity goes into the burst, the string starts at full level
+		PluckString(voice, voice->peak);
+		voice->peak = Q15_ONE;
+		voice->level = Q15_ONE;
+		voice->levelStep = 0;
+	}
+}
+
+
+/*
+ * Release a voice
+ *
+ * Starts the release ramp of the envelope.
+ *
+ * @input voice		Pointer to the voice
+ * @return None
+ *
+ */
+static void ReleaseVoice(voice_t* voice)
+{
+	voice->released = true;
+	voice->levelStep = -((voice->peak / releaseSamples) + 1);
+}
+
+
+/*
+ * Release a playing note
+ *
+ * @input note		MIDI note number
+ * @return None
+ *
+ */
+void Synth_NoteOff(uint8_t note)
+{
+	for(int i = 0; i < numVoices; i++)
+	{
+		if(voices[i].active && !voices[i].released && voices[i].note == note)
+			ReleaseVoice(&voices[i]);
+	}
+}
+
+
+/*
+ * Release all the playing notes
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Synth_AllNotesOff()
+{
+	for(int i = 0; i < numVoices; i++)
+	{
+		if(voices[i].active && !voices[i].released)
+			ReleaseVoice(&voices[i]);
+	}
+}
+
+
+/*
+ * Silence all the voices at once
+ *
+ * Unlike Synth_AllNotesOff(), the voices stop without a release ramp.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Synth_Reset()
+{
+	for(int i = 0; i < numVoices; i++)
+	{
+		voices[i].active = false;
+		voices[i].level = 0;
+	}
+}
+
+
+/*
+ * Bend the pitch of all the voices
+ *
+ * The ratio is e^x with x = bend * ln(2) / 12 in semitones, from the cubic
+ * of its series. x stays within +-0.116 for two semitones, where the
+ * error of the cubic is below 10 ppm.
+ *
+ * @input bend		Bend from SYNTH_BEND_MIN to SYNTH_BEND_MAX, 0 for none,
+ * 					the ends are SYNTH_BEND_SEMITONES down or up
+ * @return None
+ *
+ */
+void Synth_SetPitchBend(int16_t bend)
+{
+	int32_t x, x2, x3;
+
+	if(bend < SYNTH_BEND_MIN)
+		bend = SYNTH_BEND_MIN;
+
+	x = (bend * SYNTH_BEND_SEMITONES * Q16_LN2_PER_SEMITONE) / -SYNTH_BEND_MIN; // Q16
+	x2 = (x * x) >> 16;
+	x3 = (x2 * x) >> 16;
+	bendRatio = BEND_UNITY + x + x2 / 2 + x3 / 6;
+
+	for(int i = 0; i < numVoices; i++)
+	{
+		if(voices[i].active)
+			UpdateIncrement(&voices[i]);
+	}
+}
+
+
+/*
+ * Returns the number of sounding voices
+ *
+ * Released voices count until their envelope has reached silence.
+ *
+ * @input None
+ * @return Number of active voices
+ *
+ */
+int Synth_ActiveVoices()
+{
+	int count = 0;
+
+	for(int i = 0; i < numVoices; i++)
+	{
+		if(voices[i].active)
+			count++;
+	}
+	return count;
+}
+
+
+/*
+ * Prepare the voices for a new block
+ *
+ * Called once per block (control rate), after the LFOs have been updated.
+ *
+ * @input None
+ * @return None
+ *
+ */
+void Synth_BeginBlock()
+{
+	int32_t gainEnd;
+
+	Lfo_GetSegment(LFO_VIBRATO, &vibratoStart, &vibratoEnd);
+	Lfo_GetSegment(LFO_TREMOLO, &gainStart, &gainEnd);
+	gainStep = (gainEnd - gainStart) >> AUDIO_BLOCK_SHIFT;
+
+	for(int i = 0; i < numVoices; i++)
+	{
+		if(voices[i].active)
+			UpdateIncrement(&voices[i]);
+	}
+}
+
+
+/*
+ * Render a single sine voice
+ *
+ * Adds the samples of the voice to the segment of the block, saturating
+ * the result.
+ *
+ * @input voice		Pointer to the voice
+ * 		  block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+static RAM_FUNCTION void RenderSine(voice_t* voice, int16_t* block, int offset, int count)
+{
+	uint32_t phase = voice->phase;
+	uint32_t increment = voice->incrementStart + offset * voice->incrementStep;
+	int32_t gain = gainStart + offset * gainStep;
+	int32_t level = voice->level;
+	int32_t sample;
+
+	for(int i = offset; i < offset + count; i++)
+	{
+		// Envelope ramps up to the peak, holds, then ramps down to silence
+		level += voice->levelStep;
+		if(level >= voice->peak)
+		{
+			level = voice->peak;
+			if(!voice->released)
+				voice->levelStep = 0;
+		}
+		else if(level <= 0)
+		{
+			level = 0;
+			voice->active = false;
+			break;
+		}
+
+		sample = (fp_sin_phase(phase) * ((level * gain) >> 15)) >> 15;
+		sample += block[i];
+
+		if(sample > INT16_MAX)
+			sample = INT16_MAX;
+		else if(sample < INT16_MIN)
+			sample = INT16_MIN;
+
+		block[i] = sample;
+		phase += increment;
+		increment += voice->incrementStep;
+		gain += gainStep;
+	}
+
+	voice->phase = phase;
+	voice->level = level;
+}
+
+
+/*
+ * Render a single FM voice
+ *
+ * The modulator sine shifts the phase of the carrier sine. The depth of the
+ * shift follows the envelope by the amount of the patch. Renders in Q15
+ * without divisions.
+ *
+ * @input voice		Pointer to the voice
+ * 		  block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+static RAM_FUNCTION void RenderFm(voice_t* voice, int16_t* block, int offset, int count)
+{
+	uint32_t phase = voice->phase;
+	uint32_t modPhase = voice->modPhase;
+	uint32_t increment = voice->incrementStart + offset * voice->incrementStep;
+	uint32_t modIncrement = voice->modIncrement + offset * voice->modIncrementStep;
+	int32_t gain = gainStart + offset * gainStep;
+	int32_t level = voice->level;
+	int32_t depth, sample;
+	uint32_t shift;
+
+	for(int i = offset; i < offset + count; i++)
+	{
+		// Envelope ramps up to the peak, holds, then ramps down to silence
+		level += voice->levelStep;
+		if(level >= voice->peak)
+		{
+			level = voice->peak;
+			if(!voice->released)
+				voice->levelStep = 0;
+		}
+		else if(level <= 0)
+		{
+			level = 0;
+			voice->active = false;
+			break;
+		}
+
+		depth = fmDepthBase + ((fmDepthScale * level) >> 15);
+		shift = (uint32_t)(depth * fp_sin_phase(modPhase)) << FM_OFFSET_SHIFT;
+
+		sample = (fp_sin_phase(phase + shift) * ((level * gain) >> 15)) >> 15;
+		sample += block[i];
+
+		if(sample > INT16_MAX)
+			sample = INT16_MAX;
+		else if(sample < INT16_MIN)
+			sample = INT16_MIN;
+
+		block[i] = sample;
+		phase += increment;
+		modPhase += modIncrement;
+		increment += voice->incrementStep;
+		modIncrement += voice->modIncrementStep;
+		gain += gainStep;
+	}
+
+	voice->phase = phase;
+	voice->modPhase = modPhase;
+	voice->level = level;
+}
+
+
+/*
+ * Render a single plucked string voice
+ *
+ * Every output sample averages two taps of the delay line, which are
+ * interpolated by the fraction of the period, and is fed back into the
+ * line. The averaging damps the high harmonics first, like a string.
+ * Vibrato isn't applied to the strings.
+ *
+ * @input voice		Pointer to the voice
+ * 		  block		Pointer to the block
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+static RAM_FUNCTION void RenderPluck(voice_t* voice, int16_t* block, int offset, int count)
+{
+	int16_t* line = voice->line;
+	uint32_t read = voice->writeIndex - voice->delay;
+	uint32_t write = voice->writeIndex;
+	int32_t fraction = voice->fraction;
+	int32_t gain = gainStart + offset * gainStep;
+	int32_t level = voice->level;
+	int32_t tap0, tap1, tap2, sample;
+
+	for(int i = offset; i < offset + count; i++)
+	{
+		// Only the release ramp, the string starts at full level
+		level += voice->levelStep;
+		if(level <= 0)
+		{
+			level = 0;
+			voice->active = false;
+			break;
+		}
+
+		tap0 = line[read & PLUCK_LINE_MASK];
+		tap1 = line[(read - 1) & PLUCK_LINE_MASK];
+		tap2 = line[(read - 2) & PLUCK_LINE_MASK];
+		tap0 += (fraction * (tap1 - tap0)) >> 15;
+		tap1 += (fraction * (tap2 - tap1)) >> 15;
+		sample = (tap0 + tap1) >> 1;
+
+		line[write & PLUCK_LINE_MASK] = sample;
+		read++;
+		write++;
+
+		sample = (sample * ((level * gain) >> 15)) >> 15;
+		sample += block[i];
+
+		if(sample > INT16_MAX)
+			sample = INT16_MAX;
+		else if(sample < INT16_MIN)
+			sample = INT16_MIN;
+
+		block[i] = sample;
+		gain += gainStep;
+	}
+
+	voice->writeIndex = write & PLUCK_LINE_MASK;
+	voice->level = level;
+}
+
+
+/*
+ * Render a segment of the current block
+ *
+ * Contains the implementation to compute the mix of all the voices in Q15
+ * for the samples [offset, offset + count) of the block. Vibrato and tremolo
+ * are taken from the LFOs and linearly interpolated across the block.
+ * Runs from SRAM with the voice renderers and fp_sin_phase().
+ *
+ * @input block		Pointer to the block to be populated
+ * 		  offset	Index of the first sample of the segment
+ * 		  count		Number of samples in the segment
+ * @return None
+ *
+ */
+RAM_FUNCTION void Synth_Render(int16_t* block, int offset, int count)
+{
+	for(int i = offset; i < offset + count; i++)
+	{
+		block[i] = 0;
+	}
+
+	for(int i = 0; i < numVoices; i++)
+	{
+		if(!voices[i].active)
+			continue;
+
+		switch(waveform)
+		{
+		case SYNTH_WAVE_PLUCK:
+			RenderPluck(&voices[i], block, offset, count);
+			break;
+		case SYNTH_WAVE_FM:
+			RenderFm(&voices[i], block, offset, count);
+			break;
+		default:
+			RenderSine(&voices[i], block, offset, count);
+			break;
+		}
+	}
+}
@@ -10,8 +10,12 @@
 #include "SysTick.h"
 #include "MKL25Z4.h"
 
-static ticktime_t timeSinceReset = 0;
-static ticktime_t timeSinceStartup = 0;
+// SysTick runs from the external reference, core clock / 16
+#define SYSTICK_RELOAD (48000000L/256)
+#define CYCLES_PER_COUNT (16)
+
+static volatile ticktime_t timeSinceReset = 0;
+static volatile ticktime_t timeSinceStartup = 0;
 
 
 /*
@@ -26,7 +30,7 @@ static ticktime_t timeSinceStartup = 0;
  */
 void SysTick_Init()
 {
-	SysTick->LOAD = (48000000L/256); // Set reload to get 1/16 th second interrupt
+	SysTick->LOAD = SYSTICK_RELOAD; // Set reload to get 1/16 th second interrupt
 	NVIC_SetPriority(SysTick_IRQn,3); // Set interrupt priority
 	SysTick->VAL = 0; // Force load of reload value
 	SysTick->CTRL = SysTick_CTRL_TICKINT_Msk | // Enable interrupt, alternate clock source
@@ -80,6 +84,39 @@ ticktime_t get_timer()
 }
 
 
+/*
+ * Returns the core clock cycles since startup
+ *
+ * Function combines the ticks with the current value of the SysTick counter.
+ * It can be called from interrupts of any priority. The resolution is
+ * CYCLES_PER_COUNT cycles and the count wraps around after about 89
+ * seconds, so only differences should be used.
+ *
+ * @input None
+ * @return uint32_t, cycles since startup
+ *
+ */
+uint32_t get_cycles()
+{
+	ticktime_t ticks;
+	uint32_t value;
+
+	// Read again if a tick happened in between
+	do
+	{
+		ticks = timeSinceStartup;
+		value = SysTick->VAL;
+	} while(ticks != timeSinceStartup);
+
+	// Called from a higher priority interrupt, the counter may have wrapped
+	// with the tick still pending. It was reloaded if it is in its upper half.
+	if((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && value > SYSTICK_RELOAD / 2)
+		ticks++;
+
+	return (ticks * SYSTICK_RELOAD + (SYSTICK_RELOAD - value)) * CYCLES_PER_COUNT;
+}
+
+
 /*
  * ISR for systick
  *
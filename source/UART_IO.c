@@ -8,16 +8,39 @@
 
 #include "UART_IO.h"
 #include "cbfifo.h"
-#include "sysclock.h"
+#include "SysTick.h"
+#include "RamCode.h"
 #include <MKL25Z4.h>
 
 
-#define UART_OVERSAMPLE_RATE (16)
+// UART0SRC selects MCGPLLCLK/2 with the boot clocks
+#define UART_CLOCK_FREQUENCY (48000000UL)
+
+#define UART_MAX_SBR (8191)
+#define UART_BOTH_EDGE_OSR (8) // Both edges have to be sampled below this ratio
 
 #define DATA_SIZE (8)
 #define PARITY (0)
 #define STOP_BITS (2)
 
+// Handler of the received bytes, the console when NULL
+static volatile uart_receive_handler_t receiveHandler = NULL;
+
+// Flow control character to send before the queued text, 0 if none
+static volatile uint8_t flowControlChar = 0;
+
+// Sequence watched for on the console and the number of its bytes received
+static const uint8_t* sequence = NULL;
+static uint8_t sequenceLength = 0;
+static uint8_t sequenceMatched = 0;
+static volatile uart_sequence_handler_t sequenceHandler = NULL;
+
+// Baud rate in use, and the confirmed one to restore until a switch is confirmed
+static uart_baud_t baud;
+static uart_baud_t previousBaud;
+static volatile bool baudWaiting = false;
+static ticktime_t baudSwitchTime;
+
 
 /*
   * Reads one character from UART console.
@@ -76,6 +99,183 @@ int __sys_write(int handle, char* buf, int size)
 }
 
 
+/*
+  * Writes a baud rate setting to UART0, the transmitter and the receiver
+  * have to be disabled.
+  *
+  * Parameters:
+  *   setting      Setting to write
+  *
+  * Returns:
+  *   None
+  */
+static void WriteBaud(const uart_baud_t* setting)
+{
+	UART0->BDH &= ~UART0_BDH_SBR_MASK;
+	UART0->BDH |= UART0_BDH_SBR(setting->sbr >> 8);
+	UART0->BDL = UART0_BDL_SBR(setting->sbr);
+	UART0->C4 = (UART0->C4 & ~UART0_C4_OSR_MASK) | UART0_C4_OSR(setting->osr - 1);
+
+	if(setting->osr < UART_BOTH_EDGE_OSR)
+		UART0->C5 |= UART0_C5_BOTHEDGE_MASK;
+	else
+		UART0->C5 &= ~UART0_C5_BOTHEDGE_MASK;
+
+	baud = *setting;
+}
+
+
+/*
+  * Switches to a baud rate setting once the queued text is sent.
+  *
+  * Parameters:
+  *   setting      Setting to switch to
+  *
+  * Returns:
+  *   None
+  */
+static void ApplyBaud(const uart_baud_t* setting)
+{
+	// Let the transmitter finish the text at the current rate
+	while(!IsEmpty(TXQ) || (UART0->C2 & UART0_C2_TIE_MASK) || !(UART0->S1 & UART0_S1_TC_MASK))
+		;
+
+	UART0->C2 &= ~UART0_C2_TE_MASK & ~UART0_C2_RE_MASK;
+	WriteBaud(setting);
+	UART0->C2 |= UART0_C2_RE(1) | UART0_C2_TE(1);
+}
+
+
+/*
+  * Searches the oversampling ratios and divisors for the setting closest
+  * to a baud rate, with the clock of UART0.
+  *
+  * Parameters:
+  *   baud_rate    Baud rate(bits per second) to search for
+  *   setting      Pointer to store the setting found
+  *
+  * Returns:
+  *   True if the error is within UART_MAX_BAUD_ERROR, else False.
+  */
+bool UART0_FindBaud(uint32_t baud_rate, uart_baud_t* setting)
+{
+	uint32_t osr, sbr, divisor, actual, difference;
+	uint32_t bestDifference = UINT32_MAX;
+
+	if(baud_rate == 0 || baud_rate > UART_CLOCK_FREQUENCY / UART_MIN_OSR)
+		return false;
+
+	// The higher ratio wins a tie, it samples the bits more often
+	for(osr = UART_MAX_OSR; osr >= UART_MIN_OSR; osr--)
+	{
+		sbr = (UART_CLOCK_FREQUENCY + (baud_rate * osr) / 2) / (baud_rate * osr);
+		if(sbr == 0 || sbr > UART_MAX_SBR)
+			continue;
+
+		divisor = osr * sbr;
+		actual = (UART_CLOCK_FREQUENCY + divisor / 2) / divisor;
+		// Error of the exact rate in 1/65536 bits per second, not of the rounded one
+		difference = (UART_CLOCK_FREQUENCY > baud_rate * divisor) ?
+				UART_CLOCK_FREQUENCY - baud_rate * divisor : baud_rate * divisor - UART_CLOCK_FREQUENCY;
+		difference = (uint32_t)(((uint64_t)difference << 16) / divisor);
+
+		if(difference < bestDifference)
+		{
+			bestDifference = difference;
+			setting->baudRate = baud_rate;
+			setting->actual = actual;
+			setting->sbr = sbr;
+			setting->osr = osr;
+		}
+	}
+
+	if(bestDifference == UINT32_MAX)
+		return false;
+
+	divisor = setting->osr * setting->sbr;
+	setting->error = (int32_t)(((int64_t)UART_CLOCK_FREQUENCY - (int64_t)baud_rate * divisor) * 1000000 /
+			((int64_t)baud_rate * divisor));
+
+	return (setting->error <= UART_MAX_BAUD_ERROR && setting->error >= -UART_MAX_BAUD_ERROR);
+}
+
+
+/*
+  * Gets the baud rate setting in use.
+  *
+  * Parameters:
+  *   setting      Pointer to store the setting
+  *
+  * Returns:
+  *   None
+  */
+void UART0_GetBaud(uart_baud_t* setting)
+{
+	*setting = baud;
+}
+
+
+/*
+  * Switches UART0 to a new baud rate once the queued text is sent. The
+  * last confirmed rate is restored by UART0_ProcessBaud unless the new one
+  * is confirmed within UART_BAUD_CONFIRM_TICKS.
+  *
+  * Parameters:
+  *   setting      Setting found by UART0_FindBaud
+  *
+  * Returns:
+  *   None
+  */
+void UART0_SwitchBaud(const uart_baud_t* setting)
+{
+	if(!baudWaiting)
+		previousBaud = baud;
+
+	ApplyBaud(setting);
+	baudSwitchTime = now();
+	baudWaiting = true;
+}
+
+
+/*
+  * Confirms the baud rate switched to, the other end receives it.
+  *
+  * Parameters:
+  *   None
+  *
+  * Returns:
+  *   True if a switch was waiting for the confirmation, else False.
+  */
+bool UART0_ConfirmBaud()
+{
+	bool waiting = baudWaiting;
+
+	baudWaiting = false;
+	return waiting;
+}
+
+
+/*
+  * Restores the previous baud rate when a switch was not confirmed in
+  * time. Called by the main loop.
+  *
+  * Parameters:
+  *   None
+  *
+  * Returns:
+  *   True if the previous baud rate was just restored, else False.
+  */
+bool UART0_ProcessBaud()
+{
+	if(!baudWaiting || now() - baudSwitchTime <= UART_BAUD_CONFIRM_TICKS)
+		return false;
+
+	baudWaiting = false;
+	ApplyBaud(&previousBaud);
+	return true;
+}
+
+
 /*
   * Initializes UART0 with the given baud rate.
   *
@@ -87,7 +287,7 @@ int __sys_write(int handle, char* buf, int size)
   */
 void Init_UART0(uint32_t baud_rate)
 {
-	uint16_t sbr;
+	uart_baud_t setting;
 	uint8_t temp;
 
 	// Enable clock gating for UART0 and Port A
@@ -105,11 +305,8 @@ void Init_UART0(uint32_t baud_rate)
 	PORTA->PCR[2] = PORT_PCR_ISF_MASK | PORT_PCR_MUX(2); // Tx
 
 	// Set baud rate and oversampling ratio
-	sbr = (uint16_t)((SYSCLOCK_FREQUENCY)/(baud_rate * UART_OVERSAMPLE_RATE));
-	UART0->BDH &= ~UART0_BDH_SBR_MASK;
-	UART0->BDH |= UART0_BDH_SBR(sbr>>8);
-	UART0->BDL = UART0_BDL_SBR(sbr);
-	UART0->C4 |= UART0_C4_OSR(UART_OVERSAMPLE_RATE-1);
+	UART0_FindBaud(baud_rate, &setting);
+	WriteBaud(&setting);
 
 	// Disable interrupts for RX active edge and LIN break detect, select two stop bits
 	UART0->BDH |= UART0_BDH_RXEDGIE(0) | UART0_BDH_SBNS(STOP_BITS - 1) | UART0_BDH_LBKDIE(0);
@@ -150,12 +347,109 @@ void Init_UART0(uint32_t baud_rate)
 }
 
 
+/*
+  * Sends the received bytes to a handler instead of the console.
+  * The bytes are not echoed while a handler is set.
+  *
+  * Parameters:
+  *   handler      Function called by the interrupt for every byte,
+  *                NULL to give the bytes back to the console
+  *
+  * Returns:
+  *   None
+  */
+void UART0_SetReceiveHandler(uart_receive_handler_t handler)
+{
+	receiveHandler = handler;
+}
+
+
+/*
+  * Watches the console for a byte sequence. The bytes of the sequence are
+  * neither echoed nor given to the console, a partial sequence is dropped.
+  * The handler is called by the interrupt and may set a receive handler.
+  *
+  * Parameters:
+  *   bytes        Bytes to watch for, they should not be typed in a terminal
+  *   length       Number of bytes in the sequence
+  *   handler      Function called when the sequence was received,
+  *                NULL to stop watching
+  *
+  * Returns:
+  *   None
+  */
+void UART0_SetSequenceHandler(const uint8_t* bytes, uint8_t length, uart_sequence_handler_t handler)
+{
+	uint32_t maskingState;
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+
+	sequence = bytes;
+	sequenceLength = length;
+	sequenceMatched = 0;
+	sequenceHandler = (bytes != NULL && length > 0) ? handler : NULL;
+
+	__set_PRIMASK(maskingState);
+}
+
+
+/*
+  * Matches a console byte against the watched sequence.
+  *
+  * Parameters:
+  *   ch      Received byte
+  *
+  * Returns:
+  *   True if the byte belongs to the sequence, else False.
+  */
+static RAM_FUNCTION bool MatchSequence(uint8_t ch)
+{
+	if(sequenceHandler == NULL)
+		return false;
+
+	if(ch != sequence[sequenceMatched])
+		sequenceMatched = 0;
+	if(ch != sequence[sequenceMatched])
+		return false;
+
+	if(++sequenceMatched == sequenceLength)
+	{
+		sequenceMatched = 0;
+		sequenceHandler();
+	}
+	return true;
+}
+
+
+/*
+  * Sends a flow control character (XON/XOFF) ahead of the queued text.
+  *
+  * Parameters:
+  *   ch      Character to send
+  *
+  * Returns:
+  *   None
+  */
+void UART0_SendFlowControl(uint8_t ch)
+{
+	uint32_t maskingState;
+	maskingState = __get_PRIMASK();
+	__disable_irq();
+
+	flowControlChar = ch;
+	UART0->C2 |= UART_C2_TIE(1);
+
+	__set_PRIMASK(maskingState);
+}
+
+
 // UART0 IRQ Handler. Listing 8.12 on p. 235
 
 /*
  * Interrupt handler for UART0.
  * Performs enqueue-ing and dequeue-ing from the transmission and receiver buffer
- * corresponding to the UART based console.
+ * corresponding to the UART based console. Runs from SRAM, the queues
+ * are shared with the main loop and stay in the flash.
  *
  * Parameters:
  * 		None
@@ -163,7 +457,7 @@ void Init_UART0(uint32_t baud_rate)
  * Returns:
  * 		None
  */
-void UART0_IRQHandler(void) {
+RAM_FUNCTION void UART0_IRQHandler(void) {
 	uint8_t ch;
 	uint8_t tx_char;
 
@@ -181,23 +475,39 @@ void UART0_IRQHandler(void) {
 		// received a character
 		ch = UART0->D;
 
-		UART0->D = ch; // Reflect it back on the console
-
-		if(!IsFull(RXQ))
+		if(receiveHandler != NULL)
 		{
-			cbfifo_enqueue(RXQ, &ch, sizeof(ch));
+			receiveHandler(ch); // Not a console character, no echo
+		}
+		else if(MatchSequence(ch))
+		{
+			// Held back from the console
 		}
 		else
 		{
-			// error - queue full.
-			// discard character
+			UART0->D = ch; // Reflect it back on the console
+
+			if(!IsFull(RXQ))
+			{
+				cbfifo_enqueue(RXQ, &ch, sizeof(ch));
+			}
+			else
+			{
+				// error - queue full.
+				// discard character
+			}
 		}
 	}
 
 	if ( (UART0->C2 & UART0_C2_TIE_MASK) && (UART0->S1 & UART0_S1_TDRE_MASK) ) // transmitter interrupt enabled and tx buffer empty
 	{
-		// can send another character
-		if (!IsEmpty(TXQ))
+		// can send another character, flow control goes first
+		if (flowControlChar != 0)
+		{
+			UART0->D = flowControlChar;
+			flowControlChar = 0;
+		}
+		else if (!IsEmpty(TXQ))
 		{
 			cbfifo_dequeue(TXQ, &tx_char, sizeof(uint8_t));
 			UART0->D = tx_char;
@@ -24,8 +24,8 @@ typedef struct cbfifo_s
 } cbfifo_t;
 
 
-// Structures for UART TX, UART RX and TONES queues
-cbfifo_t queues[3];
+// Structures for UART TX and UART RX queues
+cbfifo_t queues[NUM_QUEUES];
 
 
 /*
@@ -10,20 +10,29 @@
 #include <stdio.h>
 
 #include "fp_trig.h"
-
-#define DAC_SAMPLING_RATE 	 (48000)
+#include "RamCode.h"
 
 // Number of steps in the lookup table.
 #define TRIG_TABLE_STEPS     (32)
 
 #define TRIG_TABLE_STEP_SIZE (HALF_PI/TRIG_TABLE_STEPS)
 
+// Phase accumulator layout: 2 bits of quadrant, 5 bits of table index, 11 bits of fraction
+#define PHASE_QUADRANT_SHIFT (30)
+#define PHASE_QUARTER_SHIFT  (14)
+#define PHASE_QUARTER_ONE    (0x10000)
+#define PHASE_INDEX_SHIFT    (11)
+#define PHASE_FRACTION_MASK  ((1 << PHASE_INDEX_SHIFT) - 1)
+
+// Scale from the lookup table range to Q15
+#define SIN_Q15_GAIN         (16)
+
 
 /*
  * Lookup table of sine values according to the scale.
- * Generated using a Python script.
+ * Generated using a Python script. Kept in SRAM for fp_sin_phase().
  */
-static const int16_t sin_lookup[TRIG_TABLE_STEPS+1] =
+static RAM_DATA const int16_t sin_lookup[TRIG_TABLE_STEPS+1] =
 	{	0, 100, 200, 299, 398, 495, 592, 687,
 		780, 872, 961, 1048, 1132, 1214, 1293, 1369,
 		1441, 1510, 1575, 1637, 1694, 1748, 1797, 1842,
@@ -109,25 +118,38 @@ int fp_sin(int x)
 
 
 /*
- * Calculate sine table
+ * Calculate sine values from a phase accumulator
  *
- * Contains the implementation to populate a buffer with sine values
- * based on the tone frequency.
+ * Contains the implementation to look up the sine of a 32-bit phase, where
+ * the full range of the phase corresponds to one period. Only the quarter wave
+ * in the lookup table is used and values in between the steps are
+ * linearly interpolated.
+ * The output is in Q15, in the range [-SIN_Q15_GAIN * TRIG_SCALE_FACTOR, SIN_Q15_GAIN * TRIG_SCALE_FACTOR]
  *
- * @input table		Pointer to the buffer to be populated
- * 		  toneFreq	Input frequency deciding the samples
- * @return Number of elements written into the buffer.
+ *
+ * @input phase		Phase of the oscillator (0 to 2^32 - 1 for one period)
+ * @return		Sine value of the phase in Q15.
  *
  */
-int tone_to_samples(uint16_t* table, int toneFreq)
+RAM_FUNCTION int16_t fp_sin_phase(uint32_t phase)
 {
-	int bufferSize = 0;
-	int numOfSamples = (PERIODS_PER_BUFFER * DAC_SAMPLING_RATE)/toneFreq;
+	uint32_t quadrant = phase >> PHASE_QUADRANT_SHIFT;
+	uint32_t x = (phase >> PHASE_QUARTER_SHIFT) & (PHASE_QUARTER_ONE - 1);
 
-	for(int i = 0; i < numOfSamples; i++)
-	{
-		table[i] = fp_sin((i * TWO_PI * toneFreq)/DAC_SAMPLING_RATE) + TRIG_SCALE_FACTOR;
-		bufferSize++;
-	}
-	return bufferSize;
+	// Second and fourth quadrants mirror the first one
+	if(quadrant & 1)
+		x = PHASE_QUARTER_ONE - x;
+
+	uint32_t index = x >> PHASE_INDEX_SHIFT;
+	int32_t lower = sin_lookup[index];
+	int32_t upper = (index < TRIG_TABLE_STEPS) ? sin_lookup[index + 1] : lower;
+	int32_t value = lower + (((upper - lower) * (int32_t)(x & PHASE_FRACTION_MASK)) >> PHASE_INDEX_SHIFT);
+
+	value *= SIN_Q15_GAIN;
+
+	// Third and fourth quadrants are negative
+	if(quadrant & 2)
+		value = -value;
+
+	return value;
 }
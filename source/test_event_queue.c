@@ -0,0 +1,99 @@
+/*
+ * test_event_queue.c - Implementation of the test function of the event queue
+ *
+ * Author: Surya Kanteti
+ *
+ */
+
+#include "test_event_queue.h"
+#include "EventQueue.h"
+#include <assert.h>
+#include <stdint.h>
+
+ /*
+  * Tests the functionality of the note event queue
+  *
+  * Returns: None, asserts on failure.
+  */
+void test_event_queue()
+{
+	note_event_t input = {0, EVENT_NOTE_ON, 69, 127};
+	note_event_t output;
+
+	EventQueue_Clear();
+
+	// TEST CASE 1: Empty queue
+
+	assert(EventQueue_Length() == 0);
+	assert(EventQueue_Space() == EVENT_QUEUE_SIZE);
+	assert(!EventQueue_Peek(&output));
+	assert(!EventQueue_Dequeue(&output));
+
+	// TEST CASE 2: Whole events come out in order
+
+	assert(EventQueue_Enqueue(&input));
+	input.timestamp = 48000;
+	input.type = EVENT_NOTE_OFF;
+	assert(EventQueue_Enqueue(&input));
+	assert(EventQueue_Length() == 2);
+
+	assert(EventQueue_Peek(&output));
+	assert(output.timestamp == 0 && output.type == EVENT_NOTE_ON);
+	assert(EventQueue_Length() == 2);
+
+	assert(EventQueue_Dequeue(&output));
+	assert(output.timestamp == 0 && output.type == EVENT_NOTE_ON);
+	assert(output.key == 69 && output.value == 127);
+
+	assert(EventQueue_Dequeue(&output));
+	assert(output.timestamp == 48000 && output.type == EVENT_NOTE_OFF);
+	assert(EventQueue_Length() == 0);
+
+	// TEST CASE 3: Fill the queue, wrapping around the end
+
+	for(int i = 0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		input.timestamp = i;
+		assert(EventQueue_Enqueue(&input));
+	}
+	assert(!EventQueue_Enqueue(&input));
+	assert(EventQueue_Space() == 0);
+
+	for(int i = 0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		assert(EventQueue_Dequeue(&output));
+		assert(output.timestamp == i);
+	}
+	assert(!EventQueue_Dequeue(&output));
+
+	// TEST CASE 4: Inserted events go before the later ones, after the equal ones
+
+	for(int i = 0; i < EVENT_QUEUE_SIZE - 1; i++)
+	{
+		assert(EventQueue_Enqueue(&input));
+		assert(EventQueue_Dequeue(&output));
+	}
+	for(int i = 0; i < 3; i++)
+	{
+		input.timestamp = EVENT_QUEUE_SIZE + 100 * i; // Wraps around the end
+		input.key = i;
+		assert(EventQueue_Enqueue(&input));
+	}
+	input.timestamp = EVENT_QUEUE_SIZE + 100;
+	input.key = 3;
+	assert(EventQueue_Insert(&input));
+	input.timestamp = 0;
+	input.key = 4;
+	assert(EventQueue_Insert(&input));
+	assert(EventQueue_Length() == 5);
+
+	const uint8_t order[] = {4, 0, 1, 3, 2};
+	for(int i = 0; i < sizeof(order); i++)
+	{
+		assert(EventQueue_Dequeue(&output));
+		assert(output.key == order[i]);
+	}
+	assert(!EventQueue_Dequeue(&output));
+
+	EventQueue_Clear();
+}
@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+"""
+armonica_link.py - Client of the binary host link of ARMonica
+
+Use it as a module, e.g.:
+    from armonica_link import Link
+    with Link('/dev/ttyACM0') as link:
+        link.note_on(60, 100)
+        print(link.stats())
+
+or from the project folder to play a scale and print the statistics:
+    python3 tools/armonica_link.py /dev/ttyACM0
+
+The link is started by sending the magic sequence A5 5A C3 3C to the
+console, which is answered with a hello frame. A frame is the sync byte
+0xA5, the length of the payload, the opcode, the payload and the
+CRC-16/CCITT (polynomial 0x1021, starting from 0xFFFF) of the length, the
+opcode and the payload, low byte first. Values in payloads are little
+endian. Notes, drums, parameters and tempo changes are not answered, the
+board only reports errors, so they can be sent back to back. A ping
+returns when the board has handled all the frames sent before it. The
+console is given back with a bye frame, or after 10 seconds without data.
+set_baud() switches the board and the port to another baud rate, the
+board goes back to the last rate if no frame comes at the new one within
+5 seconds. upload_song() writes a song image (tools/song_upload.py) into
+the flash of the board.
+
+The opcodes and payloads are those of include/HostLink.h.
+
+Requires pyserial.
+
+Author: Surya Kanteti
+"""
+
+import argparse
+import binascii
+import struct
+import time
+
+import serial
+
+MAGIC = bytes((0xA5, 0x5A, 0xC3, 0x3C))
+SYNC = 0xA5
+MAX_PAYLOAD = 32
+OVERHEAD = 5
+
+OP_HELLO = 0x00
+OP_PING = 0x01
+OP_STATS = 0x02
+OP_BYE = 0x03
+OP_BAUD = 0x04
+OP_NOTE_ON = 0x10
+OP_NOTE_OFF = 0x11
+OP_ALL_NOTES_OFF = 0x12
+OP_DRUM = 0x13
+OP_PARAMETER = 0x20
+OP_TEMPO = 0x21
+OP_SONG_ERASE = 0x30
+OP_SONG_DATA = 0x31
+OP_SONG_COMMIT = 0x32
+OP_SONG_PLAY = 0x33
+OP_REPLY = 0x80
+OP_ERROR = 0xFF
+
+ERRORS = {1: 'CRC', 2: 'unknown opcode', 3: 'length', 4: 'value', 5: 'event queue full'}
+
+# Parameters of AudioOut_SetParameter
+PARAM_ECHO = 0
+PARAM_VIBRATO = 1
+PARAM_TREMOLO = 2
+PARAM_PITCH_BEND = 3
+PARAM_SEQUENCER = 4
+
+DRUM_KICK = 0
+DRUM_SNARE = 1
+DRUM_HAT = 2
+
+# Time the board takes to send the reply to a baud frame and switch
+SWITCH_DELAY = 0.05
+
+# Song in the flash of the board, include/Song.h
+SONG_HEADER_SIZE = 32
+SONG_SECTOR_SIZE = 1024
+SONG_CHUNK = 28  # Bytes of a data frame besides the offset
+SONG_STOP = 0xFFFF
+
+STATS_FIELDS = ('frames', 'crc_errors', 'errors', 'overruns', 'blocks_rendered',
+                'render_cycles', 'dma_interrupts', 'voices', 'idle')
+
+
+def crc16(data):
+    """CRC-16/CCITT starting from 0xFFFF"""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def encode(opcode, payload=b''):
+    """Frame of an opcode and its payload"""
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError('payload longer than %d bytes' % MAX_PAYLOAD)
+    body = bytes((len(payload), opcode)) + bytes(payload)
+    return bytes((SYNC,)) + body + struct.pack('<H', crc16(body))
+
+
+class LinkError(Exception):
+    pass
+
+
+class Link:
+    """Binary link to the board over a serial port"""
+
+    def __init__(self, port, baud=38400, timeout=1.0):
+        self.port = serial.Serial(port, baud, stopbits=serial.STOPBITS_TWO, timeout=timeout)
+        self.timeout = timeout
+        self.errors = []  # (error, opcode) reported by the board
+        self.pending = bytearray()
+        self.version = None
+        self.sample_rate = None
+
+    def __enter__(self):
+        self.connect()
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def connect(self):
+        """Send the magic sequence and wait for the hello frame"""
+        self.port.reset_input_buffer()
+        self.port.write(MAGIC)
+        payload = self.wait(OP_HELLO | OP_REPLY)
+        self.version, max_payload, self.sample_rate = struct.unpack('<BBI', payload)
+        if max_payload < MAX_PAYLOAD:
+            raise LinkError('the board takes payloads of %d bytes' % max_payload)
+
+    def close(self):
+        """Give the console back"""
+        if self.port.is_open:
+            try:
+                self.send(OP_BYE)
+                self.wait(OP_BYE | OP_REPLY)
+            finally:
+                self.port.close()
+
+    def send(self, opcode, payload=b''):
+        self.port.write(encode(opcode, payload))
+
+    def read_frame(self, deadline):
+        """Next intact frame as (opcode, payload), console text is skipped"""
+        while time.time() < deadline:
+            self.pending += self.port.read(self.port.in_waiting or 1)
+            while len(self.pending) >= OVERHEAD:
+                if self.pending[0] != SYNC or self.pending[1] > MAX_PAYLOAD:
+                    del self.pending[0]
+                    continue
+                length = self.pending[1]
+                if len(self.pending) < length + OVERHEAD:
+                    break
+                frame = bytes(self.pending[:length + OVERHEAD])
+                if struct.unpack('<H', frame[-2:])[0] != crc16(frame[1:-2]):
+                    del self.pending[0]
+                    continue
+                del self.pending[:length + OVERHEAD]
+                return frame[2], frame[3:-2]
+        raise LinkError('no answer from the board')
+
+    def wait(self, opcode):
+        """Payload of the next frame with the opcode, errors are collected"""
+        deadline = time.time() + self.timeout
+        while True:
+            got, payload = self.read_frame(deadline)
+            if got == OP_ERROR:
+                self.errors.append((ERRORS.get(payload[0], payload[0]), payload[1]))
+                if payload[1] == opcode & ~OP_REPLY:
+                    raise LinkError('%s error' % self.errors[-1][0])
+            elif got == opcode:
+                return payload
+
+    def ping(self, payload=b''):
+        """Round trip time in seconds, all the frames before are handled"""
+        start = time.time()
+        self.send(OP_PING, payload)
+        if self.wait(OP_PING | OP_REPLY) != bytes(payload):
+            raise LinkError('ping returned other data')
+        return time.time() - start
+
+    def stats(self):
+        """Counts of the link and the audio engine as a dict"""
+        self.send(OP_STATS)
+        values = struct.unpack('<7IBB', self.wait(OP_STATS | OP_REPLY))
+        return dict(zip(STATS_FIELDS, values))
+
+    def set_baud(self, baud):
+        """Switch the board and the port to a baud rate, returns the actual
+        rate of the board and its error in parts per million"""
+        self.send(OP_BAUD, struct.pack('<I', baud))
+        actual, error = struct.unpack('<Ii', self.wait(OP_BAUD | OP_REPLY))
+        time.sleep(SWITCH_DELAY)
+        self.port.baudrate = baud
+        self.port.reset_input_buffer()
+        self.pending.clear()
+        self.ping()  # Confirms the new rate
+        return actual, error
+
+    def upload_song(self, image, progress=None):
+        """Erase and write the flash of the song sector by sector, then
+        commit the header. The bytes after the header are written in order,
+        at most two data frames wait in the buffer of the board."""
+        if len(image) % 4 or len(image) <= SONG_HEADER_SIZE:
+            raise ValueError('song image of a wrong length')
+        offset = SONG_HEADER_SIZE
+        for sector in range((len(image) + SONG_SECTOR_SIZE - 1) // SONG_SECTOR_SIZE):
+            self.send(OP_SONG_ERASE, bytes((sector,)))
+            self.wait(OP_SONG_ERASE | OP_REPLY)
+            end = min(len(image), (sector + 1) * SONG_SECTOR_SIZE)
+            outstanding = 0
+            while offset < end:
+                count = min(SONG_CHUNK, end - offset)
+                self.send(OP_SONG_DATA, struct.pack('<H', offset) + image[offset:offset + count])
+                self.send(OP_PING)
+                offset += count
+                outstanding += 1
+                if outstanding == 2:
+                    self.wait(OP_PING | OP_REPLY)
+                    outstanding -= 1
+            while outstanding:
+                self.wait(OP_PING | OP_REPLY)
+                outstanding -= 1
+            if any(opcode == OP_SONG_DATA for _, opcode in self.errors):
+                raise LinkError('writing the flash failed in sector %d' % sector)
+            if progress:
+                progress(offset, len(image))
+        self.send(OP_SONG_COMMIT, image[:SONG_HEADER_SIZE])
+        self.wait(OP_SONG_COMMIT | OP_REPLY)
+
+    def play_song(self, bar=0):
+        self.send(OP_SONG_PLAY, struct.pack('<H', bar))
+
+    def stop_song(self):
+        self.send(OP_SONG_PLAY, struct.pack('<H', SONG_STOP))
+
+    def note_on(self, note, velocity=100):
+        self.send(OP_NOTE_ON, bytes((note, velocity)))
+
+    def note_off(self, note):
+        self.send(OP_NOTE_OFF, bytes((note,)))
+
+    def all_notes_off(self):
+        self.send(OP_ALL_NOTES_OFF)
+
+    def drum(self, drum, velocity=100):
+        self.send(OP_DRUM, bytes((drum, velocity)))
+
+    def parameter(self, parameter, value):
+        self.send(OP_PARAMETER, struct.pack('<BH', parameter, value))
+
+    def tempo(self, bpm):
+        self.send(OP_TEMPO, struct.pack('<H', bpm))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('port', help='serial port of the board')
+    parser.add_argument('--baud', type=int, default=38400)
+    args = parser.parse_args()
+
+    with Link(args.port, args.baud) as link:
+        print('Link version %d, sampling rate %d Hz' % (link.version, link.sample_rate))
+        for note in (60, 62, 64, 65, 67, 69, 71, 72):
+            link.note_on(note, 100)
+            time.sleep(0.2)
+            link.note_off(note)
+        print('Round trip %.1f ms' % (link.ping() * 1000))
+        for name, value in link.stats().items():
+            print('%s: %d' % (name, value))
+        if link.errors:
+            print('Errors: %s' % link.errors)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,748 @@
+/*
+ * audio_sim.c - Cycle timing of the audio output on simulated peripherals
+ *
+ * Build and run from the project folder:
+ *     make -C tools sim
+ * or, to keep the DAC0 output of a scenario:
+ *     tools/build/check/audio_sim [--timeline dac.csv] [scenario]
+ *
+ * Runs the audio engine on tools/mcu_host.c against a clock of core cycles.
+ * TPM0 overflows every MOD + 1 cycles once AudioOut.c starts it, every
+ * overflow moves a sample into DAC0 through the DMAMUX and the DMA, and the
+ * interrupts are held pending until the simulated core takes them: one
+ * handler at a time, by priority, after the exception entry, with the cost
+ * of the handler in cycles. A handler is not preempted, a request of a
+ * higher priority waits for its end. The main loop renders a block in the
+ * time the handlers leave it, its samples reach the ring one by one over
+ * that time.
+ *
+ * Reports for every scenario:
+ *   - the samples written into DAC0 and their spacing,
+ *   - the gaps, overflows of TPM0 lost while the DMA waited for its handler
+ *     to start the next block,
+ *   - the underruns, samples the DMA read before the main loop rendered them,
+ *   - the latency of every interrupt, from the request to the end of the
+ *     handler, against its budget: a sample period for DMA0, a byte for
+ *     UART0, a tick for SysTick,
+ *   - for the song upload, the song bytes the host link wrote into the
+ *     flash, a word at a time with the interrupts masked.
+ * The costs of the handlers and of the rendering are estimates, bench and
+ * bench ram on the board measure them. Exits with 1 if a scenario expected
+ * to play cleanly does not, or if the faults of the others are not found.
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcu_host.h"
+#include "nvm_host.h"
+#include "UART_IO.h"
+#include "SysTick.h"
+#include "AudioOut.h"
+#include "EventQueue.h"
+#include "Synth.h"
+#include "PatchStore.h"
+#include "HostLink.h"
+#include "Song.h"
+#include "Crc16.h"
+
+#define CORE_CLOCK (48000000UL)
+#define BAUD_RATE (38400)
+#define UART_BITS_PER_BYTE (10) // Start, 8 data and stop bits
+#define ISR_ENTRY_CYCLES (15) // Exception entry of the Cortex-M0+, no wait states
+#define NEVER (~0ULL)
+
+// Cycles of the handlers, they run from SRAM
+#define DMA0_HANDLER_CYCLES (40)
+#define UART0_HANDLER_CYCLES (150)
+#define SYSTICK_HANDLER_CYCLES (20)
+
+// Cycles per sample of the main loop rendering four voices with the echo
+#define RENDER_CYCLES_PER_SAMPLE (400)
+
+// Interrupts masked by a program unit of the flash, 65 us
+#define WORD_PROGRAM_CYCLES (65 * 48)
+
+// Song bytes in a data frame of the host link, as tools/armonica_link.py sends them
+#define UPLOAD_CHUNK (28)
+#define MAX_UPLOAD_BYTES (4096)
+
+#define CHORD_AT_MS (10) // The engine is idle by then
+#define MAX_RING_SAMPLES (1024)
+#define SIM_IRQS (3)
+
+typedef struct scenario_s
+{
+	const char* name;
+	uint32_t rate; // Sample rate in Hz
+	uint32_t renderCycles; // Main loop cycles per rendered sample
+	uint32_t uartBytes; // Bytes per second received on UART0
+	uint32_t maskCycles; // Interrupts masked by the main loop for so long
+	uint32_t maskAtRequest; // ... from this DMA0 request on
+	uint32_t maskOffset; // ... plus these cycles
+	uint32_t milliseconds; // Time played
+	bool upload; // The bytes received on UART0 upload a song over the host link
+	bool expectFaults; // Gaps or underruns expected
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+	{"tone at 48 kHz", 48000, RENDER_CYCLES_PER_SAMPLE, 0, 0, 0, 0, 500, false, false},
+	{"tone at 16 kHz", 16000, RENDER_CYCLES_PER_SAMPLE, 0, 0, 0, 0, 500, false, false},
+	{"typing at 38400 baud", 48000, RENDER_CYCLES_PER_SAMPLE, BAUD_RATE / UART_BITS_PER_BYTE, 0, 0, 0, 500, false, false},
+	{"word program in a block", 48000, RENDER_CYCLES_PER_SAMPLE, 0, WORD_PROGRAM_CYCLES, 20, 20000, 100, false, false},
+	{"word program at a reload", 48000, RENDER_CYCLES_PER_SAMPLE, 0, WORD_PROGRAM_CYCLES, 20, 0, 100, false, true},
+	{"song upload at 38400 baud", 48000, RENDER_CYCLES_PER_SAMPLE, BAUD_RATE / UART_BITS_PER_BYTE, 0, 0, 0, 500, true, false},
+	{"sector erase", 48000, RENDER_CYCLES_PER_SAMPLE, 0, 100 * 48000, 20, 0, 300, false, true},
+	{"render overload", 48000, 1100, 0, 0, 0, 0, 100, false, true},
+};
+
+#define NUM_SCENARIOS (sizeof(scenarios) / sizeof(scenarios[0]))
+
+// Interrupts of the simulation, the index in the statistics
+static const IRQn_Type irqs[SIM_IRQS] = {DMA0_IRQn, UART0_IRQn, SysTick_IRQn};
+static const char* irqNames[SIM_IRQS] = {"DMA0", "UART0", "SysTick"};
+static const uint32_t handlerCycles[SIM_IRQS] = {DMA0_HANDLER_CYCLES, UART0_HANDLER_CYCLES,
+		SYSTICK_HANDLER_CYCLES};
+
+typedef struct irq_stats_s
+{
+	uint64_t requested; // Cycle of the pending request, NEVER if none
+	uint32_t count;
+	uint64_t maxLatency;
+	uint64_t budget;
+} irq_stats_t;
+
+static const scenario_t* scenario;
+static uint64_t cycle; // Core cycles since the boot
+static irq_stats_t irqStats[SIM_IRQS];
+static uint32_t dma0Requests;
+
+// The core runs one handler, or the main loop
+static int running = MCU_HOST_NO_IRQ;
+static uint64_t handlerEnd;
+static uint64_t maskedFrom, maskedUntil;
+static uint64_t handlerCyclesTotal;
+
+// Block the main loop renders: cycles of work, done so far
+static bool rendering;
+static uint64_t renderWork, renderDone;
+static uint64_t renderCyclesTotal;
+static uint32_t blocksRendered;
+
+// Program units of the flash the main loop writes after the block, one
+// at a time with the interrupts masked
+static uint32_t flashWords;
+static bool flashing;
+static uint32_t wordsProgrammed;
+
+// Bytes of the song upload, the song bytes and the frames carrying them
+static uint8_t upload[MAX_UPLOAD_BYTES];
+static uint32_t uploadLength;
+static uint8_t song[MAX_UPLOAD_BYTES];
+static uint32_t songLength;
+
+// Ring of samples, the ones rendered but not yet reached by the main loop
+static uint16_t* ring;
+static uint32_t ringSamples;
+static uint16_t rendered[MAX_RING_SAMPLES];
+static bool waiting[MAX_RING_SAMPLES];
+static uint64_t waitingUntil[MAX_RING_SAMPLES]; // Work done when the sample is in place
+
+// TPM0 as the simulation runs it
+static bool timerRunning;
+static bool timerStartPending; // Started by the block being rendered
+static uint64_t timerPeriod;
+static uint64_t nextOverflow;
+
+// Output and faults
+static FILE* timeline;
+static uint64_t lastWrite;
+static uint32_t samples, gaps, underruns, irregular;
+static uint64_t nextByte, bytePeriod;
+static uint32_t bytesSent;
+static uint64_t chordAt;
+
+
+/*
+ * Index of an interrupt in the statistics
+ */
+static int IrqIndex(int irq)
+{
+	for(int i = 0; i < SIM_IRQS; i++)
+	{
+		if(irqs[i] == irq)
+			return i;
+	}
+	fprintf(stderr, "audio_sim: interrupt %d is not simulated\n", irq);
+	exit(2);
+}
+
+
+/*
+ * Hook of DAC0: keep the time of the sample and check its spacing
+ */
+static void DacWrite(uint16_t value)
+{
+	uint64_t interval = cycle - lastWrite;
+
+	samples++;
+	if(lastWrite != NEVER && interval != timerPeriod)
+	{
+		irregular++;
+		gaps += (uint32_t)(interval / timerPeriod) - 1;
+	}
+	lastWrite = cycle;
+
+	if(timeline != NULL)
+		fprintf(timeline, "%llu,%u\n", (unsigned long long)cycle, value);
+}
+
+
+/*
+ * Note the requests of the interrupts as they are raised and dropped
+ */
+static void NotePending()
+{
+	bool pending;
+
+	for(int i = 0; i < SIM_IRQS; i++)
+	{
+		if(irqs[i] == SysTick_IRQn)
+			pending = (mcuHostScb.ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+		else
+			pending = (mcuHostNvicPending & (1UL << irqs[i])) != 0;
+
+		if(!pending)
+		{
+			irqStats[i].requested = NEVER;
+		}
+		else if(irqStats[i].requested == NEVER)
+		{
+			irqStats[i].requested = cycle;
+			if(irqs[i] == DMA0_IRQn && ++dma0Requests == scenario->maskAtRequest &&
+					scenario->maskCycles > 0)
+			{
+				// The main loop masks the interrupts and stops rendering
+				maskedFrom = cycle + scenario->maskOffset;
+				maskedUntil = maskedFrom + scenario->maskCycles;
+			}
+		}
+	}
+}
+
+
+/*
+ * The main loop holds the interrupts off
+ */
+static bool Masked()
+{
+	return cycle >= maskedFrom && cycle < maskedUntil;
+}
+
+
+/*
+ * Follow TPM0 after the sources touched it
+ */
+static void CheckTimer()
+{
+	bool counting = (TPM0->SC & TPM_SC_CMOD_MASK) != 0;
+
+	if(counting && !timerRunning && !timerStartPending)
+	{
+		timerPeriod = (uint64_t)(TPM0->MOD + 1) << (TPM0->SC & TPM_SC_PS_MASK);
+		// ResumePlayback() renders the first block before it starts TPM0
+		if(rendering)
+		{
+			timerStartPending = true;
+		}
+		else
+		{
+			timerRunning = true;
+			nextOverflow = cycle + timerPeriod;
+		}
+	}
+	else if(!counting)
+	{
+		timerRunning = false;
+		timerStartPending = false;
+		lastWrite = NEVER;
+	}
+}
+
+
+/*
+ * Address of the ring the DMA plays, from the source address and modulo
+ */
+static void FindRing()
+{
+	uint32_t modulo = (DMA0->DMA[0].DCR & DMA_DCR_SMOD_MASK) >> DMA_DCR_SMOD_SHIFT;
+	uint32_t bytes = 16UL << (modulo - 1);
+
+	ring = (uint16_t*)(uintptr_t)(DMA0->DMA[0].SAR & ~(bytes - 1));
+	ringSamples = bytes / sizeof(uint16_t);
+	if(modulo == 0 || ringSamples > MAX_RING_SAMPLES)
+	{
+		fprintf(stderr, "audio_sim: the DMA does not play a ring\n");
+		exit(2);
+	}
+}
+
+
+/*
+ * The main loop programs the next unit of the flash, the interrupts are
+ * masked from now. The ones requested meanwhile are taken between two.
+ */
+static void ProgramWord()
+{
+	maskedFrom = cycle;
+	maskedUntil = cycle + WORD_PROGRAM_CYCLES;
+	flashWords--;
+	flashing = (flashWords > 0);
+}
+
+
+/*
+ * Add a frame of the host link to the upload
+ */
+static void AddFrame(uint8_t op, const uint8_t* data, uint8_t count)
+{
+	uint16_t crc = Crc16_Byte(Crc16_Byte(CRC16_INIT, count), op);
+
+	upload[uploadLength++] = LINK_SYNC;
+	upload[uploadLength++] = count;
+	upload[uploadLength++] = op;
+	for(int i = 0; i < count; i++)
+	{
+		crc = Crc16_Byte(crc, data[i]);
+		upload[uploadLength++] = data[i];
+	}
+	upload[uploadLength++] = crc & 0xFF;
+	upload[uploadLength++] = crc >> 8;
+}
+
+
+/*
+ * Prepare the bytes of a song upload for the time played: the magic
+ * sequence, then a data frame and a ping at a time like the client sends
+ * them
+ */
+static void PrepareUpload()
+{
+	static const uint8_t magic[LINK_MAGIC_LENGTH] = {0xA5, 0x5A, 0xC3, 0x3C};
+	uint8_t payload[2 + UPLOAD_CHUNK];
+	uint32_t offset;
+	uint32_t bytes = (uint32_t)(((uint64_t)scenario->uartBytes * scenario->milliseconds) / 1000);
+
+	memcpy(upload, magic, sizeof(magic));
+	uploadLength = sizeof(magic);
+	songLength = 0;
+
+	while(uploadLength + sizeof(payload) + 2 * LINK_OVERHEAD <= bytes &&
+			uploadLength + sizeof(payload) + 2 * LINK_OVERHEAD <= MAX_UPLOAD_BYTES)
+	{
+		offset = SONG_HEADER_SIZE + songLength;
+		payload[0] = offset & 0xFF;
+		payload[1] = offset >> 8;
+		for(int i = 0; i < UPLOAD_CHUNK; i++)
+		{
+			payload[2 + i] = song[songLength++] = (uint8_t)(offset * 7 + i * 13);
+		}
+		AddFrame(LINK_OP_SONG_DATA, payload, sizeof(payload));
+		AddFrame(LINK_OP_PING, NULL, 0);
+	}
+}
+
+
+/*
+ * Let the main loop poll the host link, the audio engine and the console
+ * like main() does. A block it renders is taken back out of the ring and
+ * put in place sample by sample as the work is done, the flash it programs
+ * after the block masks the interrupts once the block is done.
+ */
+static void MainLoop()
+{
+	static uint16_t before[MAX_RING_SAMPLES];
+	audio_stats_t stats;
+	uint32_t blocks, sample, words;
+
+	while(__sys_readc() != -1)
+		;
+
+	HostLink_Process();
+	memcpy(before, ring, ringSamples * sizeof(uint16_t));
+	AudioOut_GetStats(&stats, false);
+	blocks = stats.blocksRendered;
+	words = nvmHostPrograms;
+	if(ComputeSamples())
+		HostLink_ProgramFlash();
+	words = nvmHostPrograms - words;
+	wordsProgrammed += words;
+	flashWords += words;
+	AudioOut_GetStats(&stats, false);
+
+	if(stats.blocksRendered != blocks)
+	{
+		rendering = true;
+		renderDone = 0;
+		renderWork = (uint64_t)scenario->renderCycles * AUDIO_BLOCK_SIZE;
+		blocksRendered++;
+
+		for(uint32_t i = 0; i < ringSamples; i++)
+		{
+			if(ring[i] != before[i])
+			{
+				sample = i % AUDIO_BLOCK_SIZE;
+				rendered[i] = ring[i];
+				ring[i] = before[i];
+				waiting[i] = true;
+				waitingUntil[i] = renderWork * (sample + 1) / AUDIO_BLOCK_SIZE;
+			}
+		}
+	}
+	flashing = (flashWords > 0 && !rendering);
+	CheckTimer();
+}
+
+
+/*
+ * Put the samples of the block in place as far as it is rendered
+ */
+static void PlaceSamples()
+{
+	for(uint32_t i = 0; i < ringSamples; i++)
+	{
+		if(waiting[i] && renderDone >= waitingUntil[i])
+		{
+			ring[i] = rendered[i];
+			waiting[i] = false;
+		}
+	}
+}
+
+
+/*
+ * Run the clock to a cycle: the main loop renders unless a handler runs or
+ * the interrupts are masked, SysTick counts
+ */
+static void RunTo(uint64_t until)
+{
+	uint64_t elapsed = until - cycle;
+
+	if(running != MCU_HOST_NO_IRQ)
+	{
+		handlerCyclesTotal += elapsed;
+	}
+	else if(rendering && !Masked())
+	{
+		renderDone += elapsed;
+		renderCyclesTotal += elapsed;
+		PlaceSamples();
+	}
+
+	cycle = until;
+	McuHost_Advance((uint32_t)elapsed);
+	NotePending();
+}
+
+
+/*
+ * Overflow TPM0: the DMA moves the next sample unless it waits for its
+ * handler, a sample the main loop did not render yet is an underrun
+ */
+static void TimerOverflow()
+{
+	uint32_t address = DMA0->DMA[0].SAR;
+	uint32_t index = (address - (uint32_t)(uintptr_t)ring) / sizeof(uint16_t);
+	bool transfer = !(DMA0->DMA[0].DSR_BCR & DMA_DSR_BCR_DONE_MASK);
+
+	if(transfer && index < ringSamples && waiting[index])
+	{
+		underruns++;
+		if(timeline != NULL)
+			fprintf(timeline, "%llu,underrun\n", (unsigned long long)cycle);
+	}
+
+	McuHost_TimerOverflow(1);
+	nextOverflow += timerPeriod;
+	NotePending();
+}
+
+
+/*
+ * Start the next pending handler when the core is free and not masked
+ */
+static void StartHandler()
+{
+	int irq;
+
+	if(running != MCU_HOST_NO_IRQ || Masked())
+		return;
+
+	irq = McuHost_NextPending();
+	if(irq != MCU_HOST_NO_IRQ)
+	{
+		running = irq;
+		handlerEnd = cycle + ISR_ENTRY_CYCLES + handlerCycles[IrqIndex(irq)];
+	}
+}
+
+
+/*
+ * End the handler which runs: it does its work cycle, when the simulation
+ * takes it
+ */
+static void EndHandler()
+{
+	irq_stats_t* stats = &irqStats[IrqIndex(running)];
+	uint64_t latency = cycle - stats->requested;
+
+	stats->count++;
+	if(latency > stats->maxLatency)
+		stats->maxLatency = latency;
+	stats->requested = NEVER;
+
+	McuHost_Take(running);
+	running = MCU_HOST_NO_IRQ;
+	NotePending();
+	CheckTimer();
+}
+
+
+/*
+ * Reset the board like main() does, returns the cycle to stop at
+ */
+static uint64_t Boot()
+{
+	McuHost_Reset();
+	NvmHost_Reset();
+	mcuHostDeferInterrupts = true;
+	mcuHostHooks.dacWrite = &DacWrite;
+
+	Init_UART0(BAUD_RATE);
+	SysTick_Init();
+	if(!AudioOut_Init())
+	{
+		fprintf(stderr, "audio_sim: no memory for the audio\n");
+		exit(2);
+	}
+	AudioOut_Start();
+	HostLink_Init();
+	PatchStore_Init();
+	Song_Erase(0); // The upload writes after the header of the song
+
+	// Like the rate command, the engine idles until the chord
+	if(!AudioOut_SetSampleRate(scenario->rate))
+	{
+		fprintf(stderr, "audio_sim: rate %lu refused\n", (unsigned long)scenario->rate);
+		exit(2);
+	}
+	EventQueue_Clear();
+	FindRing();
+
+	cycle = 0;
+	running = MCU_HOST_NO_IRQ;
+	maskedFrom = maskedUntil = 0;
+	rendering = false;
+	timerRunning = false;
+	timerStartPending = false;
+	lastWrite = NEVER;
+	memset(waiting, 0, sizeof(waiting));
+	memset(irqStats, 0, sizeof(irqStats));
+	for(int i = 0; i < SIM_IRQS; i++)
+		irqStats[i].requested = NEVER;
+	dma0Requests = 0;
+	handlerCyclesTotal = 0;
+	renderCyclesTotal = 0;
+	blocksRendered = 0;
+	flashWords = 0;
+	flashing = false;
+	wordsProgrammed = 0;
+	uploadLength = 0;
+	songLength = 0;
+	if(scenario->upload)
+		PrepareUpload();
+	samples = gaps = underruns = irregular = bytesSent = 0;
+
+	irqStats[0].budget = CORE_CLOCK / scenario->rate;
+	irqStats[1].budget = CORE_CLOCK * UART_BITS_PER_BYTE / BAUD_RATE;
+	irqStats[2].budget = (uint64_t)CYCLES_PER_TICK;
+	bytePeriod = scenario->uartBytes ? CORE_CLOCK / scenario->uartBytes : 0;
+	nextByte = bytePeriod ? bytePeriod : NEVER;
+	chordAt = CHORD_AT_MS * (CORE_CLOCK / 1000);
+
+	CheckTimer();
+	return chordAt + (uint64_t)scenario->milliseconds * (CORE_CLOCK / 1000);
+}
+
+
+/*
+ * Queue a chord of all the voices, it resumes the idle engine
+ */
+static void PlayChord()
+{
+	note_event_t event;
+
+	event.timestamp = AudioOut_GetSampleTime();
+	event.type = EVENT_NOTE_ON;
+	event.value = SYNTH_MAX_VELOCITY;
+	for(int i = 0; i < SYNTH_MAX_VOICES; i++)
+	{
+		event.key = 60 + 4 * i;
+		EventQueue_Enqueue(&event);
+	}
+}
+
+
+/*
+ * Run a scenario, returns true if it played as expected
+ */
+static bool Run(const scenario_t* run)
+{
+	uint64_t end, next;
+	bool faults, passed;
+	link_stats_t link;
+
+	scenario = run;
+	end = Boot();
+
+	while(cycle < end)
+	{
+		StartHandler();
+		if(running == MCU_HOST_NO_IRQ && flashing && !Masked())
+		{
+			ProgramWord();
+		}
+		else if(running == MCU_HOST_NO_IRQ && !rendering && !flashing && !Masked())
+		{
+			MainLoop();
+			StartHandler();
+		}
+
+		// Next thing to happen
+		next = end;
+		if(timerRunning && nextOverflow < next)
+			next = nextOverflow;
+		if(running != MCU_HOST_NO_IRQ && handlerEnd < next)
+			next = handlerEnd;
+		if(maskedFrom > cycle && maskedFrom < next)
+			next = maskedFrom;
+		if(maskedUntil > cycle && maskedUntil < next)
+			next = maskedUntil;
+		if(nextByte < next)
+			next = nextByte;
+		if(chordAt < next)
+			next = chordAt;
+		if(rendering && running == MCU_HOST_NO_IRQ && !Masked() &&
+				cycle + renderWork - renderDone < next)
+			next = cycle + renderWork - renderDone;
+
+		RunTo(next);
+
+		if(running != MCU_HOST_NO_IRQ && cycle == handlerEnd)
+			EndHandler();
+		if(rendering && renderDone >= renderWork)
+		{
+			rendering = false;
+			flashing = (flashWords > 0);
+			if(timerStartPending)
+			{
+				timerStartPending = false;
+				timerRunning = true;
+				nextOverflow = cycle + timerPeriod;
+			}
+		}
+		if(timerRunning && cycle == nextOverflow)
+			TimerOverflow();
+		if(cycle == nextByte)
+		{
+			if(!run->upload)
+				McuHost_UartReceive('a' + (bytesSent++ & 15));
+			else if(bytesSent < uploadLength)
+				McuHost_UartReceive(upload[bytesSent++]);
+			nextByte += bytePeriod;
+			NotePending();
+		}
+		if(cycle == chordAt)
+		{
+			PlayChord();
+			chordAt = NEVER;
+		}
+	}
+
+	faults = (gaps > 0 || underruns > 0 || irregular > 0 || mcuHostDmaMissed > 0);
+	passed = (faults == run->expectFaults) && (gaps == mcuHostDmaMissed) && samples > 0;
+
+	// Every byte of the song reached the flash
+	if(run->upload)
+	{
+		HostLink_GetStats(&link);
+		if(songLength == 0 || wordsProgrammed * NVM_PROGRAM_UNIT != songLength || link.errors > 0 ||
+				link.overruns > 0 || memcmp(NvmHost_Memory() + SONG_FLASH_ADDRESS + SONG_HEADER_SIZE,
+				song, songLength) != 0)
+			passed = false;
+	}
+
+	printf("%s, %lu Hz, %lu ms\n", run->name, (unsigned long)run->rate,
+			(unsigned long)run->milliseconds);
+	printf("  %lu samples, %lu blocks rendered, render %.1f %%, handlers %.2f %% of the core\n",
+			(unsigned long)samples, (unsigned long)blocksRendered,
+			100.0 * renderCyclesTotal / cycle, 100.0 * handlerCyclesTotal / cycle);
+	printf("  %lu gaps (%lu requests lost), %lu underruns\n", (unsigned long)gaps,
+			(unsigned long)mcuHostDmaMissed, (unsigned long)underruns);
+	if(run->upload)
+		printf("  %lu song bytes of %lu written, %lu words programmed after the blocks\n",
+				(unsigned long)(wordsProgrammed * NVM_PROGRAM_UNIT), (unsigned long)songLength,
+				(unsigned long)wordsProgrammed);
+	printf("  %-8s %8s %12s %8s %8s\n", "", "count", "max latency", "budget", "slack");
+	for(int i = 0; i < SIM_IRQS; i++)
+	{
+		if(irqStats[i].count > 0)
+			printf("  %-8s %8lu %12llu %8llu %8lld\n", irqNames[i], (unsigned long)irqStats[i].count,
+					(unsigned long long)irqStats[i].maxLatency, (unsigned long long)irqStats[i].budget,
+					(long long)irqStats[i].budget - (long long)irqStats[i].maxLatency);
+	}
+	printf("  %s (%s expected)\n", passed ? "ok" : "UNEXPECTED", run->expectFaults ? "faults" : "clean output");
+	return passed;
+}
+
+
+int main(int argc, char* argv[])
+{
+	const char* only = NULL;
+	int failures = 0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--timeline") == 0 && i + 1 < argc)
+		{
+			timeline = fopen(argv[++i], "w");
+			if(timeline == NULL)
+			{
+				perror(argv[i]);
+				return 2;
+			}
+			fprintf(timeline, "cycle,dac\n");
+		}
+		else
+		{
+			only = argv[i];
+		}
+	}
+
+	printf("Cycles: DMA0 handler %d, UART0 handler %d, SysTick handler %d, entry %d\n",
+			DMA0_HANDLER_CYCLES, UART0_HANDLER_CYCLES, SYSTICK_HANDLER_CYCLES, ISR_ENTRY_CYCLES);
+	for(size_t i = 0; i < NUM_SCENARIOS; i++)
+	{
+		if(only != NULL && strcmp(only, scenarios[i].name) != 0)
+			continue;
+		if(!Run(&scenarios[i]))
+			failures++;
+	}
+
+	if(timeline != NULL)
+		fclose(timeline);
+	return failures ? 1 : 0;
+}
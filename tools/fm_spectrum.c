@@ -0,0 +1,166 @@
+/*
+ * fm_spectrum.c - Spectrum of the FM voice against a floating point reference
+ *
+ * Build and run from the project folder:
+ *     gcc -O2 -Iinclude tools/fm_spectrum.c source/Synth.c source/Lfo.c source/fp_trig.c source/AudioArena.c source/Noise.c -lm -o fm_spectrum
+ *     ./fm_spectrum
+ *
+ * An A4 is rendered by the synthesizer with the FM wave for several
+ * patches. Once the attack is over, the spectrum of the voice is compared
+ * with sin(wc t + I sin(wm t)) computed in double precision: the levels of
+ * the carrier and the first sidebands (at the carrier +- multiples of the
+ * modulator). The error is the difference of the amplitudes, relative to
+ * the strongest component, so sidebands close to a null of the Bessel
+ * functions don't dominate it. Exits with 1 if an error is above
+ * MAX_SIDEBAND_ERROR.
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "Synth.h"
+#include "Lfo.h"
+#include "AudioOut.h"
+#include "AudioArena.h"
+
+#define SAMPLING_RATE (48000)
+#define NOTE_A4 (69)
+#define NOTE_FREQUENCY (440.0)
+#define NUM_SAMPLES (4800) // 10 Hz per bin
+#define SETTLE_BLOCKS (64) // Past the attack of the envelope
+#define NUM_SIDEBANDS (6)
+#define MAX_SIDEBAND_ERROR (-30.0) // dB relative to the strongest component
+#define MIN_CHECKED_LEVEL (-60.0)
+
+typedef struct fm_patch_s
+{
+	double ratio;
+	double index; // Radians
+} fm_patch_t;
+
+static const fm_patch_t patches[] = {
+		{1, 1}, {2, 2}, {1, 5}, {3.5, 3}, {0.5, 8}
+};
+
+static int16_t rendered[NUM_SAMPLES];
+static double reference[NUM_SAMPLES];
+
+
+/*
+ * The synthesizer only needs the sampling rate from the audio engine
+ */
+uint32_t AudioOut_GetSampleRate()
+{
+	return SAMPLING_RATE;
+}
+
+
+/*
+ * Power of a frequency, using a Hann window. The power is the peak of the
+ * three bins around it, so frequencies between bins are measured right.
+ */
+static double Power(const double* x, double frequency)
+{
+	double best = 0;
+	int center = (int)lround(frequency * NUM_SAMPLES / SAMPLING_RATE);
+
+	for(int k = center - 1; k <= center + 1; k++)
+	{
+		double re = 0, im = 0;
+		if(k < 0)
+			continue;
+		for(int n = 0; n < NUM_SAMPLES; n++)
+		{
+			double w = 0.5 - 0.5 * cos(2 * M_PI * n / NUM_SAMPLES);
+			re += w * x[n] * cos(2 * M_PI * k * n / NUM_SAMPLES);
+			im -= w * x[n] * sin(2 * M_PI * k * n / NUM_SAMPLES);
+		}
+		if(re * re + im * im > best)
+			best = re * re + im * im;
+	}
+	return best;
+}
+
+
+int main()
+{
+	static double samples[NUM_SAMPLES];
+	double worst = -200;
+	double increment;
+
+	Arena_Reset();
+	Synth_SetWaveform(SYNTH_WAVE_FM);
+	Synth_Init(SYNTH_MAX_VOICES);
+	Lfo_Init();
+
+	for(int p = 0; p < sizeof(patches) / sizeof(patches[0]); p++)
+	{
+		double ratio = patches[p].ratio, index = patches[p].index;
+		double fixedPower[2 * NUM_SIDEBANDS + 1], floatPower[2 * NUM_SIDEBANDS + 1];
+		double fixedMax = 0, floatMax = 0;
+
+		Synth_Reset();
+		Synth_SetFmPatch((uint16_t)lround(ratio * 256), (uint16_t)lround(index * 256), 0);
+		Synth_NoteOn(NOTE_A4, SYNTH_MAX_VELOCITY);
+
+		for(int b = 0; b < SETTLE_BLOCKS; b++)
+		{
+			Lfo_Update();
+			Synth_BeginBlock();
+			Synth_Render(rendered, 0, AUDIO_BLOCK_SIZE);
+		}
+		for(int b = 0; b < NUM_SAMPLES / AUDIO_BLOCK_SIZE; b++)
+		{
+			Lfo_Update();
+			Synth_BeginBlock();
+			Synth_Render(rendered, b * AUDIO_BLOCK_SIZE, AUDIO_BLOCK_SIZE);
+		}
+		Lfo_Update();
+		Synth_BeginBlock();
+		Synth_Render(rendered, (NUM_SAMPLES / AUDIO_BLOCK_SIZE) * AUDIO_BLOCK_SIZE,
+				NUM_SAMPLES % AUDIO_BLOCK_SIZE);
+
+		// The note table gives the frequency of the synthesizer, both
+		// oscillators start at phase 0 with the note
+		increment = 39370534.0; // A4 at 48 kHz
+		for(int n = 0; n < NUM_SAMPLES; n++)
+		{
+			double t = (n + SETTLE_BLOCKS * AUDIO_BLOCK_SIZE) * increment / 4294967296.0;
+			samples[n] = rendered[n];
+			reference[n] = sin(2 * M_PI * t + index * sin(2 * M_PI * ratio * t));
+		}
+
+		for(int s = -NUM_SIDEBANDS; s <= NUM_SIDEBANDS; s++)
+		{
+			double frequency = fabs(NOTE_FREQUENCY + s * ratio * NOTE_FREQUENCY);
+			fixedPower[s + NUM_SIDEBANDS] = Power(samples, frequency);
+			floatPower[s + NUM_SIDEBANDS] = Power(reference, frequency);
+			if(fixedPower[s + NUM_SIDEBANDS] > fixedMax)
+				fixedMax = fixedPower[s + NUM_SIDEBANDS];
+			if(floatPower[s + NUM_SIDEBANDS] > floatMax)
+				floatMax = floatPower[s + NUM_SIDEBANDS];
+		}
+		printf("ratio %.1f, index %.1f\n", ratio, index);
+		for(int s = -NUM_SIDEBANDS; s <= NUM_SIDEBANDS; s++)
+		{
+			double fixedDb = 10 * log10(fixedPower[s + NUM_SIDEBANDS] / fixedMax + 1e-30);
+			double floatDb = 10 * log10(floatPower[s + NUM_SIDEBANDS] / floatMax + 1e-30);
+			double frequency = NOTE_FREQUENCY + s * ratio * NOTE_FREQUENCY;
+			double error = 20 * log10(fabs(sqrt(fixedPower[s + NUM_SIDEBANDS] / fixedMax) -
+					sqrt(floatPower[s + NUM_SIDEBANDS] / floatMax)) + 1e-10);
+
+			if(floatDb < MIN_CHECKED_LEVEL || frequency <= 0)
+				continue;
+			printf("  %7.1f Hz  fixed %6.1f dB  float %6.1f dB  error %6.1f dB\n",
+					frequency, fixedDb, floatDb, error);
+			if(error > worst)
+				worst = error;
+		}
+	}
+
+	printf("\nLargest sideband error: %.1f dB (limit %.1f dB)\n", worst, MAX_SIDEBAND_ERROR);
+	return worst > MAX_SIDEBAND_ERROR;
+}
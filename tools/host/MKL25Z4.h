@@ -0,0 +1,340 @@
+/*
+ * MKL25Z4.h - Peripherals of the KL25Z simulated for the host tests
+ *
+ * Stands in for CMSIS/MKL25Z4.h when the sources are built on the host
+ * (make -C tools check). The peripherals the sources use are plain structs
+ * holding the registers of the device header under the same names, with
+ * the masks and fields of the device, so the sources build unchanged and
+ * the tests can read and set every register. Nothing happens by itself:
+ * tools/mcu_host.c plays the hardware when a test asks it to, and calls
+ * the interrupt handlers. The interrupt mask and the NVIC are variables.
+ *
+ * The data register of UART0 is wider than on the device, so a byte
+ * written by the interrupt handler can be told from none written.
+ *
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __MKL25Z4_HOST_H__
+#define __MKL25Z4_HOST_H__
+
+#include <stdint.h>
+
+// Field of a register, the value shifted into its bits
+#define HOST_FIELD(x, shift, mask) (((uint32_t)(x) << (shift)) & (mask))
+
+// Interrupt numbers of the device, the negative ones are core exceptions
+typedef enum {
+	SysTick_IRQn = -1,
+	DMA0_IRQn = 0,
+	UART0_IRQn = 12,
+	TPM0_IRQn = 17
+} IRQn_Type;
+
+
+// UART0
+typedef struct {
+	volatile uint8_t BDH;
+	volatile uint8_t BDL;
+	volatile uint8_t C1;
+	volatile uint8_t C2;
+	volatile uint8_t S1;
+	volatile uint8_t S2;
+	volatile uint8_t C3;
+	volatile uint16_t D; // Above 0xFF while no byte was written
+	volatile uint8_t MA1;
+	volatile uint8_t MA2;
+	volatile uint8_t C4;
+	volatile uint8_t C5;
+} UART0_Type;
+
+#define UART0_BDH_SBR_MASK (0x1FU)
+#define UART0_BDH_SBR(x) HOST_FIELD(x, 0, UART0_BDH_SBR_MASK)
+#define UART0_BDH_SBNS_MASK (0x20U)
+#define UART0_BDH_SBNS(x) HOST_FIELD(x, 5, UART0_BDH_SBNS_MASK)
+#define UART0_BDH_RXEDGIE_MASK (0x40U)
+#define UART0_BDH_RXEDGIE(x) HOST_FIELD(x, 6, UART0_BDH_RXEDGIE_MASK)
+#define UART0_BDH_LBKDIE_MASK (0x80U)
+#define UART0_BDH_LBKDIE(x) HOST_FIELD(x, 7, UART0_BDH_LBKDIE_MASK)
+#define UART0_BDL_SBR_MASK (0xFFU)
+#define UART0_BDL_SBR(x) HOST_FIELD(x, 0, UART0_BDL_SBR_MASK)
+
+#define UART0_C1_PE_MASK (0x2U)
+#define UART0_C1_PE(x) HOST_FIELD(x, 1, UART0_C1_PE_MASK)
+#define UART0_C1_M_MASK (0x10U)
+#define UART0_C1_M(x) HOST_FIELD(x, 4, UART0_C1_M_MASK)
+#define UART0_C1_LOOPS_MASK (0x80U)
+#define UART0_C1_LOOPS(x) HOST_FIELD(x, 7, UART0_C1_LOOPS_MASK)
+
+#define UART0_C2_RE_MASK (0x4U)
+#define UART0_C2_RE(x) HOST_FIELD(x, 2, UART0_C2_RE_MASK)
+#define UART0_C2_TE_MASK (0x8U)
+#define UART0_C2_TE(x) HOST_FIELD(x, 3, UART0_C2_TE_MASK)
+#define UART0_C2_RIE_MASK (0x20U)
+#define UART0_C2_RIE(x) HOST_FIELD(x, 5, UART0_C2_RIE_MASK)
+#define UART0_C2_TIE_MASK (0x80U)
+#define UART0_C2_TIE(x) HOST_FIELD(x, 7, UART0_C2_TIE_MASK)
+
+#define UART0_S1_PF_MASK (0x1U)
+#define UART0_S1_PF(x) HOST_FIELD(x, 0, UART0_S1_PF_MASK)
+#define UART0_S1_FE_MASK (0x2U)
+#define UART0_S1_FE(x) HOST_FIELD(x, 1, UART0_S1_FE_MASK)
+#define UART0_S1_NF_MASK (0x4U)
+#define UART0_S1_NF(x) HOST_FIELD(x, 2, UART0_S1_NF_MASK)
+#define UART0_S1_OR_MASK (0x8U)
+#define UART0_S1_OR(x) HOST_FIELD(x, 3, UART0_S1_OR_MASK)
+#define UART0_S1_RDRF_MASK (0x20U)
+#define UART0_S1_TC_MASK (0x40U)
+#define UART0_S1_TDRE_MASK (0x80U)
+
+#define UART0_S2_RXINV_MASK (0x10U)
+#define UART0_S2_RXINV(x) HOST_FIELD(x, 4, UART0_S2_RXINV_MASK)
+#define UART0_S2_MSBF_MASK (0x20U)
+#define UART0_S2_MSBF(x) HOST_FIELD(x, 5, UART0_S2_MSBF_MASK)
+
+#define UART0_C3_PEIE_MASK (0x1U)
+#define UART0_C3_PEIE(x) HOST_FIELD(x, 0, UART0_C3_PEIE_MASK)
+#define UART0_C3_FEIE_MASK (0x2U)
+#define UART0_C3_FEIE(x) HOST_FIELD(x, 1, UART0_C3_FEIE_MASK)
+#define UART0_C3_NEIE_MASK (0x4U)
+#define UART0_C3_NEIE(x) HOST_FIELD(x, 2, UART0_C3_NEIE_MASK)
+#define UART0_C3_ORIE_MASK (0x8U)
+#define UART0_C3_ORIE(x) HOST_FIELD(x, 3, UART0_C3_ORIE_MASK)
+#define UART0_C3_TXINV_MASK (0x10U)
+#define UART0_C3_TXINV(x) HOST_FIELD(x, 4, UART0_C3_TXINV_MASK)
+
+#define UART0_C4_OSR_MASK (0x1FU)
+#define UART0_C4_OSR(x) HOST_FIELD(x, 0, UART0_C4_OSR_MASK)
+#define UART0_C5_BOTHEDGE_MASK (0x2U)
+
+// The UART1 and UART2 names of the bits UART0 shares with them
+#define UART_C2_RIE(x) UART0_C2_RIE(x)
+#define UART_C2_TIE_MASK UART0_C2_TIE_MASK
+#define UART_C2_TIE(x) UART0_C2_TIE(x)
+#define UART_S1_PF_MASK UART0_S1_PF_MASK
+#define UART_S1_FE_MASK UART0_S1_FE_MASK
+#define UART_S1_NF_MASK UART0_S1_NF_MASK
+#define UART_S1_OR_MASK UART0_S1_OR_MASK
+
+
+// DMA controller, channel 0 plays the audio
+typedef struct {
+	struct {
+		volatile uint32_t SAR;
+		volatile uint32_t DAR;
+		volatile uint32_t DSR_BCR;
+		volatile uint32_t DCR;
+	} DMA[4];
+} DMA_Type;
+
+#define DMA_SAR_SAR(x) ((uint32_t)(x))
+#define DMA_DAR_DAR(x) ((uint32_t)(x))
+#define DMA_DSR_BCR_BCR_MASK (0xFFFFFFU)
+#define DMA_DSR_BCR_BCR(x) HOST_FIELD(x, 0, DMA_DSR_BCR_BCR_MASK)
+#define DMA_DSR_BCR_DONE_MASK (0x1000000U)
+#define DMA_DSR_BCR_BSY_MASK (0x2000000U)
+#define DMA_DSR_BCR_CE_MASK (0x40000000U)
+
+#define DMA_DCR_SMOD_MASK (0xF000U)
+#define DMA_DCR_SMOD_SHIFT (12)
+#define DMA_DCR_SMOD(x) HOST_FIELD(x, DMA_DCR_SMOD_SHIFT, DMA_DCR_SMOD_MASK)
+#define DMA_DCR_DSIZE_MASK (0x60000U)
+#define DMA_DCR_DSIZE_SHIFT (17)
+#define DMA_DCR_DSIZE(x) HOST_FIELD(x, DMA_DCR_DSIZE_SHIFT, DMA_DCR_DSIZE_MASK)
+#define DMA_DCR_DINC_MASK (0x80000U)
+#define DMA_DCR_SSIZE_MASK (0x300000U)
+#define DMA_DCR_SSIZE_SHIFT (20)
+#define DMA_DCR_SSIZE(x) HOST_FIELD(x, DMA_DCR_SSIZE_SHIFT, DMA_DCR_SSIZE_MASK)
+#define DMA_DCR_SINC_MASK (0x400000U)
+#define DMA_DCR_CS_MASK (0x20000000U)
+#define DMA_DCR_ERQ_MASK (0x40000000U)
+#define DMA_DCR_EINT_MASK (0x80000000U)
+
+
+// DMA request multiplexer
+typedef struct {
+	volatile uint8_t CHCFG[4];
+} DMAMUX_Type;
+
+#define DMAMUX_CHCFG_SOURCE_MASK (0x3FU)
+#define DMAMUX_CHCFG_SOURCE(x) HOST_FIELD(x, 0, DMAMUX_CHCFG_SOURCE_MASK)
+#define DMAMUX_CHCFG_ENBL_MASK (0x80U)
+
+
+// 12 bit DAC
+typedef struct {
+	struct {
+		volatile uint8_t DATL;
+		volatile uint8_t DATH;
+	} DAT[2];
+	volatile uint8_t SR;
+	volatile uint8_t C0;
+	volatile uint8_t C1;
+	volatile uint8_t C2;
+} DAC_Type;
+
+#define DAC_C0_DACRFS_MASK (0x40U)
+#define DAC_C0_DACEN_MASK (0x80U)
+
+
+// Timer/PWM module
+typedef struct {
+	volatile uint32_t SC;
+	volatile uint32_t CNT;
+	volatile uint32_t MOD;
+	struct {
+		volatile uint32_t CnSC;
+		volatile uint32_t CnV;
+	} CONTROLS[6];
+	volatile uint32_t STATUS;
+	volatile uint32_t CONF;
+} TPM_Type;
+
+#define TPM_SC_PS_MASK (0x7U)
+#define TPM_SC_PS(x) HOST_FIELD(x, 0, TPM_SC_PS_MASK)
+#define TPM_SC_CMOD_MASK (0x18U)
+#define TPM_SC_CMOD_SHIFT (3)
+#define TPM_SC_CMOD(x) HOST_FIELD(x, TPM_SC_CMOD_SHIFT, TPM_SC_CMOD_MASK)
+#define TPM_SC_TOIE_MASK (0x40U)
+#define TPM_SC_TOF_MASK (0x80U)
+#define TPM_SC_DMA_MASK (0x100U)
+#define TPM_MOD_MOD_MASK (0xFFFFU)
+#define TPM_MOD_MOD(x) HOST_FIELD(x, 0, TPM_MOD_MOD_MASK)
+
+
+// System integration module, the clock gates and the clock sources
+typedef struct {
+	volatile uint32_t SOPT2;
+	volatile uint32_t SCGC4;
+	volatile uint32_t SCGC5;
+	volatile uint32_t SCGC6;
+	volatile uint32_t SCGC7;
+} SIM_Type;
+
+#define SIM_SOPT2_PLLFLLSEL_MASK (0x10000U)
+#define SIM_SOPT2_TPMSRC_MASK (0x3000000U)
+#define SIM_SOPT2_TPMSRC(x) HOST_FIELD(x, 24, SIM_SOPT2_TPMSRC_MASK)
+#define SIM_SOPT2_UART0SRC_MASK (0xC000000U)
+#define SIM_SOPT2_UART0SRC(x) HOST_FIELD(x, 26, SIM_SOPT2_UART0SRC_MASK)
+#define SIM_SCGC4_UART0_MASK (0x400U)
+#define SIM_SCGC5_PORTA_MASK (0x200U)
+#define SIM_SCGC5_PORTE_MASK (0x2000U)
+#define SIM_SCGC6_DMAMUX_MASK (0x2U)
+#define SIM_SCGC6_TPM0_MASK (0x1000000U)
+#define SIM_SCGC6_DAC0_MASK (0x80000000U)
+#define SIM_SCGC7_DMA_MASK (0x100U)
+
+
+// Pin control of a port
+typedef struct {
+	volatile uint32_t PCR[32];
+} PORT_Type;
+
+#define PORT_PCR_MUX_MASK (0x700U)
+#define PORT_PCR_MUX(x) HOST_FIELD(x, 8, PORT_PCR_MUX_MASK)
+#define PORT_PCR_ISF_MASK (0x1000000U)
+
+
+// SysTick timer and system control block of the core
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t LOAD;
+	volatile uint32_t VAL;
+	volatile uint32_t CALIB;
+} SysTick_Type;
+
+#define SysTick_CTRL_ENABLE_Msk (1UL << 0)
+#define SysTick_CTRL_TICKINT_Msk (1UL << 1)
+#define SysTick_CTRL_CLKSOURCE_Msk (1UL << 2)
+#define SysTick_CTRL_COUNTFLAG_Msk (1UL << 16)
+#define SysTick_LOAD_RELOAD_Msk (0xFFFFFFUL)
+
+typedef struct {
+	volatile uint32_t CPUID;
+	volatile uint32_t ICSR;
+} SCB_Type;
+
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
+
+
+// The peripherals, in tools/mcu_host.c
+extern UART0_Type mcuHostUart0;
+extern DMA_Type mcuHostDma0;
+extern DMAMUX_Type mcuHostDmamux0;
+extern DAC_Type mcuHostDac0;
+extern TPM_Type mcuHostTpm0;
+extern SIM_Type mcuHostSim;
+extern PORT_Type mcuHostPorta;
+extern PORT_Type mcuHostPorte;
+extern SysTick_Type mcuHostSysTick;
+extern SCB_Type mcuHostScb;
+
+#define UART0 (&mcuHostUart0)
+#define DMA0 (&mcuHostDma0)
+#define DMAMUX0 (&mcuHostDmamux0)
+#define DAC0 (&mcuHostDac0)
+#define TPM0 (&mcuHostTpm0)
+#define SIM (&mcuHostSim)
+#define PORTA (&mcuHostPorta)
+#define PORTE (&mcuHostPorte)
+#define SysTick (&mcuHostSysTick)
+#define SCB (&mcuHostScb)
+
+
+// Interrupt mask of the core and the NVIC, the pending interrupts are
+// taken by McuHost_TakePending() as soon as they are unmasked
+extern uint32_t mcuHostPrimask;
+extern uint32_t mcuHostNvicEnabled;
+extern uint32_t mcuHostNvicPending;
+extern uint8_t mcuHostNvicPriority[32];
+
+void McuHost_TakePending(void);
+
+static inline uint32_t __get_PRIMASK(void)
+{
+	return mcuHostPrimask;
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+	mcuHostPrimask = primask & 1;
+	if(!mcuHostPrimask)
+		McuHost_TakePending();
+}
+
+static inline void __disable_irq(void)
+{
+	mcuHostPrimask = 1;
+}
+
+static inline void __enable_irq(void)
+{
+	__set_PRIMASK(0);
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	if(irq >= 0)
+		mcuHostNvicEnabled |= 1UL << irq;
+	McuHost_TakePending();
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type irq)
+{
+	if(irq >= 0)
+		mcuHostNvicEnabled &= ~(1UL << irq);
+}
+
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+	if(irq >= 0)
+		mcuHostNvicPending &= ~(1UL << irq);
+}
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+	if(irq >= 0)
+		mcuHostNvicPriority[irq] = priority & 3;
+}
+
+#endif /* __MKL25Z4_HOST_H__ */
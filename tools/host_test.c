@@ -0,0 +1,775 @@
+/*
+ * host_test.c - The firmware run on the host against simulated peripherals
+ *
+ * Build and run from the project folder:
+ *     make -C tools check
+ *
+ * The console, the command processor and the audio engine are built with
+ * tools/host/MKL25Z4.h in place of the device header and run on
+ * tools/mcu_host.c, the flash on tools/nvm_host.c. Runs the tests of the
+ * board (test_cbfifo, test_sin and test_event_queue), then checks that:
+ *   - Init_UART0 writes the divisors UART0_FindBaud picks,
+ *   - received bytes are echoed and read back by the console, text is sent
+ *     after the flow control character, a receive handler and a watched
+ *     sequence take the bytes away from the console,
+ *   - command lines typed into UART0 change the settings they name, and
+ *     invalid ones are refused, sine and FM switch in place and a patch
+ *     keeps the tempo,
+ *   - the DMA plays every block of a tone into DAC0, the engine goes idle
+ *     after it and resumes for the next one, a sample and a drum from the
+ *     host link play before the tones queued for later, and the rate
+ *     command retimes TPM0,
+ *   - every note from A0 to C8 of every wave, rendered at 48, 22.05 and
+ *     8 kHz, is within TUNING_MAX_CENTS of its equal tempered pitch, as
+ *     measured by the pitch detector of source/Pitch.c.
+ * Then times the command parsing, the queue throughput and the rendering
+ * through the DMA and prints the numbers. Exits with 1 if a check fails.
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mcu_host.h"
+#include "nvm_host.h"
+#include "cbfifo.h"
+#include "UART_IO.h"
+#include "SysTick.h"
+#include "CommandProcessor.h"
+#include "AudioOut.h"
+#include "EventQueue.h"
+#include "Synth.h"
+#include "Sampler.h"
+#include "HostLink.h"
+#include "Midi.h"
+#include "Crc16.h"
+#include "Lfo.h"
+#include "OutputStage.h"
+#include "PatchStore.h"
+#include "Pitch.h"
+#include "test_cbfifo.h"
+#include "test_fp_sin.h"
+#include "test_event_queue.h"
+
+#define BAUD_RATE (38400)
+#define OUTPUT_SIZE (4096) // Bytes of command output kept
+#define MAX_BLOCKS (2000) // Blocks played before a tone is taken as stuck
+#define MAIN_LOOP_POLLS (4)
+
+#define TUNING_LOWEST_NOTE (21) // A0, the lowest key of a piano
+#define TUNING_HIGHEST_NOTE (108) // C8, the highest one
+#define TUNING_MIN_PERIOD (4) // Samples per period of the highest sine checked
+#define TUNING_MIN_HARMONIC_PERIOD (12) // ... and of the other waves
+#define TUNING_MAX_CENTS (2 << 8) // Deviation allowed in Q8
+#define TUNING_ATTACK_BLOCKS (4) // Rendered before the pitch is measured
+#define TUNING_LAG_PERIODS (2.25) // Periods of the note in the window
+#define TUNING_MIN_LAG (512)
+#define TUNING_MAX_LAG (4096)
+#define TUNING_MAX_SAMPLES (2 * TUNING_MAX_LAG + AUDIO_BLOCK_SIZE)
+
+#define BENCH_COMMANDS (200000)
+#define BENCH_QUEUE_BYTES (16 * 1024 * 1024)
+#define BENCH_UART_BYTES (1024 * 1024)
+#define BENCH_BLOCKS (4000)
+
+static int failures = 0;
+
+// Sampling rates the tuning is checked at
+static const uint32_t tuningRates[] = {DAC_SAMPLING_RATE, 22050, DAC_MIN_SAMPLING_RATE};
+
+// Sequence which starts the host link
+static const uint8_t linkMagic[LINK_MAGIC_LENGTH] = {0xA5, 0x5A, 0xC3, 0x3C};
+
+// Bytes sent by UART0 since the last ClearSent()
+static uint8_t sent[OUTPUT_SIZE];
+static int sentLength = 0;
+
+// Values written into DAC0 by the DMA since the last PlayBlocks()
+static uint32_t dacWrites = 0;
+static uint16_t dacMin, dacMax;
+
+// Bytes given to the receive handler, and calls of the sequence handler
+static int handledBytes = 0;
+static int sequenceCalls = 0;
+
+
+/*
+ * Report a failed check
+ */
+static void Fail(const char* test, const char* message, int value)
+{
+	if(failures < 20)
+		printf("  FAIL in %s: %s (%d)\n", test, message, value);
+	failures++;
+}
+
+
+/*
+ * Seconds of a monotonic clock
+ */
+static double Seconds()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+
+static void KeepSent(uint8_t ch)
+{
+	if(sentLength < OUTPUT_SIZE)
+		sent[sentLength++] = ch;
+}
+
+
+static void ClearSent()
+{
+	sentLength = 0;
+}
+
+
+static void KeepDac(uint16_t value)
+{
+	dacWrites++;
+	if(value < dacMin)
+		dacMin = value;
+	if(value > dacMax)
+		dacMax = value;
+}
+
+
+static void CountByte(uint8_t ch)
+{
+	handledBytes++;
+}
+
+
+static void CountSequence()
+{
+	sequenceCalls++;
+}
+
+
+/*
+ * Reset the board and start the firmware like main() does
+ */
+static void Boot()
+{
+	McuHost_Reset();
+	NvmHost_Reset();
+	mcuHostHooks.uartTransmit = &KeepSent;
+	mcuHostHooks.dacWrite = &KeepDac;
+
+	Init_UART0(BAUD_RATE);
+	SysTick_Init();
+	if(!AudioOut_Init())
+		Fail("boot", "no memory for the audio", 0);
+	AudioOut_Start();
+	PatchStore_Init();
+	EventQueue_Clear();
+	ClearSent();
+}
+
+
+/*
+ * Type a line into UART0 and read it back from the console like ReadLine()
+ * does, returns the length of the line or -1 if it did not come back
+ */
+static int TypeLine(const char* text, char* line, int size)
+{
+	int length = 0;
+	int ch;
+
+	for(const char* p = text; *p != '\0'; p++)
+	{
+		McuHost_UartReceive(*p);
+	}
+	McuHost_UartReceive('\r');
+
+	while((ch = __sys_readc()) != -1 && ch != '\r' && length < size - 1)
+	{
+		line[length++] = ch;
+	}
+	line[length] = '\0';
+	return (ch == '\r') ? length : -1;
+}
+
+
+/*
+ * Handle a command typed into UART0, the text it prints is kept in output
+ */
+static void RunCommand(const char* text, char* output)
+{
+	char line[100];
+	FILE* capture = tmpfile();
+	int saved;
+	size_t length;
+
+	if(TypeLine(text, line, sizeof(line)) < 0)
+		Fail("command", "line not read back", (int)strlen(text));
+
+	// The console of the host is stdout, it is sent to a file meanwhile
+	fflush(stdout);
+	saved = dup(STDOUT_FILENO);
+	dup2(fileno(capture), STDOUT_FILENO);
+	HandleCommand(line);
+	fflush(stdout);
+	dup2(saved, STDOUT_FILENO);
+	close(saved);
+
+	rewind(capture);
+	length = fread(output, 1, OUTPUT_SIZE - 1, capture);
+	output[length] = '\0';
+	fclose(capture);
+}
+
+
+/*
+ * Receive a frame of the host link on UART0
+ */
+static void SendLinkFrame(uint8_t op, const uint8_t* data, uint8_t count)
+{
+	uint16_t crc = Crc16_Byte(CRC16_INIT, count);
+
+	crc = Crc16_Byte(crc, op);
+	McuHost_UartReceive(LINK_SYNC);
+	McuHost_UartReceive(count);
+	McuHost_UartReceive(op);
+	for(int i = 0; i < count; i++)
+	{
+		crc = Crc16_Byte(crc, data[i]);
+		McuHost_UartReceive(data[i]);
+	}
+	McuHost_UartReceive(crc & 0xFF);
+	McuHost_UartReceive(crc >> 8);
+}
+
+
+/*
+ * Play blocks like the hardware and the main loop do: TPM0 overflows once
+ * per sample into the DMA, which takes its interrupt after every block,
+ * and the main loop polls the audio engine MAIN_LOOP_POLLS times per block.
+ * Returns the number of samples written into DAC0.
+ */
+static uint32_t PlayBlocks(int blocks)
+{
+	uint32_t samples = 0;
+	uint32_t cycles = (CYCLES_PER_TICK * TICKS_PER_SECOND / AudioOut_GetSampleRate()) *
+			(AUDIO_BLOCK_SIZE / MAIN_LOOP_POLLS);
+
+	dacWrites = 0;
+	dacMin = 0xFFFF;
+	dacMax = 0;
+	for(int i = 0; i < blocks * MAIN_LOOP_POLLS; i++)
+	{
+		ComputeSamples();
+		samples += McuHost_TimerOverflow(AUDIO_BLOCK_SIZE / MAIN_LOOP_POLLS);
+		McuHost_Advance(cycles);
+	}
+	return samples;
+}
+
+
+/*
+ * Play until the engine goes idle, returns the blocks played or -1
+ */
+static int PlayUntilIdle()
+{
+	audio_stats_t stats;
+
+	for(int i = 1; i <= MAX_BLOCKS; i++)
+	{
+		PlayBlocks(1);
+		AudioOut_GetStats(&stats, false);
+		if(stats.idle)
+			return i;
+	}
+	return -1;
+}
+
+
+static void TestUart()
+{
+	uart_baud_t setting;
+	char line[32];
+	const uint8_t magic[] = {0xA5, 0x5A};
+
+	Boot();
+	UART0_FindBaud(BAUD_RATE, &setting);
+	if((((UART0->BDH & UART0_BDH_SBR_MASK) << 8) | UART0->BDL) != setting.sbr)
+		Fail("uart", "divisor", ((UART0->BDH & UART0_BDH_SBR_MASK) << 8) | UART0->BDL);
+	if((UART0->C4 & UART0_C4_OSR_MASK) + 1 != setting.osr)
+		Fail("uart", "oversampling ratio", UART0->C4 & UART0_C4_OSR_MASK);
+	if((UART0->C2 & (UART0_C2_RE_MASK | UART0_C2_TE_MASK | UART0_C2_RIE_MASK)) !=
+			(UART0_C2_RE_MASK | UART0_C2_TE_MASK | UART0_C2_RIE_MASK))
+		Fail("uart", "receiver, transmitter or interrupt disabled", UART0->C2);
+	if(!(mcuHostNvicEnabled & (1UL << UART0_IRQn)))
+		Fail("uart", "interrupt disabled in the NVIC", mcuHostNvicEnabled);
+	if(UART0_FindBaud(0, &setting) || !UART0_FindBaud(115200, &setting))
+		Fail("uart", "baud rate search", setting.sbr);
+
+	// Echo and read back
+	if(TypeLine("hello", line, sizeof(line)) != 5 || strcmp(line, "hello") != 0)
+		Fail("uart", "line read back", (int)strlen(line));
+	if(sentLength != 6 || memcmp(sent, "hello\r", 6) != 0)
+		Fail("uart", "echo", sentLength);
+	if(__sys_readc() != -1)
+		Fail("uart", "console not empty", 0);
+
+	// Text is queued until the transmit interrupt sends it
+	ClearSent();
+	__sys_write(0, "ARMonica\r\n", 10);
+	if(sentLength != 0 || !(UART0->C2 & UART0_C2_TIE_MASK))
+		Fail("uart", "text sent without the interrupt", sentLength);
+	UART0_SendFlowControl(0x13);
+	if(McuHost_UartTransmit() != 11 || sent[0] != 0x13 || memcmp(sent + 1, "ARMonica\r\n", 10) != 0)
+		Fail("uart", "flow control and text", sentLength);
+	if(UART0->C2 & UART0_C2_TIE_MASK)
+		Fail("uart", "transmit interrupt left enabled", UART0->C2);
+
+	// A receive handler takes the bytes, without echo
+	ClearSent();
+	UART0_SetReceiveHandler(&CountByte);
+	TypeLine("midi", line, sizeof(line));
+	UART0_SetReceiveHandler(NULL);
+	if(handledBytes != 5 || sentLength != 0 || __sys_readc() != -1)
+		Fail("uart", "receive handler", handledBytes);
+
+	// A watched sequence is held back from the console
+	UART0_SetSequenceHandler(magic, sizeof(magic), &CountSequence);
+	McuHost_UartReceive('a');
+	McuHost_UartReceive(0xA5);
+	McuHost_UartReceive(0x5A);
+	McuHost_UartReceive('b');
+	UART0_SetSequenceHandler(NULL, 0, NULL);
+	if(sequenceCalls != 1 || __sys_readc() != 'a' || __sys_readc() != 'b')
+		Fail("uart", "sequence handler", sequenceCalls);
+
+	// A byte received while the interrupts are masked waits for them
+	__disable_irq();
+	McuHost_UartReceive('x');
+	if(McuHost_UartReceive('y') || !(UART0->S1 & UART0_S1_OR_MASK))
+		Fail("uart", "overrun not flagged", UART0->S1);
+	__enable_irq();
+	if(__sys_readc() != 'x' || __sys_readc() != -1)
+		Fail("uart", "byte received while masked", 0);
+}
+
+
+static void TestCommands()
+{
+	char output[OUTPUT_SIZE];
+	note_event_t event;
+	uint8_t rate, depth;
+
+	Boot();
+	RunCommand("author", output);
+	if(strstr(output, "Surya Kanteti") == NULL)
+		Fail("commands", "author", 0);
+
+	RunCommand("  ECHO   on", output);
+	if(!GetEchoMode())
+		Fail("commands", "echo on", 0);
+	RunCommand("echo off", output);
+	if(GetEchoMode())
+		Fail("commands", "echo off", 0);
+	RunCommand("echo maybe", output);
+	if(GetEchoMode() || strstr(output, "Invalid") == NULL)
+		Fail("commands", "invalid echo option", 0);
+
+	RunCommand("lfo vibrato 6 25", output);
+	Lfo_GetSettings(LFO_VIBRATO, &rate, &depth);
+	if(rate != 6 || depth != 25)
+		Fail("commands", "lfo vibrato", rate);
+	RunCommand("lfo vibrato 99 25", output);
+	Lfo_GetSettings(LFO_VIBRATO, &rate, &depth);
+	if(rate != 6 || strstr(output, "Invalid rate") == NULL)
+		Fail("commands", "lfo rate out of range", rate);
+
+	RunCommand("dither tpdf", output);
+	if(OutputStage_GetMode() != OUTPUT_DITHER)
+		Fail("commands", "dither", OutputStage_GetMode());
+
+	RunCommand("wave fm", output);
+	if(Synth_GetWaveform() != SYNTH_WAVE_FM)
+		Fail("commands", "wave fm", Synth_GetWaveform());
+	RunCommand("wave sine", output);
+
+	// The rest leaves a second between the two notes and queues nothing
+	RunCommand("play C1 R1 E2~ E1", output);
+	if(EventQueue_Length() != 4 || strstr(output, "Tones in progress") == NULL)
+		Fail("commands", "play", EventQueue_Length());
+	EventQueue_Peek(&event);
+	if(AudioOut_GetPlayCursor() - event.timestamp != 5 * AudioOut_GetSampleRate())
+		Fail("commands", "rest", (int)(AudioOut_GetPlayCursor() - event.timestamp));
+	RunCommand("play H1 C0", output);
+	if(EventQueue_Length() != 4)
+		Fail("commands", "invalid tones queued", EventQueue_Length());
+
+	// Sine and FM switch in place, the delay lines of pluck drop the tones
+	RunCommand("wave fm", output);
+	if(Synth_GetWaveform() != SYNTH_WAVE_FM || EventQueue_Length() != 4)
+		Fail("commands", "wave fm dropped the tones", EventQueue_Length());
+	RunCommand("wave pluck", output);
+	if(Synth_GetWaveform() != SYNTH_WAVE_PLUCK || EventQueue_Length() != 0)
+		Fail("commands", "wave pluck", EventQueue_Length());
+	RunCommand("wave sine", output);
+
+	// A patch keeps the tempo of the engine, and is timed with every switch of the wave
+	AudioOut_SetTempo(90);
+	RunCommand("save 2", output);
+	AudioOut_SetTempo(120);
+	RunCommand("load 2", output);
+	if(AudioOut_GetTempo() != 90)
+		Fail("commands", "tempo of the patch", AudioOut_GetTempo());
+	RunCommand("bench patch", output);
+	if(strstr(output, "pluck to sine") == NULL || Synth_GetWaveform() != SYNTH_WAVE_SINE)
+		Fail("commands", "bench patch", Synth_GetWaveform());
+
+	RunCommand("midi OMNI", output);
+	if(!Midi_IsActive())
+		Fail("commands", "midi OMNI", 0);
+	Midi_Stop();
+
+	RunCommand("frobnicate", output);
+	if(strstr(output, "Unknown command: frobnicate") == NULL)
+		Fail("commands", "unknown command", 0);
+
+	RunCommand("help", output);
+	if(strstr(output, "dither") == NULL || strstr(output, "bench") == NULL)
+		Fail("commands", "help", (int)strlen(output));
+}
+
+
+static void TestPlayback()
+{
+	char output[OUTPUT_SIZE];
+	audio_stats_t stats;
+	note_event_t event;
+	uint32_t samples;
+	int blocks;
+
+	Boot();
+
+	// The ring starts silent and the engine idles with nothing to play
+	blocks = PlayUntilIdle();
+	if(blocks < 0 || McuHost_DacValue() != DAC_MIDPOINT || (TPM0->SC & TPM_SC_CMOD_MASK))
+		Fail("playback", "idle at startup", blocks);
+	if(McuHost_TimerOverflow(AUDIO_BLOCK_SIZE) != 0)
+		Fail("playback", "DMA running while idle", 0);
+
+	// A second of tone is played sample by sample, then the engine idles again
+	RunCommand("play A1", output);
+	AudioOut_GetStats(&stats, true);
+	samples = PlayBlocks(AudioOut_GetSampleRate() / AUDIO_BLOCK_SIZE);
+	if(samples != (AudioOut_GetSampleRate() / AUDIO_BLOCK_SIZE) * AUDIO_BLOCK_SIZE)
+		Fail("playback", "samples missing", samples);
+	if(dacMax - dacMin < 1000)
+		Fail("playback", "tone too quiet", dacMax - dacMin);
+	AudioOut_GetStats(&stats, false);
+	if(stats.dmaInterrupts != AudioOut_GetSampleRate() / AUDIO_BLOCK_SIZE ||
+			stats.blocksRendered != stats.dmaInterrupts + 1)
+		Fail("playback", "a block per interrupt", stats.dmaInterrupts);
+
+	blocks = PlayUntilIdle();
+	if(blocks < 0 || McuHost_DacValue() != DAC_MIDPOINT)
+		Fail("playback", "idle after the tone", blocks);
+
+	// A sample goes before the tones queued for later
+	RunCommand("play A3 C3", output);
+	PlayBlocks(2);
+	RunCommand("sample kick", output);
+	PlayBlocks(1);
+	if(Sampler_ActivePlayers() != 1)
+		Fail("playback", "sample behind the tones", EventQueue_Length());
+
+	// So does a drum from the host link
+	HostLink_Init();
+	for(int i = 0; i < LINK_MAGIC_LENGTH; i++)
+	{
+		McuHost_UartReceive(linkMagic[i]);
+	}
+	SendLinkFrame(LINK_OP_DRUM, (const uint8_t[]){0, 127}, 2);
+	HostLink_Process();
+	if(!EventQueue_Peek(&event) || event.type != EVENT_DRUM || event.timestamp != AudioOut_GetSampleTime())
+		Fail("playback", "link drum behind the tones", EventQueue_Length());
+	SendLinkFrame(LINK_OP_BYE, NULL, 0);
+	HostLink_Process();
+	if(HostLink_IsActive())
+		Fail("playback", "link bye", 0);
+	RunCommand("rate 48", output);
+
+	// The rate command retimes TPM0 and the tones follow, the ones still
+	// queued are dropped and the next ones start right away
+	RunCommand("play A30", output);
+	PlayBlocks(2);
+	RunCommand("rate 16", output);
+	if(AudioOut_GetSampleRate() != 16000 || TPM0->MOD != 48000000 / 16000 - 1)
+		Fail("playback", "rate 16", TPM0->MOD);
+	RunCommand("play C1", output);
+	if(!EventQueue_Peek(&event) || event.timestamp != AudioOut_GetSampleTime())
+		Fail("playback", "tone after the rate is late", (int)(event.timestamp - AudioOut_GetSampleTime()));
+	samples = PlayBlocks(16000 / AUDIO_BLOCK_SIZE);
+	if(samples != (16000 / AUDIO_BLOCK_SIZE) * AUDIO_BLOCK_SIZE || dacMax - dacMin < 1000)
+		Fail("playback", "tone at 16 kHz", samples);
+	RunCommand("rate 48", output);
+	if(TPM0->MOD != 48000000 / 48000 - 1)
+		Fail("playback", "rate 48", TPM0->MOD);
+}
+
+
+/*
+ * Render a note of the selected wave and measure its period, returns its
+ * deviation from the note in cents in Q8, or INT32_MIN without a period
+ */
+static int32_t MeasureNote(uint8_t note)
+{
+	static int16_t samples[TUNING_MAX_SAMPLES];
+	static uint16_t scratch[TUNING_MAX_LAG + 1];
+	int16_t block[AUDIO_BLOCK_SIZE];
+	uint32_t rate = AudioOut_GetSampleRate();
+	uint32_t period;
+	int maxLag = (int)(TUNING_LAG_PERIODS * rate / (440.0 * pow(2.0, (note - 69) / 12.0))) + 2;
+
+	if(maxLag < TUNING_MIN_LAG)
+		maxLag = TUNING_MIN_LAG;
+	if(maxLag > TUNING_MAX_LAG)
+		maxLag = TUNING_MAX_LAG;
+
+	Synth_Reset();
+	Synth_NoteOn(note, SYNTH_MAX_VELOCITY);
+	for(int i = 0; i < TUNING_ATTACK_BLOCKS; i++)
+	{
+		memset(block, 0, sizeof(block));
+		Synth_BeginBlock();
+		Synth_Render(block, 0, AUDIO_BLOCK_SIZE);
+	}
+	for(int i = 0; i < 2 * maxLag; i += AUDIO_BLOCK_SIZE)
+	{
+		memset(samples + i, 0, AUDIO_BLOCK_SIZE * sizeof(int16_t));
+		Synth_BeginBlock();
+		Synth_Render(samples + i, 0, AUDIO_BLOCK_SIZE);
+	}
+	Synth_Reset();
+
+	period = Pitch_Period(samples, maxLag, maxLag, scratch);
+	return period ? Pitch_Cents(period, rate, note) : INT32_MIN;
+}
+
+
+static void TestTuning()
+{
+	char output[OUTPUT_SIZE];
+	int32_t cents, worst, octaves;
+	int worstNote, notes, minPeriod;
+	uint32_t rate;
+	double start = Seconds();
+
+	Boot();
+	for(int i = 0; i < sizeof(tuningRates) / sizeof(tuningRates[0]); i++)
+	{
+		rate = tuningRates[i];
+		AudioOut_SetSampleRate(rate);
+		for(int wave = 0; wave < SYNTH_WAVES; wave++)
+		{
+			Synth_SetWaveform(wave);
+			AudioOut_Reconfigure();
+			worst = 0;
+			worstNote = 0;
+			notes = 0;
+
+			// Every note with a period of minPeriod samples or more. The
+			// harmonics of short periods fall between the lags the pitch
+			// is found at, and the strings and FM get out of tune with them.
+			minPeriod = (wave == SYNTH_WAVE_SINE) ? TUNING_MIN_PERIOD : TUNING_MIN_HARMONIC_PERIOD;
+			for(int note = TUNING_LOWEST_NOTE; note <= TUNING_HIGHEST_NOTE &&
+					440.0 * pow(2.0, (note - 69) / 12.0) * minPeriod <= rate; note++)
+			{
+				cents = MeasureNote(note);
+				notes++;
+				if(cents == INT32_MIN)
+				{
+					Fail("tuning", "no pitch", note);
+					continue;
+				}
+
+				// Strings longer than the delay line are plucked whole octaves up
+				octaves = 0;
+				if(wave == SYNTH_WAVE_PLUCK)
+					octaves = (cents + (600 << 8)) / (1200 << 8);
+				cents -= octaves * (1200 << 8);
+				if(octaves < 0 || cents > TUNING_MAX_CENTS || cents < -TUNING_MAX_CENTS)
+					Fail("tuning", Synth_WaveName(wave), note);
+				if(abs(cents) >= abs(worst))
+				{
+					worst = cents;
+					worstNote = note;
+				}
+			}
+			printf("  %-5s at %5lu Hz: %2d notes, worst %+.2f cents (note %d)\n", Synth_WaveName(wave),
+					(unsigned long)rate, notes, worst / 256.0, worstNote);
+		}
+	}
+
+	AudioOut_SetSampleRate(DAC_SAMPLING_RATE);
+	Synth_SetWaveform(SYNTH_WAVE_SINE);
+	AudioOut_Reconfigure();
+	printf("  %.2f s\n", Seconds() - start);
+
+	// The board measures an octave of the selected wave
+	RunCommand("bench pitch", output);
+	if(strstr(output, "no pitch") != NULL || strstr(output, "1046.5") == NULL)
+		Fail("tuning", "bench pitch", (int)strlen(output));
+}
+
+
+/*
+ * Time the parsing and handling of commands, their text is thrown away
+ */
+static void BenchCommands()
+{
+	static const char* lines[] = {"echo on", "echo off", "lfo tremolo 3 30", "dither shaped",
+			"wave", "frobnicate   with arguments"};
+	const int numLines = sizeof(lines) / sizeof(lines[0]);
+	char line[100];
+	FILE* sink = fopen("/dev/null", "w");
+	int saved;
+	double start, seconds;
+
+	Boot();
+	fflush(stdout);
+	saved = dup(STDOUT_FILENO);
+	dup2(fileno(sink), STDOUT_FILENO);
+
+	start = Seconds();
+	for(int i = 0; i < BENCH_COMMANDS; i++)
+	{
+		strcpy(line, lines[i % numLines]);
+		HandleCommand(line);
+	}
+	seconds = Seconds() - start;
+
+	fflush(stdout);
+	dup2(saved, STDOUT_FILENO);
+	close(saved);
+	fclose(sink);
+	printf("  %-34s %10.0f ns/command\n", "command parsing and handling", seconds * 1e9 / BENCH_COMMANDS);
+}
+
+
+/*
+ * Time the queues of the console and a byte through UART0
+ */
+static void BenchQueues()
+{
+	uint8_t data[64];
+	double start, seconds;
+	uint32_t checksum = 0;
+	int ch;
+
+	memset(data, 0x55, sizeof(data));
+	for(int chunk = 1; chunk <= 64; chunk *= 64)
+	{
+		start = Seconds();
+		for(int i = 0; i < BENCH_QUEUE_BYTES; i += chunk)
+		{
+			cbfifo_enqueue(TXQ, data, chunk);
+			cbfifo_dequeue(TXQ, data, chunk);
+		}
+		seconds = Seconds() - start;
+		printf("  cbfifo, %2d byte chunks %21.1f MB/s\n", chunk, BENCH_QUEUE_BYTES / seconds / 1e6);
+	}
+
+	Boot();
+	start = Seconds();
+	for(int i = 0; i < BENCH_UART_BYTES; i++)
+	{
+		McuHost_UartReceive('a' + (i & 15));
+		ch = __sys_readc();
+		checksum += ch;
+		ClearSent();
+	}
+	seconds = Seconds() - start;
+	if(checksum != (BENCH_UART_BYTES / 16) * (16 * 'a' + 120))
+		Fail("bench", "bytes lost through UART0", (int)checksum);
+	printf("  %-34s %10.0f ns/byte\n", "UART0 interrupt, echo and console", seconds * 1e9 / BENCH_UART_BYTES);
+}
+
+
+/*
+ * Time the rendering through the event queue, the DMA and DAC0 with all
+ * the voices sounding, the echo on and the shaped dither
+ */
+static void BenchRender()
+{
+	char output[OUTPUT_SIZE];
+	audio_stats_t stats;
+	note_event_t event;
+	uint32_t samples;
+	double start, seconds;
+
+	for(int wave = 0; wave < SYNTH_WAVES; wave++)
+	{
+		Boot();
+		Synth_SetWaveform(wave);
+		AudioOut_Reconfigure();
+		RunCommand("echo on", output);
+		RunCommand("dither shaped", output);
+
+		event.timestamp = AudioOut_GetSampleTime();
+		event.type = EVENT_NOTE_ON;
+		event.value = SYNTH_MAX_VELOCITY;
+		for(int i = 0; i < SYNTH_MAX_VOICES; i++)
+		{
+			event.key = 60 + 4 * i;
+			EventQueue_Enqueue(&event);
+		}
+		AudioOut_GetStats(&stats, true);
+
+		start = Seconds();
+		samples = PlayBlocks(BENCH_BLOCKS);
+		seconds = Seconds() - start;
+
+		AudioOut_GetStats(&stats, false);
+		if(samples == 0 || stats.blocksRendered == 0)
+			Fail("bench", "nothing rendered", wave);
+		else
+			printf("  render %-8s %4lu blocks %15.1f ns/sample, %.0f x real time\n", Synth_WaveName(wave),
+					(unsigned long)stats.blocksRendered, seconds * 1e9 / samples,
+					samples / (seconds * AudioOut_GetSampleRate()));
+	}
+}
+
+
+int main()
+{
+	double start = Seconds();
+
+	printf("Board tests\n");
+	test_cbfifo();
+	test_sin();
+	test_event_queue();
+	printf("UART\n");
+	TestUart();
+	printf("Playback\n");
+	TestPlayback();
+	printf("Tuning\n");
+	TestTuning();
+	printf("Commands\n");
+	TestCommands();
+
+	printf("Benchmarks\n");
+	BenchCommands();
+	BenchQueues();
+	BenchRender();
+
+	printf("%s in %.1f s\n", failures ? "FAILED" : "PASSED", Seconds() - start);
+	return failures ? 1 : 0;
+}
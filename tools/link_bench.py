@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""
+link_bench.py - Throughput of the binary host link against the text console
+
+Run from the project folder with the board on the console:
+    python3 tools/link_bench.py /dev/ttyACM0 [--baud 38400] [--switch 115200] [--count 2000]
+
+The board has to run at the baud rate given, --switch moves the board and
+the port to another rate for the benchmark and back after it. Measures:
+  - note frames streamed back to back, with a ping every WINDOW frames
+    so no more than two windows are waiting in the buffer of the board,
+  - ping and stats round trips,
+  - the same commands typed as text on the console ("echo off", waiting
+    for the prompt before the next one),
+and prints them next to the most the wire can carry: baud / 11 bits per
+byte (start, 8 data and 2 stop bits) / bytes per command.
+
+Fails if the board reports an error, a CRC error or an overrun.
+
+Requires pyserial.
+
+Author: Surya Kanteti
+"""
+
+import argparse
+import sys
+import time
+
+from armonica_link import Link, OVERHEAD, encode, OP_NOTE_ON, OP_NOTE_OFF, OP_PING, OP_REPLY
+
+BITS_PER_BYTE = 11
+WINDOW = 8  # Note frames between pings, two windows fit LINK_BUFFER_SIZE
+STATS_LENGTH = 30  # LINK_STATS_LENGTH
+PROMPT = b'? '
+TEXT_COMMAND = b'echo off\r'
+
+
+def wire_limit(baud, frame_bytes):
+    """Commands per second the wire carries at most"""
+    return baud / BITS_PER_BYTE / frame_bytes
+
+
+def stream_notes(link, count):
+    """Note frames per second, streamed with a ping every WINDOW frames"""
+    start = time.time()
+    outstanding = 0
+    for i in range(count):
+        note = 48 + (i // 2) % 24
+        if i % 2 == 0:
+            link.note_on(note, 100)
+        else:
+            link.note_off(note)
+        if (i + 1) % WINDOW == 0:
+            link.send(OP_PING)
+            outstanding += 1
+            if outstanding == 2:
+                link.wait(OP_PING | OP_REPLY)
+                outstanding -= 1
+    while outstanding:
+        link.wait(OP_PING | OP_REPLY)
+        outstanding -= 1
+    link.all_notes_off()
+    return count / (time.time() - start)
+
+
+def round_trips(call, count):
+    """Mean round trip time of a query in seconds"""
+    start = time.time()
+    for _ in range(count):
+        call()
+    return (time.time() - start) / count
+
+
+def text_commands(port, count):
+    """Console commands per second and bytes answered to each one, every
+    command waits for the prompt"""
+    port.reset_input_buffer()
+    answered = 0
+    start = time.time()
+    for _ in range(count):
+        port.write(TEXT_COMMAND)
+        received = b''
+        deadline = time.time() + 1.0
+        while not received.endswith(PROMPT):
+            if time.time() > deadline:
+                raise RuntimeError('no prompt from the console')
+            received += port.read(port.in_waiting or 1)
+        answered += len(received)
+    return count / (time.time() - start), answered / count
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('port', help='serial port of the board')
+    parser.add_argument('--baud', type=int, default=38400)
+    parser.add_argument('--switch', type=int, help='baud rate to benchmark at')
+    parser.add_argument('--count', type=int, default=2000, help='note frames to stream')
+    args = parser.parse_args()
+    baud = args.switch or args.baud
+
+    note_bytes = len(encode(OP_NOTE_ON, bytes(2))) + len(encode(OP_NOTE_OFF, bytes(1)))
+    note_bytes /= 2
+    # A ping every WINDOW frames shares the wire with the notes
+    streamed_bytes = note_bytes + OVERHEAD / WINDOW
+    queries = max(args.count // 20, 10)
+
+    with Link(args.port, args.baud) as link:
+        if args.switch:
+            actual, error = link.set_baud(args.switch)
+            print('Switched to %d baud, actual %d, error %d ppm' % (args.switch, actual, error))
+        notes = stream_notes(link, args.count)
+        ping = round_trips(link.ping, queries)
+        stats_time = round_trips(link.stats, queries)
+        stats = link.stats()
+
+        port = link.port
+        link.close()
+        port.open()
+        text, text_answer = text_commands(port, queries)
+        port.close()
+
+    if args.switch:
+        with Link(args.port, args.switch) as link:
+            link.set_baud(args.baud)
+
+    # A text command is echoed and answered with a message and the prompt,
+    # the longer direction limits it
+    text_bytes = max(len(TEXT_COMMAND), text_answer)
+    print('Baud rate %d, %d bits per byte' % (baud, BITS_PER_BYTE))
+    print('%-22s %10s %10s' % ('', 'measured', 'wire bound'))
+    print('%-22s %10.0f %10.0f' % ('Notes per second', notes, wire_limit(baud, streamed_bytes)))
+    print('%-22s %10.2f %10.2f' % ('Ping round trip ms', ping * 1000,
+                                   2000 * OVERHEAD * BITS_PER_BYTE / baud))
+    print('%-22s %10.2f %10.2f' % ('Stats round trip ms', stats_time * 1000,
+                                   1000 * (2 * OVERHEAD + STATS_LENGTH) * BITS_PER_BYTE / baud))
+    print('%-22s %10.0f %10.0f' % ('Text commands/second', text, wire_limit(baud, text_bytes)))
+    print('Link: %d frames, %d CRC errors, %d errors, %d overruns, %d reported' %
+          (stats['frames'], stats['crc_errors'], stats['errors'], stats['overruns'], len(link.errors)))
+
+    if stats['crc_errors'] or stats['errors'] or stats['overruns'] or link.errors:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
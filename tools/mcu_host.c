@@ -0,0 +1,446 @@
+/*
+ * mcu_host.c - Hardware of the KL25Z played for the host tests
+ *
+ * Holds the registers of tools/host/MKL25Z4.h and does what the hardware
+ * would when a test asks: receives and sends bytes on UART0, overflows
+ * TPM0 into DMA transfers to DAC0 and counts the SysTick timer down. The
+ * interrupt handlers of the sources are called like the NVIC would, one
+ * at a time, when they are requested, enabled and not masked. Only the
+ * way the sources use the peripherals is modeled, anything else (another
+ * DMA destination, a missing handler) stops the test with a message.
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcu_host.h"
+
+#define UART_NO_DATA (0x100) // Data register value while no byte was written
+#define MAX_LEVEL_INTERRUPTS (1000000) // Handler calls in a row before a request is taken as stuck
+#define SYSTICK_PRIORITY (3)
+
+UART0_Type mcuHostUart0;
+DMA_Type mcuHostDma0;
+DMAMUX_Type mcuHostDmamux0;
+DAC_Type mcuHostDac0;
+TPM_Type mcuHostTpm0;
+SIM_Type mcuHostSim;
+PORT_Type mcuHostPorta;
+PORT_Type mcuHostPorte;
+SysTick_Type mcuHostSysTick;
+SCB_Type mcuHostScb;
+
+uint32_t mcuHostPrimask;
+uint32_t mcuHostNvicEnabled;
+uint32_t mcuHostNvicPending;
+uint8_t mcuHostNvicPriority[32];
+
+mcu_host_hooks_t mcuHostHooks;
+bool mcuHostDeferInterrupts;
+uint32_t mcuHostInterrupts;
+uint32_t mcuHostDmaTransfers;
+uint32_t mcuHostDmaMissed;
+
+// The host keeps all the code in place, none is run from SRAM (RamCode.h)
+uint8_t __start_ramcode[1];
+extern uint8_t __end_ramcode[1] __attribute__((alias("__start_ramcode")));
+extern uint8_t __load_ramcode[1] __attribute__((alias("__start_ramcode")));
+
+// Handlers of the sources linked in, like the weak defaults of the startup code
+void SysTick_Handler(void) __attribute__((weak));
+void DMA0_IRQHandler(void) __attribute__((weak));
+void UART0_IRQHandler(void) __attribute__((weak));
+void TPM0_IRQHandler(void) __attribute__((weak));
+
+static bool taking = false; // Set while a handler runs, they don't nest
+static bool uartReceived = false; // A received byte was not read yet
+static uint8_t uartErrors = 0; // Error flags of UART0 to report
+static uint32_t uartBytesSent = 0;
+static uint32_t cycleRest = 0; // Core cycles short of a SysTick count
+
+
+/*
+ * Stop the test on a use of the hardware which is not modeled
+ */
+static void Fatal(const char* message)
+{
+	fprintf(stderr, "mcu_host: %s\n", message);
+	abort();
+}
+
+
+void McuHost_Reset()
+{
+	memset(&mcuHostUart0, 0, sizeof(mcuHostUart0));
+	memset(&mcuHostDma0, 0, sizeof(mcuHostDma0));
+	memset(&mcuHostDmamux0, 0, sizeof(mcuHostDmamux0));
+	memset(&mcuHostDac0, 0, sizeof(mcuHostDac0));
+	memset(&mcuHostTpm0, 0, sizeof(mcuHostTpm0));
+	memset(&mcuHostSim, 0, sizeof(mcuHostSim));
+	memset(&mcuHostPorta, 0, sizeof(mcuHostPorta));
+	memset(&mcuHostPorte, 0, sizeof(mcuHostPorte));
+	memset(&mcuHostSysTick, 0, sizeof(mcuHostSysTick));
+	memset(&mcuHostScb, 0, sizeof(mcuHostScb));
+	memset(&mcuHostHooks, 0, sizeof(mcuHostHooks));
+	memset(mcuHostNvicPriority, 0, sizeof(mcuHostNvicPriority));
+
+	// Reset values of the registers which are not zero
+	mcuHostUart0.BDL = 0x04;
+	mcuHostUart0.C4 = 0x0F;
+	mcuHostUart0.S1 = UART0_S1_TDRE_MASK | UART0_S1_TC_MASK;
+	mcuHostUart0.D = UART_NO_DATA;
+
+	mcuHostPrimask = 0;
+	mcuHostNvicEnabled = 0;
+	mcuHostNvicPending = 0;
+	mcuHostInterrupts = 0;
+	mcuHostDeferInterrupts = false;
+	mcuHostDmaTransfers = 0;
+	mcuHostDmaMissed = 0;
+	taking = false;
+	uartReceived = false;
+	uartErrors = 0;
+	uartBytesSent = 0;
+	cycleRest = 0;
+}
+
+
+/*
+ * Set the status flags of UART0, they are read only or cleared by writing
+ * ones on the device, which a plain register can't do. The transmitter is
+ * always empty, it sends at once.
+ */
+static void Uart0Status()
+{
+	mcuHostUart0.S1 = UART0_S1_TDRE_MASK | UART0_S1_TC_MASK | uartErrors |
+			(uartReceived ? UART0_S1_RDRF_MASK : 0);
+}
+
+
+/*
+ * UART0 requests its interrupt as long as a byte waits or the transmitter
+ * is empty with its interrupt enabled
+ */
+static bool Uart0Requesting()
+{
+	Uart0Status();
+	return ((mcuHostUart0.C2 & UART0_C2_RIE_MASK) && (mcuHostUart0.S1 & UART0_S1_RDRF_MASK)) ||
+			((mcuHostUart0.C2 & UART0_C2_TIE_MASK) && (mcuHostUart0.S1 & UART0_S1_TDRE_MASK));
+}
+
+
+/*
+ * Call the UART0 handler, the byte written into the data register is sent
+ * at once and a received byte is read by the handler
+ */
+static void TakeUart0()
+{
+	uint8_t ch;
+
+	if(UART0_IRQHandler == NULL)
+		Fatal("UART0 interrupt without a handler");
+	Uart0Status();
+	UART0_IRQHandler();
+
+	if(mcuHostUart0.D < UART_NO_DATA)
+	{
+		ch = (uint8_t)mcuHostUart0.D;
+		mcuHostUart0.D |= UART_NO_DATA;
+		if(mcuHostUart0.C2 & UART0_C2_TE_MASK)
+		{
+			uartBytesSent++;
+			if(mcuHostHooks.uartTransmit != NULL)
+				mcuHostHooks.uartTransmit(ch);
+		}
+	}
+
+	// The handler read the byte and cleared the error flags
+	uartReceived = false;
+	uartErrors = 0;
+	Uart0Status();
+}
+
+
+int McuHost_NextPending()
+{
+	int next = MCU_HOST_NO_IRQ;
+	int priority = 4;
+
+	if(mcuHostScb.ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		next = SysTick_IRQn;
+		priority = SYSTICK_PRIORITY;
+	}
+	for(int irq = 0; irq < 32; irq++)
+	{
+		if((mcuHostNvicPending & mcuHostNvicEnabled & (1UL << irq)) &&
+				mcuHostNvicPriority[irq] < priority)
+		{
+			next = irq;
+			priority = mcuHostNvicPriority[irq];
+		}
+	}
+	return next;
+}
+
+
+void McuHost_Take(IRQn_Type irq)
+{
+	if(irq == SysTick_IRQn)
+		mcuHostScb.ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+	else
+		mcuHostNvicPending &= ~(1UL << irq);
+
+	mcuHostInterrupts++;
+	if(mcuHostHooks.interrupt != NULL)
+		mcuHostHooks.interrupt(irq);
+
+	switch(irq)
+	{
+	case SysTick_IRQn:
+		if(SysTick_Handler == NULL)
+			Fatal("SysTick exception without a handler");
+		SysTick_Handler();
+		break;
+	case DMA0_IRQn:
+		if(DMA0_IRQHandler == NULL)
+			Fatal("DMA0 interrupt without a handler");
+		DMA0_IRQHandler();
+		break;
+	case UART0_IRQn:
+		TakeUart0();
+		// The request is a level, it stays until the handler clears it
+		if(Uart0Requesting())
+			mcuHostNvicPending |= 1UL << UART0_IRQn;
+		break;
+	case TPM0_IRQn:
+		if(TPM0_IRQHandler == NULL)
+			Fatal("TPM0 interrupt without a handler");
+		TPM0_IRQHandler();
+		break;
+	default:
+		Fatal("interrupt which is not modeled");
+		break;
+	}
+}
+
+
+void McuHost_TakePending(void)
+{
+	int irq;
+	uint32_t calls = 0;
+
+	if(taking || mcuHostDeferInterrupts)
+		return;
+
+	taking = true;
+	while(!mcuHostPrimask && (irq = McuHost_NextPending()) != MCU_HOST_NO_IRQ)
+	{
+		if(++calls > MAX_LEVEL_INTERRUPTS)
+			Fatal("an interrupt handler does not clear its request");
+		McuHost_Take(irq);
+	}
+	taking = false;
+}
+
+
+void McuHost_Raise(IRQn_Type irq)
+{
+	if(irq == SysTick_IRQn)
+		mcuHostScb.ICSR |= SCB_ICSR_PENDSTSET_Msk;
+	else
+		mcuHostNvicPending |= 1UL << irq;
+
+	McuHost_TakePending();
+}
+
+
+bool McuHost_UartReceive(uint8_t ch)
+{
+	if(!(mcuHostUart0.C2 & UART0_C2_RE_MASK))
+		return false;
+
+	if(uartReceived)
+	{
+		uartErrors |= UART0_S1_OR_MASK; // The byte before was not read
+		Uart0Status();
+		return false;
+	}
+
+	mcuHostUart0.D = UART_NO_DATA | ch;
+	uartReceived = true;
+	if(Uart0Requesting())
+		McuHost_Raise(UART0_IRQn);
+	return true;
+}
+
+
+int McuHost_UartTransmit()
+{
+	uint32_t sent = uartBytesSent;
+
+	if(Uart0Requesting())
+		McuHost_Raise(UART0_IRQn);
+	return (int)(uartBytesSent - sent);
+}
+
+
+/*
+ * Bytes of a transfer size field of the DMA, 0 for the reserved value
+ */
+static uint32_t TransferBytes(uint32_t size)
+{
+	static const uint32_t bytes[4] = {4, 1, 2, 0};
+	return bytes[size & 3];
+}
+
+
+/*
+ * Serve a request of channel 0 of the DMA, returns the samples written
+ * into DAC0
+ */
+static uint32_t DmaRequest()
+{
+	uint32_t dcr = mcuHostDma0.DMA[0].DCR;
+	uint32_t bcr;
+	uint32_t size, modulo, address;
+	uint16_t value;
+	uint32_t written = 0;
+
+	if(!(dcr & DMA_DCR_ERQ_MASK))
+		return 0;
+
+	// Requests are lost until the handler starts the next major loop
+	if(mcuHostDma0.DMA[0].DSR_BCR & DMA_DSR_BCR_DONE_MASK)
+	{
+		mcuHostDmaMissed++;
+		return 0;
+	}
+
+	size = TransferBytes((dcr & DMA_DCR_SSIZE_MASK) >> DMA_DCR_SSIZE_SHIFT);
+	if(size != 2 || TransferBytes((dcr & DMA_DCR_DSIZE_MASK) >> DMA_DCR_DSIZE_SHIFT) != 2 ||
+			mcuHostDma0.DMA[0].DAR != (uint32_t)(uintptr_t)&mcuHostDac0.DAT[0])
+		Fatal("DMA transfer other than 16 bit samples into DAC0");
+
+	// A cycle steal transfer moves one sample per request, else all of them
+	do
+	{
+		bcr = mcuHostDma0.DMA[0].DSR_BCR & DMA_DSR_BCR_BCR_MASK;
+		if(bcr < size)
+		{
+			mcuHostDma0.DMA[0].DSR_BCR |= DMA_DSR_BCR_CE_MASK;
+			Fatal("DMA request with no bytes left to transfer");
+		}
+		if(mcuHostDma0.DMA[0].SAR == 0)
+			Fatal("DMA transfer from address 0");
+
+		// Addresses are 32 bits, the host tests are linked below 4 GB
+		address = mcuHostDma0.DMA[0].SAR;
+		value = *(const uint16_t*)(uintptr_t)address;
+		mcuHostDac0.DAT[0].DATL = value & 0xFF;
+		mcuHostDac0.DAT[0].DATH = (value >> 8) & 0x0F;
+		written++;
+		mcuHostDmaTransfers++;
+		if(mcuHostHooks.dacWrite != NULL)
+			mcuHostHooks.dacWrite(McuHost_DacValue());
+
+		if(dcr & DMA_DCR_SINC_MASK)
+		{
+			// The source wraps around a buffer of 16 << (SMOD - 1) bytes
+			modulo = (dcr & DMA_DCR_SMOD_MASK) >> DMA_DCR_SMOD_SHIFT;
+			if(modulo == 0)
+				address += size;
+			else
+				address = (address & ~((16UL << (modulo - 1)) - 1)) |
+						((address + size) & ((16UL << (modulo - 1)) - 1));
+			mcuHostDma0.DMA[0].SAR = address;
+		}
+
+		bcr -= size;
+		mcuHostDma0.DMA[0].DSR_BCR = (mcuHostDma0.DMA[0].DSR_BCR & ~DMA_DSR_BCR_BCR_MASK) | bcr;
+	} while(!(dcr & DMA_DCR_CS_MASK) && bcr > 0);
+
+	if(bcr == 0)
+	{
+		mcuHostDma0.DMA[0].DSR_BCR |= DMA_DSR_BCR_DONE_MASK;
+		if(dcr & DMA_DCR_EINT_MASK)
+			McuHost_Raise(DMA0_IRQn);
+	}
+	return written;
+}
+
+
+uint32_t McuHost_TimerOverflow(uint32_t count)
+{
+	uint32_t written = 0;
+	uint8_t channel;
+
+	for(uint32_t i = 0; i < count; i++)
+	{
+		// A stopped counter does not overflow
+		if(!(mcuHostTpm0.SC & TPM_SC_CMOD_MASK))
+			break;
+
+		mcuHostTpm0.SC |= TPM_SC_TOF_MASK;
+		if(mcuHostTpm0.SC & TPM_SC_TOIE_MASK)
+			McuHost_Raise(TPM0_IRQn);
+
+		channel = mcuHostDmamux0.CHCFG[0];
+		if((mcuHostTpm0.SC & TPM_SC_DMA_MASK) && (channel & DMAMUX_CHCFG_ENBL_MASK) &&
+				(channel & DMAMUX_CHCFG_SOURCE_MASK) == MCU_HOST_TPM0_REQUEST)
+		{
+			written += DmaRequest();
+			mcuHostTpm0.SC &= ~TPM_SC_TOF_MASK; // Cleared by the DMA acknowledge
+		}
+	}
+	return written;
+}
+
+
+void McuHost_Advance(uint32_t cycles)
+{
+	uint32_t counts, step;
+
+	if(!(mcuHostSysTick.CTRL & SysTick_CTRL_ENABLE_Msk))
+		return;
+
+	if(mcuHostSysTick.CTRL & SysTick_CTRL_CLKSOURCE_Msk)
+	{
+		counts = cycles;
+	}
+	else
+	{
+		counts = (cycleRest + cycles) / 16;
+		cycleRest = (cycleRest + cycles) % 16;
+	}
+
+	while(counts > 0)
+	{
+		// The count after zero loads the reload value
+		if(mcuHostSysTick.VAL == 0)
+		{
+			mcuHostSysTick.VAL = mcuHostSysTick.LOAD & SysTick_LOAD_RELOAD_Msk;
+			counts--;
+			continue;
+		}
+
+		step = (counts < mcuHostSysTick.VAL) ? counts : mcuHostSysTick.VAL;
+		mcuHostSysTick.VAL -= step;
+		counts -= step;
+		if(mcuHostSysTick.VAL == 0)
+		{
+			mcuHostSysTick.CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+			if(mcuHostSysTick.CTRL & SysTick_CTRL_TICKINT_Msk)
+				McuHost_Raise(SysTick_IRQn);
+		}
+	}
+}
+
+
+uint16_t McuHost_DacValue()
+{
+	return ((mcuHostDac0.DAT[0].DATH << 8) | mcuHostDac0.DAT[0].DATL) & 0xFFF;
+}
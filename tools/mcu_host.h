@@ -0,0 +1,142 @@
+/*
+ * mcu_host.h - Hardware of the KL25Z played for the host tests
+ *
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __MCU_HOST_H__
+#define __MCU_HOST_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "MKL25Z4.h"
+
+// DMAMUX source of the TPM0 overflow
+#define MCU_HOST_TPM0_REQUEST (54)
+
+// Returned by McuHost_NextPending() when no interrupt is pending
+#define MCU_HOST_NO_IRQ (-2)
+
+// Functions called by the simulated hardware, NULL if not needed
+typedef struct mcu_host_hooks_s
+{
+	void (*uartTransmit)(uint8_t ch); // Byte sent by UART0
+	void (*dacWrite)(uint16_t value); // Value written into DAC0 by the DMA
+	void (*interrupt)(IRQn_Type irq); // Before an interrupt handler is called
+} mcu_host_hooks_t;
+
+extern mcu_host_hooks_t mcuHostHooks;
+
+// Set by a simulation which times the handlers itself: the interrupts
+// requested are left pending until it calls McuHost_Take()
+extern bool mcuHostDeferInterrupts;
+
+// Interrupt handlers called, samples moved and DMA requests lost while the
+// channel was done since the last reset
+extern uint32_t mcuHostInterrupts;
+extern uint32_t mcuHostDmaTransfers;
+extern uint32_t mcuHostDmaMissed;
+
+
+/*
+ * Resets the peripherals, the interrupt mask, the NVIC and the hooks
+ *
+ * @input None
+ * @return None
+ *
+ */
+void McuHost_Reset();
+
+
+/*
+ * Requests an interrupt, its handler is called right away unless the
+ * interrupt is masked or disabled in the NVIC, then it is left pending
+ *
+ * @input irq		Interrupt number, SysTick_IRQn for the SysTick exception
+ * @return None
+ *
+ */
+void McuHost_Raise(IRQn_Type irq);
+
+
+/*
+ * Returns the pending interrupt the NVIC would take next, the enabled one
+ * of the highest priority
+ *
+ * @input None
+ * @return Interrupt number, SysTick_IRQn, or MCU_HOST_NO_IRQ if none
+ *
+ */
+int McuHost_NextPending();
+
+
+/*
+ * Takes a pending interrupt: clears its request and calls its handler,
+ * whether the interrupts are masked or not
+ *
+ * @input irq		Interrupt number, SysTick_IRQn for the SysTick exception
+ * @return None
+ *
+ */
+void McuHost_Take(IRQn_Type irq);
+
+
+/*
+ * Receives a byte on UART0, the receive interrupt is taken if enabled.
+ * The transmitter is infinitely fast: the interrupt is taken again as
+ * long as the handler has text to send.
+ *
+ * @input ch		Received byte
+ * @return False if the receiver is disabled or the last byte was not read
+ *
+ */
+bool McuHost_UartReceive(uint8_t ch);
+
+
+/*
+ * Sends the text queued for UART0, e.g. after printing into the queue
+ * enabled the transmit interrupt
+ *
+ * @input None
+ * @return Number of bytes sent
+ *
+ */
+int McuHost_UartTransmit();
+
+
+/*
+ * Overflows TPM0, every overflow requests a DMA transfer when enabled like
+ * AudioOut.c does. Channel 0 of the DMA moves a sample from the source to
+ * DAC0, with the source address wrapped by the modulo of the channel, and
+ * takes the DMA0 interrupt once the byte count is done.
+ *
+ * @input count		Number of overflows
+ * @return Number of samples written into DAC0
+ *
+ */
+uint32_t McuHost_TimerOverflow(uint32_t count);
+
+
+/*
+ * Runs the SysTick timer for a number of core cycles, it counts every 16
+ * cycles like with the external reference, and takes the SysTick
+ * exception when it reaches zero
+ *
+ * @input cycles	Core clock cycles
+ * @return None
+ *
+ */
+void McuHost_Advance(uint32_t cycles);
+
+
+/*
+ * Returns the 12 bit value DAC0 is converting
+ *
+ * @input None
+ * @return Value of the data register 0
+ *
+ */
+uint16_t McuHost_DacValue();
+
+#endif /* __MCU_HOST_H__ */
@@ -0,0 +1,803 @@
+/*
+ * midi_replay.c - Timing of the MIDI input replayed on the host
+ *
+ * Build and run from the project folder:
+ *     gcc -O2 -Iinclude tools/midi_replay.c source/Midi.c -lm -o midi_replay
+ *     ./midi_replay [--baud <rate>] [--channel <1 to 16>] [--clock] [song.mid]
+ *
+ * The bytes of a MIDI stream are fed one at a time to the parser of
+ * source/Midi.c as the UART would receive them at the baud rate, while
+ * the blocks of the audio engine are rendered every AUDIO_BLOCK_SIZE
+ * samples at 48 kHz and take the received events. The cycle counter, the
+ * UART and the sample clock of the firmware are simulated.
+ *
+ * Without a file, built-in streams are replayed: notes with running status,
+ * clock bytes in the middle of messages, system exclusive data, pitch
+ * bend, the modulation wheel, the percussion channel, sequencer start,
+ * stop and continue, and a clock changing its tempo with some jitter.
+ * They are replayed listening to all channels and to channel 1.
+ *
+ * A Standard MIDI File (format 0 or 1) is replayed as a sender with
+ * running status would transmit it, following its tempo map. --clock
+ * adds a MIDI clock following the tempo map.
+ *
+ * Checks that the events reach the engine in the order of the stream with
+ * the expected values, that every event is taken by the first block
+ * rendered after its last byte (at most one block later), and that the
+ * tempo of the clock is followed within half a beat per minute.
+ * Exits with 1 if a check fails.
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "Midi.h"
+#include "AudioOut.h"
+#include "Drums.h"
+#include "Lfo.h"
+#include "SysTick.h"
+#include "UART_IO.h"
+
+#define SAMPLING_RATE (48000)
+#define CYCLES_PER_US (48)
+#define BITS_PER_BYTE (10) // Start, 8 data and stop bit
+#define MIDI_BAUD (31250)
+#define BLOCK_US (AUDIO_BLOCK_SIZE * 1e6 / SAMPLING_RATE)
+#define CLOCK_JITTER_US (250.0)
+#define MAX_TEMPO_ERROR (0.5)
+
+// Values the firmware gives to the events, repeated here for the checks
+#define MODULATION_RATE_HZ (5)
+#define NO_EVENT (0xFF)
+
+// A byte on the wire and the event expected once it is received
+typedef struct wire_byte_s
+{
+	double time; // Time the sender wants to send it in us
+	int order; // Keeps bytes of the same time in order
+	uint8_t byte;
+	note_event_t expected; // type NO_EVENT if none
+} wire_byte_t;
+
+// Tempo map of a MIDI file
+typedef struct tempo_change_s
+{
+	uint32_t tick;
+	double time; // us
+	uint32_t usPerBeat;
+} tempo_change_t;
+
+// Event of a MIDI file
+typedef struct smf_event_s
+{
+	uint32_t tick;
+	int order;
+	uint8_t status; // 0xF0 or 0xF7 for system exclusive data
+	uint8_t data[2];
+	const uint8_t* sysex;
+	uint32_t sysexLength;
+} smf_event_t;
+
+static wire_byte_t* wire = NULL;
+static int wireCount = 0;
+static int wireSize = 0;
+
+static tempo_change_t* tempoMap = NULL;
+static int tempoCount = 0;
+
+// Simulated firmware
+static uint64_t cycles = 0;
+static uint32_t sampleTime = 0;
+static uart_receive_handler_t handler = NULL;
+
+static double byteTime; // us per byte on the wire
+static int listenChannel = MIDI_OMNI;
+static int failures = 0;
+
+
+/*
+ * The parser times the clock with the cycle counter
+ */
+uint32_t get_cycles()
+{
+	return (uint32_t)cycles;
+}
+
+
+/*
+ * The events are stamped with the next block to render
+ */
+uint32_t AudioOut_GetSampleTime()
+{
+	return sampleTime;
+}
+
+
+uint32_t AudioOut_GetSampleRate()
+{
+	return SAMPLING_RATE;
+}
+
+
+void UART0_SetReceiveHandler(uart_receive_handler_t receiveHandler)
+{
+	handler = receiveHandler;
+}
+
+
+/*
+ * Report a failed check
+ */
+static void Fail(const char* message, double time)
+{
+	if(failures < 20)
+		printf("  FAIL at %.3f ms: %s\n", time / 1000, message);
+	failures++;
+}
+
+
+/*
+ * Add a byte to the wire
+ */
+static void Send(double time, uint8_t byte, const note_event_t* expected)
+{
+	if(wireCount == wireSize)
+	{
+		wireSize = wireSize ? 2 * wireSize : 1024;
+		wire = realloc(wire, wireSize * sizeof(wire_byte_t));
+	}
+
+	wire[wireCount].time = time;
+	wire[wireCount].order = wireCount;
+	wire[wireCount].byte = byte;
+	if(expected != NULL)
+		wire[wireCount].expected = *expected;
+	else
+		wire[wireCount].expected.type = NO_EVENT;
+	wireCount++;
+}
+
+
+static int CompareWire(const void* a, const void* b)
+{
+	const wire_byte_t* x = a;
+	const wire_byte_t* y = b;
+
+	if(x->time != y->time)
+		return (x->time < y->time) ? -1 : 1;
+	return x->order - y->order;
+}
+
+
+/*
+ * Event the firmware should produce for a channel message, from the
+ * description of the midi command rather than from the parser
+ */
+static note_event_t Expect(uint8_t status, uint8_t first, uint8_t second)
+{
+	note_event_t event = {0, NO_EVENT, 0, 0};
+	int channel = (status & 0x0F) + 1;
+	bool drums = (channel == MIDI_DRUM_CHANNEL);
+
+	if(listenChannel != MIDI_OMNI && channel != listenChannel)
+		return event;
+
+	switch(status & 0xF0)
+	{
+	case 0x90:
+		if(second != 0)
+		{
+			event.value = second;
+			event.key = first;
+			event.type = EVENT_NOTE_ON;
+			if(!drums)
+				break;
+
+			// General MIDI bass drums, snares and clap, hi-hats
+			event.type = EVENT_DRUM;
+			if(first == 35 || first == 36)
+				event.key = DRUM_KICK;
+			else if(first >= 37 && first <= 40)
+				event.key = DRUM_SNARE;
+			else if(first == 42 || first == 44 || first == 46)
+				event.key = DRUM_HAT;
+			else
+				event.type = NO_EVENT;
+			break;
+		}
+		// Falls through
+	case 0x80:
+		if(!drums)
+		{
+			event.type = EVENT_NOTE_OFF;
+			event.key = first;
+		}
+		break;
+	case 0xB0:
+		if(first == 1)
+		{
+			event.type = EVENT_PARAMETER;
+			event.key = AUDIO_PARAM_VIBRATO;
+			event.value = (MODULATION_RATE_HZ << 8) | ((second * LFO_MAX_VIBRATO_DEPTH) / 127);
+		}
+		else if(first == 120 || first == 123)
+		{
+			event.type = EVENT_REST;
+		}
+		break;
+	case 0xE0:
+		event.type = EVENT_PARAMETER;
+		event.key = AUDIO_PARAM_PITCH_BEND;
+		event.value = ((uint16_t)second << 7) | first;
+		break;
+	default:
+		break;
+	}
+	return event;
+}
+
+
+/*
+ * Send a message with its bytes one byte time apart from time on, the
+ * last byte carries the expected event
+ */
+static void Message(double time, const uint8_t* bytes, int count, note_event_t expected)
+{
+	for(int i = 0; i < count; i++)
+	{
+		Send(time + i * byteTime, bytes[i], (i == count - 1) ? &expected : NULL);
+	}
+}
+
+
+/*
+ * Send a channel message, the status is left out for running status
+ *
+ * @return Number of bytes sent
+ */
+static int ChannelMessage(double time, uint8_t status, uint8_t runningStatus, uint8_t first, uint8_t second)
+{
+	uint8_t bytes[3];
+	int count = 0;
+	int length = ((status & 0xF0) == 0xC0 || (status & 0xF0) == 0xD0) ? 1 : 2;
+
+	if(status != runningStatus)
+		bytes[count++] = status;
+	bytes[count++] = first;
+	if(length == 2)
+		bytes[count++] = second;
+
+	Message(time, bytes, count, Expect(status, first, (length == 2) ? second : 0));
+	return count;
+}
+
+
+static note_event_t Event(uint8_t type, uint8_t key, uint16_t value)
+{
+	note_event_t event = {0, type, key, value};
+	return event;
+}
+
+
+/*
+ * Replay the wire and check the events taken by the blocks
+ *
+ * @return Number of clock tempo events
+ */
+static int Replay(const char* name, double (*tempoAt)(double time), int* expectedTempos, int tempoChecks)
+{
+	note_event_t event;
+	note_event_t* expected = malloc(wireCount * sizeof(note_event_t));
+	double* completed = malloc(wireCount * sizeof(double)); // Time the events were queued
+	double* pushTimes = malloc((wireCount + 1) * sizeof(double));
+	int expectedCount = 0, matched = 0, pushed = 0, taken = 0, tempoEvents = 0;
+	double lineFree = 0, arrival = 0, nextBlock = BLOCK_US;
+	double latency, maxLatency = 0, sumLatency = 0;
+	uint32_t block = 1;
+	midi_stats_t stats;
+	char text[160];
+
+	qsort(wire, wireCount, sizeof(wire_byte_t), CompareWire);
+	cycles = 0;
+	sampleTime = AUDIO_BLOCK_SIZE;
+
+	for(int i = 0; i <= wireCount; i++)
+	{
+		if(i < wireCount)
+		{
+			// The UART sends one byte at a time
+			arrival = ((wire[i].time > lineFree) ? wire[i].time : lineFree) + byteTime;
+			lineFree = arrival;
+		}
+		else
+		{
+			arrival = lineFree + 4 * BLOCK_US;
+		}
+
+		// Blocks rendered while the byte was on the wire
+		while(nextBlock <= arrival)
+		{
+			while(Midi_Dequeue(&event))
+			{
+				latency = nextBlock - pushTimes[taken++];
+				if(latency > maxLatency)
+					maxLatency = latency;
+				sumLatency += latency;
+				if(event.timestamp != sampleTime)
+					Fail("event not stamped with the block taking it", nextBlock);
+				if(latency > BLOCK_US + 1e-6)
+					Fail("event taken later than the next block", nextBlock);
+
+				if(event.type == EVENT_TEMPO)
+				{
+					if(tempoEvents < tempoChecks && event.value != expectedTempos[tempoEvents])
+					{
+						snprintf(text, sizeof(text), "clock tempo %u, expected %d", event.value, expectedTempos[tempoEvents]);
+						Fail(text, nextBlock);
+					}
+					// Tempos of files are rounded to whole beats per minute
+					if(tempoAt != NULL && tempoAt(pushTimes[taken - 1]) > 0 &&
+							fabs(event.value - tempoAt(pushTimes[taken - 1])) > MAX_TEMPO_ERROR + 0.5)
+					{
+						snprintf(text, sizeof(text), "clock tempo %u, playing %.2f", event.value, tempoAt(pushTimes[taken - 1]));
+						Fail(text, nextBlock);
+					}
+					tempoEvents++;
+					continue;
+				}
+
+				if(matched >= expectedCount || event.type != expected[matched].type ||
+						event.key != expected[matched].key || event.value != expected[matched].value)
+				{
+					snprintf(text, sizeof(text), "unexpected event %u %u %u", event.type, event.key, event.value);
+					Fail(text, nextBlock);
+				}
+				else if(completed[matched] > nextBlock)
+				{
+					Fail("event taken before it was received", nextBlock);
+				}
+				matched++;
+			}
+			nextBlock = ++block * BLOCK_US;
+			sampleTime += AUDIO_BLOCK_SIZE;
+		}
+
+		if(i == wireCount)
+			break;
+
+		cycles = (uint64_t)(arrival * CYCLES_PER_US);
+		if(handler == NULL)
+			continue;
+
+		handler(wire[i].byte);
+		while(pushed - taken < Midi_Pending())
+			pushTimes[pushed++] = arrival;
+
+		if(wire[i].expected.type != NO_EVENT)
+		{
+			completed[expectedCount] = arrival;
+			expected[expectedCount++] = wire[i].expected;
+		}
+	}
+
+	if(matched < expectedCount)
+		Fail("events missing", arrival);
+	if(tempoEvents < tempoChecks)
+		Fail("clock tempo not followed", arrival);
+	Midi_GetStats(&stats);
+	if(stats.dropped != 0)
+		Fail("events dropped", arrival);
+
+	printf("%s: %d bytes, %lu messages, %d events, %d tempo changes (last %u BPM)\n", name,
+			wireCount, (unsigned long)stats.messages, matched, tempoEvents, stats.clockTempo);
+	printf("  latency from the last byte to the block: max %.0f us, mean %.0f us, one block is %.0f us\n",
+			maxLatency, taken ? sumLatency / taken : 0, BLOCK_US);
+
+	free(expected);
+	free(completed);
+	free(pushTimes);
+	wireCount = 0;
+	return tempoEvents;
+}
+
+
+// Tempo of the clock of the built-in streams
+#define FIRST_TEMPO (120)
+#define SECOND_TEMPO (133)
+#define BEATS_PER_TEMPO (8)
+#define CLOCK_START_US (2000.0)
+
+static double clockTimes[2 * BEATS_PER_TEMPO * MIDI_CLOCKS_PER_BEAT + 1];
+
+
+static double BuiltInTempo(double time)
+{
+	return (time < clockTimes[BEATS_PER_TEMPO * MIDI_CLOCKS_PER_BEAT]) ? FIRST_TEMPO : SECOND_TEMPO;
+}
+
+
+/*
+ * Build the built-in stream
+ */
+static void BuiltInStream(bool reset)
+{
+	const int clockCount = sizeof(clockTimes) / sizeof(double);
+	double time = CLOCK_START_US, t;
+	uint32_t random = 12345;
+	int i;
+
+	// Clock with jitter, the tempo changes on a beat
+	for(i = 0; i < clockCount; i++)
+	{
+		random = random * 1103515245 + 12345;
+		clockTimes[i] = time + ((double)(random >> 16) / 32768.0 - 1.0) * CLOCK_JITTER_US;
+		Send(clockTimes[i], 0xF8, NULL);
+		time += 60e6 / (((i < BEATS_PER_TEMPO * MIDI_CLOCKS_PER_BEAT) ? FIRST_TEMPO : SECOND_TEMPO) * MIDI_CLOCKS_PER_BEAT);
+	}
+
+	Message(1000, (uint8_t[]){0xFA}, 1, Event(EVENT_PARAMETER, AUDIO_PARAM_SEQUENCER, 1));
+
+	// A chord with running status, the clock comes in the middle of a message
+	t = clockTimes[10] - 1.5 * byteTime;
+	ChannelMessage(t, 0x90, 0, 60, 100);
+	ChannelMessage(t + 3 * byteTime, 0x90, 0x90, 64, 100);
+	ChannelMessage(t + 5 * byteTime, 0x90, 0x90, 67, 100);
+	ChannelMessage(200000, 0x91, 0, 72, 90);
+	ChannelMessage(200000 + 3 * byteTime, 0x91, 0x91, 74, 0);
+
+	// System exclusive data with a clock inside, then data without a status
+	t = clockTimes[20] - 2.5 * byteTime;
+	Message(t, (uint8_t[]){0xF0, 0x7E, 0x7F, 0x09, 0x01, 0xF7}, 6, Event(NO_EVENT, 0, 0));
+	Message(t + 8 * byteTime, (uint8_t[]){60, 100}, 2, Event(NO_EVENT, 0, 0));
+
+	// Note offs as note ons of velocity 0 with running status, and a note off
+	ChannelMessage(600000, 0x90, 0, 60, 0);
+	ChannelMessage(600000 + 3 * byteTime, 0x90, 0x90, 64, 0);
+	ChannelMessage(600000 + 5 * byteTime, 0x80, 0x90, 67, 64);
+
+	// Modulation wheel, pitch bend to the top and back to the center
+	ChannelMessage(800000, 0xB0, 0, 1, 64);
+	ChannelMessage(900000, 0xE0, 0, 0x7F, 0x7F);
+	ChannelMessage(900000 + 3 * byteTime, 0xE0, 0xE0, 0x00, 0x40);
+
+	// Percussion channel, a crash cymbal and the note offs are ignored
+	ChannelMessage(1000000, 0x99, 0, 36, 127);
+	ChannelMessage(1000000 + 3 * byteTime, 0x99, 0x99, 42, 80);
+	ChannelMessage(1000000 + 5 * byteTime, 0x99, 0x99, 49, 100);
+	ChannelMessage(1000000 + 7 * byteTime, 0x89, 0x99, 36, 0);
+
+	// One data byte messages with running status, then a note
+	ChannelMessage(1200000, 0xC0, 0, 5, 0);
+	ChannelMessage(1200000 + 2 * byteTime, 0xC0, 0xC0, 6, 0);
+	ChannelMessage(1200000 + 3 * byteTime, 0xD0, 0xC0, 30, 0);
+	ChannelMessage(1200000 + 5 * byteTime, 0xA0, 0xD0, 62, 30);
+	ChannelMessage(1200000 + 8 * byteTime, 0x90, 0xA0, 62, 100);
+
+	// System common messages end the running status
+	Message(1400000, (uint8_t[]){0xF6, 64, 100}, 3, Event(NO_EVENT, 0, 0));
+	Message(1500000, (uint8_t[]){0xF2, 0x10, 0x20, 64, 100}, 5, Event(NO_EVENT, 0, 0));
+	ChannelMessage(1600000, 0x90, 0, 64, 100);
+	ChannelMessage(1700000, 0xB0, 0, 123, 0);
+
+	// Sequencer stop and continue, within the second tempo
+	t = clockTimes[BEATS_PER_TEMPO * MIDI_CLOCKS_PER_BEAT + 5] + 2 * byteTime;
+	Message(t, (uint8_t[]){0xFC}, 1, Event(EVENT_PARAMETER, AUDIO_PARAM_SEQUENCER, 0));
+	Message(t + 50000, (uint8_t[]){0xFB}, 1, Event(EVENT_PARAMETER, AUDIO_PARAM_SEQUENCER, 1));
+
+	// Leave MIDI, what follows goes to the console
+	time += 100000;
+	if(reset)
+	{
+		Message(time, (uint8_t[]){0xFF}, 1, Event(EVENT_REST, 0, 0));
+	}
+	else
+	{
+		Message(time, (uint8_t[]){0xF6}, 1, Event(NO_EVENT, 0, 0));
+		Message(time + byteTime, (uint8_t[]){0x1B}, 1, Event(EVENT_REST, 0, 0));
+	}
+	Message(time + 10000, (uint8_t[]){0x90, 60, 100}, 3, Event(NO_EVENT, 0, 0));
+}
+
+
+/*
+ * Read a variable length quantity
+ */
+static uint32_t ReadLength(const uint8_t** p, const uint8_t* end)
+{
+	uint32_t value = 0;
+
+	while(*p < end)
+	{
+		value = (value << 7) | (**p & 0x7F);
+		if(!(*(*p)++ & 0x80))
+			break;
+	}
+	return value;
+}
+
+
+static uint32_t ReadBig(const uint8_t* p, int count)
+{
+	uint32_t value = 0;
+
+	for(int i = 0; i < count; i++)
+	{
+		value = (value << 8) | p[i];
+	}
+	return value;
+}
+
+
+static int CompareSmf(const void* a, const void* b)
+{
+	const smf_event_t* x = a;
+	const smf_event_t* y = b;
+
+	if(x->tick != y->tick)
+		return (x->tick < y->tick) ? -1 : 1;
+	return x->order - y->order;
+}
+
+
+static uint32_t division;
+
+
+/*
+ * Time of a tick from the tempo map in us
+ */
+static double TickTime(double tick)
+{
+	int i = tempoCount - 1;
+
+	while(i > 0 && tempoMap[i].tick > tick)
+		i--;
+	return tempoMap[i].time + (tick - tempoMap[i].tick) * tempoMap[i].usPerBeat / division;
+}
+
+
+/*
+ * Tempo of the file at a time, -1 if it changed within the beat before,
+ * which the clock tempo is measured over
+ */
+static double FileTempo(double time)
+{
+	int i = tempoCount - 1;
+
+	while(i > 0 && tempoMap[i].time > time)
+		i--;
+	if(i > 0 && tempoMap[i].time > time - 2.0 * tempoMap[i - 1].usPerBeat)
+		return -1;
+	return 60e6 / tempoMap[i].usPerBeat;
+}
+
+
+/*
+ * Build the stream of a Standard MIDI File
+ *
+ * @return Number of events, -1 if the file can't be read
+ */
+static int FileStream(const char* path, bool clock)
+{
+	FILE* file = fopen(path, "rb");
+	uint8_t* contents;
+	const uint8_t *p, *end, *trackEnd;
+	long size;
+	int tracks, count = 0, capacity = 1024;
+	smf_event_t* events = malloc(capacity * sizeof(smf_event_t));
+	uint32_t tick, length;
+	uint8_t status, runningStatus = 0;
+	double time, lastTime = 0, offset = 10000;
+
+	if(file == NULL)
+		return -1;
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	contents = malloc(size);
+	if(fread(contents, 1, size, file) != (size_t)size || size < 14 || memcmp(contents, "MThd", 4) != 0)
+	{
+		fclose(file);
+		return -1;
+	}
+	fclose(file);
+
+	tracks = ReadBig(contents + 10, 2);
+	division = ReadBig(contents + 12, 2);
+	if(division & 0x8000)
+	{
+		printf("SMPTE time division is not supported\n");
+		return -1;
+	}
+
+	tempoMap = realloc(tempoMap, sizeof(tempo_change_t));
+	tempoMap[0] = (tempo_change_t){0, 0, 500000};
+	tempoCount = 1;
+
+	p = contents + 8 + ReadBig(contents + 4, 4);
+	end = contents + size;
+	for(int track = 0; track < tracks && p + 8 <= end; track++)
+	{
+		if(memcmp(p, "MTrk", 4) != 0)
+			break;
+		trackEnd = p + 8 + ReadBig(p + 4, 4);
+		if(trackEnd > end)
+			trackEnd = end;
+		p += 8;
+		tick = 0;
+		runningStatus = 0;
+
+		while(p < trackEnd)
+		{
+			tick += ReadLength(&p, trackEnd);
+			if(p >= trackEnd)
+				break;
+			if(count == capacity)
+			{
+				capacity *= 2;
+				events = realloc(events, capacity * sizeof(smf_event_t));
+			}
+
+			status = (*p & 0x80) ? *p++ : runningStatus;
+			if(status == 0xFF)
+			{
+				uint8_t type = *p++;
+				length = ReadLength(&p, trackEnd);
+				if(type == 0x51 && length == 3)
+				{
+					tempoMap = realloc(tempoMap, (tempoCount + 1) * sizeof(tempo_change_t));
+					tempoMap[tempoCount++] = (tempo_change_t){tick, 0, ReadBig(p, 3)};
+				}
+				p += length;
+				continue;
+			}
+
+			events[count] = (smf_event_t){tick, count, status, {0, 0}, NULL, 0};
+			if(status == 0xF0 || status == 0xF7)
+			{
+				length = ReadLength(&p, trackEnd);
+				events[count].sysex = p;
+				events[count].sysexLength = length;
+				p += length;
+				runningStatus = 0;
+			}
+			else
+			{
+				runningStatus = status;
+				events[count].data[0] = *p++;
+				if((status & 0xF0) != 0xC0 && (status & 0xF0) != 0xD0)
+					events[count].data[1] = *p++;
+			}
+			count++;
+		}
+		p = trackEnd;
+	}
+
+	// Time of the tempo changes, in the order of their ticks
+	for(int i = 1; i < tempoCount; i++)
+	{
+		for(int j = i; j > 0 && tempoMap[j - 1].tick > tempoMap[j].tick; j--)
+		{
+			tempo_change_t swap = tempoMap[j];
+			tempoMap[j] = tempoMap[j - 1];
+			tempoMap[j - 1] = swap;
+		}
+	}
+	for(int i = 1; i < tempoCount; i++)
+	{
+		tempoMap[i].time = tempoMap[i - 1].time +
+				(double)(tempoMap[i].tick - tempoMap[i - 1].tick) * tempoMap[i - 1].usPerBeat / division;
+	}
+
+	// Send the events as a sender with running status would, the events of
+	// the same time one after the other
+	qsort(events, count, sizeof(smf_event_t), CompareSmf);
+	runningStatus = 0;
+	for(int i = 0; i < count; i++)
+	{
+		time = offset + TickTime(events[i].tick);
+		if(time < lastTime)
+			time = lastTime;
+
+		if(events[i].sysex != NULL)
+		{
+			if(events[i].status == 0xF0)
+				Send(time, 0xF0, NULL);
+			for(uint32_t j = 0; j < events[i].sysexLength; j++)
+				Send(time + (j + 1) * byteTime, events[i].sysex[j], NULL);
+			lastTime = time + (events[i].sysexLength + 1) * byteTime;
+			runningStatus = 0;
+			continue;
+		}
+
+		lastTime = time + ChannelMessage(time, events[i].status, runningStatus,
+				events[i].data[0], events[i].data[1]) * byteTime;
+		runningStatus = events[i].status;
+	}
+
+	if(clock)
+	{
+		Message(offset / 2, (uint8_t[]){0xFA}, 1, Event(EVENT_PARAMETER, AUDIO_PARAM_SEQUENCER, 1));
+		for(int i = 0; offset + TickTime(i * (double)division / MIDI_CLOCKS_PER_BEAT) <= lastTime; i++)
+		{
+			Send(offset + TickTime(i * (double)division / MIDI_CLOCKS_PER_BEAT), 0xF8, NULL);
+		}
+		Message(lastTime + byteTime * 4, (uint8_t[]){0xFC}, 1, Event(EVENT_PARAMETER, AUDIO_PARAM_SEQUENCER, 0));
+	}
+
+	for(int i = 0; i < tempoCount; i++)
+	{
+		tempoMap[i].time += offset;
+	}
+	free(events);
+	return count;
+}
+
+
+int main(int argc, char** argv)
+{
+	const char* path = NULL;
+	int baud = MIDI_BAUD;
+	bool clock = false;
+	int tempos[] = {FIRST_TEMPO, SECOND_TEMPO};
+	char name[64];
+	int count;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--baud") == 0 && i + 1 < argc)
+			baud = atoi(argv[++i]);
+		else if(strcmp(argv[i], "--channel") == 0 && i + 1 < argc)
+			listenChannel = atoi(argv[++i]);
+		else if(strcmp(argv[i], "--clock") == 0)
+			clock = true;
+		else
+			path = argv[i];
+	}
+	if(baud <= 0 || listenChannel < MIDI_OMNI || listenChannel > MIDI_CHANNELS)
+	{
+		printf("usage: midi_replay [--baud <rate>] [--channel <1 to 16>] [--clock] [song.mid]\n");
+		return 1;
+	}
+	byteTime = BITS_PER_BYTE * 1e6 / baud;
+
+	if(path != NULL)
+	{
+		count = FileStream(path, clock);
+		if(count < 0)
+		{
+			printf("Can't read %s\n", path);
+			return 1;
+		}
+		Midi_Start(listenChannel);
+		snprintf(name, sizeof(name), "%.40s at %d baud", path, baud);
+		Replay(name, clock ? FileTempo : NULL, NULL, 0);
+		Midi_Stop();
+	}
+	else
+	{
+		// All the channels, left with a reset
+		listenChannel = MIDI_OMNI;
+		BuiltInStream(true);
+		Midi_Start(MIDI_OMNI);
+		snprintf(name, sizeof(name), "All channels at %d baud", baud);
+		Replay(name, BuiltInTempo, tempos, 2);
+		if(handler != NULL || Midi_IsActive())
+			Fail("the console was not given back by the reset", 0);
+
+		// Channel 1, left with escape
+		listenChannel = 1;
+		BuiltInStream(false);
+		Midi_Start(1);
+		snprintf(name, sizeof(name), "Channel 1 at %d baud", baud);
+		Replay(name, BuiltInTempo, tempos, 2);
+		if(handler != NULL || Midi_IsActive())
+			Fail("the console was not given back by escape", 0);
+	}
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
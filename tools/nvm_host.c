@@ -0,0 +1,129 @@
+/*
+ * nvm_host.c - Flash of the board simulated in RAM for the host tests
+ *
+ * Implements include/Nvm.h the way the flash of the KL25Z behaves: an
+ * erase sets the 1 KB sector to 0xFF, and programming a 4 byte unit can
+ * only clear bits, so programming a unit which is not erased fails like
+ * the driver reports it. Addresses are checked against the size and the
+ * alignment. Erases are counted per sector for the wear checks, and the
+ * power can be cut in the middle of an operation (NvmHost_FailAfter).
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvm_host.h"
+
+uint32_t nvmHostErases[NVM_HOST_SECTORS];
+uint32_t nvmHostPrograms;
+
+static uint8_t memory[NVM_HOST_SIZE];
+static uint32_t failAfter = 0; // Operations left before the power is cut, 0 if never
+static jmp_buf* failTarget;
+
+
+/*
+ * Count an operation, returns 1 if the power is cut in the middle of it
+ */
+static int PowerCut()
+{
+	if(failAfter == 0)
+		return 0;
+	return (--failAfter == 0);
+}
+
+
+void NvmHost_Reset()
+{
+	memset(memory, NVM_ERASED, sizeof(memory));
+	memset(nvmHostErases, 0, sizeof(nvmHostErases));
+	nvmHostPrograms = 0;
+	failAfter = 0;
+}
+
+
+void NvmHost_FailAfter(uint32_t operations, jmp_buf* target)
+{
+	failAfter = operations;
+	failTarget = target;
+}
+
+
+uint8_t* NvmHost_Memory()
+{
+	return memory;
+}
+
+
+bool Nvm_Init()
+{
+	return true;
+}
+
+
+bool Nvm_Erase(uint32_t address)
+{
+	if(address % NVM_SECTOR_SIZE != 0 || address >= NVM_HOST_SIZE)
+	{
+		fprintf(stderr, "nvm: erase of a wrong address 0x%05X\n", (unsigned)address);
+		exit(2);
+	}
+
+	if(PowerCut())
+	{
+		// Half of the sector got erased
+		memset(&memory[address], NVM_ERASED, NVM_SECTOR_SIZE / 2);
+		longjmp(*failTarget, 1);
+	}
+
+	memset(&memory[address], NVM_ERASED, NVM_SECTOR_SIZE);
+	nvmHostErases[address / NVM_SECTOR_SIZE]++;
+	return true;
+}
+
+
+bool Nvm_Program(uint32_t address, const void* data, uint32_t length)
+{
+	const uint8_t* bytes = data;
+	uint32_t i;
+
+	if(address % NVM_PROGRAM_UNIT != 0 || length % NVM_PROGRAM_UNIT != 0 || address + length > NVM_HOST_SIZE)
+	{
+		fprintf(stderr, "nvm: program of a wrong range 0x%05X + %u\n", (unsigned)address, (unsigned)length);
+		exit(2);
+	}
+
+	for(; length > 0; length -= NVM_PROGRAM_UNIT)
+	{
+		for(i = 0; i < NVM_PROGRAM_UNIT; i++)
+		{
+			if(memory[address + i] != NVM_ERASED)
+				return false; // The flash refuses to program a unit twice
+		}
+
+		if(PowerCut())
+		{
+			// Some bits of the unit got cleared
+			for(i = 0; i < NVM_PROGRAM_UNIT / 2; i++)
+				memory[address + i] &= bytes[i];
+			longjmp(*failTarget, 1);
+		}
+
+		for(i = 0; i < NVM_PROGRAM_UNIT; i++)
+			memory[address + i] = bytes[i];
+		nvmHostPrograms++;
+
+		address += NVM_PROGRAM_UNIT;
+		bytes += NVM_PROGRAM_UNIT;
+	}
+	return true;
+}
+
+
+const void* Nvm_Read(uint32_t address)
+{
+	return &memory[address];
+}
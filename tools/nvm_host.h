@@ -0,0 +1,45 @@
+/*
+ * nvm_host.h - Flash of the board simulated in RAM for the host tests
+ *
+ *      Author: Surya Kanteti
+ */
+
+#ifndef __NVM_HOST_H__
+#define __NVM_HOST_H__
+
+#include <setjmp.h>
+#include <stdint.h>
+
+#include "Nvm.h"
+
+// Size of the simulated flash, from address 0 like the KL25Z
+#define NVM_HOST_SIZE (128 * 1024)
+#define NVM_HOST_SECTORS (NVM_HOST_SIZE / NVM_SECTOR_SIZE)
+
+// Erases of every sector and program units written since the last reset
+extern uint32_t nvmHostErases[NVM_HOST_SECTORS];
+extern uint32_t nvmHostPrograms;
+
+
+/*
+ * Erase the whole flash and clear the counters
+ */
+void NvmHost_Reset();
+
+
+/*
+ * Cut the power in the middle of an erase or a program
+ *
+ * The operation after the given number of operations (erases and program
+ * units) is left half done, and the test continues at target with
+ * longjmp(target, 1). 0 keeps the power on.
+ */
+void NvmHost_FailAfter(uint32_t operations, jmp_buf* target);
+
+
+/*
+ * Returns the contents of the simulated flash
+ */
+uint8_t* NvmHost_Memory();
+
+#endif /* __NVM_HOST_H__ */
@@ -0,0 +1,150 @@
+/*
+ * output_quality.c - SNR and THD of the output stage, measured on the host
+ *
+ * Build and run from the project folder:
+ *     gcc -O2 -Iinclude tools/output_quality.c source/OutputStage.c source/fp_trig.c -lm -o output_quality
+ *     ./output_quality
+ *
+ * A 440 Hz tone at 48 kHz is converted to 12-bit DAC values the old ways
+ * (fp_sin() + TRIG_SCALE_FACTOR as tone_to_samples() did, and truncating
+ * the Q15 mix with >> 4) and with every mode of the output stage. The
+ * spectrum of the DAC values gives the SNR over the whole band and below
+ * 4 kHz, and the THD from the 2nd to the 9th harmonic. The quiet tone
+ * stands for an echo tail.
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "OutputStage.h"
+#include "fp_trig.h"
+
+#define SAMPLING_RATE (48000)
+#define TONE_FREQUENCY (440)
+#define NUM_SAMPLES (4800) // A whole number of periods, so no window is needed
+#define TONE_BIN (TONE_FREQUENCY * NUM_SAMPLES / SAMPLING_RATE)
+#define LOW_BAND_BIN (4000 * NUM_SAMPLES / SAMPLING_RATE)
+#define MAX_HARMONIC (9)
+
+typedef struct spectrum_result_s
+{
+	double snr; // Signal to everything else, dB
+	double lowBandSnr; // Signal to everything else below 4 kHz, dB
+	double thd; // Harmonics to signal, dB
+} spectrum_result_t;
+
+static uint16_t codes[NUM_SAMPLES];
+static double power[NUM_SAMPLES / 2];
+
+
+/*
+ * Measure the spectrum of the DAC values in codes[]
+ *
+ * @input None
+ * @return SNR and THD of the tone
+ *
+ */
+static spectrum_result_t Measure()
+{
+	spectrum_result_t result;
+	double signal, harmonics = 0, noise = 0, lowNoise = 0;
+
+	for(int k = 0; k < NUM_SAMPLES / 2; k++)
+	{
+		double re = 0, im = 0;
+		for(int n = 0; n < NUM_SAMPLES; n++)
+		{
+			double angle = 2 * M_PI * (double)((long)k * n % NUM_SAMPLES) / NUM_SAMPLES;
+			re += (codes[n] - DAC_MIDPOINT) * cos(angle);
+			im -= (codes[n] - DAC_MIDPOINT) * sin(angle);
+		}
+		power[k] = re * re + im * im;
+	}
+
+	signal = power[TONE_BIN];
+	for(int k = 1; k < NUM_SAMPLES / 2; k++)
+	{
+		if(k == TONE_BIN)
+			continue;
+		if(k % TONE_BIN == 0 && k / TONE_BIN <= MAX_HARMONIC)
+			harmonics += power[k];
+		noise += power[k];
+		if(k < LOW_BAND_BIN)
+			lowNoise += power[k];
+	}
+
+	result.snr = 10 * log10(signal / noise);
+	result.lowBandSnr = 10 * log10(signal / lowNoise);
+	result.thd = 10 * log10(harmonics / signal);
+	return result;
+}
+
+
+/*
+ * Render the tone in Q15
+ *
+ * @input block			Pointer to the samples to be populated
+ * 		  amplitude		Peak amplitude in Q15
+ * @return None
+ *
+ */
+static void RenderTone(int16_t* block, double amplitude)
+{
+	for(int n = 0; n < NUM_SAMPLES; n++)
+	{
+		block[n] = (int16_t)lrint(amplitude * sin(2 * M_PI * TONE_FREQUENCY * n / SAMPLING_RATE));
+	}
+}
+
+
+static void PrintResult(const char* name, spectrum_result_t result)
+{
+	printf("  %-24s SNR %6.1f dB   SNR < 4 kHz %6.1f dB   THD %7.1f dB\n",
+			name, result.snr, result.lowBandSnr, result.thd);
+}
+
+
+int main()
+{
+	static int16_t block[NUM_SAMPLES];
+	const double levels[] = {0, -40};
+
+	for(int l = 0; l < sizeof(levels) / sizeof(levels[0]); l++)
+	{
+		double amplitude = 32000 * pow(10, levels[l] / 20);
+		printf("%d Hz tone at %.0f dBFS\n", TONE_FREQUENCY, levels[l]);
+
+		if(levels[l] == 0)
+		{
+			// tone_to_samples() wrote fp_sin() + TRIG_SCALE_FACTOR (0 to 4074)
+			for(int n = 0; n < NUM_SAMPLES; n++)
+			{
+				int x = (int)(((long long)TWO_PI * TONE_FREQUENCY * n / SAMPLING_RATE) % TWO_PI);
+				codes[n] = fp_sin(x) + TRIG_SCALE_FACTOR;
+			}
+			PrintResult("fp_sin (before)", Measure());
+		}
+
+		RenderTone(block, amplitude);
+
+		for(int n = 0; n < NUM_SAMPLES; n++)
+		{
+			codes[n] = (block[n] >> 4) + DAC_MIDPOINT;
+		}
+		PrintResult("truncate >> 4 (before)", Measure());
+
+		for(int mode = 0; mode < OUTPUT_MODES; mode++)
+		{
+			char name[32];
+			OutputStage_SetMode(mode);
+			OutputStage_Process(block, codes, NUM_SAMPLES);
+			snprintf(name, sizeof(name), "dither %s", OutputStage_ModeName(mode));
+			PrintResult(name, Measure());
+		}
+		printf("\n");
+	}
+	return 0;
+}
@@ -0,0 +1,366 @@
+/*
+ * patch_store_test.c - The patch store run on a flash simulated in RAM
+ *
+ * Build and run from the project folder:
+ *     gcc -O2 -Iinclude tools/patch_store_test.c tools/nvm_host.c source/PatchStore.c source/Crc16.c -o patch_store_test
+ *     ./patch_store_test
+ *
+ * source/PatchStore.c is built against tools/nvm_host.c in place of the
+ * flash driver. Checks that:
+ *   - blank and foreign flash is formatted, and blank sectors aren't
+ *     erased again when the log first moves into them,
+ *   - the patches are found again after a reset, the last save of a slot wins,
+ *   - saving the patch a slot holds already writes nothing,
+ *   - thousands of saves wear the sectors evenly,
+ *   - a reset in the middle of any erase or program leaves every slot with
+ *     its old or its new patch, also while the log moves to the next sector,
+ *   - a damaged record gives back the patch saved before it.
+ * Exits with 1 if a check fails.
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "PatchStore.h"
+#include "nvm_host.h"
+
+#define WEAR_SAVES (20000)
+#define MAX_WEAR_SPREAD (1) // Erases between the most and the least worn sector
+#define STORE_OFFSET(sector) (PATCH_STORE_ADDRESS + (sector) * NVM_SECTOR_SIZE)
+
+static int failures = 0;
+
+
+/*
+ * Report a failed check
+ */
+static void Fail(const char* test, const char* message, int value)
+{
+	if(failures < 20)
+		printf("  FAIL in %s: %s (%d)\n", test, message, value);
+	failures++;
+}
+
+
+/*
+ * Patch holding a value in all its fields
+ */
+static patch_t MakePatch(int value)
+{
+	patch_t patch;
+
+	patch.wave = value % 5;
+	patch.echo = value & 1;
+	patch.output = value % 3;
+	patch.fmEnvelope = value % 101;
+	patch.fmRatio = (uint16_t)(value * 7);
+	patch.fmIndex = (uint16_t)(value * 13);
+	patch.vibratoRate = value % 20;
+	patch.vibratoDepth = value % 100;
+	patch.tremoloRate = value % 20;
+	patch.tremoloDepth = value % 100;
+	patch.tempo = (uint16_t)(40 + value % 200);
+	return patch;
+}
+
+
+/*
+ * Check that a slot holds a patch, or none if value is negative
+ */
+static int Holds(uint8_t slot, int value)
+{
+	patch_t patch;
+	patch_t expected;
+
+	if(!PatchStore_Load(slot, &patch))
+		return value < 0;
+
+	expected = MakePatch(value);
+	return value >= 0 && memcmp(&patch, &expected, sizeof(patch)) == 0;
+}
+
+
+/*
+ * Blank flash, and flash holding something else, is formatted
+ */
+static void TestFormat()
+{
+	patch_store_stats_t stats;
+	patch_t patch;
+
+	NvmHost_Reset();
+	if(!PatchStore_Init())
+		Fail("format", "blank flash not formatted", 0);
+
+	PatchStore_GetStats(&stats);
+	if(stats.used != 0 || stats.records != 0 || stats.generation != 1)
+		Fail("format", "store not empty", stats.used);
+	if(PatchStore_Load(0, &patch))
+		Fail("format", "empty slot loaded", 0);
+
+	NvmHost_Reset();
+	memset(NvmHost_Memory() + STORE_OFFSET(2) + 100, 0x42, 300);
+	if(!PatchStore_Init())
+		Fail("format", "foreign flash not formatted", 0);
+	PatchStore_GetStats(&stats);
+	if(stats.erases != 1)
+		Fail("format", "erases of foreign flash", stats.erases);
+
+	// The program is never written
+	for(int sector = 0; sector < PATCH_STORE_ADDRESS / NVM_SECTOR_SIZE; sector++)
+	{
+		if(nvmHostErases[sector] != 0)
+			Fail("format", "sector outside the store erased", sector);
+	}
+
+	// Moving the log twice over blank flash empties two blank sectors
+	NvmHost_Reset();
+	PatchStore_Init();
+	PatchStore_GetStats(&stats);
+	for(int value = 0; value < (PATCH_STORE_SECTORS - 2) * stats.capacity + 1; value++)
+	{
+		patch = MakePatch(value);
+		PatchStore_Save(value % PATCH_SLOTS, &patch);
+	}
+	PatchStore_GetStats(&stats);
+	if(stats.generation != PATCH_STORE_SECTORS - 1 || stats.erases != 0)
+		Fail("format", "blank sector erased", stats.erases);
+}
+
+
+/*
+ * The patches are found after a reset
+ */
+static void TestPersist()
+{
+	patch_t patch;
+
+	NvmHost_Reset();
+	PatchStore_Init();
+
+	for(int value = 0; value < 3 * PATCH_SLOTS; value++)
+	{
+		patch = MakePatch(value);
+		if(!PatchStore_Save(value % PATCH_SLOTS, &patch))
+			Fail("persist", "save failed", value);
+	}
+
+	PatchStore_Init();
+	for(int slot = 0; slot < PATCH_SLOTS; slot++)
+	{
+		if(!Holds(slot, 2 * PATCH_SLOTS + slot))
+			Fail("persist", "slot lost its last patch", slot);
+	}
+
+	patch = MakePatch(1);
+	if(PatchStore_Save(PATCH_SLOTS, &patch))
+		Fail("persist", "slot out of range saved", PATCH_SLOTS);
+	if(PatchStore_Load(PATCH_SLOTS, &patch))
+		Fail("persist", "slot out of range loaded", PATCH_SLOTS);
+}
+
+
+/*
+ * Saving the same patch again writes nothing
+ */
+static void TestUnchanged()
+{
+	patch_t patch = MakePatch(7);
+	uint32_t programs;
+
+	NvmHost_Reset();
+	PatchStore_Init();
+	PatchStore_Save(3, &patch);
+
+	programs = nvmHostPrograms;
+	for(int i = 0; i < 100; i++)
+		PatchStore_Save(3, &patch);
+
+	if(nvmHostPrograms != programs)
+		Fail("unchanged", "identical saves programmed the flash", nvmHostPrograms - programs);
+}
+
+
+/*
+ * Many saves wear the sectors of the store evenly
+ */
+static void TestWear()
+{
+	patch_store_stats_t stats;
+	patch_t patch;
+	uint32_t least = 0xFFFFFFFF;
+	uint32_t most = 0;
+	uint32_t erases;
+
+	NvmHost_Reset();
+	PatchStore_Init();
+
+	for(int value = 0; value < WEAR_SAVES; value++)
+	{
+		patch = MakePatch(value);
+		if(!PatchStore_Save(value % 3, &patch))
+		{
+			Fail("wear", "save failed", value);
+			return;
+		}
+	}
+
+	for(int sector = 0; sector < PATCH_STORE_SECTORS; sector++)
+	{
+		erases = nvmHostErases[STORE_OFFSET(sector) / NVM_SECTOR_SIZE];
+		least = (erases < least) ? erases : least;
+		most = (erases > most) ? erases : most;
+	}
+
+	PatchStore_GetStats(&stats);
+	printf("  %d saves: %u to %u erases per sector, %u records per sector\n",
+			WEAR_SAVES, (unsigned)least, (unsigned)most, (unsigned)stats.capacity);
+
+	if(most - least > MAX_WEAR_SPREAD)
+		Fail("wear", "sectors worn unevenly", most - least);
+	// Every sector holds capacity records between two erases, less the copies
+	if(most > (uint32_t)WEAR_SAVES / (PATCH_STORE_SECTORS * (stats.capacity - PATCH_SLOTS)) + 1)
+		Fail("wear", "too many erases", most);
+
+	PatchStore_Init();
+	for(int slot = 0; slot < 3; slot++)
+	{
+		if(!Holds(slot, WEAR_SAVES - 1 - (WEAR_SAVES - 1 - slot) % 3))
+			Fail("wear", "slot lost its last patch", slot);
+	}
+}
+
+
+/*
+ * Value of the last patch saved into a slot, after saving values 0 to
+ * count - 1 into slot value % PATCH_SLOTS
+ */
+static int LastValue(int count, int slot)
+{
+	return count - 1 - (count - 1 - slot + PATCH_SLOTS) % PATCH_SLOTS;
+}
+
+
+/*
+ * A reset in the middle of any flash operation keeps the old or the new patch
+ */
+static void TestPowerLoss()
+{
+	static uint8_t before[PATCH_STORE_SECTORS * NVM_SECTOR_SIZE];
+	uint8_t* store = NvmHost_Memory() + PATCH_STORE_ADDRESS;
+	patch_store_stats_t stats;
+	volatile uint32_t cut;
+	volatile int done;
+	jmp_buf target;
+	patch_t patch;
+	uint8_t slot;
+	uint8_t other;
+	int cuts = 0;
+
+	NvmHost_Reset();
+	PatchStore_Init();
+	PatchStore_GetStats(&stats);
+
+	// Saves before the interrupted one, so the log moves to the next sector
+	// (and wraps around the store) at some of them
+	for(int saved = PATCH_SLOTS; saved < (PATCH_STORE_SECTORS + 1) * stats.capacity; saved++)
+	{
+		NvmHost_Reset();
+		PatchStore_Init();
+		for(int value = 0; value < saved; value++)
+		{
+			patch = MakePatch(value);
+			PatchStore_Save(value % PATCH_SLOTS, &patch);
+		}
+		memcpy(before, store, sizeof(before));
+
+		slot = saved % PATCH_SLOTS;
+		other = (slot + 1) % PATCH_SLOTS;
+		done = 0;
+		for(cut = 1; !done; cut++)
+		{
+			memcpy(store, before, sizeof(before));
+			PatchStore_Init();
+
+			if(setjmp(target) == 0)
+			{
+				NvmHost_FailAfter(cut, &target);
+				patch = MakePatch(saved);
+				PatchStore_Save(slot, &patch);
+				done = 1;
+			}
+			else
+				cuts++;
+			NvmHost_FailAfter(0, NULL);
+
+			if(!PatchStore_Init())
+				Fail("power loss", "store not usable after a reset", saved);
+
+			if(!Holds(slot, saved) && (done || !Holds(slot, LastValue(saved, slot))))
+				Fail("power loss", "slot lost its patch", saved);
+			for(int i = 0; i < PATCH_SLOTS; i++)
+			{
+				if(i != slot && !Holds(i, LastValue(saved, i)))
+					Fail("power loss", "other slot damaged", saved);
+			}
+
+			// The store keeps working after the reset
+			patch = MakePatch(saved + 1000);
+			PatchStore_Save(other, &patch);
+			PatchStore_Init();
+			if(!Holds(other, saved + 1000))
+				Fail("power loss", "save after a reset lost", saved);
+		}
+	}
+	printf("  %d resets in the middle of a flash operation\n", cuts);
+}
+
+
+/*
+ * A damaged record gives back the patch saved before it
+ */
+static void TestCorrupted()
+{
+	patch_store_stats_t stats;
+	patch_t patch;
+	uint8_t* record;
+
+	NvmHost_Reset();
+	PatchStore_Init();
+	patch = MakePatch(10);
+	PatchStore_Save(5, &patch);
+	patch = MakePatch(11);
+	PatchStore_Save(5, &patch);
+
+	// Flip a bit in the patch of the second record, records are 20 bytes
+	// after the 8 bytes of the sector header
+	PatchStore_GetStats(&stats);
+	record = NvmHost_Memory() + STORE_OFFSET(stats.sector) + 8 + (stats.records - 1) * 20;
+	record[6] ^= 0x01;
+
+	PatchStore_Init();
+	if(!Holds(5, 10))
+		Fail("corrupted", "previous patch not given back", 5);
+}
+
+
+int main()
+{
+	printf("Format\n");
+	TestFormat();
+	printf("Persist\n");
+	TestPersist();
+	printf("Unchanged\n");
+	TestUnchanged();
+	printf("Wear\n");
+	TestWear();
+	printf("Power loss\n");
+	TestPowerLoss();
+	printf("Corrupted\n");
+	TestCorrupted();
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
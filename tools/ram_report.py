@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+ram_report.py - RAM usage per module from a GNU ld map file
+
+Run after linking, e.g. from the Debug folder:
+    python3 ../tools/ram_report.py ARMonica.map
+
+Every input section placed in SRAM (.data, .bss, .audio_arena, ...) is
+attributed to the object file it came from. Library objects are grouped
+under their archive. The code and tables run from SRAM (RAM_FUNCTION and
+RAM_DATA of include/RamCode.h) are listed as well, with the functions they
+hold, as they take RAM and the same bytes again in the flash.
+
+Author: Surya Kanteti
+"""
+
+import os
+import re
+import sys
+from collections import defaultdict
+
+SRAM_START = 0x1FFFF000
+SRAM_SIZE = 0x4000
+
+# Input sections which are RAM contents, not just addresses in SRAM
+RAM_SECTIONS = ('.data', '.bss', '.audio_arena', '.noinit', '.ramfunc', '.ramdata', 'COMMON')
+
+# Input sections of the code and tables run from SRAM
+RAM_CODE_SECTIONS = ('.ramfunc', '.ramdata')
+
+SECTION_LINE = re.compile(r'^ (\S+)\s*$')
+PLACEMENT_LINE = re.compile(r'^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$')
+SYMBOL_LINE = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_]\w*)\s*$')
+
+
+def module_name(path):
+    """Short name of the object file (or archive) a section came from."""
+    path = path.strip().replace('\\', '/')
+    archive = re.match(r'.*/([^/]+\.a)\(', path)
+    if archive:
+        return archive.group(1)
+    return os.path.basename(path)
+
+
+def parse_map(lines):
+    """RAM usage per module, and the code in SRAM per module with its symbols"""
+    usage = defaultdict(int)
+    ram_code = defaultdict(int)
+    ram_symbols = defaultdict(list)
+    in_memory_map = False
+    pending = None
+    code_module = None
+
+    for line in lines:
+        if line.startswith('Linker script and memory map'):
+            in_memory_map = True
+            continue
+        if not in_memory_map:
+            continue
+
+        match = PLACEMENT_LINE.match(line)
+        if match:
+            section = match.group(1) or pending
+            pending = None
+            code_module = None
+            address = int(match.group(2), 16)
+            size = int(match.group(3), 16)
+            if section is None or size == 0:
+                continue
+            if not section.startswith(RAM_SECTIONS):
+                continue
+            if SRAM_START <= address < SRAM_START + SRAM_SIZE:
+                module = module_name(match.group(4))
+                usage[module] += size
+                if section.startswith(RAM_CODE_SECTIONS):
+                    ram_code[module] += size
+                    code_module = module
+            continue
+
+        # Global symbols of the section above
+        match = SYMBOL_LINE.match(line)
+        if match:
+            if code_module is not None:
+                ram_symbols[code_module].append(match.group(2))
+            continue
+        code_module = None
+
+        match = SECTION_LINE.match(line)
+        pending = match.group(1) if match else None
+
+    return usage, ram_code, ram_symbols
+
+
+def main():
+    if len(sys.argv) != 2:
+        print('usage: ram_report.py <map file>')
+        return 1
+
+    with open(sys.argv[1], errors='replace') as map_file:
+        usage, ram_code, ram_symbols = parse_map(map_file)
+
+    total = sum(usage.values())
+    print('RAM usage per module (bytes)')
+    for module, size in sorted(usage.items(), key=lambda item: -item[1]):
+        print('  %-28s %6d' % (module, size))
+    print('  %-28s %6d of %d' % ('total static', total, SRAM_SIZE))
+
+    print('Code and tables run from SRAM (bytes)')
+    for module, size in sorted(ram_code.items(), key=lambda item: -item[1]):
+        print('  %-28s %6d  %s' % (module, size, ' '.join(ram_symbols[module])))
+    print('  %-28s %6d, copied from the flash' % ('total', sum(ram_code.values())))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,122 @@
+/*
+ * render_bench.c - Render loop of the audio engine timed on the host
+ *
+ * Build and run from the project folder, against the host library of the
+ * Debug or the Release flags:
+ *     make -C tools bench
+ *
+ * Every wave of the synthesizer is rendered with all the voices sounding,
+ * the LFOs and the echo running and the shaped dither of the output stage,
+ * block by block as AudioOut.c renders them. Prints the nanoseconds per
+ * output sample, and how many times faster than real time at 48 kHz that
+ * is. The host numbers compare builds of the same sources, the cycles on
+ * the board are printed by "bench voice" and "bench ram".
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "Synth.h"
+#include "Lfo.h"
+#include "Echo.h"
+#include "OutputStage.h"
+#include "AudioOut.h"
+#include "AudioArena.h"
+
+#define SAMPLING_RATE (48000)
+#define BENCH_BLOCKS (20000) // About 53 s of audio per wave
+#define ECHO_SAMPLES ((ECHO_DELAY_MS * SAMPLING_RATE) / 1000)
+
+#ifndef BENCH_FLAGS
+#define BENCH_FLAGS "unknown flags"
+#endif
+
+static int16_t block[AUDIO_BLOCK_SIZE];
+static uint16_t out[AUDIO_BLOCK_SIZE];
+
+
+/*
+ * The audio subsystems only need the sampling rate from the audio engine
+ */
+uint32_t AudioOut_GetSampleRate()
+{
+	return SAMPLING_RATE;
+}
+
+
+/*
+ * Configure the subsystems for a wave like AudioOut.c does, the echo takes
+ * the memory left
+ */
+static void Configure(synth_wave_t wave)
+{
+	int echoSamples = ECHO_SAMPLES;
+
+	Synth_SetWaveform(wave);
+	Arena_Reset();
+	Arena_Alloc(ARENA_MIX, AUDIO_BLOCK_SIZE * sizeof(int16_t), sizeof(int16_t));
+	Synth_Init(SYNTH_MAX_VOICES);
+	Lfo_Init();
+	Lfo_Configure(LFO_VIBRATO, 5, 20);
+	Lfo_Configure(LFO_TREMOLO, 3, 30);
+
+	if(echoSamples > (int)Arena_Free())
+		echoSamples = Arena_Free();
+	Echo_Init(echoSamples);
+	OutputStage_SetMode(OUTPUT_SHAPED);
+}
+
+
+/*
+ * Nanoseconds per output sample of a wave
+ */
+static double RenderNanoseconds(synth_wave_t wave)
+{
+	struct timespec start, end;
+	uint32_t checksum = 0;
+
+	Configure(wave);
+	for(int i = 0; i < SYNTH_MAX_VOICES; i++)
+	{
+		Synth_NoteOn(60 + 4 * i, SYNTH_MAX_VELOCITY);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(int i = 0; i < BENCH_BLOCKS; i++)
+	{
+		Lfo_Update();
+		Synth_BeginBlock();
+		Synth_Render(block, 0, AUDIO_BLOCK_SIZE);
+		Echo_Process(block, AUDIO_BLOCK_SIZE);
+		OutputStage_Process(block, out, AUDIO_BLOCK_SIZE);
+		checksum += out[i % AUDIO_BLOCK_SIZE];
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	// Keeps the output alive for the optimizer
+	if(checksum == 0)
+		printf("  silent output\n");
+
+	Synth_Reset();
+	return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) /
+			((double)BENCH_BLOCKS * AUDIO_BLOCK_SIZE);
+}
+
+
+int main()
+{
+	double nanoseconds;
+
+	printf("Render loop built with %s, %d voices\n", BENCH_FLAGS, SYNTH_MAX_VOICES);
+	printf("  %-8s %12s %14s\n", "wave", "ns/sample", "x real time");
+	for(int wave = 0; wave < SYNTH_WAVES; wave++)
+	{
+		nanoseconds = RenderNanoseconds(wave);
+		printf("  %-8s %12.2f %14.0f\n", Synth_WaveName(wave), nanoseconds,
+				1e9 / (SAMPLING_RATE * nanoseconds));
+	}
+	return 0;
+}
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+size_report.py - Flash and RAM per module of the linked program
+
+Run after linking, e.g. from the Release folder:
+    python3 ../tools/size_report.py ARMonica.axf [--tools arm-none-eabi-]
+
+Every function and variable is attributed to the source file it was
+compiled from by the line information of the program (nm -l), so the
+report holds with link-time optimization, where the map file only names
+the partitions of the optimizer. Code and constants take flash, initialized
+variables take flash and RAM, and so do the code and tables run from SRAM.
+Symbols without line information (the C library, padding) are summed up
+as "other". Needs the program built with -g, which adds nothing to the flash.
+
+Author: Surya Kanteti
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+FLASH_START = 0x0
+FLASH_SIZE = 0x1B000 # PROGRAM_FLASH, the song and the patches are kept out
+SRAM_START = 0x1FFFF000
+SRAM_SIZE = 0x4000
+
+SECTION_LINE = re.compile(r'^\s*\d+\s+(\S+)\s+([0-9a-fA-F]+)\s+([0-9a-fA-F]+)\s+([0-9a-fA-F]+)')
+
+
+def in_flash(address):
+    return FLASH_START <= address < FLASH_START + FLASH_SIZE
+
+
+def in_sram(address):
+    return SRAM_START <= address < SRAM_START + SRAM_SIZE
+
+
+def read_sections(tools, program):
+    """Sections taking memory, as name: (address, load address, size, loaded)"""
+    output = subprocess.run([tools + 'objdump', '-h', program], capture_output=True,
+                            text=True, check=True).stdout.splitlines()
+    sections = {}
+    for i, line in enumerate(output):
+        match = SECTION_LINE.match(line)
+        if not match or i + 1 >= len(output) or 'ALLOC' not in output[i + 1]:
+            continue
+        sections[match.group(1)] = (int(match.group(3), 16), int(match.group(4), 16),
+                                    int(match.group(2), 16), 'LOAD' in output[i + 1])
+    return sections
+
+
+def read_symbols(tools, program):
+    """Symbols with a size, as (address, size, section, module)"""
+    output = subprocess.run([tools + 'nm', '-S', '-l', '--defined-only', '-f', 'sysv', program],
+                            capture_output=True, text=True, check=True).stdout.splitlines()
+    symbols = {}
+    for line in output:
+        fields = line.split('|')
+        if len(fields) != 7 or not fields[4].strip():
+            continue
+        section, _, location = fields[6].partition('\t')
+        module = 'other'
+        if location:
+            module = os.path.basename(location.replace('\\', '/').rsplit(':', 1)[0])
+        address = int(fields[1], 16) & ~1 # Thumb bit of the functions
+        # Aliases, like the default interrupt handlers, are counted once
+        symbols[address] = (address, int(fields[4], 16), section.strip(), module)
+    return list(symbols.values())
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('program', help='linked program (.axf)')
+    parser.add_argument('--tools', default='arm-none-eabi-', help='prefix of nm and objdump')
+    args = parser.parse_args()
+
+    sections = read_sections(args.tools, args.program)
+    flash = defaultdict(int)
+    ram = defaultdict(int)
+    for address, size, section, module in read_symbols(args.tools, args.program):
+        if section not in sections:
+            continue
+        _, load, _, loaded = sections[section]
+        if in_sram(address):
+            ram[module] += size
+        if loaded and in_flash(load):
+            flash[module] += size
+
+    # Bytes of the sections not covered by a symbol
+    flash_total = sum(size for _, load, size, loaded in sections.values() if loaded and in_flash(load))
+    ram_total = sum(size for address, _, size, _ in sections.values() if in_sram(address))
+    flash['other'] += flash_total - sum(flash.values())
+    ram['other'] += ram_total - sum(ram.values())
+
+    print('Flash and RAM per module (bytes)')
+    print('  %-28s %7s %7s' % ('module', 'flash', 'RAM'))
+    for module in sorted(set(flash) | set(ram), key=lambda name: (name == 'other', -flash[name], -ram[name])):
+        print('  %-28s %7d %7d' % (module, flash[module], ram[module]))
+    print('  %-28s %7d %7d of %d and %d' % ('total', flash_total, ram_total, FLASH_SIZE, SRAM_SIZE))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,501 @@
+/*
+ * song_test.c - Upload and playback of the song on a flash simulated in RAM
+ *
+ * Build and run from the project folder:
+ *     gcc -O2 -Iinclude tools/song_test.c tools/nvm_host.c source/Song.c source/Crc16.c -lm -o song_test
+ *     ./song_test [song.bin]
+ *
+ * source/Song.c is built against tools/nvm_host.c in place of the flash
+ * driver, and played block by block as the render of source/AudioOut.c
+ * does. A built-in song with notes, drums and tempo changes is uploaded
+ * sector by sector and checks that:
+ *   - the upload refuses bytes out of order and a header with a wrong CRC,
+ *   - the song is found again after a reset,
+ *   - every event is played at the sample of its tick within one sample,
+ *     following the tempo changes,
+ *   - playing from any bar gives the same events as from the start,
+ *   - a stop and the erase of a sector end the sounding notes,
+ *   - a damaged song is not played.
+ * A song image written by tools/song_upload.py --output is uploaded and
+ * played to the end instead, checking the order of the events and that
+ * no note is left sounding. Exits with 1 if a check fails.
+ *
+ *      Author: Surya Kanteti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "Song.h"
+#include "AudioOut.h"
+#include "Crc16.h"
+#include "Drums.h"
+#include "nvm_host.h"
+
+#define SAMPLING_RATE (48000)
+#define TICKS_PER_BEAT (96)
+#define BEATS_PER_BAR (4)
+#define TICKS_PER_BAR (TICKS_PER_BEAT * BEATS_PER_BAR)
+#define TEST_BARS (24)
+#define MAX_EVENTS (4096)
+#define MAX_IMAGE (SONG_FLASH_SIZE)
+#define MAX_TIME_ERROR (1.0) // Samples
+
+// An event of the built-in song, and the time it has to be played at
+typedef struct expected_event_s
+{
+	uint32_t tick;
+	uint8_t type;
+	uint8_t key;
+	uint16_t value;
+	double time; // Samples from the start of the song
+} expected_event_t;
+
+static uint8_t image[MAX_IMAGE];
+static uint32_t imageLength;
+
+static expected_event_t expected[MAX_EVENTS];
+static int expectedCount;
+
+static note_event_t played[MAX_EVENTS];
+static int playedCount;
+
+static uint32_t sampleTime = 0;
+static int failures = 0;
+
+
+uint32_t AudioOut_GetSampleRate()
+{
+	return SAMPLING_RATE;
+}
+
+
+uint32_t AudioOut_GetSampleTime()
+{
+	return sampleTime;
+}
+
+
+/*
+ * Report a failed check
+ */
+static void Fail(const char* test, const char* message, int value)
+{
+	if(failures < 20)
+		printf("  FAIL in %s: %s (%d)\n", test, message, value);
+	failures++;
+}
+
+
+/*
+ * Append a variable length quantity
+ */
+static void PutDelta(uint8_t** out, uint32_t ticks)
+{
+	uint8_t bytes[4];
+	int count = 0;
+
+	do
+	{
+		bytes[count++] = ticks & 0x7F;
+		ticks >>= 7;
+	} while(ticks > 0);
+
+	while(count > 0)
+	{
+		count--;
+		*(*out)++ = bytes[count] | (count > 0 ? 0x80 : 0);
+	}
+}
+
+
+/*
+ * Add an event to the built-in song
+ */
+static void Expect(uint32_t tick, uint8_t type, uint8_t key, uint16_t value)
+{
+	expected[expectedCount].tick = tick;
+	expected[expectedCount].type = type;
+	expected[expectedCount].key = key;
+	expected[expectedCount].value = value;
+	expectedCount++;
+}
+
+
+/*
+ * Build the image of the built-in song
+ *
+ * A note on every beat held for half of it, a drum on every bar, and a
+ * tempo change every 8 bars. The events are stored in order of their
+ * ticks, with the time of every one computed from the tempo map.
+ */
+static void BuildSong()
+{
+	song_header_t header;
+	song_bar_t* index = (song_bar_t*)&image[SONG_HEADER_SIZE];
+	uint8_t* out = &image[SONG_HEADER_SIZE + TEST_BARS * sizeof(song_bar_t)];
+	static const uint16_t tempos[] = {120, 97, 173};
+	uint16_t tempo = tempos[0];
+	uint32_t tick = 0;
+	double time = 0;
+	int i = 0;
+
+	expectedCount = 0;
+	for(int bar = 0; bar < TEST_BARS; bar++)
+	{
+		if(bar % 8 == 0 && bar > 0)
+			Expect(bar * TICKS_PER_BAR, EVENT_TEMPO, 0, tempos[bar / 8]);
+		Expect(bar * TICKS_PER_BAR, EVENT_DRUM, bar % DRUMS, 100);
+		for(int beat = 0; beat < BEATS_PER_BAR; beat++)
+		{
+			uint32_t start = bar * TICKS_PER_BAR + beat * TICKS_PER_BEAT;
+			Expect(start, EVENT_NOTE_ON, 48 + (bar + beat) % 24, 60 + beat * 10);
+			Expect(start + TICKS_PER_BEAT / 2, EVENT_NOTE_OFF, 48 + (bar + beat) % 24, 0);
+		}
+	}
+
+	for(int bar = 0; bar <= TEST_BARS; bar++)
+	{
+		// Bar line, the index points after it
+		PutDelta(&out, bar * TICKS_PER_BAR - tick);
+		time += (bar * TICKS_PER_BAR - tick) * (SAMPLING_RATE * 60.0 / (tempo * TICKS_PER_BEAT));
+		tick = bar * TICKS_PER_BAR;
+		if(bar == TEST_BARS)
+		{
+			*out++ = SONG_END;
+			break;
+		}
+		*out++ = SONG_BAR;
+		index[bar].offset = out - image;
+		index[bar].tempo = tempo;
+
+		for(; i < expectedCount && expected[i].tick < (uint32_t)(bar + 1) * TICKS_PER_BAR; i++)
+		{
+			PutDelta(&out, expected[i].tick - tick);
+			time += (expected[i].tick - tick) * (SAMPLING_RATE * 60.0 / (tempo * TICKS_PER_BEAT));
+			tick = expected[i].tick;
+			expected[i].time = time;
+
+			switch(expected[i].type)
+			{
+			case EVENT_TEMPO:
+				*out++ = SONG_TEMPO;
+				*out++ = expected[i].value & 0xFF;
+				*out++ = expected[i].value >> 8;
+				tempo = expected[i].value;
+				break;
+			case EVENT_DRUM:
+				*out++ = SONG_DRUM | expected[i].key;
+				*out++ = expected[i].value;
+				break;
+			default:
+				*out++ = expected[i].key;
+				*out++ = expected[i].value;
+				break;
+			}
+		}
+	}
+
+	while((out - image) % 4 != 0)
+		*out++ = NVM_ERASED;
+	imageLength = out - image;
+
+	memset(&header, 0, sizeof(header));
+	header.magic = SONG_MAGIC;
+	header.version = SONG_VERSION;
+	header.beatsPerBar = BEATS_PER_BAR;
+	header.ticksPerBeat = TICKS_PER_BEAT;
+	header.tempo = tempos[0];
+	header.bars = TEST_BARS;
+	header.length = imageLength - SONG_HEADER_SIZE;
+	header.crc = Crc16_Update(CRC16_INIT, &image[SONG_HEADER_SIZE], header.length);
+	strcpy(header.name, "test");
+	memcpy(image, &header, sizeof(header));
+}
+
+
+/*
+ * Upload the image the way tools/song_upload.py does
+ */
+static bool Upload()
+{
+	uint32_t offset = SONG_HEADER_SIZE;
+	uint32_t end, count;
+
+	for(uint8_t sector = 0; sector * NVM_SECTOR_SIZE < imageLength; sector++)
+	{
+		if(!Song_Erase(sector))
+			return false;
+
+		end = (sector + 1) * NVM_SECTOR_SIZE;
+		end = (end < imageLength) ? end : imageLength;
+		for(; offset < end; offset += count)
+		{
+			count = (end - offset < 28) ? end - offset : 28;
+			if(!Song_Write(offset, &image[offset], count))
+				return false;
+		}
+	}
+	return Song_Commit((const song_header_t*)image);
+}
+
+
+/*
+ * Play the song block by block until it ends
+ *
+ * @return Number of blocks rendered
+ */
+static int Play(int maxBlocks)
+{
+	note_event_t events[1];
+	uint32_t stepTime;
+	int blocks = 0;
+	int count;
+
+	playedCount = 0;
+	while(Song_IsRunning() && blocks < maxBlocks)
+	{
+		while(Song_NextStep(&stepTime) && (int32_t)(stepTime - sampleTime) < AUDIO_BLOCK_SIZE)
+		{
+			count = Song_Step(events);
+			if(count > 0 && playedCount < MAX_EVENTS)
+				played[playedCount++] = events[0];
+		}
+		sampleTime += AUDIO_BLOCK_SIZE;
+		blocks++;
+	}
+	return blocks;
+}
+
+
+/*
+ * Check the played events against the built-in song from an event on
+ */
+static void CheckPlayed(const char* test, int first, uint32_t start)
+{
+	double error;
+
+	if(playedCount != expectedCount - first)
+	{
+		Fail(test, "number of events", playedCount);
+		return;
+	}
+
+	for(int i = 0; i < playedCount; i++)
+	{
+		const expected_event_t* event = &expected[first + i];
+
+		if(played[i].type != event->type || played[i].key != event->key || played[i].value != event->value)
+		{
+			Fail(test, "wrong event", i);
+			return;
+		}
+
+		// Relative to the first event played, a tempo map starting at its bar
+		error = (double)(played[i].timestamp - start) - (event->time - expected[first].time);
+		if(fabs(error) > MAX_TIME_ERROR)
+		{
+			Fail(test, "event off its tick by samples", (int)error);
+			return;
+		}
+	}
+}
+
+
+/*
+ * Upload the built-in song and play it from the start and from every bar
+ */
+static void TestBuiltIn()
+{
+	song_info_t info;
+	uint32_t start;
+	int first;
+
+	NvmHost_Reset();
+	Song_Init();
+	BuildSong();
+	printf("  %d events in %u bytes, %u bytes per event\n", expectedCount, (unsigned)imageLength,
+			(unsigned)(imageLength - SONG_HEADER_SIZE - TEST_BARS * sizeof(song_bar_t)) / expectedCount);
+
+	// Out of order bytes and a wrong CRC are refused
+	Song_Erase(0);
+	if(Song_Write(SONG_HEADER_SIZE + 4, &image[SONG_HEADER_SIZE + 4], 4))
+		Fail("upload", "bytes out of order written", 0);
+	if(Song_Write(SONG_HEADER_SIZE, &image[SONG_HEADER_SIZE], 3))
+		Fail("upload", "partial word written", 0);
+	if(Song_Commit((const song_header_t*)image))
+		Fail("upload", "incomplete song committed", 0);
+
+	if(!Upload())
+		Fail("upload", "upload failed", 0);
+
+	Song_Init();
+	Song_GetInfo(&info);
+	if(!info.valid || info.header->bars != TEST_BARS || info.written != 0)
+		Fail("upload", "song not found after a reset", 0);
+
+	// From the start
+	sampleTime = 1000;
+	if(!Song_Start(0))
+		Fail("play", "song not started", 0);
+	Play(100000);
+	CheckPlayed("play", 0, 1000);
+
+	// From every bar
+	for(int bar = 1; bar < TEST_BARS; bar++)
+	{
+		start = sampleTime;
+		if(!Song_Start(bar))
+		{
+			Fail("bar", "song not started at bar", bar);
+			continue;
+		}
+		Play(100000);
+
+		for(first = 0; expected[first].tick < (uint32_t)bar * TICKS_PER_BAR; first++)
+			;
+		CheckPlayed("bar", first, start);
+		if(playedCount > 0 && played[0].timestamp != start)
+			Fail("bar", "bar not started at once", bar);
+	}
+
+	if(Song_Start(TEST_BARS))
+		Fail("bar", "started after the last bar", TEST_BARS);
+}
+
+
+/*
+ * A stop, and the erase of the song, end the sounding notes
+ */
+static void TestStop()
+{
+	note_event_t events[1];
+	uint32_t stepTime;
+	int on = 0, off = 0;
+
+	for(int pass = 0; pass < 2; pass++)
+	{
+		Song_Start(0);
+
+		// Up to a note on
+		while(on == off)
+		{
+			Song_NextStep(&stepTime);
+			sampleTime = stepTime;
+			if(Song_Step(events) == 1)
+			{
+				on += (events[0].type == EVENT_NOTE_ON);
+				off += (events[0].type == EVENT_NOTE_OFF);
+			}
+		}
+
+		if(pass == 0)
+			Song_Stop();
+		else
+			Song_Erase(3);
+
+		while(Song_IsRunning())
+		{
+			Song_NextStep(&stepTime);
+			if(stepTime != sampleTime)
+				Fail("stop", "note not ended at once", pass);
+			if(Song_Step(events) == 1)
+				off += (events[0].type == EVENT_NOTE_OFF);
+		}
+		if(on != off)
+			Fail("stop", "notes left sounding", on - off);
+	}
+
+	if(Song_Start(0))
+		Fail("stop", "erased song started", 0);
+}
+
+
+/*
+ * A damaged song is not played
+ */
+static void TestDamaged()
+{
+	BuildSong();
+	NvmHost_Reset();
+	Upload();
+
+	NvmHost_Memory()[SONG_FLASH_ADDRESS + imageLength - 8] ^= 0x10;
+	if(Song_Init())
+		Fail("damaged", "damaged song found", 0);
+	if(Song_Start(0))
+		Fail("damaged", "damaged song started", 0);
+}
+
+
+/*
+ * Upload a song image of tools/song_upload.py and play it to the end
+ */
+static void TestImage(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	uint8_t sounding[128] = {0};
+	song_info_t info;
+	int blocks, left = 0;
+
+	if(file == NULL)
+	{
+		Fail("image", "can't open the file", 0);
+		return;
+	}
+	imageLength = fread(image, 1, sizeof(image), file);
+	fclose(file);
+
+	NvmHost_Reset();
+	if(!Upload() || !Song_Init())
+	{
+		Fail("image", "upload failed", 0);
+		return;
+	}
+
+	Song_GetInfo(&info);
+	sampleTime = 0;
+	Song_Start(0);
+	blocks = Play(INT32_MAX);
+
+	for(int i = 0; i < playedCount; i++)
+	{
+		if(i > 0 && played[i].timestamp < played[i - 1].timestamp)
+			Fail("image", "events out of order", i);
+		if(played[i].type == EVENT_NOTE_ON)
+			sounding[played[i].key]++;
+		else if(played[i].type == EVENT_NOTE_OFF && sounding[played[i].key] > 0)
+			sounding[played[i].key]--;
+	}
+	for(int i = 0; i < 128; i++)
+		left += sounding[i];
+
+	printf("  \"%.*s\": %u bars, %d events in %.1f s\n", SONG_NAME_LENGTH, info.header->name,
+			info.header->bars, playedCount, blocks * AUDIO_BLOCK_SIZE / (double)SAMPLING_RATE);
+	if(left != 0)
+		Fail("image", "notes left sounding", left);
+}
+
+
+int main(int argc, char** argv)
+{
+	if(argc > 1)
+	{
+		printf("Image\n");
+		TestImage(argv[1]);
+	}
+	else
+	{
+		printf("Built-in song\n");
+		TestBuiltIn();
+		printf("Stop\n");
+		TestStop();
+		printf("Damaged\n");
+		TestDamaged();
+	}
+
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+"""
+song_upload.py - Convert a MIDI file into a song and write it into the flash of ARMonica
+
+Run from the project folder with the board on the console:
+    python3 tools/song_upload.py song.mid /dev/ttyACM0 [--baud 38400] [--name <name>] [--play <bar>]
+or only convert the file into a song image:
+    python3 tools/song_upload.py song.mid --output song.bin
+
+A Standard MIDI File (format 0 or 1, ticks per beat) is converted into the
+song format of include/Song.h: the tracks are merged, the notes of every
+channel play the voices, channel 10 plays the drums (General MIDI kicks,
+snares and hi-hats, like the midi command), and the tempo changes are kept.
+The bars follow the first time signature (4/4 without one). Every event is
+a delta time in ticks and two or three bytes, a bar line starts every bar
+and the bar index gives the offset and the tempo of every bar, so the
+board can start playing at any bar.
+
+The image is written over the binary host link: every sector is erased
+before its bytes are written, and the header is written last, once the
+board has checked the CRC of the rest. The board keeps playing while the
+bytes are written, an erase stops the audio for a moment.
+
+Requires pyserial for the upload.
+
+Author: Surya Kanteti
+"""
+
+import argparse
+import binascii
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+SONG_MAGIC = 0x474E4F53
+SONG_VERSION = 1
+SONG_HEADER_SIZE = 32
+SONG_FLASH_SIZE = 16 * 1024
+SONG_NAME_LENGTH = 12
+SONG_DRUM = 0x80
+SONG_TEMPO = 0xF1
+SONG_BAR = 0xFE
+SONG_END = 0xFF
+SONG_MIN_TEMPO = 20
+SONG_MAX_TEMPO = 400
+DEFAULT_TEMPO = 120
+
+DRUM_CHANNEL = 9
+# General MIDI percussion notes and the drums of include/Drums.h
+DRUMS = {35: 0, 36: 0, 37: 1, 38: 1, 39: 1, 40: 1, 42: 2, 44: 2, 46: 2}
+
+# Order of the events at the same tick
+ORDER_TEMPO, ORDER_OFF, ORDER_ON = range(3)
+
+
+def crc16(data):
+    """CRC-16/CCITT starting from 0xFFFF"""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def read_vlq(data, pos):
+    value = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value = (value << 7) | (byte & 0x7F)
+        if not byte & 0x80:
+            return value, pos
+
+
+def vlq(value):
+    """Variable length quantity, most significant 7 bits first"""
+    out = [value & 0x7F]
+    value >>= 7
+    while value:
+        out.insert(0, 0x80 | (value & 0x7F))
+        value >>= 7
+    return bytes(out)
+
+
+def read_midi(path):
+    """Ticks per beat, beats per bar and the events as (tick, order, kind, key, value)"""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'MThd':
+        raise ValueError('not a MIDI file')
+    length, fmt, tracks, division = struct.unpack('>IHHH', data[4:14])
+    if fmt > 1:
+        raise ValueError('format %d files are not supported' % fmt)
+    if division & 0x8000:
+        raise ValueError('SMPTE timing is not supported')
+
+    events = []
+    signature = None
+    pos = 8 + length
+    for _ in range(tracks):
+        if data[pos:pos + 4] != b'MTrk':
+            raise ValueError('track missing')
+        end = pos + 8 + struct.unpack('>I', data[pos + 4:pos + 8])[0]
+        pos += 8
+        tick = 0
+        status = 0
+        while pos < end:
+            delta, pos = read_vlq(data, pos)
+            tick += delta
+            if data[pos] & 0x80:
+                status = data[pos]
+                pos += 1
+            if status == 0xFF:
+                kind = data[pos]
+                size, pos = read_vlq(data, pos + 1)
+                body = data[pos:pos + size]
+                pos += size
+                if kind == 0x51:
+                    bpm = round(60e6 / int.from_bytes(body, 'big'))
+                    bpm = max(SONG_MIN_TEMPO, min(SONG_MAX_TEMPO, bpm))
+                    events.append((tick, ORDER_TEMPO, 'tempo', 0, bpm))
+                elif kind == 0x58 and signature is None:
+                    signature = (body[0], body[1])
+                status = 0
+            elif status in (0xF0, 0xF7):
+                size, pos = read_vlq(data, pos)
+                pos += size
+                status = 0
+            else:
+                kind = status & 0xF0
+                channel = status & 0x0F
+                size = 1 if kind in (0xC0, 0xD0) else 2
+                first = data[pos]
+                second = data[pos + 1] if size == 2 else 0
+                pos += size
+                if kind == 0x90 and second > 0:
+                    if channel == DRUM_CHANNEL:
+                        if first in DRUMS:
+                            events.append((tick, ORDER_ON, 'drum', DRUMS[first], second))
+                    else:
+                        events.append((tick, ORDER_ON, 'note', first, second))
+                elif kind in (0x80, 0x90) and channel != DRUM_CHANNEL:
+                    events.append((tick, ORDER_OFF, 'note', first, 0))
+        pos = end
+
+    numerator, power = signature or (4, 2)
+    ticks_per_bar = division * numerator * 4 // (1 << power)
+    events.sort(key=lambda event: (event[0], event[1]))
+    return division, numerator, ticks_per_bar, events
+
+
+def build_song(path, name):
+    """Image of the song: header, bar index and events, padded to whole words"""
+    division, beats_per_bar, ticks_per_bar, events = read_midi(path)
+    if not events:
+        raise ValueError('no notes in the file')
+
+    tempo = DEFAULT_TEMPO
+    while events and events[0][0] == 0 and events[0][2] == 'tempo':
+        tempo = events.pop(0)[4]
+    start_tempo = tempo
+
+    last_tick = events[-1][0] if events else 0
+    bars = last_tick // ticks_per_bar + 1
+    index_size = 4 * bars
+
+    stream = bytearray()
+    index = []
+    tick = 0
+    bar = 0
+    for event in events + [(bars * ticks_per_bar, ORDER_TEMPO, 'end', 0, 0)]:
+        # Bar lines up to the event, the deltas after a bar line count from it
+        while bar < bars and bar * ticks_per_bar <= event[0]:
+            stream += vlq(bar * ticks_per_bar - tick) + bytes((SONG_BAR,))
+            tick = bar * ticks_per_bar
+            index.append((SONG_HEADER_SIZE + index_size + len(stream), tempo))
+            bar += 1
+        time, _, kind, key, value = event
+        stream += vlq(time - tick)
+        tick = time
+        if kind == 'note':
+            stream += bytes((key, value))
+        elif kind == 'drum':
+            stream += bytes((SONG_DRUM | key, value))
+        elif kind == 'tempo':
+            stream += bytes((SONG_TEMPO,)) + struct.pack('<H', value)
+            tempo = value
+        else:
+            stream += bytes((SONG_END,))
+
+    body = b''.join(struct.pack('<HH', offset, bar_tempo) for offset, bar_tempo in index) + stream
+    body += b'\xFF' * (-len(body) % 4)
+    if SONG_HEADER_SIZE + len(body) > SONG_FLASH_SIZE:
+        raise ValueError('the song takes %d bytes, %d fit in the flash' %
+                         (SONG_HEADER_SIZE + len(body), SONG_FLASH_SIZE))
+    if max(offset for offset, _ in index) > 0xFFFF:
+        raise ValueError('bar offsets do not fit')
+
+    header = struct.pack('<IBBHHHIHH12s', SONG_MAGIC, SONG_VERSION, beats_per_bar, division,
+                         start_tempo, bars, len(body), crc16(body), 0xFFFF,
+                         name.encode('ascii', 'replace')[:SONG_NAME_LENGTH])
+    return header + body, bars
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('midi', help='Standard MIDI File')
+    parser.add_argument('port', nargs='?', help='serial port of the board')
+    parser.add_argument('--baud', type=int, default=38400)
+    parser.add_argument('--name', help='name of the song, the file name by default')
+    parser.add_argument('--output', help='write the song image into a file')
+    parser.add_argument('--play', type=int, metavar='BAR', help='play the song from a bar after the upload')
+    args = parser.parse_args()
+
+    name = args.name or os.path.splitext(os.path.basename(args.midi))[0]
+    image, bars = build_song(args.midi, name)
+    print('%s: %d bars, %d bytes of %d' % (name, bars, len(image), SONG_FLASH_SIZE))
+
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(image)
+    if not args.port:
+        return
+
+    from armonica_link import Link
+
+    def progress(done, total):
+        print('  %d of %d bytes written' % (done, total))
+
+    with Link(args.port, args.baud) as link:
+        link.upload_song(image, progress)
+        print('Song written')
+        if args.play:
+            link.play_song(args.play - 1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+stack_report.py - Stack frames per function from the -fstack-usage files
+
+Run after linking, e.g. from the Release folder:
+    python3 ../tools/stack_report.py . [--top 25]
+
+Every .su file below the folder is read, one line per function with the
+bytes of its frame and whether the frame is static, dynamic or bounded.
+With link-time optimization the objects are compiled again at the link,
+and the .su files of that step (named *.ltrans*.su) are used when found,
+as they hold the functions as they were linked. Otherwise the frames are
+those of every file compiled on its own, which the link may inline into
+bigger ones.
+
+The largest frames are listed, then the interrupt handlers, whose frames
+and the 32 bytes the core stacks on entry come on top of the deepest
+frames of the main loop, and the frames the compiler could not bound.
+The call depth is not followed.
+
+Author: Surya Kanteti
+"""
+
+import argparse
+import os
+import sys
+
+# Registers stacked by the Cortex-M0+ on exception entry
+EXCEPTION_FRAME = 32
+
+
+def read_usage(folder):
+    """Frames as (function, module, bytes, qualifiers), one per function"""
+    files = []
+    for root, _, names in os.walk(folder):
+        files += [os.path.join(root, name) for name in names if name.endswith('.su')]
+    linked = [path for path in files if '.ltrans' in os.path.basename(path)]
+    if linked:
+        files = linked
+
+    frames = {}
+    for path in files:
+        with open(path, errors='replace') as su_file:
+            for line in su_file:
+                fields = line.rstrip('\n').split('\t')
+                if len(fields) != 3:
+                    continue
+                location = fields[0].rsplit(':', 3)
+                if len(location) != 4:
+                    continue
+                source, function = location[0], location[3]
+                module = os.path.basename(source.replace('\\', '/'))
+                size = int(fields[1])
+                # Inline functions of headers are listed by every file using them
+                key = (module, location[1], function)
+                if key not in frames or frames[key][2] < size:
+                    frames[key] = (function, module, size, fields[2])
+    return list(frames.values()), linked != []
+
+
+def print_frames(title, frames):
+    print(title)
+    for function, module, size, qualifiers in frames:
+        print('  %-32s %-24s %6d  %s' % (function, module, size, qualifiers))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('folder', help='build folder holding the .su files')
+    parser.add_argument('--top', type=int, default=25, help='number of the largest frames listed')
+    args = parser.parse_args()
+
+    frames, linked = read_usage(args.folder)
+    if not frames:
+        print('No stack usage files, build with -fstack-usage')
+        return 1
+
+    frames.sort(key=lambda frame: -frame[2])
+    print('Stack frames of %d functions (bytes), %s' % (len(frames),
+          'as linked' if linked else 'per compiled file'))
+    print_frames('Largest frames', frames[:args.top])
+
+    # The default handlers of the startup code only stop the core
+    handlers = [frame for frame in frames if frame[0].endswith(('_IRQHandler', '_Handler')) and
+                not frame[1].startswith('startup_')]
+    if handlers:
+        print_frames('Interrupt handlers, %d bytes stacked on entry' % EXCEPTION_FRAME, handlers)
+
+    unbounded = [frame for frame in frames if frame[3] != 'static']
+    if unbounded:
+        print_frames('Frames which are not static', unbounded)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
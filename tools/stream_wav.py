@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+stream_wav.py - Stream a WAV file to ARMonica over the UART
+
+Run from the project folder, e.g.:
+    python3 tools/stream_wav.py /dev/ttyACM0 samples/kick.wav --rate 3000 --bits 8
+
+The file is mixed down to mono, resampled linearly to the stream rate and
+quantized to unsigned 8-bit samples, or 12-bit samples packed two in three
+bytes (low byte first). The "stream" command is sent first, then the
+samples are written in small chunks. The device pauses the sender with
+XOFF (0x13) and resumes it with XON (0x11). The buffer statistics are
+printed at the end.
+
+At 38400 baud with two stop bits about 3490 bytes per second get through,
+so 8-bit streams up to about 3400 Hz and 12-bit streams up to about
+2300 Hz can be sustained.
+
+Requires pyserial.
+
+Author: Surya Kanteti
+"""
+
+import argparse
+import os
+import sys
+import time
+
+import serial
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from wav2adpcm import read_wav, resample  # noqa: E402
+
+XON = 0x11
+XOFF = 0x13
+CHUNK = 16
+
+
+def quantize(samples, bits):
+    if bits == 8:
+        return bytes(max(0, min(255, (s >> 8) + 128)) for s in samples)
+
+    values = [max(0, min(4095, (s >> 4) + 2048)) for s in samples]
+    if len(values) & 1:
+        values.append(2048)
+    packed = bytearray()
+    for first, second in zip(values[0::2], values[1::2]):
+        packed += bytes((first & 0xFF, (first >> 8) | ((second & 0x0F) << 4), second >> 4))
+    return bytes(packed)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('port', help='serial port of the board')
+    parser.add_argument('wav')
+    parser.add_argument('--rate', type=int, default=3000, help='stream rate in Hz (1000 to 16000)')
+    parser.add_argument('--bits', type=int, choices=(8, 12), default=8)
+    parser.add_argument('--baud', type=int, default=38400)
+    args = parser.parse_args()
+
+    samples, rate = read_wav(args.wav)
+    data = quantize(resample(samples, rate, args.rate), args.bits)
+
+    with serial.Serial(args.port, args.baud, stopbits=serial.STOPBITS_TWO, timeout=0) as port:
+        port.write(b'stream %d %d\r' % (args.rate, args.bits))
+        time.sleep(0.2)
+        sys.stdout.write(port.read(port.in_waiting or 1).decode('ascii', 'replace'))
+
+        paused = False
+        sent = 0
+        start = time.time()
+        while sent < len(data):
+            for byte in port.read(port.in_waiting or 1):
+                if byte == XOFF:
+                    paused = True
+                elif byte == XON:
+                    paused = False
+            if paused:
+                time.sleep(0.001)
+                continue
+            sent += port.write(data[sent:sent + CHUNK])
+            port.flush()
+
+        elapsed = time.time() - start
+        print('Sent %d bytes in %.1f s (%.0f bytes per second)' % (sent, elapsed, sent / max(elapsed, 0.001)))
+
+        # Wait for the stream to time out, then read the statistics
+        time.sleep(2.0)
+        port.reset_input_buffer()
+        port.write(b'stream\r')
+        time.sleep(0.5)
+        print(port.read(port.in_waiting or 1).decode('ascii', 'replace'))
+
+
+if __name__ == '__main__':
+    main()
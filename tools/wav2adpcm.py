@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+wav2adpcm.py - Convert WAV files into the IMA-ADPCM sample bank
+
+Run from the project folder, e.g.:
+    python3 tools/wav2adpcm.py --rate 16000 samples/kick.wav samples/snare.wav
+
+Every file is mixed down to mono, resampled linearly to the given rate and
+encoded as IMA-ADPCM, two samples per byte, low nibble first. The stream
+starts with a predictor of 0 and a step index of 0, which is where
+Adpcm_Start() starts decoding. The bank is written to source/SampleBank.c
+as const data, so it stays in flash.
+
+Author: Surya Kanteti
+"""
+
+import argparse
+import os
+import struct
+import sys
+import wave
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+]
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def read_wav(path):
+    """Samples of a 8 or 16 bit PCM file as a list of mono ints, and the rate."""
+    with wave.open(path, 'rb') as wav:
+        channels = wav.getnchannels()
+        width = wav.getsampwidth()
+        rate = wav.getframerate()
+        frames = wav.readframes(wav.getnframes())
+
+    if width == 1:
+        values = [(b - 128) << 8 for b in frames]
+    elif width == 2:
+        values = list(struct.unpack('<%dh' % (len(frames) // 2), frames))
+    else:
+        sys.exit('%s: only 8 and 16 bit PCM is supported' % path)
+
+    mono = [sum(values[i:i + channels]) // channels
+            for i in range(0, len(values), channels)]
+    return mono, rate
+
+
+def resample(samples, source_rate, target_rate):
+    """Linear interpolation, the same way the sampler plays them back."""
+    if source_rate == target_rate or not samples:
+        return samples
+    count = (len(samples) * target_rate) // source_rate
+    out = []
+    for i in range(count):
+        position = i * source_rate / target_rate
+        index = int(position)
+        fraction = position - index
+        following = samples[min(index + 1, len(samples) - 1)]
+        out.append(int(round(samples[index] + (following - samples[index]) * fraction)))
+    return out
+
+
+def encode(samples):
+    """IMA-ADPCM codes, mirroring the decoder in source/Adpcm.c."""
+    predictor = 0
+    index = 0
+    codes = []
+    for sample in samples:
+        step = STEP_TABLE[index]
+        delta = sample - predictor
+        code = 0
+        if delta < 0:
+            code = 8
+            delta = -delta
+
+        # Quantize with the same shifts as the decoder reconstructs
+        difference = step >> 3
+        if delta >= step:
+            code |= 4
+            delta -= step
+            difference += step
+        if delta >= step >> 1:
+            code |= 2
+            delta -= step >> 1
+            difference += step >> 1
+        if delta >= step >> 2:
+            code |= 1
+            difference += step >> 2
+
+        if code & 8:
+            predictor -= difference
+        else:
+            predictor += difference
+        predictor = max(-32768, min(32767, predictor))
+        index = max(0, min(88, index + INDEX_TABLE[code & 7]))
+        codes.append(code)
+
+    if len(codes) & 1:
+        codes.append(0)
+    return bytes(codes[i] | (codes[i + 1] << 4) for i in range(0, len(codes), 2))
+
+
+def c_name(path):
+    return os.path.splitext(os.path.basename(path))[0].lower().replace('-', '_').replace(' ', '_')
+
+
+def write_bank(path, entries, rate, section):
+    attribute = ' __attribute__((section("%s")))' % section if section else ''
+    lines = [
+        '/*',
+        ' * SampleBank.c - IMA-ADPCM samples played by the sampler',
+        ' *',
+        ' * Generated by tools/wav2adpcm.py, do not edit.',
+        ' */',
+        '',
+        '#include "Sampler.h"',
+        '',
+    ]
+    for name, count, data in entries:
+        lines.append('// %s: %d samples at %d Hz, %d bytes' % (name, count, rate, len(data)))
+        lines.append('static const uint8_t %s_adpcm[%d]%s =' % (name, len(data), attribute))
+        lines.append('\t{')
+        for i in range(0, len(data), 16):
+            lines.append('\t\t' + ', '.join('0x%02X' % b for b in data[i:i + 16]) + ',')
+        lines.append('\t};')
+        lines.append('')
+
+    lines.append('const sample_info_t sampleBank[] =')
+    lines.append('\t{')
+    for name, count, _ in entries:
+        lines.append('\t\t{"%s", %s_adpcm, %d, %d},' % (name, name, count, rate))
+    lines.append('\t};')
+    lines.append('')
+    lines.append('const int sampleBankSize = sizeof(sampleBank) / sizeof(sampleBank[0]);')
+    lines.append('')
+
+    with open(path, 'w', newline='\n') as out:
+        out.write('\n'.join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('wavs', nargs='+', help='WAV files, in the order of the sample ids')
+    parser.add_argument('--rate', type=int, default=16000, help='sample rate stored in flash')
+    parser.add_argument('--output', default='source/SampleBank.c')
+    parser.add_argument('--section', help='linker section for the sample data')
+    args = parser.parse_args()
+
+    entries = []
+    for path in args.wavs:
+        samples, rate = read_wav(path)
+        samples = resample(samples, rate, args.rate)
+        entries.append((c_name(path), len(samples), encode(samples)))
+
+    write_bank(args.output, entries, args.rate, args.section)
+    total = sum(len(data) for _, _, data in entries)
+    print('%s: %d samples, %d bytes of flash' % (args.output, len(entries), total))
+
+
+if __name__ == '__main__':
+    main()